@@ -1,6 +1,6 @@
 /************************************************************
  * File: Direct3D11 thread.cpp          Created: 2022/10/12 *
- *                               Code last mod.: 2024/07/20 *
+ *                               Code last mod.: 2026/10/17 *
  *                                                          *
  * Desc: Video rendering via Direct3D 11 API.               *
  *                                                          *
@@ -127,6 +127,7 @@ RESOLUTION ScrRes = { 3600, 1600, 16.0f / 36.0f, 36.0f / 16.0f, 1.0f, DXGI_FORMA
 #include <dxgidebug.h>
 
 void Direct3D11Thread(ptr argList) {
+   MEM_TAG_SCOPE memTagScope(ss_video);
    // Live debugging for D3D11
    IDXGIDebug1 *devDebug;;
    hr = DXGIGetDebugInterface1(0, IID_PPV_ARGS(&devDebug));
@@ -147,12 +148,12 @@ void Direct3D11Thread(ptr argList) {
    ui32    iCurrentFrames = 0;
 
    // Prevent thread from shutting down (after engine reset)
-   _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~VIDEO_THREAD_DIED);
+   ThreadLifeClear(VIDEO_THREAD_DIED);
 
    hWnd = hRndrWnd = gpu.CreateRenderWindow();
 
 Reinitialise_:
-   _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~VIDEO_THREAD_RESET);
+   ThreadLifeClear(VIDEO_THREAD_RESET);
 
    cHANDLE waitGPU = gpu.InitialiseBackbuffer(hRndrWnd, ScrRes, ae_windowed);
 
@@ -460,7 +461,7 @@ Reinitialise_:
    fl32 fAvgFrameTime = 0;
    fl64 dTrisPerSec = 0;
 
-   _InterlockedOr64((vsi64ptr)&THREAD_LIFE, (si64)VIDEO_THREAD_DONE);
+   ThreadLifeSet(VIDEO_THREAD_DONE);
 
    ///
    /// Primary rendering loop
@@ -532,11 +533,11 @@ Reinitialise_:
       //WaitForSingleObjectEx(waitGPU, 1000, false);
       gpu.ren.ClearAndFlipOutputImage(c4_black_trans);
 
-      // Entities: Wait until visibility & modification culling completes, then upload modified entity data and render
-      cui128 entManThreadData = gpuHelper.ent.WaitThenUploadAndRender(0);
+      // Entities: Take the newest culling results, then upload modified entity data and render
+      cui128 entManThreadData = gpuHelper.ent.UploadAndRender(0);
 
-      // Map: Wait until visibility & modification culling completes, then upload modified cell data and render
-      cui128 mapManThreadData = gpuHelper.map.WaitThenUploadAndRender(0, 0);
+      // Map: Take the newest culling results, then upload modified cell data and render
+      cui128 mapManThreadData = gpuHelper.map.UploadAndRender(0, 0);
       uiVisChunks = mapManThreadData.m128i_u32[0];
 
       // Update debug UI readouts
@@ -548,8 +549,6 @@ Reinitialise_:
       snprintf(textBuffer[2], 128, "%d:%d:%d", inputBox.z, gui.siGUIElements, gui.uiGUIVerts);
 
       // Render 3D overlay(s)
-      gpu.cfg.SetBlendState(0, 1);
-      gpu.cfg.SetDepthStencilState(0, 0, 0);
       if(siActiveLayer.m128i_i32[0] < 0 && siCell != 0x080000001) gpu.ren.QueueDrawVoxel(0, (*(MAP_DESC *)ptrLib[14]).mcrv.activeCell, c4_light_violet);
 
       // Render GUI
@@ -559,10 +558,10 @@ Reinitialise_:
       // Display backbuffer
       gpu.ren.QueuePresentOutputImage(0);
 
-      Idle(thread.sleepTime[ss_video]);
+      ThreadLifeIdle(VIDEO_THREAD_ALIVE | VIDEO_THREAD_RESET, threadLife, thread.sleepTime[ss_video]);
    } while (threadLife & VIDEO_THREAD_ALIVE);
 
-   mapMan.Cull(0, 0, 0, 0, 0);
+   mapMan.Cull(0, 0, 0, 0);
    gpu.lit.DestroyAll();
    gpu.cfg.UnloadShaderData();
    DestroyWindow(hWnd);
@@ -570,7 +569,7 @@ Reinitialise_:
    hr = devDebug->ReportLiveObjects(DXGI_DEBUG_ALL, DXGI_DEBUG_RLO_ALL);
 
    Sleep(8);
-   _InterlockedOr64((vsi64ptr)&THREAD_LIFE, (si64)VIDEO_THREAD_DIED);
+   ThreadLifeSet(VIDEO_THREAD_DIED);
    //_endthread();
 }
 
@@ -594,7 +593,7 @@ LRESULT CALLBACK RndrWndProc(HWND hWndw, UINT message, WPARAM wParam, LPARAM lPa
    case WM_DESTROY:
    case WM_CLOSE:
    case WM_QUIT:
-      _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~MAIN_THREAD_ALIVE);
+      ThreadLifeClear(MAIN_THREAD_ALIVE);
       return 0;
    default:
       return DefWindowProc(hWndw, message, wParam, lParam);
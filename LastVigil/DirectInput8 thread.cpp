@@ -1,6 +1,6 @@
 /************************************************************
  * File: DirectInput8 thread.cpp        Created: 2022/11/01 *
- *                                Last modified: 2024/07/20 *
+ *                                Last modified: 2026/10/17 *
  *                                                          *
  * Desc:                                                    *
  *                                                          *
@@ -402,6 +402,7 @@ inline static csi16 ModifyCharBuffer(void) {
 }
 
 void DirectInput8Thread(ptr ArgList) {
+   MEM_TAG_SCOPE memTagScope(ss_input);
    CLASS_TIMER inputTimer;
    DIPROPDWORD dpw {};
    ui64        threadLife, i, j, k;
@@ -409,11 +410,11 @@ void DirectInput8Thread(ptr ArgList) {
    bool        povState;
 
    // Prevent thread from shutting down (after engine reset)
-   _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~INPUT_THREAD_DIED);
+   ThreadLifeClear(INPUT_THREAD_DIED);
 
 Reinitialise_:
 
-   _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~INPUT_THREAD_RESET);
+   ThreadLifeClear(INPUT_THREAD_RESET);
 
    Sleep(1000);
 
@@ -442,7 +443,7 @@ Reinitialise_:
    inputTimer.Reset(1.0);
    cfl64 dCurrentFrameTime = 0.0;
 
-   _InterlockedOr64((vsi64ptr)&THREAD_LIFE, (si64)INPUT_THREAD_DONE);
+   ThreadLifeSet(INPUT_THREAD_DONE);
 
    ///
    /// Primary processing loop
@@ -453,11 +454,14 @@ Reinitialise_:
 
       // Stall if no state change requested
       if(!(gcv.misc[7] & 0x080)) {
-         Idle(thread.sleepTime[ss_input]);
+         ThreadLifeIdle(INPUT_THREAD_ALIVE | INPUT_THREAD_RESET, threadLife, thread.sleepTime[ss_input]);
          continue;
       }
       gcv.misc[7] &= 0x07F;
 
+      // Release the previous tic's transient allocations
+      frameArena.Reset();
+
       // Thread timing snapshot
       inputTimer.Update();
       cfl64 dCurrentTicTime = inputTimer.GetTotalTimeScaled();
@@ -635,7 +639,7 @@ Reinitialise_:
                gcvLocal.joy[0].t.x = 1.0f;
                continue;
             case DIK_RCONTROL:
-               _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~MAIN_THREAD_ALIVE);
+               ThreadLifeClear(MAIN_THREAD_ALIVE);
                continue;
             default:
                gcvLocal.misc[3] |= 0x080;
@@ -658,6 +662,7 @@ Reinitialise_:
 
 //   Try(di8Key->Unacquire());
 //   Try(di8Mse->Unacquire());
-   _InterlockedOr64((vsi64ptr)&THREAD_LIFE, (si64)INPUT_THREAD_DIED);
+   frameArena.Destroy();
+   ThreadLifeSet(INPUT_THREAD_DIED);
    //_endthread();
 }
@@ -1,6 +1,6 @@
 /**************************************************************  
  * File: D3D11 helper functions.h         Created: 2023/05/31 *
- *                                  Last modified: 2024/07/09 *
+ *                                  Last modified: 2026/10/17 *
  *                                                            *
  * Desc:                                                      *
  *                                                            *
@@ -17,6 +17,7 @@
 #include "Direct3D11 functions/class_buffers.h"
 #include "Armada Intelligence/class_mapmanager.h"
 #include "Armada Intelligence/class_entitymanager.h"
+#include "Visibility results.h"
 
 al16 struct HELPFUNC_MAP {
    ui128 mapManThreadData = null128;
@@ -24,29 +25,27 @@ al16 struct HELPFUNC_MAP {
    CLASS_GPU    &gpu;
    CLASS_MAPMAN &man;
 
-   declare2d64z(ui32ptr, visBuf,  MAX_WORLDS, MAX_MAP_LOD);
-   declare1d64z(ui32ptr, modBuf,  MAX_WORLDS);
-   declare2d64z(si32,    gpuBuf,  MAX_WORLDS, 5u);
-   declare2d64z(si32,    vertBuf, MAX_WORLDS, MAX_MAP_LOD);
+   declare1d64z(VIS_RESULTS, vis,     MAX_WORLDS);
+   declare2d64z(si32,        gpuBuf,  MAX_WORLDS, 5u);
+   declare2d64z(si32,        vertBuf, MAX_WORLDS, MAX_MAP_LOD);
 
    ui8 levelsOfDetail = 0;
 
    HELPFUNC_MAP(CLASS_GPU &gpuClass, CLASS_MAPMAN &mapMan) : gpu(gpuClass), man(mapMan) {}
 
-   ~HELPFUNC_MAP(void) { mfree(modBuf, visBuf, vertBuf, gpuBuf); }
+   ~HELPFUNC_MAP(void) {
+      for(ui32 i = 0; i < MAX_WORLDS; i++) vis[i].Destroy();
+      mfree(vis, vertBuf, gpuBuf);
+   }
 
    void CreateBuffers(csi16 worldIndex, csi16 mapIndex, csi16 elementTableIndex) {
       cMAP        &map   = *man.world[worldIndex].map[mapIndex];
       cELEM_TABLE &table = man.table[elementTableIndex];
       csi32        count = map.desc.mapChunks;
 
-      for(ui32 i = 0; i <= levelsOfDetail; i++) {
-         csi32 subcount = count >> (levelsOfDetail - i);
-
-         visBuf[worldIndex][i]  = zalloc1d16(ui32, subcount);
-         vertBuf[worldIndex][i] = gpu.buf.CreateVertex(visBuf[worldIndex][i], sizeof(ui32), subcount, 1u);
-      }
-      modBuf[worldIndex] = zalloc1d16(ui32, count);
+      vis[worldIndex].Create(count, levelsOfDetail, count);
+      for(ui32 i = 0; i <= levelsOfDetail; i++)
+         vertBuf[worldIndex][i] = gpu.buf.CreateVertex(vis[worldIndex].set[0].list[i], sizeof(ui32), count >> (levelsOfDetail - i), 1u);
 
       cVEC3Du32 mapDim = { ui32(map.desc.mapDim.x), ui32(map.desc.mapDim.y), ui32(map.desc.mapDim.z) };
       declare1d16(ui32, relIndices, map.desc.mapCells);
@@ -60,43 +59,47 @@ al16 struct HELPFUNC_MAP {
       gpuBuf[worldIndex][0] = gpu.buf.CreateConstant(0, map.pCB, sizeof(MAPDIMS_ICB), man.world[worldIndex].totalMaps, 3u, ae_stages_vertex_geometry, true);
       gpuBuf[worldIndex][1] = gpu.buf.CreateStructured(0, table.pIGS, sizeof(ELEM_IGS), table.numElements, ae_buf_immutable);
       gpuBuf[worldIndex][2] = gpu.buf.CreateStructured(0, relIndices, sizeof(ui32),     map.desc.mapCells, ae_buf_immutable);
-      gpuBuf[worldIndex][3] = gpu.buf.CreateStructured(0, map.pDGS,   sizeof(CELL_DGS), map.desc.mapCells, ae_buf_dynamic);
-      gpuBuf[worldIndex][4] = gpu.buf.CreateStructured(0, map.pDPS,   sizeof(CELL_DPS), map.desc.mapCells, ae_buf_dynamic);
+      // Streamed and sparse maps have no full arrays to copy; every chunk starts modified, so the first upload fills them
+      cbool reserved = map.stream || map.sparse;
+      gpuBuf[worldIndex][3] = gpu.buf.CreateStructured(0, reserved ? NULL : map.pDGS, sizeof(CELL_DGS), map.desc.mapCells, ae_buf_dynamic);
+      gpuBuf[worldIndex][4] = gpu.buf.CreateStructured(0, reserved ? NULL : map.pDPS, sizeof(CELL_DPS), map.desc.mapCells, ae_buf_dynamic);
 
       mfree1(relIndices);
    }
 
-   inline void StartViewCulling(csi32 worldIndex, csi32 mapIndex) const { man.Cull(visBuf[worldIndex], modBuf[worldIndex], worldIndex, mapIndex, 1); }
+   inline void StartViewCulling(csi32 worldIndex, csi32 mapIndex) { man.Cull(&vis[worldIndex], worldIndex, mapIndex, cm_job); }
 
 ///--- !!! Expand to 7 LODs !!!
-   // Returns counts for { Chunks uploaded, LOD 0 chunks, LOD 1 chunks, LOD 2 chunks }
-   cui128 WaitThenUploadAndRender(csi16 worldIndex, csi16 mapIndex) {
+   // Returns counts for { LOD 0 chunks, LOD 1 chunks, LOD 2 chunks, Chunks uploaded }
+   cui128 UploadAndRender(csi16 worldIndex, csi16 mapIndex) {
       cMAP &map = *man.world[worldIndex].map[mapIndex];
+      bool  fresh;
       ui32  i;
 
-      // Wait until visibility & modification culling completes
-      man.WaitForCulling(mapManThreadData, 0);
+      // Lock-step cull modes publish only once their threads are collected
+      if(man.lockStep) man.WaitForCulling(mapManThreadData, 0);
 
-      // Upload modified cell data
-      CELL_DGSptrc cellGeoData = (CELL_DGSptr)gpu.buf.LockStructuredBeforeUpdate(0, gpuBuf[worldIndex][3]);
-      CELL_DPSptrc cellPixData = (CELL_DPSptr)gpu.buf.LockStructuredBeforeUpdate(0, gpuBuf[worldIndex][4]);
-      
-      cui64 chunkDGS = sizeof(CELL_DGS) * map.desc.chunkCells;
-      cui64 chunkDPS = sizeof(CELL_DPS) * map.desc.chunkCells;
+      // Newest complete culling results; a pass still in flight is not waited on
+      VIS_SET &set     = vis[worldIndex].Take(fresh);
+      cui32    uploads = fresh ? set.modCount : 0;
 
-      for(i = 0; i < mapManThreadData.m128i_u32[3]; i++) {
-         csi32 cellIndex = modBuf[worldIndex][i] * map.desc.chunkCells;
+      // Upload modified cell data; a set already rendered was uploaded then
+      if(uploads) {
+         CELL_DGSptrc cellGeoData = (CELL_DGSptr)gpu.buf.LockStructuredBeforeUpdate(0, gpuBuf[worldIndex][3]);
+         CELL_DPSptrc cellPixData = (CELL_DPSptr)gpu.buf.LockStructuredBeforeUpdate(0, gpuBuf[worldIndex][4]);
 
-         Stream16(&map.pDGS[cellIndex], &cellGeoData[cellIndex], chunkDGS);
-         Stream16(&map.pDPS[cellIndex], &cellPixData[cellIndex], chunkDPS);
+         // Encoded chunks of a sparse map are decoded straight into the buffers
+         for(i = 0; i < uploads; i++) man.StageChunk(map, set.mod[i], cellGeoData, cellPixData);
+         gpu.buf.UnlockStructuredAfterUpdate(0, gpuBuf[worldIndex][3]);
+         gpu.buf.UnlockStructuredAfterUpdate(0, gpuBuf[worldIndex][4]);
       }
-      gpu.buf.UnlockStructuredAfterUpdate(0, gpuBuf[worldIndex][3]);
-      gpu.buf.UnlockStructuredAfterUpdate(0, gpuBuf[worldIndex][4]);
 
       // Render map
-      cMAP_PARAMS params = { gpuBuf[worldIndex], vertBuf[worldIndex], visBuf[worldIndex], mapManThreadData.m128i_u32, map.desc.chunkCells, 0 };
+      cMAP_PARAMS params = { gpuBuf[worldIndex], vertBuf[worldIndex], (ui32ptrc (&)[MAX_MAP_LOD])set.list, set.count, map.desc.chunkCells, 0 };
       gpu.ren.QueueDrawMap(params);
 
+      mapManThreadData = { .m128i_u32 = { set.count[0], set.count[1], set.count[2], uploads } };
+
       return mapManThreadData;
    }
 
@@ -111,16 +114,18 @@ al16 struct HELPFUNC_ENT {
    CLASS_GPU    &gpu;
    CLASS_ENTMAN &man;
 
-   declare2d64z(ui32ptr, visBuf,  MAX_ENTITY_GROUPS, MAX_ENT_LOD);
-   declare1d64z(ui32ptr, modBuf,  MAX_ENTITY_GROUPS);
-   declare2d64z(si32,    gpuBuf,  MAX_ENTITY_GROUPS, 4u);
-   declare2d64z(si32,    vertBuf, MAX_ENTITY_GROUPS, MAX_ENT_LOD);
+   declare1d64z(VIS_RESULTS, vis,     MAX_ENTITY_GROUPS);
+   declare2d64z(si32,        gpuBuf,  MAX_ENTITY_GROUPS, 4u);
+   declare2d64z(si32,        vertBuf, MAX_ENTITY_GROUPS, MAX_ENT_LOD);
 
    ui8 levelsOfDetail = 0;
 
    HELPFUNC_ENT(CLASS_GPU &gpuClass, CLASS_ENTMAN &entMan) : gpu(gpuClass), man(entMan) {}
 
-   ~HELPFUNC_ENT() { mfree(modBuf, visBuf, vertBuf, gpuBuf); }
+   ~HELPFUNC_ENT() {
+      for(ui32 i = 0; i < MAX_ENTITY_GROUPS; i++) vis[i].Destroy();
+      mfree(vis, vertBuf, gpuBuf);
+   }
 
    void CreateBuffers(csi16 groupIndex) {
       OBJECT_GROUP &objGroup = man.objGroup[groupIndex];
@@ -128,13 +133,10 @@ al16 struct HELPFUNC_ENT {
 
       cui32 count = RoundUpToNearest32(entGroup.totalBones);
 
-      for(ui32 i = 0; i <= levelsOfDetail; i++) {
-         csi32 subcount = count >> (levelsOfDetail - i);
-
-         visBuf[groupIndex][i]  = zalloc1d16(ui32, subcount);
-         vertBuf[groupIndex][i] = gpu.buf.CreateVertex(visBuf[groupIndex][i], sizeof(ui32) * 32, (subcount + 31) >> 5, 1);
-      }
-      modBuf[groupIndex] = zalloc1d16(ui32, count);
+      // Mod lists hold a skipped set's carried-over bones as well as a full pass (see _ET_Cull_Pass())
+      vis[groupIndex].Create(count, levelsOfDetail, (count << 1) + 64u);
+      for(ui32 i = 0; i <= levelsOfDetail; i++)
+         vertBuf[groupIndex][i] = gpu.buf.CreateVertex(vis[groupIndex].set[0].list[i], sizeof(ui32) * 32, ((count >> (levelsOfDetail - i)) + 31) >> 5, 1);
 
       gpuBuf[groupIndex][0] = gpu.buf.CreateStructured(0, objGroup.object, sizeof(OBJECT_IGS), objGroup.totalObjects, ae_buf_immutable);
       gpuBuf[groupIndex][1] = gpu.buf.CreateStructured(0, objGroup.part, sizeof(PART_IGS), objGroup.totalParts, ae_buf_immutable);
@@ -142,34 +144,43 @@ al16 struct HELPFUNC_ENT {
       gpuBuf[groupIndex][3] = gpu.buf.CreateStructured(0, entGroup.spriteO, sizeof(SPRITE_DPS), entGroup.totalSpritesO, ae_buf_dynamic);
    }
 
-   inline void StartViewCulling(csi32 groupIndex) const { man.Cull(visBuf[groupIndex], modBuf[groupIndex], groupIndex, 1); }
+   inline void StartViewCulling(csi32 groupIndex) { man.Cull(&vis[groupIndex], groupIndex, cm_job); }
 
    ///--- !!! Expand to 7 LODs !!!
-   // Returns counts for { Entities uploaded, LOD 0 entities, LOD 1 entities, LOD 2 entities }
-   cui128 WaitThenUploadAndRender(csi16 groupIndex) {
+   // Returns counts for { LOD 0 entities, LOD 1 entities, LOD 2 entities, Entities uploaded }
+   cui128 UploadAndRender(csi16 groupIndex) {
       cENTITY_GROUP &group = man.entGroup[groupIndex];
+      bool           fresh;
       ui32           i;
 
-      // Wait until visibility & modification culling completes
-      man.WaitForCulling(entManThreadData, 0);
-
-      // Upload modified entity data
-      BONE_DGSptrc   boneGeoData = (BONE_DGSptr)gpu.buf.LockStructuredBeforeUpdate(0, gpuBuf[groupIndex][2]);
-      SPRITE_DPSptrc bonePixData = (SPRITE_DPSptr)gpu.buf.LockStructuredBeforeUpdate(0, gpuBuf[groupIndex][3]);
+      // Lock-step cull modes publish only once their threads are collected
+      if(man.lockStep) man.WaitForCulling(entManThreadData, 0);
 
-      for(i = 0; i < entManThreadData.m128i_u32[3]; i++) {
-         csi32 boneIndex = modBuf[groupIndex][i];
+      // Newest complete culling results; a pass still in flight is not waited on
+      VIS_SET &set     = vis[groupIndex].Take(fresh);
+      cui32    uploads = fresh ? set.modCount : 0;
 
-         Stream64(&group.bone_dgs[boneIndex], &boneGeoData[boneIndex], sizeof(BONE_DGS));
-         Stream16(&group.spriteO[boneIndex], &bonePixData[boneIndex], sizeof(SPRITE_DPS));
+      // Upload modified entity data
+      if(uploads) {
+         BONE_DGSptrc   boneGeoData = (BONE_DGSptr)gpu.buf.LockStructuredBeforeUpdate(0, gpuBuf[groupIndex][2]);
+         SPRITE_DPSptrc bonePixData = (SPRITE_DPSptr)gpu.buf.LockStructuredBeforeUpdate(0, gpuBuf[groupIndex][3]);
+
+         for(i = 0; i < uploads; i++) {
+            csi32 boneIndex = set.mod[i];
+
+            Stream64(&group.bone_dgs[boneIndex], &boneGeoData[boneIndex], sizeof(BONE_DGS));
+            Stream16(&group.spriteO[boneIndex], &bonePixData[boneIndex], sizeof(SPRITE_DPS));
+         }
+         gpu.buf.UnlockStructuredAfterUpdate(0, gpuBuf[groupIndex][2]);
+         gpu.buf.UnlockStructuredAfterUpdate(0, gpuBuf[groupIndex][3]);
       }
-      gpu.buf.UnlockStructuredAfterUpdate(0, gpuBuf[groupIndex][2]);
-      gpu.buf.UnlockStructuredAfterUpdate(0, gpuBuf[groupIndex][3]);
 
       // Render entities
-      cENT_PARAMS params = { gpuBuf[groupIndex], vertBuf[groupIndex], visBuf[groupIndex], entManThreadData.m128i_u32, levelsOfDetail, 0 };
+      cENT_PARAMS params = { gpuBuf[groupIndex], vertBuf[groupIndex], (ui32ptrc (&)[MAX_ENT_LOD])set.list, set.count, levelsOfDetail, 0 };
       gpu.ren.QueueDrawEntities(params);
 
+      entManThreadData = { .m128i_u32 = { set.count[0], set.count[1], set.count[2], uploads } };
+
       return entManThreadData;
    }
 
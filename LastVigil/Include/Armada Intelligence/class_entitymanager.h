@@ -1,6 +1,6 @@
 /************************************************************
  * File: class_entitymanager.h          Created: 2023/05/06 *
- *                                Last modified: 2024/07/14 *
+ *                                Last modified: 2026/10/17 *
  *                                                          *
  * Desc:                                                    *
  *                                                          *
@@ -12,11 +12,13 @@
 #include "Data structures.h"
 #include "Entity structures.h"
 #include "Map structures.h"
+#include "Visibility results.h"
 #include "Common functions.h"
 
 extern vui128 ENTMAN_THREAD_STATUS;
 
 static void _ET_Cull_Nonvisible_and_Unchanged(ptr);
+static void _ET_Cull_Pass(ptr, cui64, cui64);
 static void _ET_Cull_Nonvisible_Accurate(ptr);
 static void _ET_Cull_Unchanged(ptr);
 
@@ -37,9 +39,12 @@ al16 struct CLASS_ENTMAN {
    si32 siObjectGroups = 0;
    si32 siEntityGroups = 0;
 
-   // 4 bytes spare
+   ui16 groupGen[MAX_ENTITY_GROUPS] = {}; // First slot generation of the next group created at each index (ENTITY_GROUP::genBase)
+
+   // 4 bytes spare (groupGen ends at byte 204)
 
    ENTMAN_THREAD_DATA threadData[2];
+   ui8                lockStep = 0; // Split cull threads (Cull() split CULL_MODEs) publish only through WaitForCulling()
 
 #ifdef AE_PTR_LIB
    CLASS_ENTMAN(void) {
@@ -55,6 +60,7 @@ al16 struct CLASS_ENTMAN {
 
    // Create array of object template slots
    cui32 CreateObjectGroup(chptrc name, chptrc text, csi32 maxObjects, csi32 maxParts) {
+      MEM_TAG_SCOPE memTagScope(ss_entity);
       // Find next available index
       for(siEntry = 0; objGroup[siEntry].object; siEntry++);
       if(siEntry >= MAX_OBJECT_GROUPS) { return 0x080000001; }
@@ -67,30 +73,125 @@ al16 struct CLASS_ENTMAN {
       return siEntry; // Return group index
    }
 
-   // Create array of entity slots
+   //-- Growable group arrays
+   //   Each array of an entity group reserves address space for MAX_ENTITIES or MAX_BONES elements when the group is
+   //   created, and commits pages as maxEntities/maxBones grow. Arrays never move, so ENTITY::part/bone/sprite and the
+   //   culler's pointers stay valid across growth; newly committed elements read as zero.
+
+   // Commits the group's arrays from their current capacity up to newMaxEntities and newMaxBones. Returns false, leaving
+   // the capacity unchanged, if the OS refuses; pages committed before the failure are kept for the next attempt
+   inline cbool CommitEntityGroup(ENTITY_GROUP &curGroup, cui32 newMaxEntities, cui32 newMaxBones) const {
+      cui64 e0 = (ui32)curGroup.maxEntities, e1 = newMaxEntities, b0 = (ui32)curGroup.maxBones, b1 = newMaxBones;
+
+      if(!vcommit(curGroup.entity,        e0 * sizeof(ENTITY),         e1 * sizeof(ENTITY))         ||
+         !vcommit(curGroup.entityFree,    e0 * sizeof(ui32),           e1 * sizeof(ui32))           ||
+         !vcommit(curGroup.entityLive,    e0 * sizeof(ui32),           e1 * sizeof(ui32))           ||
+         !vcommit(curGroup.livePos,       e0 * sizeof(ui32),           e1 * sizeof(ui32))           ||
+         !vcommit(curGroup.entityGen,     e0 * sizeof(ui16),           e1 * sizeof(ui16))           ||
+         !vcommit(curGroup.entityVis,     ((e0 + 63u) >> 6) << 3,      ((e1 + 63u) >> 6) << 3)      ||
+         !vcommit(curGroup.entityMod,     ((e0 + 63u) >> 6) << 3,      ((e1 + 63u) >> 6) << 3)      ||
+         !vcommit(curGroup.bone,          b0 * sizeof(BONE),           b1 * sizeof(BONE))           ||
+         !vcommit(curGroup.bone_dgs,      b0 * sizeof(BONE_DGS),       b1 * sizeof(BONE_DGS))       ||
+         !vcommit(curGroup.spriteO,       b0 * sizeof(SPRITE_DPS),     b1 * sizeof(SPRITE_DPS))     ||
+         !vcommit(curGroup.spriteT,       b0 * sizeof(SPRITE_DPS),     b1 * sizeof(SPRITE_DPS))     ||
+         !vcommit(curGroup.boneNext,      b0 * sizeof(ui32),           b1 * sizeof(ui32))           ||
+         !vcommit(curGroup.spriteFree[0], b0 * sizeof(ui32),           b1 * sizeof(ui32))           ||
+         !vcommit(curGroup.spriteFree[1], b0 * sizeof(ui32),           b1 * sizeof(ui32))           ||
+         !vcommit(curGroup.boneSolo,      b0,                          b1)) return false;
+
+      // New slots start at the group's base generation, not 0, so ID64s of a destroyed group at this index stay stale
+      for(ui64 i = e0; i < e1; i++) curGroup.entityGen[i] = curGroup.genBase;
+
+      curGroup.maxEntities = newMaxEntities;
+      curGroup.maxBones    = newMaxBones;
+
+      return true;
+   }
+
+   // Releases every array of a group, committed pages and reservation alike
+   inline void ReleaseEntityGroup(ENTITY_GROUP &curGroup) const {
+      cui64 e = (ui32)curGroup.maxEntities, b = (ui32)curGroup.maxBones;
+
+      vrelease(curGroup.boneSolo,      b,                      MAX_BONES);
+      vrelease(curGroup.spriteFree[1], b * sizeof(ui32),       MAX_BONES * sizeof(ui32));
+      vrelease(curGroup.spriteFree[0], b * sizeof(ui32),       MAX_BONES * sizeof(ui32));
+      vrelease(curGroup.boneNext,      b * sizeof(ui32),       MAX_BONES * sizeof(ui32));
+      vrelease(curGroup.spriteT,       b * sizeof(SPRITE_DPS), MAX_BONES * sizeof(SPRITE_DPS));
+      vrelease(curGroup.spriteO,       b * sizeof(SPRITE_DPS), MAX_BONES * sizeof(SPRITE_DPS));
+      vrelease(curGroup.bone_dgs,      b * sizeof(BONE_DGS),   MAX_BONES * sizeof(BONE_DGS));
+      vrelease(curGroup.bone,          b * sizeof(BONE),       MAX_BONES * sizeof(BONE));
+      vrelease(curGroup.entityMod,     ((e + 63u) >> 6) << 3,  MAX_ENTITIES >> 3);
+      vrelease(curGroup.entityVis,     ((e + 63u) >> 6) << 3,  MAX_ENTITIES >> 3);
+      vrelease(curGroup.entityGen,     e * sizeof(ui16),       MAX_ENTITIES * sizeof(ui16));
+      vrelease(curGroup.livePos,       e * sizeof(ui32),       MAX_ENTITIES * sizeof(ui32));
+      vrelease(curGroup.entityLive,    e * sizeof(ui32),       MAX_ENTITIES * sizeof(ui32));
+      vrelease(curGroup.entityFree,    e * sizeof(ui32),       MAX_ENTITIES * sizeof(ui32));
+      vrelease(curGroup.entity,        e * sizeof(ENTITY),     MAX_ENTITIES * sizeof(ENTITY));
+   }
+
+   // Doubles a group's entity (or bone) capacity, to at least minEntities (minBones), capped at MAX_ENTITIES (MAX_BONES)
+   inline cbool GrowEntityGroup(ENTITY_GROUP &curGroup, cui32 minEntities, cui32 minBones) const {
+      ui32 newEntities = (ui32)curGroup.maxEntities, newBones = (ui32)curGroup.maxBones;
+
+      if(minEntities > newEntities) newEntities = (newEntities << 1) > minEntities ? (newEntities << 1) : minEntities;
+      if(minBones > newBones)       newBones    = (newBones << 1) > minBones ? (newBones << 1) : minBones;
+      if(newEntities > MAX_ENTITIES) newEntities = MAX_ENTITIES;
+      if(newBones > MAX_BONES)       newBones    = MAX_BONES;
+      if(newEntities < minEntities || newBones < minBones) return false;
+
+      return CommitEntityGroup(curGroup, newEntities, newBones);
+   }
+
+   // Create array of entity slots; maxEntities/maxBones are the initial capacity, which grows on demand up to MAX_ENTITIES/MAX_BONES
    cui32 CreateEntityGroup(chptrc name, chptrc text, csi32 maxEntities, csi32 maxBones) {
+      MEM_TAG_SCOPE memTagScope(ss_entity);
       // Find next available index
       for(siEntry = 0; entGroup[siEntry].entity; siEntry++);
       if(siEntry >= MAX_ENTITY_GROUPS) { return 0x080000001; }
       if(maxEntities > MAX_ENTITIES) { return 0x080000002; }
       if(maxBones > MAX_BONES) { return 0x080000003; }
 
-      entGroup[siEntry].name          = name;
-      entGroup[siEntry].text          = text;
-      entGroup[siEntry].entity        = (ENTITY *)zalloc32(sizeof(ENTITY) * maxEntities);
-      entGroup[siEntry].bone          = (BONE *)zalloc32(sizeof(BONE) * maxBones);
-      entGroup[siEntry].bone_dgs      = (BONE_DGS *)zalloc32(sizeof(BONE_DGS) * maxBones);
-      entGroup[siEntry].spriteO       = (SPRITE_DPS *)zalloc32(sizeof(SPRITE_DPS) * maxBones);
-      entGroup[siEntry].spriteT       = (SPRITE_DPS *)zalloc32(sizeof(SPRITE_DPS) * maxBones);
-      entGroup[siEntry].entityVis     = (ui64ptr)zalloc32(maxEntities >> 3);
-      entGroup[siEntry].entityMod     = (ui64ptr)zalloc32(maxEntities >> 3);
-      entGroup[siEntry].totalEntities = 0;
-      entGroup[siEntry].totalBones    = 0;
-      entGroup[siEntry].totalBone_DGS = 0;
-      entGroup[siEntry].totalSpritesO = 0;
-      entGroup[siEntry].totalSpritesT = 0;
-      entGroup[siEntry].maxEntities   = maxEntities;
-      entGroup[siEntry].maxBones      = maxBones;
+      ENTITY_GROUP &curGroup = entGroup[siEntry];
+
+      curGroup.name          = name;
+      curGroup.text          = text;
+      curGroup.entity        = (ENTITY *)vreserve(MAX_ENTITIES * sizeof(ENTITY));
+      curGroup.bone          = (BONE *)vreserve(MAX_BONES * sizeof(BONE));
+      curGroup.bone_dgs      = (BONE_DGS *)vreserve(MAX_BONES * sizeof(BONE_DGS));
+      curGroup.spriteO       = (SPRITE_DPS *)vreserve(MAX_BONES * sizeof(SPRITE_DPS));
+      curGroup.spriteT       = (SPRITE_DPS *)vreserve(MAX_BONES * sizeof(SPRITE_DPS));
+      curGroup.entityVis     = (ui64ptr)vreserve(MAX_ENTITIES >> 3);
+      curGroup.entityMod     = (ui64ptr)vreserve(MAX_ENTITIES >> 3);
+      curGroup.entityFree    = (ui32ptr)vreserve(MAX_ENTITIES * sizeof(ui32));
+      curGroup.entityLive    = (ui32ptr)vreserve(MAX_ENTITIES * sizeof(ui32));
+      curGroup.livePos       = (ui32ptr)vreserve(MAX_ENTITIES * sizeof(ui32));
+      curGroup.entityGen     = (ui16ptr)vreserve(MAX_ENTITIES * sizeof(ui16));
+      curGroup.boneNext      = (ui32ptr)vreserve(MAX_BONES * sizeof(ui32));
+      curGroup.spriteFree[0] = (ui32ptr)vreserve(MAX_BONES * sizeof(ui32));
+      curGroup.spriteFree[1] = (ui32ptr)vreserve(MAX_BONES * sizeof(ui32));
+      curGroup.boneSolo      = (ui8ptr)vreserve(MAX_BONES);
+      curGroup.totalEntities = 0;
+      curGroup.totalBones    = 0;
+      curGroup.totalBone_DGS = 0;
+      curGroup.totalSpritesO = 0;
+      curGroup.totalSpritesT = 0;
+      curGroup.maxEntities   = 0;
+      curGroup.maxBones      = 0;
+      curGroup.freeEntities  = 0;
+      curGroup.liveEntities  = 0;
+      curGroup.freeSprites[0] = 0;
+      curGroup.freeSprites[1] = 0;
+      curGroup.genBase        = groupGen[siEntry];
+      for(ui32 i = 0; i < MAX_BONES_PER_ENTITY; i++) curGroup.boneFree[i] = 0x0FFFFFFFF;
+
+      if(!curGroup.entity || !curGroup.bone || !curGroup.bone_dgs || !curGroup.spriteO || !curGroup.spriteT || !curGroup.entityVis ||
+         !curGroup.entityMod || !curGroup.entityFree || !curGroup.entityLive || !curGroup.livePos || !curGroup.entityGen ||
+         !curGroup.boneNext || !curGroup.spriteFree[0] || !curGroup.spriteFree[1] || !curGroup.boneSolo ||
+         !CommitEntityGroup(curGroup, maxEntities, maxBones)) {
+         ReleaseEntityGroup(curGroup);
+         memset(&curGroup, 0, sizeof(ENTITY_GROUP));
+         return 0x080000004;
+      }
       siEntityGroups++;
 
       return siEntry;   // Return group index
@@ -109,12 +210,21 @@ al16 struct CLASS_ENTMAN {
       return 0x80000001;
    }
 
-   // Remove group of entity slots
+   // Remove group of entity slots. The next group created at this index issues generations above any this one reached
    cui32 DestroyEntityGroup(csi16 group) {
       if(entGroup[group].entity) {
-         mfree(entGroup[siEntry].entityMod, entGroup[siEntry].entityVis, entGroup[group].spriteT, entGroup[group].spriteO, entGroup[group].bone, entGroup[group].entity);
+         cENTITY_GROUP &curGroup = entGroup[group];
+         ui16           advance  = 0; // Furthest any slot's generation moved past genBase
 
-         memset(&objGroup[group], 0, sizeof(OBJECT_GROUP));
+         for(si32 i = 0; i < curGroup.maxEntities; i++) {
+            cui16 slotAdvance = curGroup.entityGen[i] - curGroup.genBase;
+            if(slotAdvance > advance) advance = slotAdvance;
+         }
+         groupGen[group] = curGroup.genBase + advance + 1u;
+
+         ReleaseEntityGroup(entGroup[group]);
+
+         memset(&entGroup[group], 0, sizeof(ENTITY_GROUP));
 
          return --siEntityGroups;
       }
@@ -145,30 +255,232 @@ al16 struct CLASS_ENTMAN {
       return { index, group };
    }
 
-   cID64 CreateEntity(cui32 group, ID32 object, cbool transparent) {
-      cui32 index = entGroup[group].totalEntities++;
+   //-- Slot pool
+   //   Entity slots, bone ranges and sprite indices are recycled through per-group free lists; every operation is O(1).
+   //   Bone ranges are pooled by length (1~MAX_BONES_PER_ENTITY), so a released range is only reused by an entity of
+   //   the same part count. None of these functions are thread-safe: call them while the group's culler is idle.
+
+   // Issues an entity slot, reusing the most recently released one, and growing the group when it is full. Returns 0x080000001
+   // when the group is at MAX_ENTITIES or cannot grow
+   inline cui32 AcquireEntitySlot(ENTITY_GROUP &curGroup) const {
+      ui32 index;
+
+      if(curGroup.freeEntities) index = curGroup.entityFree[--curGroup.freeEntities];
+      else if(curGroup.totalEntities < curGroup.maxEntities || GrowEntityGroup(curGroup, curGroup.totalEntities + 1u, 0)) index = curGroup.totalEntities++;
+      else return 0x080000001;
+
+      curGroup.livePos[index] = curGroup.liveEntities;
+      curGroup.entityLive[curGroup.liveEntities++] = index;
+
+      return index;
+   }
+
+   // Issues boneCount (1~MAX_BONES_PER_ENTITY) contiguous bones, reusing a released range of that length, and growing the group
+   // when it is full. Returns 0x080000001 when the group is at MAX_BONES or cannot grow
+   inline cui32 AcquireBoneRange(ENTITY_GROUP &curGroup, cui32 boneCount) const {
+      ui32 &head = curGroup.boneFree[boneCount - 1];
+
+      if(head != 0x0FFFFFFFF) {
+         cui32 boneIndex = head;
+         head = curGroup.boneNext[boneIndex];
+         return boneIndex;
+      }
+      if(curGroup.totalBones + boneCount > (ui32)curGroup.maxBones && !GrowEntityGroup(curGroup, 0, curGroup.totalBones + boneCount)) return 0x080000001;
+
+      cui32 boneIndex = curGroup.totalBones;
+      curGroup.totalBones += boneCount;
+
+      return boneIndex;
+   }
+
+   // Returns boneCount bones starting at boneIndex to the pool; a range at the top of the array shrinks totalBones instead
+   inline void ReleaseBoneRange(ENTITY_GROUP &curGroup, cui32 boneIndex, cui32 boneCount) const {
+      if(boneIndex + boneCount == (ui32)curGroup.totalBones) {
+         curGroup.totalBones = boneIndex;
+         if(curGroup.totalBone_DGS > curGroup.totalBones) curGroup.totalBone_DGS = curGroup.totalBones;
+         return;
+      }
+      curGroup.boneNext[boneIndex]     = curGroup.boneFree[boneCount - 1];
+      curGroup.boneFree[boneCount - 1] = boneIndex;
+   }
+
+   // Issues a sprite array index (sai); layer: 0==Opaque, 1==Transparent
+   inline cui32 AcquireSprite(ENTITY_GROUP &curGroup, cui8 layer) const {
+      if(curGroup.freeSprites[layer]) return curGroup.spriteFree[layer][--curGroup.freeSprites[layer]];
+
+      return (layer ? curGroup.totalSpritesT++ : curGroup.totalSpritesO++);
+   }
+
+   // Returns a slot to the pool and retires its generation; swap-and-pop keeps the live list dense for the culler
+   inline void ReleaseEntitySlot(ENTITY_GROUP &curGroup, cui32 index) const {
+      cui32 pos  = curGroup.livePos[index];
+      cui32 last = curGroup.entityLive[--curGroup.liveEntities];
+
+      curGroup.entityLive[pos] = last;
+      curGroup.livePos[last]   = pos;
+      curGroup.livePos[index]  = 0x0FFFFFFFF;
+
+      curGroup.entityGen[index]++;
+      curGroup.entityFree[curGroup.freeEntities++] = index;
+   }
+
+   // Rebuilds the bone-range free lists from the live entities and standalone bones (boneSolo). Adjacent released ranges
+   // merge, each gap is re-split into ranges of up to MAX_BONES_PER_ENTITY bones (listed lowest-first), and a gap at the
+   // top of the array shrinks totalBones
+   inline void CompactBones(ENTITY_GROUP &curGroup) const {
+      cui32 totalBones = (ui32)curGroup.totalBones;
+      ui32  tail[MAX_BONES_PER_ENTITY];
+      ui32  top = 0; // End of the highest live range
+
+      // boneNext doubles as scratch: the length of each live range at its first bone, 0 elsewhere
+      memset(curGroup.boneNext, 0, totalBones * sizeof(ui32));
+      for(si32 i = 0; i < curGroup.liveEntities; i++) {
+         cENTITY &curEnt = curGroup.entity[curGroup.entityLive[i]];
+         curGroup.boneNext[curEnt.boneIndex] = curEnt.numParts + 1u;
+      }
+      for(ui32 b = 0; b < totalBones; b++) if(curGroup.boneSolo[b]) curGroup.boneNext[b] = 1u;
+      for(ui32 i = 0; i < MAX_BONES_PER_ENTITY; i++) curGroup.boneFree[i] = 0x0FFFFFFFF;
+
+      for(ui32 b = 0; b < totalBones;) {
+         if(curGroup.boneNext[b]) { b += curGroup.boneNext[b];   top = b;   continue; }
+
+         ui32 gapEnd = b + 1u;
+         while(gapEnd < totalBones && !curGroup.boneNext[gapEnd]) gapEnd++;
+         if(gapEnd == totalBones) break;
+
+         // Links are written behind the scan, so they never overwrite a length still to be read
+         for(ui32 length; b < gapEnd; b += length) {
+            length = (gapEnd - b) < MAX_BONES_PER_ENTITY ? (gapEnd - b) : MAX_BONES_PER_ENTITY;
+            ui32 &head = curGroup.boneFree[length - 1u];
+            if(head == 0x0FFFFFFFF) head = b;
+            else curGroup.boneNext[tail[length - 1u]] = b;
+            tail[length - 1u] = b;
+         }
+      }
+      for(ui32 i = 0; i < MAX_BONES_PER_ENTITY; i++)
+         if(curGroup.boneFree[i] != 0x0FFFFFFFF) curGroup.boneNext[tail[i]] = 0x0FFFFFFFF;
+
+      curGroup.totalBones = top;
+      if(curGroup.totalBone_DGS > curGroup.totalBones) curGroup.totalBone_DGS = curGroup.totalBones;
+   }
+
+   // Rebuilds both sprite free stacks from the sprite indices (sai) of the live entities' bones and standalone bones;
+   // released indices at the top of each layer shrink its total, and the rest are stacked so the lowest is issued first
+   inline void CompactSprites(ENTITY_GROUP &curGroup) const {
+      si32 *const totalSprites[2] = { &curGroup.totalSpritesO, &curGroup.totalSpritesT };
+
+      // spriteFree doubles as scratch: 1 at each sai in use, 0 elsewhere
+      for(ui8 layer = 0; layer < 2u; layer++) memset(curGroup.spriteFree[layer], 0, *totalSprites[layer] * sizeof(ui32));
+      for(si32 i = 0; i < curGroup.liveEntities; i++) {
+         cENTITY &curEnt = curGroup.entity[curGroup.entityLive[i]];
+         cui8     layer  = (curEnt.sprite == &curGroup.spriteT[curEnt.boneIndex] ? 1 : 0);
+
+         for(ui32 b = curEnt.boneIndex; b <= curEnt.boneIndex + curEnt.numParts; b++) curGroup.spriteFree[layer][curGroup.bone_dgs[b].sai] = 1u;
+      }
+      for(si32 b = 0; b < curGroup.totalBones; b++)
+         if(curGroup.boneSolo[b]) curGroup.spriteFree[curGroup.boneSolo[b] - 1u][curGroup.bone_dgs[b].sai] = 1u;
+
+      for(ui8 layer = 0; layer < 2u; layer++) {
+         ui32ptrc stack = curGroup.spriteFree[layer];
+         si32    &total = *totalSprites[layer];
+         ui32     count = 0;
+
+         while(total && !stack[total - 1]) total--;
+         // stack[count] is written only after stack[i >= count] has been read
+         for(si32 i = 0; i < total; i++) if(!stack[i]) stack[count++] = i;
+         for(ui32 i = 0, j = count - 1u; count && i < j; i++, j--) { cui32 t = stack[i];   stack[i] = stack[j];   stack[j] = t; }
+         curGroup.freeSprites[layer] = count;
+      }
+   }
+
+   // Returns true if id refers to a live entity of the generation it was issued with
+   inline cbool IsEntityValid(cID64 id) const {
+      if(id.group >= MAX_ENTITY_GROUPS || !entGroup[id.group].entity) return false;
+
+      cENTITY_GROUP &curGroup = entGroup[id.group];
+
+      return id.index < (ui32)curGroup.totalEntities && curGroup.livePos[id.index] != 0x0FFFFFFFF && curGroup.entityGen[id.index] == id.gen;
+   }
+
+   // Releases an entity's slot, bone range and sprite indices, and retires its generation. Returns the group's remaining live
+   // entity count, or 0x080000001 if id is stale. The entity must already be removed from any MAP_DESC association list.
+   cui32 DestroyEntity(cID64 id) {
+      if(!IsEntityValid(id)) return 0x080000001;
+
+      ENTITY_GROUP &curGroup = entGroup[id.group];
+      cENTITY      &curEnt   = curGroup.entity[id.index];
 
-      if(index >= MAX_ENTITIES) return { 0x080000001, 0x0 };
+      cui32 boneIndex = curEnt.boneIndex;
+      cui32 boneCount = curEnt.numParts + 1u;
+      cui8  layer     = (curEnt.sprite == &curGroup.spriteT[boneIndex] ? 1 : 0);
 
+      for(ui32 i = boneIndex; i < boneIndex + boneCount; i++) {
+         curGroup.spriteFree[layer][curGroup.freeSprites[layer]++] = curGroup.bone_dgs[i].sai;
+         curGroup.bone_dgs[i].size = { 0.0f, 0.0f, 0.0f }; // Not drawn, should a stale index reach the GPU
+      }
+      ReleaseBoneRange(curGroup, boneIndex, boneCount);
+
+      ATOMIC_BITSET(curGroup.entityVis, ui32(curGroup.totalEntities)).Reset(id.index);
+      ATOMIC_BITSET(curGroup.entityMod, ui32(curGroup.totalEntities)).Reset(id.index);
+
+      ReleaseEntitySlot(curGroup, id.index);
+
+      return curGroup.liveEntities;
+   }
+
+   // Optional compaction pass: rebuilds the live list in ascending slot order (swap-and-pop leaves it scrambled), drops
+   // released slots from the top of the array, and refills the free stack lowest-slot-first. Released bone ranges and
+   // sprite indices are rebuilt from the live entities the same way (CompactBones, CompactSprites), so no release mark
+   // or free-list count outlives the pass. ID64s remain valid. O(totalEntities + totalBones)
+   void CompactEntities(csi16 entityGroup) {
+      ENTITY_GROUP &curGroup = entGroup[entityGroup];
+      csi32         oldTotal = curGroup.totalEntities;
+
+      while(curGroup.totalEntities && curGroup.livePos[curGroup.totalEntities - 1] == 0x0FFFFFFFF) curGroup.totalEntities--;
+      // Trimmed slots read as never issued; their generations stay, so stale ID64s remain invalid once a slot is reissued
+      for(si32 i = curGroup.totalEntities; i < oldTotal; i++) curGroup.livePos[i] = 0;
+
+      curGroup.liveEntities = 0;
+      curGroup.freeEntities = 0;
+      for(si32 i = curGroup.totalEntities - 1; i >= 0; i--)
+         if(curGroup.livePos[i] == 0x0FFFFFFFF) curGroup.entityFree[curGroup.freeEntities++] = i;
+      for(si32 i = 0; i < curGroup.totalEntities; i++)
+         if(curGroup.livePos[i] != 0x0FFFFFFFF) {
+            curGroup.livePos[i] = curGroup.liveEntities;
+            curGroup.entityLive[curGroup.liveEntities++] = i;
+         }
+
+      CompactBones(curGroup);
+      CompactSprites(curGroup);
+   }
+
+   cID64 CreateEntity(cui32 group, ID32 object, cbool transparent) {
       const OBJECT_GROUP &srcGroup = objGroup[object.group];
             ENTITY_GROUP &curGroup = entGroup[group];
 
       csi32 partCount = (srcGroup.object[object.index].bits >> 28) + 1;
 
-      csi32 boneIndex = curGroup.totalBones;
-      csi32 lastIndex = (curGroup.totalBones += partCount);
+      cui32 index = AcquireEntitySlot(curGroup);
+
+      if(index == 0x080000001) return { 0x080000001, 0x0 };
+
+      cui32 boneIndex = AcquireBoneRange(curGroup, partCount);
+
+      if(boneIndex == 0x080000001) { ReleaseEntitySlot(curGroup, index);   return { 0x080000001, 0x0 }; }
+
+      csi32 lastIndex = boneIndex + partCount;
 
       curGroup.entity[index].part[0]     = &curGroup.entity[index];
       curGroup.entity[index].bone        = &curGroup.bone[boneIndex];
       curGroup.entity[index].geometry    = &curGroup.bone_dgs[boneIndex];
-      curGroup.entity[index].numParts    = partCount;
+      curGroup.entity[index].numParts    = partCount - 1;
       curGroup.entity[index].objectIndex = object.index;
       curGroup.entity[index].boneIndex   = boneIndex;
       curGroup.bone_dgs[boneIndex].oai   = object.index;
       curGroup.bone_dgs[boneIndex].opi   = srcGroup.object[object.index].ppi;
       if(transparent) {
          curGroup.entity[index].sprite = &curGroup.spriteT[boneIndex];
-         curGroup.bone_dgs[boneIndex].sai = curGroup.totalSpritesT++;
+         curGroup.bone_dgs[boneIndex].sai = AcquireSprite(curGroup, 1);
 
          for(si32 i = boneIndex + 1, j = 1; i < lastIndex; i++, j++) {
 /*            csi32 entityIndex = index + j;
@@ -179,13 +491,13 @@ al16 struct CLASS_ENTMAN {
          entity[group][entityIndex].bone     = &bone[group][i];
          entity[group][entityIndex].geometry = &bone_dgs[group][i];
          entity[group][entityIndex].sprite   = &spriteO[group][i];*/
-            curGroup.bone_dgs[i].sai = curGroup.totalSpritesT++;
+            curGroup.bone_dgs[i].sai = AcquireSprite(curGroup, 1);
             curGroup.bone_dgs[i].oai = object.index;
             curGroup.bone_dgs[i].opi = boneIndex;
          }
       } else {
          curGroup.entity[index].sprite = &curGroup.spriteO[boneIndex];
-         curGroup.bone_dgs[boneIndex].sai = curGroup.totalSpritesO++;
+         curGroup.bone_dgs[boneIndex].sai = AcquireSprite(curGroup, 0);
 
          for(si32 i = boneIndex + 1, j = 1; i < lastIndex; i++, j++) {
 /*            csi32 entityIndex = index + j;
@@ -196,27 +508,30 @@ al16 struct CLASS_ENTMAN {
          entity[group][entityIndex].bone     = &bone[group][i];
          entity[group][entityIndex].geometry = &bone_dgs[group][i];
          entity[group][entityIndex].sprite   = &spriteO[group][i];*/
-            curGroup.bone_dgs[i].sai = curGroup.totalSpritesO++;
+            curGroup.bone_dgs[i].sai = AcquireSprite(curGroup, 0);
             curGroup.bone_dgs[i].oai = object.index;
             curGroup.bone_dgs[i].opi = boneIndex;
          }
       }
 
-      return { index, group };
+      return { index, ui16(group), curGroup.entityGen[index] };
    }
 
    cID64 CreateEntity(MAP_DESC &md, cui32 entityGroup, ID32 objectID, cSSE4Df32 position, cSSE4Df32 orientation, cSSE4Df32 size) {
-      cui32 index = entGroup[entityGroup].totalEntities++;
-
-      if(index >= MAX_ENTITIES) return { 0x080000001, 0x0 };
-
       const OBJECT_GROUP &srcGroup = objGroup[objectID.group];
             ENTITY_GROUP &curGroup = entGroup[entityGroup];
 
       csi8 partCount = srcGroup.object[objectID.index].qc;
 
-      csi32 boneIndex = curGroup.totalBones;
-      csi32 lastIndex = (curGroup.totalBones += partCount + 1);
+      cui32 index = AcquireEntitySlot(curGroup);
+
+      if(index == 0x080000001) return { 0x080000001, 0x0 };
+
+      cui32 boneIndex = AcquireBoneRange(curGroup, partCount + 1);
+
+      if(boneIndex == 0x080000001) { ReleaseEntitySlot(curGroup, index);   return { 0x080000001, 0x0 }; }
+
+      csi32 lastIndex = boneIndex + partCount + 1;
 
       curGroup.totalBone_DGS = curGroup.totalBones;
 
@@ -241,9 +556,9 @@ al16 struct CLASS_ENTMAN {
       curGroup.bone[boneIndex].cbd     = { 0.875f, 0.875f, 0.875f };
       curGroup.bone[boneIndex].cbt     = 3;
 //      curGroup.bone_dgs[boneIndex].pos  = position;
-      SetPos(md, ID64{ index, entityGroup }, position.xmm);
+      SetPos(md, ID64{ index, ui16(entityGroup), curGroup.entityGen[index] }, position.xmm);
       curGroup.bone_dgs[boneIndex].rot  = (VEC3Df &)orientation;
-      curGroup.bone_dgs[boneIndex].sai  = curGroup.totalSpritesO++;
+      curGroup.bone_dgs[boneIndex].sai  = AcquireSprite(curGroup, 0);
       curGroup.bone_dgs[boneIndex].size = (VEC3Df &)size;
       curGroup.bone_dgs[boneIndex].opi  = srcGroup.object[objectID.index].ppi;
       curGroup.bone_dgs[boneIndex].aft  = 1.0f;
@@ -274,7 +589,7 @@ al16 struct CLASS_ENTMAN {
 */
          curGroup.bone[i] = { null3Df, 1.0f, 1.0f, 100.0f, 293.0f, 273.0f, 373.0f, 1.0f, { 0.875f, 0.875f, 0.875f }, 3 };
          curGroup.bone_dgs[i].size = { 1.0f, 1.0f, 1.0f };
-         curGroup.bone_dgs[i].sai  = curGroup.totalSpritesO++;
+         curGroup.bone_dgs[i].sai  = AcquireSprite(curGroup, 0);
          curGroup.bone_dgs[i].opi  = srcGroup.object[objectID.index].ppi + i - boneIndex;
          curGroup.bone_dgs[i].aft  = 1.0f;
          curGroup.bone_dgs[i].afc  = 0;
@@ -285,16 +600,18 @@ al16 struct CLASS_ENTMAN {
          curGroup.spriteO[i] = { 1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
       }
 
-      return { index, entityGroup };
+      return { index, ui16(entityGroup), curGroup.entityGen[index] };
    }
 
+   // Issues a bone outside any entity. It stays live for the group's lifetime; boneSolo keeps compaction from reissuing it
    cui32 CreateBone(cui32 entityGroup, cVEC3Df position, cVEC3Df orientation, cVEC3Df size, cbool transparent) {
-      cui32 boneIndex = entGroup[entityGroup].totalBones++;
+      ENTITY_GROUP &curGroup = entGroup[entityGroup];
 
-      if(boneIndex >= MAX_BONES) return 0x080000001;
+      cui32 boneIndex = AcquireBoneRange(curGroup, 1);
 
-      cENTITY_GROUP &curGroup = entGroup[entityGroup];
+      if(boneIndex == 0x080000001) return 0x080000001;
 
+      curGroup.boneSolo[boneIndex]     = transparent ? 2u : 1u;
       curGroup.bone[boneIndex].mass    = 1.0f;
       curGroup.bone[boneIndex].tension = 1.0f;
       curGroup.bone[boneIndex].strInt  = 100.0f;
@@ -311,10 +628,10 @@ al16 struct CLASS_ENTMAN {
       curGroup.bone_dgs[boneIndex].afc  = 0;
       curGroup.bone_dgs[boneIndex].afo  = 0;
       if(transparent) {
-         curGroup.bone_dgs[boneIndex].sai = entGroup[entityGroup].totalSpritesT++;
+         curGroup.bone_dgs[boneIndex].sai = AcquireSprite(curGroup, 1);
          curGroup.spriteT[boneIndex] = { 1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
       } else {
-         curGroup.bone_dgs[boneIndex].sai = entGroup[entityGroup].totalSpritesO++;
+         curGroup.bone_dgs[boneIndex].sai = AcquireSprite(curGroup, 0);
          curGroup.spriteO[boneIndex] = { 1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
       }
 
@@ -425,8 +742,7 @@ al16 struct CLASS_ENTMAN {
 
    // Fill association list with the ID of every entity the line between endPoints touches. Returns ID of closest entity; 0x080000001 if list is empty
    cID64 PopulateEntityList(MAP_DESC &md, cVEC2Ds32 curPos, cVEC2Du8 camProj) const {
-      ///--- Be smarter... ---///
-      static fl32ptrc dist = (fl32ptr)malloc16(1024 * sizeof(fl32));
+      FRAME_SCOPE frameScope(frameArena); // dist[] is released on return
 
       CLASS_CAM &cam = *(CLASS_CAM *)ptrLib[5];
       ID64ptrc   ei  = md.wlrv.entityIndex;
@@ -452,6 +768,11 @@ al16 struct CLASS_ENTMAN {
       // List is empty
       if(!md.wlrv.entityCount) return { 0x080000001 };
 
+      fl32ptrc dist = falloc1d16(fl32, md.wlrv.entityCount);
+
+      // Frame arena exhausted
+      if(!dist) return { 0x080000002 };
+
       // Calculate distances from camera
       dist[0] = cam.DistanceFromCamera(entGroup[ei[0].group].entity[ei[0].index].geometry->pos_lerp.xmm, 0);
       for(index = 1; index < md.wlrv.entityCount; index++) {
@@ -476,16 +797,20 @@ al16 struct CLASS_ENTMAN {
       return ei[0];
    }
 
-   si32 Cull(ui32ptrptrc arrayVisible, ui32ptrc arrayUnchanged, csi32 entityGroup, csi8 threadCount) {
+   // Starts a culling pass into results' back set; as CLASS_MAPMAN::Cull()
+   si32 Cull(VIS_RESULTS *const results, csi32 entityGroup, csi8 threadCount) {
       static ui8 uiTHREADS = 0;
 
 //      if(!arrayVisible) { MAN_THREAD_STATUS.m128i_u8[0] &= 0x0F3; return 0; }
-      if(!arrayVisible) { ENTMAN_THREAD_STATUS.m128i_u8[0] &= 0x0F3; return 0; }
+      if(!results) { ENTMAN_THREAD_STATUS.m128i_u8[0] &= 0x0F3; return 0; }
 
       cui8 threadBits = ENTMAN_THREAD_STATUS.m128i_u8[0];
 
-      if(!(threadBits & 0x01)) threadData[0] = { &entGroup[entityGroup], arrayVisible };
-      if(!(threadBits & 0x02)) threadData[1] = { &entGroup[entityGroup], arrayUnchanged };
+      lockStep = threadCount == cm_splitThreads || threadCount < 0;
+      if(!lockStep && (threadBits & 0x03)) return 0;
+
+      if(!(threadBits & 0x01)) threadData[0] = { &entGroup[entityGroup], results->Back().list, results };
+      if(!(threadBits & 0x02)) threadData[1] = { &entGroup[entityGroup], results->Back().mod,  results };
 
       ///- Stall/skip? if status if 'busy'
       while(ENTMAN_THREAD_STATUS.m128i_u8[0] & 0x03) _mm_pause(); //Sleep(1);
@@ -493,10 +818,10 @@ al16 struct CLASS_ENTMAN {
       //ENTMAN_THREAD_STATUS.m128i_u8[0] &= 0x0FC;
 
       switch(threadCount) {
-//      case 0;
+//      case cm_inline:
 //         Cull_Nonvisible_and_Unchanged(&threadData[0]);
 //         return 3;
-      case 1:
+      case cm_thread:
          ENTMAN_THREAD_STATUS.m128i_u8[0] |= 0x03;
          if(!(uiTHREADS & 0x03)) {
             HANDLE thread0 = (HANDLE)_beginthread(_ET_Cull_Nonvisible_and_Unchanged, 0, &threadData[0]);
@@ -505,7 +830,7 @@ al16 struct CLASS_ENTMAN {
             uiTHREADS |= 0x03;
          }
          return 3;
-      case 2:
+      case cm_splitThreads:
          ENTMAN_THREAD_STATUS.m128i_u8[0] |= 0x03;
          if(!(uiTHREADS & 0x03)) {
             //HANDLE thread0 = (HANDLE)_beginthread(_ET_Cull_Nonvisible_Simple, 0, &threadData[0]);
@@ -518,7 +843,7 @@ al16 struct CLASS_ENTMAN {
             uiTHREADS |= 0x03;
          }
          return 3;
-      case -1:
+      case cm_splitVisible:
          ENTMAN_THREAD_STATUS.m128i_u8[0] |= 0x01;
          if(!(uiTHREADS & 0x01)) {
             //HANDLE thread0 = (HANDLE)_beginthread(_ET_Cull_Nonvisible_Simple, 0, &threadData[0]);
@@ -527,7 +852,7 @@ al16 struct CLASS_ENTMAN {
             uiTHREADS |= 0x01;
          }
          return 1;
-      case -2:
+      case cm_splitModified:
          ENTMAN_THREAD_STATUS.m128i_u8[0] |= 0x02;
          if(!(uiTHREADS & 0x02)) {
             HANDLE thread1 = (HANDLE)_beginthread(_ET_Cull_Unchanged, 0, &threadData[1]);
@@ -535,6 +860,11 @@ al16 struct CLASS_ENTMAN {
             uiTHREADS |= 0x02;
          }
          return 2;
+      case cm_job:
+         ENTMAN_THREAD_STATUS.m128i_u8[0] |= 0x03;
+         // A persistent cull thread, if one was started, takes the pass itself
+         if(!(uiTHREADS & 0x03)) jobSystem.Submit(_ET_Cull_Pass, &threadData[0]);
+         return 3;
       }
 
       ENTMAN_THREAD_STATUS.m128i_u8[0] &= 0x0F3;
@@ -542,9 +872,11 @@ al16 struct CLASS_ENTMAN {
       return 0;
    }
 
-   inline void WaitForCulling(ui128 &results, cDWORD sleepDelay) const {
-      if(sleepDelay) while(ENTMAN_THREAD_STATUS.m128i_u8[0] & 0x03) Sleep(sleepDelay);
-      else while(ENTMAN_THREAD_STATUS.m128i_u8[0] & 0x03) _mm_pause();
+   // Lock-step modes only; as CLASS_MAPMAN::WaitForCulling()
+   inline void WaitForCulling(ui128 &results, cDWORD sleepDelay) {
+      // Help the job system (possibly running the cull pass itself) rather than idle
+      while(ENTMAN_THREAD_STATUS.m128i_u8[0] & 0x03)
+         if(!jobSystem.TryRunOne()) { if(sleepDelay) Sleep(sleepDelay); else _mm_pause(); }
 
       cVEC2Du64 entManThreadData = (cVEC2Du64 &)ENTMAN_THREAD_STATUS;
 
@@ -553,101 +885,129 @@ al16 struct CLASS_ENTMAN {
 
       results = { .m128i_u32 = { ui32(entManThreadData.x >> 4) & 0x03FFFFFFF, ui32(entManThreadData.x >> 34) & 0x03FFFFFFF,
                                  ui32(entManThreadData.y) & 0x03FFFFFFF, ui32(entManThreadData.y >> 30) & 0x03FFFFFFF } };
+
+      if(!lockStep || !threadData[0].results) return;
+
+      VIS_SET &set = threadData[0].results->Back();
+      for(ui8 i = 0; i < 3; i++) set.count[i] = results.m128i_u32[i];
+      set.modCount = results.m128i_u32[3];
+      threadData[0].results->Publish();
    }
 };
 
 static void _ET_Cull_Nonvisible_Accurate(ptr) {}
 static void _ET_Cull_Unchanged(ptr) {}
 
-static void _ET_Cull_Nonvisible_and_Unchanged(ptr threadData) {
+// One culling pass; run by the persistent cull thread, or as a job (Cull() cm_job)
+static void _ET_Cull_Pass(ptr threadData, cui64, cui64) {
    static si64 frequencyTics, startTics, endTics;
    QueryPerformanceFrequency((LARGE_INTEGER *)&frequencyTics);
 
    CLASS_CAM    &camMan = *(CLASS_CAM *)ptrLib[5];
    CLASS_ENTMAN &entMan = *(CLASS_ENTMAN *)ptrLib[7];
 
-   cEMTDptrc     data[2] = { (cEMTDptrc)threadData, (cEMTDptrc)threadData + 1 };
-   ENTITY_GROUP &group   = *(*data[0]).group;
-
-   cui32 entityCount = group.totalEntities;
+   cEMTDptrc     data    = (cEMTDptrc)threadData;
+   ENTITY_GROUP &group   = *data->group;
+   VIS_RESULTS  &results = *data->results;
+   VIS_SET      &set     = results.Back();
 
-   ui32ptrc nearBones = (*data[0]).entityVis[0];
-   ui32ptrc medBones  = (*data[0]).entityVis[1];
-   ui32ptrc farBones  = (*data[0]).entityVis[2];
-   ui32ptrc modBones  = (*data[1]).entityMod;
+   ui32ptrc nearBones = set.list[0];
+   ui32ptrc medBones  = set.list[1];
+   ui32ptrc farBones  = set.list[2];
+   ui32ptrc modBones  = set.mod;
 
    SSE4Df32 sphereData[8];
 
    ui64 modCount, nearCount, medCount, farCount;
    ui32 i, j, k, l;
 
-   ENTMAN_THREAD_STATUS.m128i_u8[0] |= 0x0C;
-
-   do {
-      ///- Stall/skip? if status if 'busy'
-      while(!(ENTMAN_THREAD_STATUS.m128i_u8[0] & 0x03)) _mm_pause(); //Sleep(1);
+   QueryPerformanceCounter((LARGE_INTEGER *)&startTics);
 
-      QueryPerformanceCounter((LARGE_INTEGER *)&startTics);
+   CAMERA_SNAPSHOT camera;
+   camMan.ReadSnapshot(camera, 0);
 
-      nearCount = medCount = farCount = 0;
-      modCount = 0;
+   nearCount = medCount = farCount = 0;
 
-      // Test for modified entities
-      for(i = 0; i < entityCount; i++) {
-         cui64 bitOS   = (ui64)0x01 << (i & 0x03F);
-         cui32 qwordOS = i >> 6;
+   // Walk the dense live list; released slots are never visited
+   cui32     entityCount = group.liveEntities;
+   cui32ptrc entityLive = group.entityLive;
 
-         if(group.entityMod[qwordOS] & bitOS) {
-            for(j = 0; j <= group.entity[i].numParts; j++)
-               modBones[modCount++] = group.entity[i].boneIndex + j;
-            group.entityMod[qwordOS] ^= bitOS;
-         }
-      }
-      for(; i & 0x01F; i++)
-         modBones[modCount++] = 0x0FFFFFFFF;
+   ATOMIC_BITSET entityMod(group.entityMod, ui32(group.totalEntities));   // Released slots' bits are reset on release
 
-      // Calculate each entity's distance-to-camera and reject out-of-view entities
-      // Sort nearest-to-furthest into L.O.D. lists for input assembler
-      for(i = 0; i < entityCount; i += j) {
-         for(j = 0; j < 8; j++) {
-            csi32 entityIndex = i + j;
+   // A set the renderer skipped keeps its modified bones; append to them, less their padding. Should they fill half the list,
+   // mark every live entity modified instead
+   for(modCount = set.modCount; modCount && modBones[modCount - 1] == 0x0FFFFFFFF; modCount--);
+   if(modCount > results.modCapacity >> 1) {
+      for(i = 0; i < entityCount; i++) entityMod.Set(entityLive[i]);
+      modCount = 0;
+   }
 
-            ((VEC3Df &)sphereData[j]) = group.entity[entityIndex].geometry->pos;
+   // Take the modified entities a word at a time, clearing each word as it is read; then pad to whole 32-bone vertices
+   entityMod.DrainEach(0, entityMod.Words(), [&](cui64 entityIndex) {
+      for(ui32 part = 0; part <= group.entity[entityIndex].numParts; part++)
+         modBones[modCount++] = group.entity[entityIndex].boneIndex + part;
+   });
+   for(; modCount & 0x01F; modCount++)
+      modBones[modCount] = 0x0FFFFFFFF;
+
+   // Calculate each entity's distance-to-camera and reject out-of-view entities
+   // Sort nearest-to-furthest into L.O.D. lists for input assembler
+   for(i = 0; i < entityCount; i += j) {
+      for(j = 0; j < 8 && i + j < entityCount; j++) {
+         csi32 entityIndex = entityLive[i + j];
+
+         ((VEC3Df &)sphereData[j]) = group.entity[entityIndex].geometry->pos;
 ///--- Switch according to bounding type
-            sphereData[j].vector.w = group.entity[entityIndex].vbd.x;
-         }
+         sphereData[j].vector.w = group.entity[entityIndex].vbd.x;
+      }
 
-         cui8 visible = camMan.SphereFrustumIntersect8(sphereData, 0);
+      cui8 visible = camMan.SphereFrustumIntersect8(sphereData, camera.data);
 
-         for(k = 0; k < j; k++)
-            if(visible & (0x01 << k)) {
-               csi32 entityIndex = i + k;
+      for(k = 0; k < j; k++)
+         if(visible & (0x01 << k)) {
+            csi32 entityIndex = entityLive[i + k];
 //               cui32 QWordOS = index >> 6;
 //               cui64 bitOS   = (ui64)0x01 << (index & 0x03F);
-               cENTITY &curEntity = group.entity[entityIndex];
+            cENTITY &curEntity = group.entity[entityIndex];
 
-               cfl32 distance = camMan.DistanceFromCamera(sphereData[k].xmm, 0);
-               // Change hard limits to LOD scalars
-               if(curEntity.geometry->size.x > 0.0f) {
+            cfl32 distance = camMan.DistanceFromCamera(sphereData[k].xmm, camera.data);
+            // Change hard limits to LOD scalars
+            if(curEntity.geometry->size.x > 0.0f) {
 //                  if(distance < 128.0f)
-                  for(l = 0; l <= curEntity.numParts; l++)
-                     nearBones[nearCount++] = curEntity.boneIndex + l;
+               for(l = 0; l <= curEntity.numParts; l++)
+                  nearBones[nearCount++] = curEntity.boneIndex + l;
 //                  else if(distance < 512.0f)
 //                     medBones[medCount++] = index;
 //                  else if(distance < 2048.0f)
 //                     farBones[farCount++] = index;
-               }
             }
-      }
+         }
+   }
+
+   set.count[0]  = (ui32)nearCount;
+   set.count[1]  = (ui32)medCount;
+   set.count[2]  = (ui32)farCount;
+   set.modCount  = (ui32)modCount;
+   set.cameraSeq = camera.seq;
+   results.Publish();
+
+   ENTMAN_THREAD_STATUS.m128i_u8[0] &= 0x0FC;
+
+   QueryPerformanceCounter((LARGE_INTEGER *)&endTics);
+   sysData.culling.entity.time   = double(endTics - startTics) / double(frequencyTics) * 1000.0;
+   sysData.culling.entity.mod    = (ui32)modCount;
+   sysData.culling.entity.vis[0] = (ui32)nearCount;
+   sysData.culling.entity.vis[1] = (ui32)medCount;
+   sysData.culling.entity.vis[2] = (ui32)farCount;
+}
 
-      ENTMAN_THREAD_STATUS.m128i_u64[0] = (medCount << 34) | (nearCount << 4) | 0x0C;
-      ENTMAN_THREAD_STATUS.m128i_u64[1] = (modCount << 30) | farCount;
+static void _ET_Cull_Nonvisible_and_Unchanged(ptr threadData) {
+   ENTMAN_THREAD_STATUS.m128i_u8[0] |= 0x0C;
+
+   do {
+      ///- Stall/skip? if status if 'busy'
+      while(!(ENTMAN_THREAD_STATUS.m128i_u8[0] & 0x03)) _mm_pause(); //Sleep(1);
 
-         QueryPerformanceCounter((LARGE_INTEGER *)&endTics);
-         sysData.culling.entity.time   = double(endTics - startTics) / double(frequencyTics) * 1000.0;
-         sysData.culling.entity.mod    = (ui32)modCount;
-         sysData.culling.entity.vis[0] = (ui32)nearCount;
-         sysData.culling.entity.vis[1] = (ui32)medCount;
-         sysData.culling.entity.vis[2] = (ui32)farCount;
+      _ET_Cull_Pass(threadData, 0, 0);
    } while(ENTMAN_THREAD_STATUS.m128i_u64[0] & 0x0C);
 }
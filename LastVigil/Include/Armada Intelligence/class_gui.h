@@ -1,6 +1,6 @@
 /*******************************************************************************  
  * File: class_gui.h                                       Created: 2023/01/26 *
- *                                                   Last modified: 2026/08/13 *
+ *                                                   Last modified: 2026/10/17 *
  *                                                                             *
  * Desc:                                                                       *
  *                                                                             *
@@ -132,8 +132,12 @@ public:
       for(i = MAX_ATLAS - 1; i >= 0; --i)
          if(uiAtlasTexIndex[i])
             gpu.tex.Unload2D(uiAtlasTexIndex[i]);
-      for(i = siInterfaces - 1; i >= 0; --i)
-         mfree(interfaceProfile[i].vertex, interfaceProfile[i].inputs, interfaceProfile[i].inputLabel, interfaceProfile[i]._mod);
+      for(i = siInterfaces - 1; i >= 0; --i) {
+         cui64 committed = interfaceProfile[i].maxVertices;
+         vrelease(interfaceProfile[i].vertex, committed * sizeof(ui32), GUI_INTERFACE_RESERVE * sizeof(ui32));
+         vrelease(interfaceProfile[i]._mod.p, (committed + 7u) >> 3u, GUI_INTERFACE_RESERVE >> 3u);
+         mfree(interfaceProfile[i].inputs, interfaceProfile[i].inputLabel);
+      }
       mfree(element, element_dgs, textBuffer, interfaceProfile, stAtlas, stLanguage, alphabet, alphabet_pIMM, spriteLib);
       uiLanguages = uiAtlas = 0;
       siInterfaces = -1;
@@ -191,6 +195,7 @@ public:
    }
 
    cui32 CreateSpriteLibrary(si32 libraryIndex, csi16 maxSprites, csi16 atlasIndex) {
+      MEM_TAG_SCOPE memTagScope(ss_gui);
       // Find first available slot if index is -1
       if(libraryIndex == -1) {
          ui8 i = 0;
@@ -228,6 +233,7 @@ public:
 
    // Returns index of library, or 0x080000001 if all sprite library slots occupied
    csi16 LoadSpriteLibrary(cwchptrc filename, si16 libIndex) {
+      MEM_TAG_SCOPE memTagScope(ss_gui);
       chptr textArrayOS = 0;
       ui32  stringCount = 0;
       ui16  index       = 0;
@@ -719,6 +725,7 @@ public:
    }
 
    cui32 CreateTextList(cGUI_EL_DESC &desc) {
+      MEM_TAG_SCOPE memTagScope(ss_gui);
       if(siGUIElements >= MAX_GUI_ELEMENTS) return 0x080000001;
 
       csi32 textBufferStart = siTextBankOS;
@@ -1282,6 +1289,7 @@ public:
 
    // Returns index of interface, or 0x08001 if all interface slots occupied
    cui16 LoadInterface(cwchptrc filename, si16 interfaceIndex) {
+      MEM_TAG_SCOPE memTagScope(ss_gui);
       union {
          chptrc st = (chptr)salloc(RoundUpToNearest16(512u), 16u, null128);
          //declare1d16z(char, stTemp, 512u);
@@ -1428,6 +1436,7 @@ public:
 
    // Returns true if successful
    cbool SaveInterface(cwchptrc filename, csi16 interfaceIndex) {
+      MEM_TAG_SCOPE memTagScope(ss_gui);
       GUI_INTERFACE &curProfile = interfaceProfile[interfaceIndex];
 
       ui32 i, j, k, l;
@@ -1678,6 +1687,7 @@ public:
 
    // Add one element to an interface. Returns remaining vertex capacity for that interface.
    inline ui32 AddElementToInterface(cui32 elementIndex, csi16 interfaceIndex) {
+      MEM_TAG_SCOPE memTagScope(ss_gui);
       // 0) Contracts
       if (interfaceIndex < 0 || interfaceIndex >= siInterfaces) return 0u;
       if (elementIndex >= (ui32)siGUIElements)                  return 0u;
@@ -1693,7 +1703,7 @@ public:
       if (curVertexCount[(ui32)interfaceIndex] + need > MAX_INTERFACE_VERTS)
          return 0u; // not enough per-interface vertex space to safely add
 
-      // 2) Grow interface element capacity if required (cap at MAX_INTERFACE_VERTS)
+      // 2) Grow interface element capacity if required (cap at MAX_INTERFACE_VERTS); arrays grow in place, so no copy
       if (iface.vertCount >= iface.maxVertices)
       {
          ui32 oldMax = (ui32)iface.maxVertices;
@@ -1701,21 +1711,9 @@ public:
          if (target > MAX_INTERFACE_VERTS) target = MAX_INTERFACE_VERTS;
          if (target <= oldMax) return 0u; // cannot grow further
 
-         // grow vertex index array
-         ui32ptr vNew = zalloc1d32(ui32, (ui16)target);
-         if (!vNew) return 0u;
-         if (oldMax) memcpy(vNew, iface.vertex, oldMax * sizeof(ui32));
-         _aligned_free(iface.vertex);
-         iface.vertex = vNew;
-
-         // grow activity bitset (1 bit per element)
-         ui16   oldBytes = (ui16)((oldMax + 7u) >> 3);
-         ui16   newBytes = (ui16)((target + 7u) >> 3);
-         ui8ptr mNew     = zalloc1d16(ui8, newBytes);
-         if (!mNew) return 0u;
-         if (oldBytes) memcpy(mNew, iface._mod.p, oldBytes);
-         _aligned_free(iface._mod.p);
-         iface._mod = mNew;
+         // grow vertex index array & activity bitset (1 bit per element)
+         if (!vcommit(iface.vertex, oldMax * sizeof(ui32), target * sizeof(ui32))) return 0u;
+         if (!vcommit(iface._mod.p, (oldMax + 7u) >> 3, (target + 7u) >> 3))      return 0u;
 
          iface.maxVertices = (ui16)target;
       }
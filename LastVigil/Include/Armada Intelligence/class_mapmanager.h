@@ -1,6 +1,6 @@
 /*
  * File: class_mapmanager.h             Created: 2022/11/29
- *                                Last modified: 2025/09/25
+ *                                Last modified: 2026/10/17
  *
  * Desc:
  *
@@ -13,6 +13,7 @@
 #include "master header.h"
 #include "Data structures.h"
 #include "Map structures.h"
+#include "Visibility results.h"
 #include "File operations.h"
 #include "Common functions.h"
 
@@ -21,6 +22,36 @@ extern vui128 MAPMAN_THREAD_STATUS;
 static void _MM_Cull_Nonvisible_RasteriseLayer(cVEC4Ds32[2]);
 static void _MM_Cull_Nonvisible_Rasterise(cVEC4Ds32[4]);
 static void _MM_Cull_Nonvisible_and_Unchanged(ptr);
+static void _MM_Cull_Pass(ptr, cui64, cui64);
+static void _MM_Cull_Slab(ptr, cui64, cui64);
+static void _MM_Publish(cMAPptrc, VIS_RESULTS &);
+static void _MM_ReadChunk(MAP &, const ui8 *, cui64);
+static void _MM_WriteChunk(const MAP &, ui8ptrc, cui64);
+static void _MM_ReadChunks(ptr, cui64, cui64);
+static void _MM_WriteChunks(ptr, cui64, cui64);
+template <typename FN> static void _MM_FillCells(MAP &, cui64, cui64, FN);
+template <typename FN> static void _MM_ForEachRun(const ui8 *, cui32, cui32, FN);
+template <typename FN> static cui32 _MM_EncodeCells(FN, cui32, ui8ptrc, cui32, ui32 &);
+static void _MM_DecodeChunk(MAP &, const ui8 *, cui32, cui64);
+static void _MM_StoreChunk(const MAP &, cui64, ui8ptrc, MAP_FILE_CHUNK &);
+static cbool _MM_CommitChunk(MAP &, cui64);
+static void _MM_DecommitChunk(MAP &, cui64);
+static cbool _MM_SparseOwned(const MAP_SPARSE &, const ui8 *);
+static cbool _MM_SparseStore(MAP &, cui64, const ui8 *, cui32, cui32);
+static cbool _MM_SparsePlace(MAP &, cui64, const ui8 *, cui32, cui32, ui8ptrc);
+static void _MM_LayerValues(MAP_CELL_VALUE &, MAP_CELL_VALUE &, MAP_CELL_VALUE &, cui8, cui8, cui8);
+static cui8 _MM_SurfaceElement(cui64);
+static void _MM_WriteCells(MAP &, cui64, cui64, const MAP_CELL_VALUE &);
+static void _MM_FillValue(MAP &, cui64, cui64, const MAP_CELL_VALUE &);
+static void _MM_FillChunks(ptr, cui64, cui64);
+static cui32 _MM_StreamVictim(const MAP &);
+static void _MM_StreamClaim(MAP &, cui32);
+static void _MM_StreamRetire(MAP &, cui32);
+static void _MM_StreamFree(MAP &, cui32);
+static cbool _MM_StreamLoad(MAP &, cui32);
+static void _MM_StreamEvict(MAP &, cui32);
+static void _MM_StreamLoadJob(ptr, cui64, cui64);
+static void _MM_StreamEvictJob(ptr, cui64, cui64);
 static void _MM_Cull_Nonvisible_Simple(ptr);
 static void _MM_Cull_Nonvisible_Accurate(ptr);
 static void _MM_Cull_Unchanged(ptr);
@@ -49,6 +80,10 @@ al16 struct CLASS_MAPMAN {
    cwchar stMapsDir[10] = L"map_data\\";
 
    MAPMAN_THREAD_DATA threadData[2];
+   MAPMAN_CULL_SLABS  cullSlabs = {};    // Parallel pass (_MM_Cull_Pass) scratch; owned by the running pass
+   ui8                lockStep  = 0;     // Split cull threads (Cull() split CULL_MODEs) publish only through WaitForCulling()
+   bool               denseMaps = false; // Load maps with every chunk at full size, not sparse (MAP_SPARSE), so large pages and NUMA
+                                         // placement apply to them; read by each LoadMap
 
    CLASS_MAPMAN(CLASS_FILEOPS &fileOpsClass) : files(fileOpsClass) {
 #ifdef AE_PTR_LIB
@@ -122,6 +157,7 @@ al16 struct CLASS_MAPMAN {
    }
 
    cui32 LoadPeriodicTable(wchptrc filename, si32 index) {
+      MEM_TAG_SCOPE memTagScope(ss_map);
       si32 i = 0;
       // Find first available slot if index is -1
       if(index == -1) {
@@ -201,6 +237,7 @@ al16 struct CLASS_MAPMAN {
    void DestroyPeriodicTable(cui8 index) const { memset(&table[index], 0x0, sizeof(ELEM_TABLE)); }
 
    cui32 CreateWorld(csi32 worldIndex, csi32 periodicTableIndex, csi32 maxMaps) {
+      MEM_TAG_SCOPE memTagScope(ss_map);
       if(world[worldIndex].map) return 0x080000001;   // world already exists
 
       WORLD &curWorld = world[worldIndex];
@@ -231,6 +268,7 @@ al16 struct CLASS_MAPMAN {
 
    // Allocate RAM for a map's .wlrv arrays
    inline void CreateSelectionBuffers(csi32 mapIndex, csi32 worldIndex, csi16 averagePerCell) const {
+      MEM_TAG_SCOPE memTagScope(ss_map);
       MAP       &curMap    = *world[worldIndex].map[mapIndex];
       cSSE4Ds32  dimExp_   = { .xmm = _mm_cvtepi16_epi32((ui128 &)curMap.desc.mapDim) };
       cSSE4Df32  dimExp    = { .xmm = _mm_cvtepi32_ps(_mm_mullo_epi32(dimExp_.xmm, dimExp_.xmm)) };
@@ -245,125 +283,821 @@ al16 struct CLASS_MAPMAN {
    }
 
    // Allocate RAM for a map's .entityList array
-   inline void CreateAssociationBuffer(MAP_DESC &md) const { md.entityList = (ID64ptr)salloc((ui64)md.entListDim * (ui64)md.mapCells * sizeof(ID64), 32, max256); }
+   inline void CreateAssociationBuffer(MAP_DESC &md) const {
+      MEM_TAG_SCOPE memTagScope(ss_map);
+      md.entityList = (ID64ptr)salloc((ui64)md.entListDim * (ui64)md.mapCells * sizeof(ID64), 32, max256, MEM_SITE);
+   }
 
    inline void DestroyAssociationBuffer(csi32 mapIndex, csi32 worldIndex) const { mdealloc((*world[worldIndex].map[mapIndex]).desc.entityList); }
 
-   cui32 LoadMap(wchptrc filename, csi32 worldIndex, si32 mapIndex) {
-      si32 i = 0;
+   // Range of a map's chunks placed on a NUMA node by AllocCellArrays, and run by that node's workers (ParallelForChunks).
+   // Boundaries are multiples of MAP_NODE_GRAIN, so no job and no chunkVis or chunkMod qword spans two nodes
+   inline void ChunkRangeOfNode(cui32 totalChunks, cui8 node, ui32 &firstChunk, ui32 &chunkCount) const {
+      cui64 nodeCount = sysData.cpu.nodeCount;
+      cui32 endChunk  = node + 1u < nodeCount ? ui32(ui64(totalChunks) * (node + 1u) / nodeCount / MAP_NODE_GRAIN * MAP_NODE_GRAIN) : totalChunks;
+
+      firstChunk = ui32(ui64(totalChunks) * node / nodeCount / MAP_NODE_GRAIN * MAP_NODE_GRAIN);
+      chunkCount = endChunk - firstChunk;
+   }
+
+   // Runs fn over chunks [0, totalChunks) in 'grain'-chunk jobs, and returns once all have finished. On a multi-node host
+   // each node's range (ChunkRangeOfNode) is queued for the workers pinned to that node. 'grain' must divide MAP_NODE_GRAIN
+   inline void ParallelForChunks(cui32 totalChunks, cui32 grain, const JOB_FN fn, ptrc data) const {
+      JOB_COUNTER counter;
+
+      if(sysData.cpu.nodeCount > 1u) for(ui8 node = 0; node < sysData.cpu.nodeCount; ++node) {
+         ui32 firstChunk, chunkCount;
+         ChunkRangeOfNode(totalChunks, node, firstChunk, chunkCount);
+         jobSystem.ParallelFor(firstChunk, firstChunk + chunkCount, grain, fn, data, counter, node);
+      }
+      else jobSystem.ParallelFor(totalChunks, grain, fn, data, counter);
+
+      jobSystem.Wait(counter);
+   }
+
+   // Commits chunks [firstChunk, firstChunk + chunkCount) of a map's cell, geometry and pixel arrays on a NUMA node. Only
+   // effective on arrays reserved by AllocCellArrays' NUMA path, for ranges not yet committed
+   inline cbool PlaceChunkRange(MAP &curMap, cui32 firstChunk, cui32 chunkCount, cui8 node) const {
+      cui64 first = ui64(firstChunk) * curMap.desc.chunkCells, count = ui64(chunkCount) * curMap.desc.chunkCells;
+      cui64 store = MapCellStoreBytes(curMap.desc.chunkCells);
+
+      return CommitOnNode(CellStore(curMap), firstChunk * store, chunkCount * store, node) &&
+             CommitOnNode(curMap.pDGS, first * sizeof(CELL_DGS), count * sizeof(CELL_DGS), node) &&
+             CommitOnNode(curMap.pDPS, first * sizeof(CELL_DPS), count * sizeof(CELL_DPS), node);
+   }
+
+   // Allocates a map's cell, geometry and pixel arrays, and records their dimensions in .desc. On a multi-node host, each
+   // node's memory holds one contiguous range of chunks (ChunkRangeOfNode); otherwise, or if that fails, the arrays come
+   // from lalloc (large pages when EnableLargePages succeeded at start-up)
+   inline cbool AllocCellArrays(MAP &curMap, cui32 chunkCells, cui32 totalChunks) const {
+      cui64 totalCells = ui64(chunkCells) * totalChunks;
+
+      curMap.desc.chunkCells = chunkCells;
+      curMap.desc.mapCells   = ui32(totalCells);
+
+      if(sysData.cpu.nodeCount > 1u) {
+         curMap.pDGS = (CELL_DGS *)nreserve(sizeof(CELL_DGS) * totalCells, MEM_SITE);
+         curMap.pDPS = (CELL_DPS *)nreserve(sizeof(CELL_DPS) * totalCells, MEM_SITE);
+         SetCellStore(curMap, nreserve(MapCellStoreBytes(chunkCells) * totalChunks, MEM_SITE));
+
+         bool placed = CellStore(curMap) && curMap.pDGS && curMap.pDPS;
+         for(ui8 node = 0; placed && node < sysData.cpu.nodeCount; ++node) {
+            ui32 firstChunk, chunkCount;
+            ChunkRangeOfNode(totalChunks, node, firstChunk, chunkCount);
+            placed = PlaceChunkRange(curMap, firstChunk, chunkCount, node);
+         }
+         if(placed) return true;
+         mfree(curMap.pDPS, curMap.pDGS, CellStore(curMap));
+      }
+      curMap.pDGS = (CELL_DGS *)lalloc32(sizeof(CELL_DGS) * totalCells);
+      curMap.pDPS = (CELL_DPS *)lalloc32(sizeof(CELL_DPS) * totalCells);
+      SetCellStore(curMap, lalloc32(MapCellStoreBytes(chunkCells) * totalChunks));
+
+      return CellStore(curMap) && curMap.pDGS && curMap.pDPS;
+   }
+
+   // Index of the periodic table named 'name'; if none matches, the table file of that name is loaded into a free slot.
+   // 0x080000002 if no slot is free or the table cannot be loaded
+   cui32 FindPeriodicTable(cchptrc name) {
+      wchar wstName[256];
+      si32  i = 0;
+
+      for(; i < MAX_TABLES; i++) if(table[i].stName && !strcmp(name, table[i].stName)) return i;
+      // Not present; attempt to load
+      for(i = 0; i < MAX_TABLES && table[i].stName; i++);
+      if(i >= MAX_TABLES) return 0x080000002;   // No free slots available
+
+      mbstowcs(wstName, name, 255);   wstName[255] = 0;
+      cui32 index = LoadPeriodicTable(wstName, i);
+
+      return index < MAX_TABLES && table[index].stName ? index : 0x080000002;
+   }
+
+   // Returns the byte after the string at 'cursor', or NULL if it is not terminated before 'end'
+   static inline const ui8 *NextString(const ui8 *const cursor, const ui8 *const end) {
+      const ui8 *const terminator = (const ui8 *)memchr(cursor, 0, end - cursor);
+
+      return terminator ? terminator + 1 : NULL;
+   }
+
+   // Reserves a streamed map's cell, geometry and pixel arrays; each chunk's range is committed while it is resident
+   inline cbool ReserveCellArrays(MAP &curMap, cui32 chunkCells, cui32 totalChunks) const {
+      cui64 totalCells = ui64(chunkCells) * totalChunks;
+
+      curMap.desc.chunkCells = chunkCells;
+      curMap.desc.mapCells   = ui32(totalCells);
+      curMap.pDGS = (CELL_DGS *)vreserve(sizeof(CELL_DGS) * totalCells);
+      curMap.pDPS = (CELL_DPS *)vreserve(sizeof(CELL_DPS) * totalCells);
+      SetCellStore(curMap, vreserve(MapCellStoreBytes(chunkCells) * totalChunks));
+
+      return CellStore(curMap) && curMap.pDGS && curMap.pDPS;
+   }
+
+   // True if a chunk's cell, geometry and pixel arrays each span whole pages (VM_PAGE_BYTES), so it can be committed alone
+   static inline cbool WholePageChunks(cui32 chunkCells) {
+      return !((ui64(chunkCells) * sizeof(CELL_DGS)) % VM_PAGE_BYTES || (ui64(chunkCells) * sizeof(CELL_DPS)) % VM_PAGE_BYTES ||
+               MapCellStoreBytes(chunkCells) % VM_PAGE_BYTES);
+   }
+
+   // Makes a map sparse (MAP_SPARSE): reserves its arrays and allocates its encoded-chunk table; every chunk must then be
+   // placed, encoded or expanded, before use. False, leaving the map without arrays, if its chunks do not span whole pages,
+   // or allocation fails
+   inline cbool CreateSparse(MAP &curMap, cui32 chunkCells, cui32 totalChunks) const {
+      if(!WholePageChunks(chunkCells)) return false;
+
+      MAP_SPARSE *const sparse = (MAP_SPARSE *)zalloc64(sizeof(MAP_SPARSE));
+      if(!sparse) return false;
+
+      sparse->chunk = (MAP_SPARSE_CHUNK *)zalloc16(sizeof(MAP_SPARSE_CHUNK) * totalChunks);
+      sparse->value = (MAP_CELL_VALUE *)malloc64(sizeof(MAP_CELL_VALUE) * MM_SPARSE_VALUES);
+      if(sparse->chunk && sparse->value) {
+         if(ReserveCellArrays(curMap, chunkCells, totalChunks)) {
+            curMap.sparse = sparse;
+            return true;
+         }
+
+         cui64 totalCells = ui64(chunkCells) * totalChunks;
+         vrelease(curMap.pDGS, 0, sizeof(CELL_DGS) * totalCells);
+         vrelease(curMap.pDPS, 0, sizeof(CELL_DPS) * totalCells);
+         vrelease(CellStore(curMap), 0, MapCellStoreBytes(chunkCells) * totalChunks);
+         curMap.pDGS = NULL;
+         curMap.pDPS = NULL;
+         SetCellStore(curMap, NULL);
+      }
+      mfree(sparse->value, sparse->chunk, sparse);
+
+      return false;
+   }
+
+   // Sets a loaded map's dimensions and allocates its arrays and buffers; every chunk starts visible and modified. The
+   // arrays of a streamed map (.stream set) are reserved only; otherwise 'sparse' makes the map sparse where it can be
+   // (CreateSparse), leaving its chunks to be placed.
+   // Returns 0; 0x080000003 if the dimensions are invalid or the arrays cannot be allocated, 0x080000004 if the map is
+   // streamed and its chunks' arrays do not span whole pages (VM_PAGE_BYTES)
+   cui32 AllocLoadedMap(MAP &curMap, cVEC3Du16 mapDim, cVEC3Du16 chunkDim, csi16 zso, csi16 entListDim, cbool sparse) {
+      MAP_DESC &desc = curMap.desc;
+
+      if(!chunkDim.x || !chunkDim.y || !chunkDim.z || !mapDim.x || !mapDim.y || !mapDim.z) return 0x080000003;
+      if(mapDim.x % chunkDim.x || mapDim.y % chunkDim.y || mapDim.z % chunkDim.z) return 0x080000003;
+
+      cVEC3Du16 chunkCount  = { ui16(mapDim.x / chunkDim.x), ui16(mapDim.y / chunkDim.y), ui16(mapDim.z / chunkDim.z) };
+      cui32     chunkCells  = ui32(chunkDim.x) * chunkDim.y * chunkDim.z;
+      cui32     totalChunks = ui32(chunkCount.x) * chunkCount.y * chunkCount.z;
+      cui64     chunkQWords = (totalChunks + 63u) >> 6;
+
+      if(curMap.stream && !WholePageChunks(chunkCells)) return 0x080000004;
+
+      desc.mapDim     = mapDim;
+      desc.chunkDim   = chunkDim;
+      desc.chunkCount = chunkCount;
+      desc.mapChunks  = totalChunks;
+      desc.zso        = zso;
+      desc.entListDim = entListDim;
+
+      curMap.pCB      = (MAPDIMS_ICB *)malloc16(sizeof(MAPDIMS_ICB));
+      curMap.chunkVis = (ui64 *)zalloc16(chunkQWords * sizeof(ui64));
+      curMap.chunkMod = (ui64 *)zalloc16(chunkQWords * sizeof(ui64));
+      cbool arrays = curMap.stream ? ReserveCellArrays(curMap, chunkCells, totalChunks) :
+                     (sparse && CreateSparse(curMap, chunkCells, totalChunks)) || AllocCellArrays(curMap, chunkCells, totalChunks);
+      if(!arrays || !curMap.pCB || !curMap.chunkVis || !curMap.chunkMod) return 0x080000003;
+
+      for(ui64 i = 0; i < chunkQWords; i++) curMap.chunkVis[i] = curMap.chunkMod[i] = ~0ull;
+      if(totalChunks & 0x03F) curMap.chunkVis[chunkQWords - 1u] = curMap.chunkMod[chunkQWords - 1u] = (ui64(1) << (totalChunks & 0x03F)) - 1u;
+
+      CreateSelectionBuffers(desc.wlrv.map, desc.wlrv.world, 16);
+      if(entListDim) CreateAssociationBuffer(desc);
+
+      curMap.pCB->setMapDims(mapDim.x - 1, mapDim.y - 1, mapDim.z - 1);
+      curMap.pCB->setChunkDims(chunkDim.x - 1, chunkDim.y - 1, chunkDim.z - 1);
+      curMap.pCB->setMapCells(desc.mapCells - 1);
+      curMap.pCB->setChunkCells(chunkCells - 1);
+      curMap.pCB->setMapChunks(chunkCount.x - 1, chunkCount.y - 1, chunkCount.z - 1);
+      curMap.pCB->setFlag(false);
+      curMap.pCB->setSpawnOffset(zso - 1);
+      curMap.pCB->oobCell = {};
+
+      return 0;
+   }
+
+   // Copies a loaded map's name, info and periodic table. Returns 0; 0x080000002 if the table cannot be found or loaded
+   cui32 SetLoadedMapStrings(MAP &curMap, cchptrc name, cchptrc info, cchptrc tableName) {
+      curMap.desc.stName = (chptr)malloc32(strlen(name) + 1u);   strcpy(curMap.desc.stName, name);
+      curMap.desc.stInfo = (chptr)malloc32(strlen(info) + 1u);   strcpy(curMap.desc.stInfo, info);
+
+      cui32 ptIndex = FindPeriodicTable(tableName);
+      if(ptIndex >= MAX_TABLES) return 0x080000002;
+      curMap.desc.ptIndex = si16(ptIndex);
+
+      return 0;
+   }
+
+   // OpenMap: format 002u. The chunk table and payloads are validated in full, then the payloads are copied by
+   // MAP_FILE_GRAIN-chunk jobs (a sparse map keeps them encoded), or, for a streamed map, left to FaultChunk and StreamUpdate
+   cui32 LoadMap002u(MAP &curMap, const FILE_VIEW &view) {
+      const MAP_FILE_HEADER &header = *(const MAP_FILE_HEADER *)view.data;
+
+      if(view.bytes < sizeof(MAP_FILE_HEADER) || header.headerBytes < sizeof(MAP_FILE_HEADER) || header.fileBytes > view.bytes) return 0x080000003;
+      if(header.stringsOffset < header.headerBytes || header.tableOffset < header.stringsOffset ||
+         header.tableOffset + ui64(header.mapChunks) * sizeof(MAP_FILE_CHUNK) > header.fileBytes) return 0x080000003;
+
+      const ui8 *const end       = view.data + header.tableOffset;
+      cchptrc          name      = (cchptr)(view.data + header.stringsOffset);
+      const ui8 *const info      = NextString((const ui8 *)name, end);
+      const ui8 *const tableName = info ? NextString(info, end) : NULL;
+      if(!tableName || !NextString(tableName, end)) return 0x080000003;
+
+      cui32 result = AllocLoadedMap(curMap, header.mapDim, header.chunkDim, header.zso, header.entListDim, !denseMaps);
+      if(result) return result;
+      if(curMap.desc.chunkCells != header.chunkCells || curMap.desc.mapChunks != header.mapChunks ||
+         header.chunkBytes != MapChunkBytes(header.chunkCells)) return 0x080000003;
+
+      // Every slot holds a raw payload, so a streamed map can rewrite it in place in any encoding
+      MAP_FILE_CHUNK *const chunk = (MAP_FILE_CHUNK *)end;
+      for(ui32 c = 0; c < header.mapChunks; c++)
+         if(chunk[c].offset & 0x03F || chunk[c].offset + header.chunkBytes > header.fileBytes ||
+            !MapPayloadValid(view.data + chunk[c].offset, chunk[c].bytes, chunk[c].encoding, header.chunkCells)) return 0x080000003;
+
+      result = SetLoadedMapStrings(curMap, name, (cchptr)info, (cchptr)tableName);
+      if(result) return result;
+
+      curMap.oob.vel  = header.oobVel;
+      curMap.oob.temp = header.oobTemp;
+      curMap.oob.rad  = header.oobRad;
+      curMap.oob.elec = header.oobElec;
+
+      if(curMap.stream) return CreateStream(curMap, chunk);
+
+      MAP_FILE_JOB job = { &curMap, view.data, chunk, 0 };
+      ParallelForChunks(header.mapChunks, MAP_FILE_GRAIN, _MM_ReadChunks, &job);
+
+      return job.failed ? 0x080000003 : 0;
+   }
+
+   // OpenMap: format 001u, parsed from the mapped file
+   cui32 LoadMap001u(MAP &curMap, const FILE_VIEW &view) {
+      const ui8 *const end       = view.data + view.bytes;
+      cchptrc          name      = (cchptr)(view.data + sizeof(MAP_FILE_TAG_001u));
+      const ui8 *const info      = NextString((const ui8 *)name, end);
+      const ui8 *const tableName = info ? NextString(info, end) : NULL;
+      const ui8       *cursor    = tableName ? NextString(tableName, end) : NULL;
+      VEC3Du16         mapDim, chunkDim;
+      si16             zso;
+
+      // Dimensions, zso & out-of-bounds cell
+      if(!cursor || end - cursor < 34) return 0x080000003;
+      memcpy(&mapDim,          cursor,      sizeof(VEC3Du16));
+      memcpy(&chunkDim,        cursor + 6,  sizeof(VEC3Du16));
+      memcpy(&zso,             cursor + 12, sizeof(si16));
+      memcpy(&curMap.oob.vel,  cursor + 14, sizeof(VEC2Df));
+      memcpy(&curMap.oob.temp, cursor + 22, sizeof(fl32));
+      memcpy(&curMap.oob.rad,  cursor + 26, sizeof(fl32));
+      memcpy(&curMap.oob.elec, cursor + 30, sizeof(fl32));
+      cursor += 34;
+
+      cui32 result = AllocLoadedMap(curMap, mapDim, chunkDim, zso, 0, false);
+      if(result) return result;
+
+      constexpr ui64 CELL_BYTES = sizeof(VEC2Df) + sizeof(fl32) * 3u;
+      cui64          cells      = curMap.desc.mapCells;
+      if(ui64(end - cursor) < cells * (CELL_BYTES + sizeof(CELL_DGS) + sizeof(CELL_DPS))) return 0x080000003;
+
+      result = SetLoadedMapStrings(curMap, name, (cchptr)info, (cchptr)tableName);
+      if(result) return result;
+
+      // vel, temp, rad & elec are contiguous in CELL and in MAP_CELL_VALUE
+      MAP_CELL_VALUE value = {};
+      for(ui64 i = 0; i < cells; i++, cursor += CELL_BYTES) {
+         memcpy(&value.vel, cursor, CELL_BYTES);
+         StoreCell(curMap, i, value);
+      }
+      Copy(cursor, curMap.pDGS, cells * sizeof(CELL_DGS));
+      Copy(cursor + cells * sizeof(CELL_DGS), curMap.pDPS, cells * sizeof(CELL_DPS));
+
+      return 0;
+   }
+
+   // Sets up a streamed map's residency; no chunk is resident, or visible to culling, until it is loaded
+   cui32 CreateStream(MAP &curMap, MAP_FILE_CHUNK *const table) const {
+      MAP_STREAM &stream      = *curMap.stream;
+      cui32       chunks      = curMap.desc.mapChunks;
+      cui64       chunkQWords = (chunks + 63u) >> 6;
+
+      if(stream.slots > chunks) stream.slots = chunks;
+      stream.state     = (ui8ptr)zalloc16(chunks);
+      stream.chunkSlot = (ui32ptr)malloc16(sizeof(ui32) * chunks);
+      stream.slotChunk = (ui32ptr)malloc16(sizeof(ui32) * stream.slots);
+      stream.slotUse   = (ui64ptr)zalloc16(sizeof(ui64) * stream.slots);
+      stream.freeSlot  = (ui32ptr)malloc16(sizeof(ui32) * stream.slots);
+      stream.visible   = (ui64ptr)malloc16(sizeof(ui64) * chunkQWords);
+      stream.dirty     = (ui64ptr)zalloc16(sizeof(ui64) * chunkQWords);
+      if(!stream.state || !stream.chunkSlot || !stream.slotChunk || !stream.slotUse || !stream.freeSlot || !stream.visible || !stream.dirty)
+         return 0x080000003;
+
+      for(ui32 i = 0; i < chunks; i++) stream.chunkSlot[i] = MM_STREAM_NONE;
+      // Lowest slots are taken first
+      for(ui32 i = 0; i < stream.slots; i++) {
+         stream.slotChunk[i] = MM_STREAM_NONE;
+         stream.freeSlot[i]  = stream.slots - 1u - i;
+      }
+      stream.freeSlots = stream.slots;
+      for(ui64 i = 0; i < chunkQWords; i++) {
+         stream.visible[i]  = curMap.chunkVis[i];
+         curMap.chunkVis[i] = curMap.chunkMod[i] = 0;
+      }
+      stream.table = table;
+#ifdef DATA_TRACKING
+      _InterlockedExchangeAdd((vol long *)&sysData.streaming.slots, long(stream.slots));
+#endif
+      return 0;
+   }
+
+   // Waits for a streamed map's jobs, writes its modified chunks back to the file, then releases its arrays and closes the
+   // file. Called by DestroyMap
+   void CloseStream(MAP &curMap) const {
+      if(!curMap.stream) return;
+
+      MAP_STREAM &stream     = *curMap.stream;
+      cui64       chunkCells = curMap.desc.chunkCells;
+      cui64       totalCells = curMap.desc.mapCells;
+      ui64        resident   = 0;
+
+      jobSystem.Wait(stream.jobs);
+      // Set once CreateStream succeeds
+      if(stream.table) {
+         ATOMIC_BITSET dirty(stream.dirty, curMap.desc.mapChunks);
+
+         for(ui32 s = 0; s < stream.slots; s++) {
+            cui32 chunk = stream.slotChunk[s];
+            if(chunk == MM_STREAM_NONE) continue;
+            resident++;
+            if(!dirty.Reset(chunk)) continue;
+            _MM_StoreChunk(curMap, chunk, stream.file.data + stream.table[chunk].offset, stream.table[chunk]);
+#ifdef DATA_TRACKING
+            _InterlockedIncrement64((vsi64ptr)&sysData.streaming.writeBacks);
+#endif
+         }
+#ifdef DATA_TRACKING
+         _InterlockedExchangeAdd((vol long *)&sysData.streaming.slots, -long(stream.slots));
+         _InterlockedExchangeAdd((vol long *)&sysData.streaming.resident, -long(resident));
+#endif
+      }
+      vrelease(curMap.pDGS, resident * chunkCells * sizeof(CELL_DGS), totalCells * sizeof(CELL_DGS));
+      vrelease(curMap.pDPS, resident * chunkCells * sizeof(CELL_DPS), totalCells * sizeof(CELL_DPS));
+      vrelease(CellStore(curMap), resident * MapCellStoreBytes(chunkCells), curMap.desc.mapChunks * MapCellStoreBytes(chunkCells));
+      curMap.pDGS = NULL;
+      curMap.pDPS = NULL;
+      SetCellStore(curMap, NULL);
+
+      files.UnmapFile(stream.file);
+      mfree(stream.dirty, stream.visible, stream.freeSlot, stream.slotUse, stream.slotChunk, stream.chunkSlot, stream.state, curMap.stream);
+      curMap.stream = NULL;
+   }
+
+   // Frees a sparse map's encoded chunks and releases its arrays. Called by DestroyMap
+   void CloseSparse(MAP &curMap) const {
+      if(!curMap.sparse) return;
+
+      MAP_SPARSE &sparse     = *curMap.sparse;
+      cui64       chunkCells = curMap.desc.chunkCells;
+      cui64       totalCells = curMap.desc.mapCells;
+      ui64        encoded    = 0, encodedBytes = 0;
+
+      for(ui32 c = 0; c < curMap.desc.mapChunks; c++) {
+         const MAP_SPARSE_CHUNK &stored = sparse.chunk[c];
+         if(stored.encoding == mce_raw) continue;
+         encoded++;
+         encodedBytes += stored.bytes;
+         if(_MM_SparseOwned(sparse, stored.payload)) mfree((ui8ptr)stored.payload);
+      }
+#ifdef DATA_TRACKING
+      _InterlockedExchangeAdd((vol long *)&sysData.sparse.encoded, -long(encoded));
+      _InterlockedExchangeAdd((vol long *)&sysData.sparse.expanded, -long(sparse.expanded));
+      _InterlockedExchangeAdd64((vsi64ptr)&sysData.sparse.encodedBytes, -si64(encodedBytes));
+#endif
+      vrelease(curMap.pDGS, sparse.expanded * chunkCells * sizeof(CELL_DGS), totalCells * sizeof(CELL_DGS));
+      vrelease(curMap.pDPS, sparse.expanded * chunkCells * sizeof(CELL_DPS), totalCells * sizeof(CELL_DPS));
+      vrelease(CellStore(curMap), sparse.expanded * MapCellStoreBytes(chunkCells), curMap.desc.mapChunks * MapCellStoreBytes(chunkCells));
+      curMap.pDGS = NULL;
+      curMap.pDPS = NULL;
+      SetCellStore(curMap, NULL);
+
+      mfree(sparse.value, sparse.chunk, curMap.sparse);
+      curMap.sparse = NULL;
+   }
+
+   // LoadMap & StreamMap. 'residentChunks' == 0: load every chunk
+   cui32 OpenMap(wchptrc filename, csi32 worldIndex, si32 mapIndex, cui32 residentChunks, cui32 radius) {
+      MEM_TAG_SCOPE memTagScope(ss_map);
+      FILE_VIEW     view;
       // Find first available slot if mapIndex is -1
       if(mapIndex == -1)
          for(mapIndex = 0; mapIndex < world[worldIndex].maxMaps && world[worldIndex].map[mapIndex]; mapIndex++);
       // Map slot already occupied, or all slots occupied
-      if(mapIndex >= world[worldIndex].maxMaps) return 0x080000001;
-
-      MAP &curMap = *world[worldIndex].map[mapIndex];
+      if(mapIndex >= world[worldIndex].maxMaps || world[worldIndex].map[mapIndex]) return 0x080000001;
 
       wcscpy(files.wstTemp, stMapsDir);
       wcscpy(files.wstTemp + wcslen(stMapsDir), filename);
-      HANDLE hMapData = CreateFile(files.wstTemp, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_READONLY, NULL);
+      if(!(residentChunks ? files.MapForUpdating(files.wstTemp, view) : files.MapForReading(files.wstTemp, view))) return 0x080000003;
 
-      // Read & process tagline
-      files.ReadLine(hMapData, files.stTemp);
-//--- To do...
-      // Read critical map information
-      files.ReadLine(hMapData, files.stTemp);   curMap.desc.stName = (chptr)malloc32(strlen(files.stTemp) + 1u);   strcpy(curMap.desc.stName, files.stTemp);
-      files.ReadLine(hMapData, files.stTemp);   curMap.desc.stInfo = (chptr)malloc32(strlen(files.stTemp) + 1u);   strcpy(curMap.desc.stInfo, files.stTemp);
-      // Search periodic table array for match
-      files.ReadLine(hMapData, files.stTemp);
-      for(i = 0; !strcmp(files.stTemp, table[i].stName) || i < MAX_TABLES; i++);
-      if(i < MAX_TABLES)
-         curMap.desc.ptIndex = i;
-      // Not present; attempt to load
-      else {
-         for(i = 0; table[i].stName || i < MAX_TABLES; i++);
-         if(i >= MAX_TABLES)   // No free slots available
-            return 0x080000002;
-         LoadPeriodicTable(files.wstTemp, i);
-         curMap.desc.ptIndex = i;
+      // Occupies the slot first, so a failed load is released by DestroyMap
+      MAP &curMap = *(world[worldIndex].map[mapIndex] = (MAP *)zalloc32(sizeof(MAP)));
+      world[worldIndex].totalMaps++;
+      curMap.desc.wlrv.world = worldIndex;
+      curMap.desc.wlrv.map   = mapIndex;
+      if(residentChunks && (curMap.stream = (MAP_STREAM *)zalloc64(sizeof(MAP_STREAM)))) {
+         curMap.stream->slots  = residentChunks;
+         curMap.stream->radius = radius;
       }
 
-      ReadFile(hMapData, &curMap.desc.mapDim,   sizeof(VEC3Ds16), (LPDWORD)&uiBytes, NULL);
-      ReadFile(hMapData, &curMap.desc.chunkDim, sizeof(VEC3Ds16), (LPDWORD)&uiBytes, NULL);
-      ReadFile(hMapData, &curMap.desc.zso,      sizeof(si16),     (LPDWORD)&uiBytes, NULL);
-      ReadFile(hMapData, &curMap.oob.vel,       sizeof(VEC2Df),   (LPDWORD)&uiBytes, NULL);
-      ReadFile(hMapData, &curMap.oob.temp,      sizeof(fl32),     (LPDWORD)&uiBytes, NULL);
-      ReadFile(hMapData, &curMap.oob.rad,       sizeof(fl32),     (LPDWORD)&uiBytes, NULL);
-      ReadFile(hMapData, &curMap.oob.elec,      sizeof(fl32),     (LPDWORD)&uiBytes, NULL);
-      curMap.oob.geometry = NULL;
-      curMap.oob.pixel    = NULL;
-      // Calculate cached values
-      csi32 chunkCells  = curMap.desc.chunkDim.x * curMap.desc.chunkDim.y * curMap.desc.chunkDim.z;
-      csi32 totalCells  = curMap.desc.mapDim.x * curMap.desc.mapDim.y * curMap.desc.mapDim.z;
-      cui32 totalChunks = totalCells / chunkCells;
-      
-      cVEC3Du8 chunkCount = { ui8(curMap.desc.mapDim.x / curMap.desc.chunkDim.x - 1), ui8(curMap.desc.mapDim.y / curMap.desc.chunkDim.y - 1), ui8(curMap.desc.mapDim.z / curMap.desc.chunkDim.z - 1) };
-
-      curMap.pCB = (MAPDIMS_ICB *)malloc16(sizeof(MAPDIMS_ICB));
-      curMap.desc.chunkCells = chunkCells;
-      curMap.desc.mapCells   = totalCells;
-      curMap.pCB->setMapDims(curMap.desc.mapDim.x - 1, curMap.desc.mapDim.y - 1, curMap.desc.mapDim.z - 1);
-      curMap.pCB->setChunkDims(curMap.desc.chunkDim.x - 1, curMap.desc.chunkDim.y - 1, curMap.desc.chunkDim.z - 1);
-//      curMap.pCB->totalCells = { ui32(chunkCells), ui32(totalCells) };
-//      curMap.pCB->zso        = ui16(curMap.desc.zso);
-//      curMap.pCB->chunkCount = chunkCount;
-//      curMap.pCB->bitFlags   = 0;
-      // Read cell data
-      curMap.cell = (CELL *)malloc32(sizeof(CELL) * curMap.desc.mapCells);
-      for(ui32 i = 0; i < curMap.desc.mapCells; i++) {
-         ReadFile(hMapData, &curMap.cell[i].vel,  sizeof(VEC2Df), (LPDWORD)&uiBytes, NULL);
-         ReadFile(hMapData, &curMap.cell[i].temp, sizeof(fl32),   (LPDWORD)&uiBytes, NULL);
-         ReadFile(hMapData, &curMap.cell[i].rad,  sizeof(fl32),   (LPDWORD)&uiBytes, NULL);
-         ReadFile(hMapData, &curMap.cell[i].elec, sizeof(fl32),   (LPDWORD)&uiBytes, NULL);
+      cbool formatV2 = view.bytes >= sizeof(MAP_FILE_TAG_002u) && !memcmp(view.data, MAP_FILE_TAG_002u, sizeof(MAP_FILE_TAG_002u));
+      cbool formatV1 = view.bytes >= sizeof(MAP_FILE_TAG_001u) && !memcmp(view.data, MAP_FILE_TAG_001u, sizeof(MAP_FILE_TAG_001u));
+      cui32 result   = residentChunks && !curMap.stream ? 0x080000003 :
+                       formatV2                         ? LoadMap002u(curMap, view) :
+                       formatV1 && !residentChunks      ? LoadMap001u(curMap, view) : 0x080000003;
+      // A streamed map keeps its file
+      if(!result && curMap.stream) curMap.stream->file = view;
+      else files.UnmapFile(view);
+      if(result) {
+         DestroyMap(worldIndex, mapIndex);
+         return result;
+      }
+
+      return mapIndex;
+   }
+
+   // Loads a map file (format 002u or 001u) from stMapsDir into a world's map slot; -1 takes the first free slot.
+   // Returns the map index. 0x080000001 if the slot is occupied or none is free, 0x080000002 if the map's periodic table
+   // cannot be found or loaded, 0x080000003 if the file cannot be read or is not a valid map file
+   cui32 LoadMap(wchptrc filename, csi32 worldIndex, si32 mapIndex) { return OpenMap(filename, worldIndex, mapIndex, 0, 0); }
+
+   // As LoadMap, but streams the map from its file: at most 'residentChunks' chunks are resident, chunks within 'radius'
+   // chunks of the camera are kept and prefetched (StreamUpdate), and modified chunks are written back to the file when
+   // evicted, and by DestroyMap. Cells are reached through FaultChunk or ResidentCell.
+   // Also returns 0x080000003 for 001u files (save them as 002u first), and 0x080000004 if a chunk's cell, geometry or
+   // pixel data is not a whole number of pages (VM_PAGE_BYTES)
+   cui32 StreamMap(wchptrc filename, csi32 worldIndex, si32 mapIndex, cui32 residentChunks, cui32 radius) {
+      return OpenMap(filename, worldIndex, mapIndex, residentChunks ? residentChunks : 1u, radius);
+   }
+
+   // Makes a chunk's cells addressable. A streamed chunk is made resident, loading it on the calling thread if need be, and
+   // evicting the least recently used chunk if no slot is free; 'modify' marks it for write-back. An encoded chunk of a
+   // sparse map is expanded (ExpandChunk), whether or not 'modify' is set. Always true for dense maps.
+   // Returns false if the chunk cannot be loaded or expanded, or every slot holds a chunk used within MM_STREAM_MIN_AGE
+   // updates
+   cbool FaultChunk(MAP &curMap, cui32 chunk, cbool modify) const {
+      if(curMap.sparse) return ExpandChunk(curMap, chunk);
+      if(!curMap.stream) return true;
+
+      MAP_STREAM &stream = *curMap.stream;
+
+      for(;;) {
+         SpinLockVia(SPIN_WAIT_POLICY, &stream.lock);
+         switch(stream.state[chunk]) {
+         case mcs_resident:
+            stream.slotUse[stream.chunkSlot[chunk]] = stream.tick;
+            SpinUnlock(&stream.lock);
+#ifdef DATA_TRACKING
+            _InterlockedIncrement64((vsi64ptr)&sysData.streaming.hits);
+#endif
+            if(modify) ATOMIC_BITSET(stream.dirty, curMap.desc.mapChunks).Set(chunk);
+            return true;
+         case mcs_absent:
+            if(stream.freeSlots) {
+               _MM_StreamClaim(curMap, chunk);
+               SpinUnlock(&stream.lock);
+#ifdef DATA_TRACKING
+               _InterlockedIncrement64((vsi64ptr)&sysData.streaming.misses);
+#endif
+               if(!_MM_StreamLoad(curMap, chunk)) return false;
+               if(modify) ATOMIC_BITSET(stream.dirty, curMap.desc.mapChunks).Set(chunk);
+               return true;
+            } else {
+               // Evict, then try again; another thread may take the freed slot first
+               cui32 victim = _MM_StreamVictim(curMap);
+               if(victim != MM_STREAM_NONE) _MM_StreamRetire(curMap, victim);
+               SpinUnlock(&stream.lock);
+               if(victim == MM_STREAM_NONE) return false;
+               _MM_StreamEvict(curMap, victim);
+            }
+            break;
+         default: // Being loaded or evicted by another thread
+            SpinUnlock(&stream.lock);
+            if(!jobSystem.TryRunOne()) _mm_pause();
+         }
+      }
+   }
+
+   // Gives an encoded chunk of a sparse map full storage: commits its pages and decodes it there. True if the chunk is
+   // expanded; false if its pages cannot be committed
+   cbool ExpandChunk(MAP &curMap, cui32 chunk) const {
+      MAP_SPARSE       &sparse = *curMap.sparse;
+      MAP_SPARSE_CHUNK &stored = sparse.chunk[chunk];
+
+      if(stored.encoding == mce_raw) return true;
+
+      SpinLockVia(SPIN_WAIT_POLICY, &sparse.lock);
+      cbool expanded = stored.encoding == mce_raw || _MM_CommitChunk(curMap, chunk);
+      if(expanded && stored.encoding != mce_raw) {
+         cui32 bytes = stored.bytes;
+         _MM_DecodeChunk(curMap, stored.payload, stored.encoding, chunk);
+         if(_MM_SparseOwned(sparse, stored.payload)) mfree((ui8ptr)stored.payload);
+         stored.payload  = NULL;
+         stored.bytes    = 0;
+         stored.encoding = mce_raw;   // Last: the unlocked test above then finds the cells in place
+         sparse.expanded++;
+#ifdef DATA_TRACKING
+         _InterlockedIncrement64((vsi64ptr)&sysData.sparse.expansions);
+         _InterlockedIncrement((vol long *)&sysData.sparse.expanded);
+         _InterlockedDecrement((vol long *)&sysData.sparse.encoded);
+         _InterlockedExchangeAdd64((vsi64ptr)&sysData.sparse.encodedBytes, -si64(bytes));
+#endif
+      }
+      SpinUnlock(&sparse.lock);
+
+      return expanded;
+   }
+
+   // Copies a chunk's geometry and pixel data to 'dgs' and 'dps', which are indexed as the map's arrays (the mapped GPU
+   // buffers). An encoded chunk of a sparse map is decoded into them; it is not expanded
+   inline void StageChunk(const MAP &curMap, cui32 chunk, CELL_DGSptrc dgs, CELL_DPSptrc dps) const {
+      cui32 chunkCells = curMap.desc.chunkCells;
+      cui64 first      = ui64(chunk) * chunkCells;
+
+      if(curMap.sparse && curMap.sparse->chunk[chunk].encoding != mce_raw) {
+         MAP_SPARSE &sparse = *curMap.sparse;
+
+         SpinLockVia(SPIN_WAIT_POLICY, &sparse.lock);
+         const MAP_SPARSE_CHUNK &stored  = sparse.chunk[chunk];
+         cbool                   encoded = stored.encoding != mce_raw;
+         if(encoded)
+            _MM_ForEachRun(stored.payload, stored.encoding, chunkCells, [dgs, dps, first](cui32 begin, cui32 cells, const MAP_CELL_VALUE &value) {
+               for(ui64 i = first + begin; i < first + begin + cells; i++) {
+                  dgs[i] = value.geometry;
+                  dps[i] = value.pixel;
+               }
+            });
+         SpinUnlock(&sparse.lock);
+         if(encoded) return;
+      }
+      Stream16(&curMap.pDGS[first], &dgs[first], chunkCells * sizeof(CELL_DGS));
+      Stream16(&curMap.pDPS[first], &dps[first], chunkCells * sizeof(CELL_DPS));
+   }
+
+   // True if chunk 'c' of a map has its cells in memory: not held encoded (sparse) and resident (streamed). Read unlocked
+   static inline cbool ChunkInMemory(const MAP &curMap, cui32 c) {
+      return !(curMap.sparse && curMap.sparse->chunk[c].encoding != mce_raw) && !(curMap.stream && curMap.stream->state[c] != mcs_resident);
+   }
+
+   // Replaces each group of 8 values of field 'field' (MAP_CELL_FIELD) of chunks [firstChunk, endChunk) of a map with
+   // fn(values), through MAP_CELL_LAYOUT's Load8/Store8; the lanes past a chunk's last cell may hold anything, and are
+   // written back only where the layout has room for them. Chunks not in memory are skipped (ChunkInMemory; FaultChunk them
+   // first), and a streamed map's chunks must not be evicted meanwhile. Chunk ranges are independent, so a sweep can be
+   // split over ParallelFor jobs
+   template <typename FN>
+   static inline void SweepField(const MAP &curMap, cui32 field, cui32 firstChunk, cui32 endChunk, FN fn) {
+      cui32      chunkCells = curMap.desc.chunkCells;
+      cui32      whole      = chunkCells & ~0x07u;
+      cui256     all        = _mm256_set1_epi32(-1);
+      cui256     tail       = _mm256_cmpgt_epi32(_mm256_set1_epi32(si32(chunkCells - whole)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+      const auto sweep      = [&curMap, chunkCells, field, &fn](cui32 c, cui32 i, cui256 mask) {
+         MAP_CELL_LAYOUT::Store8(curMap.cell, chunkCells, c, field, i, fn(MAP_CELL_LAYOUT::Load8(curMap.cell, chunkCells, c, field, i, mask)), mask);
+      };
+
+      for(ui32 c = firstChunk; c < endChunk; c++) {
+         if(!ChunkInMemory(curMap, c)) continue;
+
+         for(ui32 i = 0; i < whole; i += 8u) sweep(c, i, all);
+         if(whole < chunkCells) sweep(c, whole, tail);
+      }
+   }
+
+   // Multiplies a field by 'factor'; e.g. radiation decay (mcf_rad)
+   static inline void ScaleField(const MAP &curMap, cui32 field, cfl32 factor, cui32 firstChunk, cui32 endChunk) {
+      cfl32x8 scale = _mm256_set1_ps(factor);
+
+      SweepField(curMap, field, firstChunk, endChunk, [scale](cfl32x8 values) { return _mm256_mul_ps(values, scale); });
+   }
+
+   // Moves a field 'rate' (0~1) of the way toward 'target'; e.g. temperature toward ambient (mcf_temp)
+   static inline void RelaxField(const MAP &curMap, cui32 field, cfl32 target, cfl32 rate, cui32 firstChunk, cui32 endChunk) {
+      cfl32x8 goal = _mm256_set1_ps(target), step = _mm256_set1_ps(rate);
+
+      SweepField(curMap, field, firstChunk, endChunk,
+                 [goal, step](cfl32x8 values) { return _mm256_fmadd_ps(_mm256_sub_ps(goal, values), step, values); });
+   }
+
+   // Sum of a field over the cells of chunks [firstChunk, endChunk) in memory; lanes past each chunk's last cell are masked off
+   static inline cfl64 SumField(const MAP &curMap, cui32 field, cui32 firstChunk, cui32 endChunk) {
+      cui32      chunkCells = curMap.desc.chunkCells;
+      cui32      whole      = chunkCells & ~0x07u;
+      cui256     all        = _mm256_set1_epi32(-1);
+      cui256     tail       = _mm256_cmpgt_epi32(_mm256_set1_epi32(si32(chunkCells - whole)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+      const auto load       = [&curMap, chunkCells, field](cui32 c, cui32 i, cui256 mask) {
+         return MAP_CELL_LAYOUT::Load8(curMap.cell, chunkCells, c, field, i, mask);
+      };
+      fl64       total      = 0.0;
+
+      for(ui32 c = firstChunk; c < endChunk; c++) {
+         if(!ChunkInMemory(curMap, c)) continue;
+
+         fl32x8 sum = _mm256_setzero_ps();
+         for(ui32 i = 0; i < whole; i += 8u) sum = _mm256_add_ps(sum, load(c, i, all));
+         if(whole < chunkCells) sum = _mm256_add_ps(sum, _mm256_and_ps(load(c, whole, tail), _mm256_castsi256_ps(tail)));
+
+         cfl64x4 wide = _mm256_add_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(sum)), _mm256_cvtps_pd(_mm256_extractf128_ps(sum, 1)));
+         al32 fl64 lane[4];
+         _mm256_store_pd(lane, wide);
+         total += lane[0] + lane[1] + lane[2] + lane[3];
       }
-      curMap.pDGS = (CELL_DGS *)malloc32(sizeof(CELL_DGS) * curMap.desc.mapCells);   ReadFile(hMapData, curMap.pDGS, sizeof(CELL_DGS) * curMap.desc.mapCells, (LPDWORD)&uiBytes, NULL);
-      curMap.pDPS = (CELL_DPS *)malloc32(sizeof(CELL_DPS) * curMap.desc.mapCells);   ReadFile(hMapData, curMap.pDPS, sizeof(CELL_DPS) * curMap.desc.mapCells, (LPDWORD)&uiBytes, NULL);
-      curMap.chunkVis = (ui64 *)malloc16(ui64(totalChunks + 7) >> 3);
-      curMap.chunkMod = (ui64 *)malloc16(ui64(totalChunks + 7) >> 3);
 
-      return ++world[worldIndex].totalMaps;
+      return total;
    }
 
+   // CalcCellIndex, faulting in the cell's chunk (FaultChunk); 'modify' marks the chunk for write-back.
+   // Returns NULL if the coordinate is outside the map or the chunk cannot be made resident
+   inline CELL_PTR ResidentCell(cVEC3Ds32 coord, csi32 mapIndex, csi32 worldIndex, cbool modify = false) const {
+      cui32 cellIndex = CalcCellIndex(coord, mapIndex, worldIndex);
+      if(cellIndex == 0x080000001) return {};
+
+      MAP &curMap = *world[worldIndex].map[mapIndex];
+
+      if(!FaultChunk(curMap, cellIndex / curMap.desc.chunkCells, modify)) return {};
+      return MAP_CELL_LAYOUT::At(curMap.cell, cellIndex);
+   }
+
+   // Advances a streamed map's residency by one tick; call once per frame, after culling. Renews the chunks within .radius
+   // chunks of 'position' (map space, as CalcCellIndex), active chunks (chunkMod) and the chunks of the newest visibility
+   // set; then queues jobs loading absent chunks near the camera and evicting down to the low-water mark
+   // (MM_STREAM_LOW_WATER), at most MM_STREAM_PREFETCH of each
+   void StreamUpdate(csi32 mapIndex, csi32 worldIndex, cVEC3Df position) {
+      MAP &curMap = *world[worldIndex].map[mapIndex];
+      if(!curMap.stream) return;
+
+      MAP_STREAM &stream = *curMap.stream;
+      cMAP_DESC  &desc   = curMap.desc;
+      cui64       tick   = stream.tick + 1u;
+      csi32       radius = si32(stream.radius);
+      csi32       centre[3] = { (si32(floorf(position.x)) + (desc.mapDim.x >> 1)) / desc.chunkDim.x,
+                                (si32(floorf(position.y)) + (desc.mapDim.y >> 1)) / desc.chunkDim.y,
+                                (si32(floorf(position.z)) + desc.zso) / desc.chunkDim.z };
+      csi32       low[3]    = { max(centre[0] - radius, 0), max(centre[1] - radius, 0), max(centre[2] - radius, 0) };
+      csi32       high[3]   = { min(centre[0] + radius, si32(desc.chunkCount.x) - 1), min(centre[1] + radius, si32(desc.chunkCount.y) - 1),
+                                min(centre[2] + radius, si32(desc.chunkCount.z) - 1) };
+      ui32        load[MM_STREAM_PREFETCH], evict[MM_STREAM_PREFETCH];
+      ui32        loads = 0, evicts = 0;
+
+      const auto renew = [&stream, tick](cui64 chunk) {
+         if(stream.state[chunk] == mcs_resident) stream.slotUse[stream.chunkSlot[chunk]] = tick;
+      };
+
+      SpinLockVia(SPIN_WAIT_POLICY, &stream.lock);
+      stream.tick = tick;
+      ATOMIC_BITSET(curMap.chunkMod, desc.mapChunks).CollectEach(0, (desc.mapChunks + 63u) >> 6, renew);
+      if(threadData[0].map == &curMap && threadData[0].results) {
+         const VIS_SET &set = threadData[0].results->set[threadData[0].results->ready & 0x03u];
+         for(ui8 l = 0; l < VIS_MAX_LOD; l++)
+            for(ui32 i = 0; i < set.count[l]; i++) renew(set.list[l][i]);
+         for(ui32 i = 0; i < set.modCount; i++) renew(set.mod[i]);
+      }
+      for(si32 z = low[2]; z <= high[2]; z++)
+         for(si32 y = low[1]; y <= high[1]; y++)
+            for(si32 x = low[0]; x <= high[0]; x++) {
+               cui32 chunk = ui32(x) + (ui32(y) + ui32(z) * desc.chunkCount.y) * desc.chunkCount.x;
+               if(stream.state[chunk] == mcs_resident) stream.slotUse[stream.chunkSlot[chunk]] = tick;
+               else if(stream.state[chunk] == mcs_absent && stream.freeSlots && loads < MM_STREAM_PREFETCH) {
+                  _MM_StreamClaim(curMap, chunk);
+                  load[loads++] = chunk;
+               }
+            }
+      cui32 lowWater = stream.slots - stream.slots / MM_STREAM_LOW_WATER;
+      for(ui32 held = stream.slots - stream.freeSlots - stream.retiring; held > lowWater && evicts < MM_STREAM_PREFETCH; held--) {
+         cui32 victim = _MM_StreamVictim(curMap);
+         if(victim == MM_STREAM_NONE) break;
+         _MM_StreamRetire(curMap, victim);
+         evict[evicts++] = victim;
+      }
+      SpinUnlock(&stream.lock);
+
+      for(ui32 i = 0; i < evicts; i++) jobSystem.Submit({ _MM_StreamEvictJob, &curMap, evict[i], evict[i] + 1u, &stream.jobs, NULL, 0 });
+      for(ui32 i = 0; i < loads; i++)  jobSystem.Submit({ _MM_StreamLoadJob, &curMap, load[i], load[i] + 1u, &stream.jobs, NULL, 0 });
+#ifdef DATA_TRACKING
+      _InterlockedExchangeAdd64((vsi64ptr)&sysData.streaming.prefetches, si64(loads));
+#endif
+   }
+
+   // Writes a map in format 002u, encoding uniform and low-entropy chunks (_MM_StoreChunk).
+   // Returns 0; 0x080000001 if the map slot is empty, 0x080000003 if the file cannot be written
    cui32 SaveMap(wchptrc filename, csi32 mapIndex, csi32 worldIndex) {
       // Map slot is empty
       if(!world[worldIndex].map[mapIndex]) return 0x080000001;
 
-      MAP &curMap = *world[worldIndex].map[mapIndex];
+      MAP       &curMap      = *world[worldIndex].map[mapIndex];
+      FILE_VIEW  view;
+      cchptrc    stName      = curMap.desc.stName ? curMap.desc.stName : "";
+      cchptrc    stInfo      = curMap.desc.stInfo ? curMap.desc.stInfo : "";
+      cchptrc    stTable     = table[curMap.desc.ptIndex].stName ? table[curMap.desc.ptIndex].stName : "";
+      cui64      bytes[3]    = { strlen(stName) + 1u, strlen(stInfo) + 1u, strlen(stTable) + 1u };
+      cui32      mapChunks   = curMap.desc.mapChunks;
+      cui32      chunkBytes  = ui32(MapChunkBytes(curMap.desc.chunkCells));
+      cui64      tableOffset = RoundUpToNearest64(ui64(sizeof(MAP_FILE_HEADER)) + bytes[0] + bytes[1] + bytes[2]);
+      cui64      dataOffset  = RoundUpToNearest64(tableOffset + ui64(mapChunks) * sizeof(MAP_FILE_CHUNK));
+      cui64      fileBytes   = dataOffset + ui64(mapChunks) * chunkBytes;
 
       wcscpy(files.wstTemp, stMapsDir);
       wcscpy(files.wstTemp + wcslen(stMapsDir), filename);
-      HANDLE hMapData = CreateFile(files.wstTemp, GENERIC_WRITE, FILE_SHARE_WRITE, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
-
-      // Write tag line: 2[Engine].4[Frontend].2[Data type].3[Format version]1[Compression method]
-      WriteFile(hMapData, "AE.LV01.MD.001u\0", 16, (LPDWORD)&uiBytes, NULL);
-      // Write critical map information
-      WriteFile(hMapData, curMap.desc.stName, DWORD(strlen(curMap.desc.stName) + 1u) * sizeof(char), (LPDWORD)&uiBytes, NULL);
-      WriteFile(hMapData, curMap.desc.stInfo, DWORD(strlen(curMap.desc.stInfo) + 1u) * sizeof(char), (LPDWORD)&uiBytes, NULL);
-      WriteFile(hMapData, table[curMap.desc.ptIndex].stName, DWORD(strlen(table[curMap.desc.ptIndex].stName) + 1) * sizeof(char), (LPDWORD)&uiBytes, NULL);
-      WriteFile(hMapData, &curMap.desc.mapDim,   sizeof(VEC3Ds16), (LPDWORD)&uiBytes, NULL);
-      WriteFile(hMapData, &curMap.desc.chunkDim, sizeof(VEC3Ds16), (LPDWORD)&uiBytes, NULL);
-      WriteFile(hMapData, &curMap.desc.zso,      sizeof(si16),     (LPDWORD)&uiBytes, NULL);
-      WriteFile(hMapData, &curMap.oob.vel,       sizeof(VEC2Df),   (LPDWORD)&uiBytes, NULL);
-      WriteFile(hMapData, &curMap.oob.temp,      sizeof(fl32),     (LPDWORD)&uiBytes, NULL);
-      WriteFile(hMapData, &curMap.oob.rad,       sizeof(fl32),     (LPDWORD)&uiBytes, NULL);
-      WriteFile(hMapData, &curMap.oob.elec,      sizeof(fl32),     (LPDWORD)&uiBytes, NULL);
-      // Write cell data
-      for(ui32 i = 0; i < curMap.desc.mapCells; i++) {
-         WriteFile(hMapData, &curMap.cell[i].vel,  sizeof(VEC2Df), (LPDWORD)&uiBytes, NULL);
-         WriteFile(hMapData, &curMap.cell[i].temp, sizeof(fl32),   (LPDWORD)&uiBytes, NULL);
-         WriteFile(hMapData, &curMap.cell[i].rad,  sizeof(fl32),   (LPDWORD)&uiBytes, NULL);
-         WriteFile(hMapData, &curMap.cell[i].elec, sizeof(fl32),   (LPDWORD)&uiBytes, NULL);
+      if(!files.MapForWriting(files.wstTemp, fileBytes, view)) return 0x080000003;
+
+      // A new mapping is zero-filled; padding and reserved fields are left as they are
+      MAP_FILE_HEADER &header = *(MAP_FILE_HEADER *)view.data;
+      memcpy(header.tag, MAP_FILE_TAG_002u, sizeof(MAP_FILE_TAG_002u));
+      header.headerBytes   = sizeof(MAP_FILE_HEADER);
+      header.chunkCells    = curMap.desc.chunkCells;
+      header.mapChunks     = mapChunks;
+      header.chunkBytes    = chunkBytes;
+      header.stringsOffset = sizeof(MAP_FILE_HEADER);
+      header.tableOffset   = tableOffset;
+      header.fileBytes     = fileBytes;
+      header.mapDim        = curMap.desc.mapDim;
+      header.chunkDim      = curMap.desc.chunkDim;
+      header.zso           = curMap.desc.zso;
+      header.entListDim    = curMap.desc.entListDim;
+      header.oobVel        = curMap.oob.vel;
+      header.oobTemp       = curMap.oob.temp;
+      header.oobRad        = curMap.oob.rad;
+      header.oobElec       = curMap.oob.elec;
+
+      ui8ptr strings = view.data + sizeof(MAP_FILE_HEADER);
+      memcpy(strings, stName,  bytes[0]);   strings += bytes[0];
+      memcpy(strings, stInfo,  bytes[1]);   strings += bytes[1];
+      memcpy(strings, stTable, bytes[2]);
+
+      MAP_FILE_CHUNK *const chunk = (MAP_FILE_CHUNK *)(view.data + tableOffset);
+      for(ui32 c = 0; c < mapChunks; c++) chunk[c] = { dataOffset + ui64(c) * chunkBytes, chunkBytes, mce_raw };
+
+      if(mapChunks) {
+         MAP_FILE_JOB job = { &curMap, view.data, chunk, 0 };
+         ParallelForChunks(mapChunks, MAP_FILE_GRAIN, _MM_WriteChunks, &job);
+      }
+      files.UnmapFile(view);
+
+      return 0;
+   }
+
+   // CreateMap's fill of a sparse map: chunks below surfaceChOS hold the open element and chunks from solidChOS the solid
+   // element, each as one shared value; surface chunks are encoded cell by cell, or expanded if they cannot be. Every chunk
+   // starts visible and modified. Returns 0; 0x080000003 if memory runs out
+   cui32 CreateSparseCells(MAP &curMap, cui8 openElement, cui8 solidElement, cui8 atlasIndex, csi32 surfaceChOS, csi32 solidChOS) const {
+      cui32          chunkCells  = curMap.desc.chunkCells;
+      cui32          totalChunks = curMap.desc.mapChunks;
+      cui32          capacity    = ui32(MapChunkBytes(chunkCells) / MAP_PALETTE_RATIO);
+      cui64          chunkQWords = (ui64(totalChunks) + 63u) >> 6;
+      MAP_CELL_VALUE open, surface, solid;
+
+      _MM_LayerValues(open, surface, solid, openElement, solidElement, atlasIndex);
+
+      ui8ptrc scratch = (ui8ptr)malloc64(capacity);
+      bool    placed  = scratch != NULL;
+      for(ui32 c = 0; placed && c < totalChunks; c++) {
+         if(si32(c) < surfaceChOS) placed = _MM_SparseStore(curMap, c, (const ui8 *)&open, sizeof(MAP_CELL_VALUE), mce_uniform);
+         else if(si32(c) >= solidChOS) placed = _MM_SparseStore(curMap, c, (const ui8 *)&solid, sizeof(MAP_CELL_VALUE), mce_uniform);
+         else {
+            // The surface element follows the cell index, as in the dense fill
+            cui64      first = ui64(c) * chunkCells;
+            const auto value = [&surface, first](cui64 i) {
+               MAP_CELL_VALUE result = surface;
+               result.geometry.et = { _MM_SurfaceElement(first + i), 0, 0, 0 };
+               return result;
+            };
+            ui32  encoding;
+            cui32 bytes = _MM_EncodeCells(value, chunkCells, scratch, capacity, encoding);
+
+            if(bytes) placed = _MM_SparseStore(curMap, c, scratch, bytes, encoding);
+            else {
+               placed = _MM_CommitChunk(curMap, c);
+               if(placed) {
+                  _MM_FillCells(curMap, first, chunkCells, value);
+                  curMap.sparse->expanded++;
+#ifdef DATA_TRACKING
+                  _InterlockedIncrement((vol long *)&sysData.sparse.expanded);
+#endif
+               }
+            }
+         }
       }
-      WriteFile(hMapData, curMap.pDGS, sizeof(CELL_DGS) * curMap.desc.mapCells, (LPDWORD)&uiBytes, NULL);
-      WriteFile(hMapData, curMap.pDPS, sizeof(CELL_DPS) * curMap.desc.mapCells, (LPDWORD)&uiBytes, NULL);
+      mfree(scratch);
+      if(!placed) return 0x080000003;
 
-      CloseHandle(hMapData);
+      for(ui64 i = 0; i < chunkQWords; i++) curMap.chunkVis[i] = curMap.chunkMod[i] = ~0ull;
+      if(totalChunks & 0x03F) curMap.chunkVis[chunkQWords - 1u] = curMap.chunkMod[chunkQWords - 1u] = (ui64(1) << (totalChunks & 0x03F)) - 1u;
 
       return 0;
    }
 
-   // Map's unique descriptor copied to 'md'
+   // Map's unique descriptor copied to 'md'. A dense map is filled by MAP_FILL_GRAIN-chunk jobs (_MM_FillChunks). Unless
+   // denseMaps is set, a map is made sparse where it can be (CreateSparse): it holds its open and solid layers as two shared
+   // uniform values and its surface layer encoded, committing no cell pages; 0x080000003 if memory runs out
    cui32 CreateMap(MAP_DESC &md, si32 mapIndex, csi32 worldIndex, cui8 openElement, cui8 solidElement) {
+      MEM_TAG_SCOPE memTagScope(ss_map);
       si32 i = 0;
       // Find first available slot if mapIndex is -1
       if(mapIndex == -1) for(mapIndex = 0; mapIndex < world[worldIndex].maxMaps && world[worldIndex].map[mapIndex]; mapIndex++);
@@ -385,12 +1119,16 @@ al16 struct CLASS_MAPMAN {
 
       MAP &curMap = *(world[worldIndex].map[mapIndex] = (MAP *)malloc32(sizeof(MAP)));
 
+      curMap.stream   = NULL;
+      curMap.sparse   = NULL;
       curMap.pCB      = (MAPDIMS_ICB *)malloc16(sizeof(MAPDIMS_ICB));
-      curMap.pDGS     = (CELL_DGS *)malloc32(sizeof(CELL_DGS) * totalCells);
-      curMap.pDPS     = (CELL_DPS *)malloc32(sizeof(CELL_DPS) * totalCells);
-      curMap.cell     = (CELL *)malloc32(sizeof(CELL) * totalCells);
-      curMap.chunkVis = (ui64 *)malloc16(ui64(totalChunks + 7) >> 3);
-      curMap.chunkMod = (ui64 *)malloc16(ui64(totalChunks + 7) >> 3);
+      if((denseMaps || !CreateSparse(curMap, chunkCells, totalChunks)) && !AllocCellArrays(curMap, chunkCells, totalChunks)) {
+         mfree(curMap.pDPS, curMap.pDGS, CellStore(curMap), curMap.pCB, &curMap);
+         world[worldIndex].map[mapIndex] = NULL;
+         return 0x080000003;
+      }
+      curMap.chunkVis = (ui64 *)zalloc16(((ui64(totalChunks) + 63u) >> 6) * sizeof(ui64));
+      curMap.chunkMod = (ui64 *)zalloc16(((ui64(totalChunks) + 63u) >> 6) * sizeof(ui64));
 
       curMap.oob.geometry = NULL;
       curMap.oob.pixel    = NULL;
@@ -413,6 +1151,14 @@ al16 struct CLASS_MAPMAN {
       curMap.desc.chunkCount = chunkCount;
       curMap.desc.entListDim = md.entListDim;
 
+      // Before any fill job writes chunkVis, or the constant buffer is set
+      if(!curMap.pCB || !curMap.chunkVis || !curMap.chunkMod) {
+         CloseSparse(curMap);
+         mfree(curMap.chunkMod, curMap.chunkVis, curMap.pDPS, curMap.pDGS, CellStore(curMap), curMap.pCB, &curMap);
+         world[worldIndex].map[mapIndex] = NULL;
+         return 0x080000003;
+      }
+
       CreateSelectionBuffers(worldIndex, mapIndex, 16);   CreateAssociationBuffer(curMap.desc);
 
       curMap.pCB->setMapDims(md.mapDim.x - 1, md.mapDim.y - 1, md.mapDim.z - 1);
@@ -424,99 +1170,30 @@ al16 struct CLASS_MAPMAN {
       curMap.pCB->setSpawnOffset(md.zso - 1);
       curMap.pCB->oobCell = {};
 
-      si32 chunkIndex = 0;
-      $LoopMT4 for(; chunkIndex < surfaceChOS; chunkIndex++) {
-         cui64 bitOS   = ui64(0x01) << (chunkIndex & 0x03F);
-         cui32 QWordOS = chunkIndex >> 6;
-         curMap.chunkVis[QWordOS] |= bitOS;
-
-         for(si32 i = 0; i < chunkCells; i++) {
-            csi32  cellIndex = chunkIndex * chunkCells + i;
-            CELL  &curCell   = world[worldIndex].map[mapIndex]->cell[cellIndex];
-
-            curCell.geometry       = &curMap.pDGS[cellIndex];
-            curCell.geometry->et   = { openElement, 0, 0, 0 };
-            curCell.geometry->er   = { 255, 0, 0, 0 };
-            curCell.geometry->end  = { 0, 0, 0, 0 };
-            curCell.geometry->dens = 0.0f;
-            //curCell.geometry->warp = 0.0f;
-            curCell.pixel          = &curMap.pDPS[cellIndex];
-            curCell.pixel->pmc     = 1.0f;
-            curCell.pixel->gtc     = 1.0f;
-            curCell.pixel->gev     = 0.0f;
-            curCell.pixel->ems     = 1.0f;
-            curCell.pixel->nms     = 1.0f;
-            curCell.pixel->rms     = 1.0f;
-            curCell.pixel->pms     = 1.0f;
-            curCell.pixel->ai      = atlasIndex;
-            curCell.vel            = { 0.0f, 0.0f };
-            curCell.temp           = 294.15f;
-            curCell.rad            = 0.0f;
-            curCell.elec           = 0.0f;
-         }
-      }
-      $LoopMT4 for(; chunkIndex < solidChOS; chunkIndex++) {
-         cui64 bitOS   = ui64(0x01) << (chunkIndex & 0x03F);
-         cui32 QWordOS = chunkIndex >> 6;
-         curMap.chunkVis[QWordOS] |= bitOS;
-
-         for(si32 i = 0; i < chunkCells; i++) {
-            csi32 cellIndex  = chunkIndex * chunkCells + i;
-            CELL  &curCell   = world[worldIndex].map[mapIndex]->cell[cellIndex];
-
-            curCell.geometry       = &curMap.pDGS[cellIndex];
-//            curCell.geometry->et   = { solidElement, 0, 0, 0 };
-            curCell.geometry->et   = { ui8(fl32(cellIndex % 1024) / 256.0f + 1.0f), 0, 0, 0 };
-            curCell.geometry->er   = { 255, 0, 0, 0 };
-            curCell.geometry->end  = { 0, 0, 0, 0 };
-            curCell.geometry->dens = 1.0f;
-            //curCell.geometry->warp = 0.0f;
-            curCell.pixel          = &curMap.pDPS[cellIndex];
-            curCell.pixel->pmc     = 1.0f;
-            curCell.pixel->gtc     = 1.0f;
-            curCell.pixel->gev     = 0.0f;
-            curCell.pixel->ems     = 1.0f;
-            curCell.pixel->nms     = 1.0f;
-            curCell.pixel->rms     = 1.0f;
-            curCell.pixel->pms     = 1.0f;
-            curCell.pixel->ai      = atlasIndex;
-            curCell.vel            = { 0.0f, 0.0f };
-            curCell.temp           = 294.15f;
-            curCell.rad            = 0.0f;
-            curCell.elec           = 0.0f;
-         }
-      }
-      $LoopMT4 for(; chunkIndex < totalChunks; chunkIndex++) {
-         cui64 bitOS   = ui64(0x01) << (chunkIndex & 0x03F);
-         cui32 QWordOS = chunkIndex >> 6;
-         curMap.chunkVis[QWordOS] |= bitOS;
-
-         for(si32 i = 0; i < chunkCells; i++) {
-            csi32 cellIndex  = chunkIndex * chunkCells + i;
-            CELL  &curCell   = world[worldIndex].map[mapIndex]->cell[cellIndex];
-
-            curCell.geometry       = &curMap.pDGS[cellIndex];
-            curCell.geometry->et   = { solidElement, 0, 0, 0 };
-            curCell.geometry->er   = { 255, 0, 0, 0 };
-            curCell.geometry->end  = { 0, 0, 0, 0 };
-            curCell.geometry->dens = 1.01f;
-            //curCell.geometry->warp = 0.0f;
-            curCell.pixel          = &curMap.pDPS[cellIndex];
-            curCell.pixel->pmc     = 1.0f;
-            curCell.pixel->gtc     = 1.0f;
-            curCell.pixel->gev     = 0.0f;
-            curCell.pixel->ems     = 1.0f;
-            curCell.pixel->nms     = 1.0f;
-            curCell.pixel->rms     = 1.0f;
-            curCell.pixel->pms     = 1.0f;
-            curCell.pixel->ai      = atlasIndex;
-            curCell.vel            = { 0.0f, 0.0f };
-            curCell.temp           = 294.15f;
-            curCell.rad            = 0.0f;
-            curCell.elec           = 0.0f;
+      if(curMap.sparse) {
+         cui32 result = CreateSparseCells(curMap, openElement, solidElement, atlasIndex, surfaceChOS, solidChOS);
+         if(result) {
+            // DestroyMap releases the slot; the name and info belong to 'md'
+            curMap.desc.stName = NULL;
+            curMap.desc.stInfo = NULL;
+            world[worldIndex].totalMaps++;
+            DestroyMap(worldIndex, mapIndex);
+            return result;
          }
+         Copy32(&curMap.desc, &md, sizeof(MAP_DESC));
+         world[worldIndex].totalMaps++;
+
+         return mapIndex;
       }
 
+      MAP_FILL_JOB job;
+
+      _MM_LayerValues(job.open, job.surface, job.solid, openElement, solidElement, atlasIndex);
+      job.map         = &curMap;
+      job.surfaceChOS = surfaceChOS;
+      job.solidChOS   = solidChOS;
+      ParallelForChunks(totalChunks, MAP_FILL_GRAIN, _MM_FillChunks, &job);
+
       Copy32(&curMap.desc, &md, sizeof(MAP_DESC));
 
       world[worldIndex].totalMaps++;
@@ -528,8 +1205,10 @@ al16 struct CLASS_MAPMAN {
       // Map slot is empty
       if(!world[worldIndex].map[mapIndex]) return -1;
 
+      CloseStream(*world[worldIndex].map[mapIndex]);
+      CloseSparse(*world[worldIndex].map[mapIndex]);
       mfree(world[worldIndex].map[mapIndex]->chunkMod, world[worldIndex].map[mapIndex]->chunkVis, world[worldIndex].map[mapIndex]->pDPS, world[worldIndex].map[mapIndex]->pDGS,
-            world[worldIndex].map[mapIndex]->cell, world[worldIndex].map[mapIndex]->pCB, world[worldIndex].map[mapIndex]->desc.entityList, world[worldIndex].map[mapIndex]->desc.wlrv.cellIndex,
+            CellStore(*world[worldIndex].map[mapIndex]), world[worldIndex].map[mapIndex]->pCB, world[worldIndex].map[mapIndex]->desc.entityList, world[worldIndex].map[mapIndex]->desc.wlrv.cellIndex,
             world[worldIndex].map[mapIndex]->desc.wlrv.entityIndex, world[worldIndex].map[mapIndex]->desc.stInfo, world[worldIndex].map[mapIndex]->desc.stName, world[worldIndex].map[mapIndex]);
 
       world[worldIndex].map[mapIndex] = 0;
@@ -658,7 +1337,9 @@ al16 struct CLASS_MAPMAN {
    inline void ModQuadCellDensity(cVEC3Ds32 coord, cfl32 densityMod, csi32 mapIndex, csi32 worldIndex) const {
       static SSE4Ds32 vAbove, vBelow, cell;
 
-      cMAP &curMap = *world[worldIndex].map[mapIndex];
+      MAP &curMap = *world[worldIndex].map[mapIndex];
+
+      ATOMIC_BITSET chunkMod(curMap.chunkMod, curMap.desc.mapChunks);   // Marked concurrently with the cull passes
 
       cVEC3Ds32 minus1    = { coord.x - 1, coord.y - 1, coord.z - 1 };
       cVEC3Ds32 coords[4] = { { coord }, { minus1.x, coord.y, coord.z }, { coord.x, minus1.y, coord.z }, { minus1.x, minus1.y, coord.z } };
@@ -670,6 +1351,9 @@ al16 struct CLASS_MAPMAN {
       if(CalcQuadCellIndices(cell, coords, worldIndex, mapIndex))
          for(ui8 i = 0; i < 4; i++) {
             if(cell._si32[i] == -1) continue;
+            // Expands encoded chunks of a sparse map, and loads streamed ones
+            if(!FaultChunk(curMap, cell._si32[i] / curMap.desc.chunkCells, true)) continue;
+            if(vBelow._si32[i] != -1 && !FaultChunk(curMap, vBelow._si32[i] / curMap.desc.chunkCells, true)) continue;
             cfl32 fDensity     = curMap.cell[cell._si32[i]].geometry->dens + densityMod;
             csi32 chunkIndex   = (cell._si32[i] / curMap.desc.chunkCells);
             cfl32 densityBelow = (vBelow._si32[i] != -1 ? curMap.cell[vBelow._si32[i]].geometry->dens : 0.0f);
@@ -680,7 +1364,7 @@ al16 struct CLASS_MAPMAN {
                   if(densityBelow > 1.0f) {
                      curMap.cell[vBelow._si32[i]].geometry->dens = 1.0f;
                      csi32 chunkIndexB = (vBelow._si32[i] / curMap.desc.chunkCells);
-                     curMap.chunkMod[chunkIndexB >> 6] |= ui64(0x01) << (chunkIndexB & 0x03F);
+                     chunkMod.Set(chunkIndexB);
                   }
                }
             } else if(fDensity > 1.0f) {
@@ -703,10 +1387,10 @@ al16 struct CLASS_MAPMAN {
                if(densityBelow == 1.0f) {
                   curMap.cell[vBelow._si32[i]].geometry->dens = 1.01f;
                   csi32 chunkIndexB = (vBelow._si32[i] / curMap.desc.chunkCells);
-                  curMap.chunkMod[chunkIndexB >> 6] |= ui64(0x01) << (chunkIndexB & 0x03F);
+                  chunkMod.Set(chunkIndexB);
                }
             }
-            curMap.chunkMod[chunkIndex >> 6] |= ui64(0x01) << (chunkIndex & 0x03F);
+            chunkMod.Set(chunkIndex);
 
             /// --- Debugging purposes ---///
             if((i == 0) && (cell._si32[0] != 0x080000001)) ((MAP_DESC &)ptrLib[14]).RES32 = cell._si32[0];
@@ -751,43 +1435,40 @@ al16 struct CLASS_MAPMAN {
 
       cui32 chunkCount = map->desc.mapChunks;
 
+      VIS_RESULTS &results = *data[0]->results;
+      VIS_SET     &set     = results.Back();
+
       SSE4Ds32 chunkOS   = {};
-      ui32ptrc nearCells = data[0]->chunkVis[0];
-      ui32ptrc medCells  = data[0]->chunkVis[1];
-      ui32ptrc farCells  = data[0]->chunkVis[2];
-      ui32ptrc modCells  = data[1]->chunkMod;
+      ui32ptrc nearCells = set.list[0];
+      ui32ptrc medCells  = set.list[1];
+      ui32ptrc farCells  = set.list[2];
+      ui32ptrc modCells  = set.mod;
 
       ui64 modCount, nearCount, medCount, farCount;
       ui32 i;
 
-      camMan.SetDimsf(map->desc.chunkDim, map->desc.chunkCount, 0);
+      CAMERA_SNAPSHOT camera;
+      camMan.ReadSnapshot(camera, 0);
+      camMan.SetDimsf(map->desc.chunkDim, map->desc.chunkCount, camera.data);
 
       nearCount = medCount = farCount = 0;
-      modCount = 0;
-
-      for(i = 0; i < chunkCount; i++) {
-         cui64 bitOS   = ui64(0x01) << (i & 0x03F);
-         cui32 qwordOS = i >> 6;
 
-         if(map->chunkMod[qwordOS] & bitOS) {
-            modCells[modCount++] = i;
-            map->chunkMod[qwordOS] ^= bitOS;
-         }
-      }
+      ATOMIC_BITSET chunkMod(map->chunkMod, chunkCount);
+      modCount = chunkMod.Drain(0, chunkMod.Words(), modCells);
 
       // Calculate each chunk's distance-to-camera and reject out-of-view chunks
       // Sort nearest-to-furthest into L.O.D. lists for input assembler
       for(chunkOS.vector.z = mapChunksL.vector.z; chunkOS.vector.z < mapChunksH.vector.z; chunkOS.vector.z++) {
          for(chunkOS.vector.y = mapChunksL.vector.y; chunkOS.vector.y < mapChunksH.vector.y; chunkOS.vector.y++) {
             for(chunkOS.vector.x = mapChunksL.vector.x; chunkOS.vector.x < mapChunksH.vector.x;) {
-               cui8 visible = camMan.ChunkFrustumIntersect8(chunkOS, 0);
+               cui8 visible = camMan.ChunkFrustumIntersect8(chunkOS, camera.data);
 
                for(i = 0; i < 8; i++, chunkOS.vector.x++)
                   if(visible & 0x01 << i) {
                      csi32 chunkIndex = CalcChunkIndex((cVEC3Ds32 &)chunkOS, 0, 0);
                      cui32 QWordOS    = chunkIndex >> 6;
                      cui64 bitOS      = ui64(0x01) << (chunkIndex & 0x03F);
-                     cfl32 distance = camMan.DistanceFromCamera(chunkOS.xmm, 0);
+                     cfl32 distance = camMan.DistanceFromCamera(chunkOS.xmm, camera.data);
 
                      // Change hard limits to LOD scalars
                      if(map->chunkVis[QWordOS] & bitOS) {
@@ -803,19 +1484,29 @@ al16 struct CLASS_MAPMAN {
          }
       }
 
-      MAPMAN_THREAD_STATUS.m128i_u64[0] = (modCount << 34) | (nearCount << 4);
-      MAPMAN_THREAD_STATUS.m128i_u64[1] = medCount | (farCount << 30);
+      set.count[0]  = (ui32)nearCount;
+      set.count[1]  = (ui32)medCount;
+      set.count[2]  = (ui32)farCount;
+      set.modCount  = (ui32)modCount;
+      set.cameraSeq = camera.seq;
+      _MM_Publish(map, results);
    }
 
-   public : inline si32 Cull(ui32ptrptrc arrayVisible, ui32ptrc arrayUnchanged, csi32 mapIndex, csi32 worldIndex, csi8 threadCount) {
+   // Starts a culling pass into results' back set (threadCount: CULL_MODE). cm_inline, cm_thread and cm_job publish each pass
+   // themselves and never wait: if the previous pass is still running, no new pass is started and 0 is returned. Null
+   // results stops the persistent cull thread(s)
+   public : inline si32 Cull(VIS_RESULTS *const results, csi32 mapIndex, csi32 worldIndex, csi8 threadCount) {
       static ui8 uiTHREADS = 0;
 
-      if(!arrayVisible) { MAPMAN_THREAD_STATUS.m128i_u8[0] &= 0x0F3; return 0; }
+      if(!results) { MAPMAN_THREAD_STATUS.m128i_u8[0] &= 0x0F3; return 0; }
 
       cui8 threadBits = MAPMAN_THREAD_STATUS.m128i_u8[0];
 
-      if(!(threadBits & 0x01)) threadData[0] = { world[worldIndex].map[mapIndex], arrayVisible };
-      if(!(threadBits & 0x02)) threadData[1] = { world[worldIndex].map[mapIndex], arrayUnchanged };
+      lockStep = threadCount == cm_splitThreads || threadCount < 0;
+      if(!lockStep && (threadBits & 0x03)) return 0;
+
+      if(!(threadBits & 0x01)) threadData[0] = { world[worldIndex].map[mapIndex], results->Back().list, results };
+      if(!(threadBits & 0x02)) threadData[1] = { world[worldIndex].map[mapIndex], results->Back().mod,  results };
 
       ///- Stall/skip? if status if 'busy'
       while(MAPMAN_THREAD_STATUS.m128i_u8[0] & 0x03) _mm_pause(); //Sleep(1);
@@ -823,10 +1514,10 @@ al16 struct CLASS_MAPMAN {
       //MAPMAN_THREAD_STATUS.m128i_u8[0] &= 0x0FC;
 
       switch(threadCount) {
-      case 0:
+      case cm_inline:
          Cull_Nonvisible_and_Unchanged(&threadData[0]);
          return 3;
-      case 1:
+      case cm_thread:
          MAPMAN_THREAD_STATUS.m128i_u8[0] |= 0x03;
          if(!(uiTHREADS & 0x03)) {
             HANDLE thread0 = (HANDLE)_beginthread(_MM_Cull_Nonvisible_and_Unchanged, 0, &threadData[0]);
@@ -835,7 +1526,7 @@ al16 struct CLASS_MAPMAN {
             uiTHREADS |= 0x03;
          }
          return 3;
-      case 2:
+      case cm_splitThreads:
          MAPMAN_THREAD_STATUS.m128i_u8[0] |= 0x03;
          if(!(uiTHREADS & 0x03)) {
             //HANDLE thread0 = (HANDLE)_beginthread(_MM_Cull_Nonvisible_Simple, 0, &threadData[0]);
@@ -846,7 +1537,7 @@ al16 struct CLASS_MAPMAN {
             uiTHREADS |= 0x03;
          }
          return 3;
-      case -1:
+      case cm_splitVisible:
          MAPMAN_THREAD_STATUS.m128i_u8[0] |= 0x01;
          if(!(uiTHREADS & 0x01)) {
             //HANDLE thread0 = (HANDLE)_beginthread(_MM_Cull_Nonvisible_Simple, 0, &threadData[0]);
@@ -855,7 +1546,7 @@ al16 struct CLASS_MAPMAN {
             uiTHREADS |= 0x01;
          }
          return 1;
-      case -2:
+      case cm_splitModified:
          MAPMAN_THREAD_STATUS.m128i_u8[0] |= 0x02;
          if(!(uiTHREADS & 0x02)) {
             HANDLE thread1 = (HANDLE)_beginthread(_MM_Cull_Unchanged, 0, &threadData[1]);
@@ -863,6 +1554,11 @@ al16 struct CLASS_MAPMAN {
             uiTHREADS |= 0x02;
          }
          return 2;
+      case cm_job:
+         MAPMAN_THREAD_STATUS.m128i_u8[0] |= 0x03;
+         // A persistent cull thread, if one was started, takes the pass itself
+         if(!(uiTHREADS & 0x03)) jobSystem.Submit(_MM_Cull_Pass, &threadData[0]);
+         return 3;
       }
 
       MAPMAN_THREAD_STATUS.m128i_u8[0] &= 0x0F3;
@@ -870,9 +1566,11 @@ al16 struct CLASS_MAPMAN {
       return 0;
    }
 
-   inline void WaitForCulling(ui128 &results, cDWORD sleepDelay) const {
-      if(sleepDelay) while(MAPMAN_THREAD_STATUS.m128i_u8[0] & 0x03) Sleep(sleepDelay);
-      else while(MAPMAN_THREAD_STATUS.m128i_u8[0] & 0x03) _mm_pause();
+   // Lock-step modes only: waits for the split cull threads, then publishes their counts with the back set they filled
+   inline void WaitForCulling(ui128 &results, cDWORD sleepDelay) {
+      // Help the job system (possibly running the cull pass itself) rather than idle
+      while(MAPMAN_THREAD_STATUS.m128i_u8[0] & 0x03)
+         if(!jobSystem.TryRunOne()) { if(sleepDelay) Sleep(sleepDelay); else _mm_pause(); }
 
       cVEC2Du64 mapManThreadData = (cVEC2Du64 &)MAPMAN_THREAD_STATUS;
 
@@ -881,6 +1579,13 @@ al16 struct CLASS_MAPMAN {
 
       results = { .m128i_u32 = { ui32(mapManThreadData.x >> 4) & 0x03FFFFFFF, ui32(mapManThreadData.x >> 34) & 0x03FFFFFFF,
                                  ui32(mapManThreadData.y)      & 0x03FFFFFFF, ui32(mapManThreadData.y >> 30) & 0x03FFFFFFF } };
+
+      if(!lockStep || !threadData[0].results) return;
+
+      VIS_SET &set = threadData[0].results->Back();
+      for(ui8 i = 0; i < 3; i++) set.count[i] = results.m128i_u32[i];
+      set.modCount = results.m128i_u32[3];
+      _MM_Publish(threadData[0].map, *threadData[0].results);
    }
 };
 
@@ -1061,9 +1766,6 @@ static void _MM_Cull_Nonvisible_Accurate(ptr threadData) {
                                         mapChunksH.vector.z - data->map->desc.chunkCount.z, 1 } };
 
    SSE4Ds32 chunkOS   = {};
-   ui32ptrc nearCells = data->chunkVis[0];
-   ui32ptrc medCells  = data->chunkVis[1];
-   ui32ptrc farCells  = data->chunkVis[2];
 
    ui64 nearCount, medCount, farCount;
    ui8  i;
@@ -1075,7 +1777,14 @@ static void _MM_Cull_Nonvisible_Accurate(ptr threadData) {
       ///- Stall/skip? if status if 'busy'
       while(!(MAPMAN_THREAD_STATUS.m128i_u8[0] & 0x01)) _mm_pause(); //Sleep(1);
 
-      camMan.SetDimsf(data->map->desc.chunkDim, data->map->desc.chunkCount, 0);
+      // Cull() re-points these at the current back set between passes
+      ui32ptrc nearCells = data->chunkVis[0];
+      ui32ptrc medCells  = data->chunkVis[1];
+      ui32ptrc farCells  = data->chunkVis[2];
+
+      CAMERA_SNAPSHOT camera;
+      camMan.ReadSnapshot(camera, 0);
+      camMan.SetDimsf(data->map->desc.chunkDim, data->map->desc.chunkCount, camera.data);
 
       nearCount = medCount = farCount = 0;
 
@@ -1087,7 +1796,7 @@ static void _MM_Cull_Nonvisible_Accurate(ptr threadData) {
 ///--- ??? Swap order of tests ???
                //cSSE4Ds32 cell2 = { .vector = { chunkOS.vector.x + 1, chunkOS.vector.y, chunkOS.vector.z } };
                //cAVX8Ds32 cells = { .xmm = { chunkOS.xmm, cell2.xmm } };
-               cui8 visible = camMan.ChunkFrustumIntersect8(chunkOS, 0);
+               cui8 visible = camMan.ChunkFrustumIntersect8(chunkOS, camera.data);
 
                for(i = 0; i < 8; i++, chunkOS.vector.x++)
                   if(visible & 0x01 << i) {
@@ -1096,7 +1805,7 @@ static void _MM_Cull_Nonvisible_Accurate(ptr threadData) {
                      cui32     QWordOS    = chunkIndex >> 6;
                      cui64     bitOS      = ui64(0x01) << (chunkIndex & 0x03F);
 
-                     cfl32 distance = camMan.DistanceFromCamera(chunkOS.xmm, 0);
+                     cfl32 distance = camMan.DistanceFromCamera(chunkOS.xmm, camera.data);
                      // Change hard limits to LOD scalars
                      if(data->map->chunkVis[QWordOS] & bitOS) {
 //                        if(distance < 128.0f)
@@ -1117,11 +1826,10 @@ static void _MM_Cull_Nonvisible_Accurate(ptr threadData) {
 }
 
 static void _MM_Cull_Unchanged(ptr threadData) {
-   cMMTDcptrc data       = (cMMTDcptrc)threadData;
-   cui32      chunkCount = data->map->desc.mapChunks;
+   cMMTDcptrc    data = (cMMTDcptrc)threadData;
+   ATOMIC_BITSET chunkMod(data->map->chunkMod, data->map->desc.mapChunks);
 
    al16 ui64 j;
-        ui32 i;
 
 //   MAPMAN_THREAD_STATUS &= 0x03FFFFFFFF;
    MAPMAN_THREAD_STATUS.m128i_u8[0] |= 0x08;
@@ -1130,226 +1838,669 @@ static void _MM_Cull_Unchanged(ptr threadData) {
       ///- Stall/skip? if status if 'busy'
       while(!(MAPMAN_THREAD_STATUS.m128i_u8[0] & 0x02)) _mm_pause(); //Sleep(1);
 
-      for(i = 0, j = 0; i < chunkCount; i++) {
-         cui64 bitOS  = ui64(0x01) << (i & 0x03F);
-         cui32 qwordOS = i >> 6;
-
-         if(data->map->chunkMod[qwordOS] & bitOS) { data->chunkMod[j++] = i;   data->map->chunkMod[qwordOS] ^= bitOS; }
-      }
+      j = chunkMod.Drain(0, chunkMod.Words(), data->chunkMod);
 
       MAPMAN_THREAD_STATUS.m128i_u64[0] ^= (j << 4) | 0x02;
    } while(MAPMAN_THREAD_STATUS.m128i_u8[0] & 0x08);
 }
 
-#if !defined(USE_OLD_CODE)
-static void _MM_Cull_Nonvisible_and_Unchanged(ptr threadData) {
-      static si64 frequencyTics, startTics, endTics;
-      QueryPerformanceFrequency((LARGE_INTEGER *)&frequencyTics);
-
-   CLASS_CAM    &camMan = *(CLASS_CAM *)ptrLib[5];
-   CLASS_MAPMAN &mapMan = *(CLASS_MAPMAN *)ptrLib[6];
+// Copies chunk 'c' of a map from its raw 002u payload into MAP_CELL_LAYOUT's storage (MAP_CELL_LAYOUT::ReadChunk)
+static void _MM_ReadChunk(MAP &map, const ui8 *const payload, cui64 c) {
+   cui64           chunkCells = map.desc.chunkCells;
+   cui64           dpsOS      = MapChunkDPSOffset(map.desc.chunkCells);
+   cui64           cellOS     = MapChunkCellOffset(map.desc.chunkCells);
+   CELL_DGS *const dgs        = &map.pDGS[c * chunkCells];
+   CELL_DPS *const dps        = &map.pDPS[c * chunkCells];
+
+   Copy(payload,          dgs,  chunkCells * sizeof(CELL_DGS));
+   Copy(payload + dpsOS,  dps,  chunkCells * sizeof(CELL_DPS));
+   MAP_CELL_LAYOUT::ReadChunk(map.cell, (const CELL *)(payload + cellOS), dgs, dps, c, map.desc.chunkCells);
+}
 
-   cMMTDcptrc dataVis = (cMMTDcptrc)threadData;
-   cMMTDcptrc dataMod = dataVis + 1;
-   MAP       *map     = dataVis->map;
+// Copies chunk 'c' of a map to its raw 002u payload; stored cells carry no pointers (MAP_CELL_LAYOUT::WriteChunk)
+static void _MM_WriteChunk(const MAP &map, ui8ptrc payload, cui64 c) {
+   cui64       chunkCells = map.desc.chunkCells;
+   cui64       dpsOS      = MapChunkDPSOffset(map.desc.chunkCells);
+   CELL *const stored     = (CELL *)(payload + MapChunkCellOffset(map.desc.chunkCells));
 
-   cSSE4Ds32 mapChunksH = { .vector = { map->desc.chunkCount.x >> 1, map->desc.chunkCount.y >> 1, (map->desc.chunkCount.z + 1) >> 1, 1 } };
-   cSSE4Ds32 mapChunksL = { .vector = { mapChunksH.vector.x - map->desc.chunkCount.x, mapChunksH.vector.y - map->desc.chunkCount.y,
-                                        mapChunksH.vector.z - map->desc.chunkCount.z, 1 } };
+   Copy(&map.pDGS[c * chunkCells], payload,         chunkCells * sizeof(CELL_DGS));
+   Copy(&map.pDPS[c * chunkCells], payload + dpsOS, chunkCells * sizeof(CELL_DPS));
+   MAP_CELL_LAYOUT::WriteChunk(map.cell, stored, c, map.desc.chunkCells);
+}
 
-   cui32 chunkCount = map->desc.mapChunks;
+// Copies chunks [begin, end) of a mapped 002u file into a map; a sparse map keeps them encoded where it can
+// (_MM_SparsePlace). A job of LoadMap's ParallelFor
+static void _MM_ReadChunks(ptr jobData, cui64 begin, cui64 end) {
+   MAP_FILE_JOB &job = *(MAP_FILE_JOB *)jobData;
+   MAP          &map = *job.map;
 
-   ui32ptrc nearCells = dataVis->chunkVis[0];
-   ui32ptrc medCells  = dataVis->chunkVis[1];
-   ui32ptrc farCells  = dataVis->chunkVis[2];
-   ui32ptrc modCells  = dataMod->chunkMod;
+   if(!map.sparse) {
+      for(ui64 c = begin; c < end; c++) _MM_DecodeChunk(map, job.file + job.chunk[c].offset, job.chunk[c].encoding, c);
+      return;
+   }
 
-   ui64 modCount, nearCount, medCount, farCount;
+   ui8ptrc scratch = (ui8ptr)malloc64(MapChunkBytes(map.desc.chunkCells) / MAP_PALETTE_RATIO);
+   ui64    c       = begin;
+   for(; scratch && c < end; c++)
+      if(!_MM_SparsePlace(map, c, job.file + job.chunk[c].offset, job.chunk[c].bytes, job.chunk[c].encoding, scratch)) break;
+   if(c < end) job.failed = 1u;
+   mfree(scratch);
+}
 
-   cAVX8Ds32 laneOffsets = { .vector = { 0, 1, 2, 3, 4, 5, 6, 7 } };
-   cAVX8Ds32 ones        = { .vector = { 1, 1, 1, 1, 1, 1, 1, 1 } };
-   cAVX8Df32 zeroF       = { .vector = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f } };
+// Stores chunks [begin, end) of a map in a mapped 002u file (_MM_StoreChunk). A job of SaveMap's ParallelFor
+static void _MM_WriteChunks(ptr jobData, cui64 begin, cui64 end) {
+   const MAP_FILE_JOB &job = *(MAP_FILE_JOB *)jobData;
 
-   csi32 chunkMinX = mapChunksL.vector.x;
-   csi32 chunkMinY = mapChunksL.vector.y;
-   csi32 chunkMinZ = mapChunksL.vector.z;
-   csi32 chunkMaxX = mapChunksH.vector.x;
-   csi32 chunkMaxY = mapChunksH.vector.y;
-   csi32 chunkMaxZ = mapChunksH.vector.z;
+   for(ui64 c = begin; c < end; c++) _MM_StoreChunk(*job.map, c, job.file + job.chunk[c].offset, job.chunk[c]);
+}
 
-   MAPMAN_THREAD_STATUS.m128i_u8[0] |= 0x0C;
+//-- Encoded chunks (MAP_CELL_VALUE, MAP_CHUNK_PALETTE) and sparse maps (MAP_SPARSE)
 
-   do {
-      while(!(MAPMAN_THREAD_STATUS.m128i_u8[0] & 0x03)) _mm_pause(); ///== Change to new spinlock
+// Sets cells [first, first + cells) of a map, whose pages are committed, to value(0)~value(cells - 1), and links them to
+// their geometry and pixel data
+template <typename FN>
+static void _MM_FillCells(MAP &map, cui64 first, cui64 cells, FN value) {
+   for(ui64 i = 0; i < cells; i++) {
+      const MAP_CELL_VALUE cell = value(i);
 
-      QueryPerformanceCounter((LARGE_INTEGER *)&startTics);
+      map.pDGS[first + i] = cell.geometry;
+      map.pDPS[first + i] = cell.pixel;
+      StoreCell(map, first + i, cell);
+   }
+}
 
-      camMan.SetDimsf(map->desc.chunkDim, map->desc.chunkCount, 0);
+// Calls fn(firstCell, cells, value) for each run of equal cells of an encoded (mce_uniform, mce_palette) payload, in order
+template <typename FN>
+static void _MM_ForEachRun(const ui8 *const payload, cui32 encoding, cui32 chunkCells, FN fn) {
+   if(encoding == mce_uniform) {
+      fn(0, chunkCells, *(const MAP_CELL_VALUE *)payload);
+      return;
+   }
 
-      nearCount = medCount = farCount = modCount = 0;
+   const MAP_CHUNK_PALETTE    &header = *(const MAP_CHUNK_PALETTE *)payload;
+   const MAP_CELL_RUN   *const run    = (const MAP_CELL_RUN *)(payload + sizeof(MAP_CHUNK_PALETTE));
+   const MAP_CELL_VALUE *const value  = (const MAP_CELL_VALUE *)(payload + MapPaletteValuesOffset(header.runs));
 
-      cSSE4Df32 camPosSSE = camMan.data32[0].pos;
-      cAVX8Df32 camPosX   = { .ymm = _mm256_set1_ps(camPosSSE.vector.x) };
-      cAVX8Df32 camPosY   = { .ymm = _mm256_set1_ps(camPosSSE.vector.y) };
-      cAVX8Df32 camPosZ   = { .ymm = _mm256_set1_ps(camPosSSE.vector.z) };
+   for(ui32 r = 0, first = 0; r < header.runs; first += run[r++].cells) fn(first, ui32(run[r].cells), value[run[r].value]);
+}
 
-      cui64 chunkQWords = (chunkCount + 63u) >> 6;
-      ui64  qwordIndex  = 0;
-      al32 ui64 modMaskBuf[4];
+// Encodes a chunk's cells, value(0)~value(chunkCells - 1), into 'out': as one value if they are all equal, else as a palette
+// of at most MAP_PALETTE_VALUES values if that fits in 'capacity' bytes. Returns the bytes written and sets 'encoding';
+// 0 if the chunk must stay raw
+template <typename FN>
+static cui32 _MM_EncodeCells(FN value, cui32 chunkCells, ui8ptrc out, cui32 capacity, ui32 &encoding) {
+   MAP_CELL_VALUE      palette[MAP_PALETTE_VALUES];
+   MAP_CELL_RUN *const run    = (MAP_CELL_RUN *)(out + sizeof(MAP_CHUNK_PALETTE));
+   ui32                values = 0, runs = 0, current = 0;
 
-      for(; qwordIndex + 4 <= chunkQWords; qwordIndex += 4) {
-         cAVX4Du64 modVec = { .ymm = _mm256_loadu_si256((const __m256i *)&map->chunkMod[qwordIndex]) };
+   if(capacity < sizeof(MAP_CHUNK_PALETTE) + sizeof(MAP_CELL_VALUE)) return 0;
 
-         if(_mm256_testz_si256(modVec.ymm, modVec.ymm)) continue;
+   // Runs are written as they close; the palette follows them once their count is known
+   for(ui32 i = 0; i < chunkCells; i++) {
+      const MAP_CELL_VALUE cell = value(i);
 
-         _mm256_store_si256((__m256i *)modMaskBuf, modVec.ymm);
+      if(runs && SameCellValue(cell, palette[current])) {
+         if(run[runs - 1u].cells < MAP_RUN_CELLS) {
+            run[runs - 1u].cells++;
+            continue;
+         }
+      } else {
+         for(current = 0; current < values && !SameCellValue(cell, palette[current]); current++);
+         if(current == values) {
+            if(values == MAP_PALETTE_VALUES) return 0;
+            palette[values++] = cell;
+         }
+      }
+      if(MapPaletteBytes(values, runs + 1u) > capacity) return 0;
+      run[runs++] = { ui16(current), 1u };
+   }
 
-         for(ui32 lane = 0; lane < 4; lane++) {
-            ui64  mask      = modMaskBuf[lane];
-            cui32 baseIndex = (ui32)((qwordIndex + lane) << 6);
+   if(values == 1u) {
+      *(MAP_CELL_VALUE *)out = palette[0];
+      encoding = mce_uniform;
+      return sizeof(MAP_CELL_VALUE);
+   }
 
-            if(baseIndex >= chunkCount) {
-               map->chunkMod[qwordIndex + lane] = 0;
-               continue;
-            }
+   cui64 runBytes = ui64(runs) * sizeof(MAP_CELL_RUN);
+   cui64 valuesOS = MapPaletteValuesOffset(runs);
 
-            cui32 remaining = chunkCount - baseIndex;
-            if(!remaining) {
-               map->chunkMod[qwordIndex + lane] = 0;
-               continue;
-            }
+   *(MAP_CHUNK_PALETTE *)out = { values, runs };
+   memset(out + sizeof(MAP_CHUNK_PALETTE) + runBytes, 0, valuesOS - sizeof(MAP_CHUNK_PALETTE) - runBytes);
+   Copy(palette, out + valuesOS, values * sizeof(MAP_CELL_VALUE));
+   encoding = mce_palette;
 
-            if(remaining < 64u) mask &= (ui64(1) << remaining) - 1ull;
-            if(!mask) continue;
+   return ui32(MapPaletteBytes(values, runs));
+}
 
-            ui64 clearMask = mask;
+// Copies chunk 'c' of a map, whose pages are committed, from its 002u payload of any encoding
+static void _MM_DecodeChunk(MAP &map, const ui8 *const payload, cui32 encoding, cui64 c) {
+   if(encoding == mce_raw) {
+      _MM_ReadChunk(map, payload, c);
+      return;
+   }
 
-            while(mask) {
-               cui32 bitIndex = (cui32)_tzcnt_u64(mask);
-               mask &= mask - 1ull;
-               cui32 chunkIndexValue = baseIndex + bitIndex;
-               if(chunkIndexValue < chunkCount) modCells[modCount++] = chunkIndexValue;
-            }
+   cui64 first = c * map.desc.chunkCells;
+   _MM_ForEachRun(payload, encoding, map.desc.chunkCells, [&map, first](cui32 begin, cui32 cells, const MAP_CELL_VALUE &value) {
+      _MM_FillCells(map, first + begin, cells, [&value](cui64) { return value; });
+   });
+}
 
-            map->chunkMod[qwordIndex + lane] ^= clearMask;
-         }
+// Stores chunk 'c' of a map in its 002u payload slot, encoded if that takes at most 1/MAP_PALETTE_RATIO of the slot, and
+// records the payload's size and encoding in 'entry'. An encoded chunk of a sparse map is copied as it is
+static void _MM_StoreChunk(const MAP &map, cui64 c, ui8ptrc slot, MAP_FILE_CHUNK &entry) {
+   cui32 chunkCells = map.desc.chunkCells;
+   cui32 chunkBytes = ui32(MapChunkBytes(chunkCells));
+
+   if(map.sparse) {
+      MAP_SPARSE &sparse  = *map.sparse;
+      bool        encoded = false;
+
+      SpinLockVia(SPIN_WAIT_POLICY, &sparse.lock);
+      const MAP_SPARSE_CHUNK &stored = sparse.chunk[c];
+      if(stored.encoding != mce_raw) {
+         Copy(stored.payload, slot, stored.bytes);
+         entry.bytes    = stored.bytes;
+         entry.encoding = stored.encoding;
+         encoded        = true;
       }
+      SpinUnlock(&sparse.lock);
+      if(encoded) return;
+   }
 
-      for(; qwordIndex < chunkQWords; qwordIndex++) {
-         ui64 mask = map->chunkMod[qwordIndex];
+   ui32  encoding;
+   cui32 bytes = _MM_EncodeCells([&map, c](cui32 i) { return ChunkCellValue(map, c, i); }, chunkCells, slot, chunkBytes / MAP_PALETTE_RATIO,
+                                 encoding);
+   if(bytes) {
+      entry.bytes    = bytes;
+      entry.encoding = encoding;
+      return;
+   }
+   _MM_WriteChunk(map, slot, c);
+   entry.bytes    = chunkBytes;
+   entry.encoding = mce_raw;
+}
 
-         if(!mask) continue;
+// Commits the pages of chunk 'c' of a map whose arrays are reserved (streamed or sparse). False, leaving none committed, if
+// the OS refuses
+static cbool _MM_CommitChunk(MAP &map, cui64 c) {
+   cui64 chunkCells = map.desc.chunkCells;
+   cui64 first      = c * chunkCells;
 
-         cui32 baseIndex = (ui32)(qwordIndex << 6);
-         if(baseIndex >= chunkCount) {
-            map->chunkMod[qwordIndex] = 0;
-            continue;
-         }
+   cbool dgs  = vcommitRange(map.pDGS, first * sizeof(CELL_DGS), chunkCells * sizeof(CELL_DGS));
+   cbool dps  = dgs && vcommitRange(map.pDPS, first * sizeof(CELL_DPS), chunkCells * sizeof(CELL_DPS));
+   cbool cell = dps && vcommitRange(CellStore(map), c * MapCellStoreBytes(map.desc.chunkCells), MapCellStoreBytes(map.desc.chunkCells));
 
-         cui32 remaining = chunkCount - baseIndex;
-         if(!remaining) {
-            map->chunkMod[qwordIndex] = 0;
-            continue;
-         }
+   if(!cell) {
+      if(dps) vdecommitRange(map.pDPS, first * sizeof(CELL_DPS), chunkCells * sizeof(CELL_DPS));
+      if(dgs) vdecommitRange(map.pDGS, first * sizeof(CELL_DGS), chunkCells * sizeof(CELL_DGS));
+   }
 
-         if(remaining < 64u) mask &= (ui64(1) << remaining) - 1ull;
-         if(!mask) continue;
+   return cell;
+}
 
-         ui64 clearMask = mask;
+static void _MM_DecommitChunk(MAP &map, cui64 c) {
+   cui64 chunkCells = map.desc.chunkCells;
+   cui64 first      = c * chunkCells;
 
-         while(mask) {
-            cui32 bitIndex = (cui32)_tzcnt_u64(mask);
-            mask &= mask - 1ull;
-            cui32 chunkIndexValue = baseIndex + bitIndex;
-            if(chunkIndexValue < chunkCount) modCells[modCount++] = chunkIndexValue;
-         }
+   vdecommitRange(CellStore(map), c * MapCellStoreBytes(map.desc.chunkCells), MapCellStoreBytes(map.desc.chunkCells));
+   vdecommitRange(map.pDPS, first * sizeof(CELL_DPS), chunkCells * sizeof(CELL_DPS));
+   vdecommitRange(map.pDGS, first * sizeof(CELL_DGS), chunkCells * sizeof(CELL_DGS));
+}
+
+// True if a sparse map's payload is an allocation of its own, not an entry of .value
+static cbool _MM_SparseOwned(const MAP_SPARSE &sparse, const ui8 *const payload) {
+   return payload < (const ui8 *)sparse.value || payload >= (const ui8 *)(sparse.value + MM_SPARSE_VALUES);
+}
+
+// Holds chunk 'c' of a sparse map encoded: a uniform value is shared through .value while it has room, any other payload is
+// copied. False if the copy cannot be allocated
+static cbool _MM_SparseStore(MAP &map, cui64 c, const ui8 *const payload, cui32 bytes, cui32 encoding) {
+   MAP_SPARSE &sparse = *map.sparse;
+   const ui8  *stored = NULL;
+
+   if(encoding == mce_uniform) {
+      const MAP_CELL_VALUE &value = *(const MAP_CELL_VALUE *)payload;
+      ui32                  v     = 0;
+
+      SpinLockVia(SPIN_WAIT_POLICY, &sparse.lock);
+      for(; v < sparse.values && !SameCellValue(value, sparse.value[v]); v++);
+      if(v == sparse.values && v < MM_SPARSE_VALUES) sparse.value[sparse.values++] = value;
+      if(v < sparse.values) stored = (const ui8 *)&sparse.value[v];
+      SpinUnlock(&sparse.lock);
+   }
+   if(!stored) {
+      ui8ptrc copy = (ui8ptr)malloc64(bytes);
+      if(!copy) return false;
+      Copy(payload, copy, bytes);
+      stored = copy;
+   }
+
+   sparse.chunk[c].payload  = stored;
+   sparse.chunk[c].bytes    = bytes;
+   sparse.chunk[c].encoding = encoding;
+#ifdef DATA_TRACKING
+   _InterlockedIncrement((vol long *)&sysData.sparse.encoded);
+   _InterlockedExchangeAdd64((vsi64ptr)&sysData.sparse.encodedBytes, si64(bytes));
+#endif
+   return true;
+}
+
+// Places chunk 'c' of a sparse map from its 002u payload: an encoded payload is held as it is, a raw one is encoded into
+// 'scratch' (MapChunkBytes / MAP_PALETTE_RATIO bytes) if it can be, else committed and copied. False if memory runs out
+static cbool _MM_SparsePlace(MAP &map, cui64 c, const ui8 *const payload, cui32 bytes, cui32 encoding, ui8ptrc scratch) {
+   if(encoding != mce_raw) return _MM_SparseStore(map, c, payload, bytes, encoding);
+
+   cui32                 chunkCells = map.desc.chunkCells;
+   const CELL_DGS *const dgs        = (const CELL_DGS *)payload;
+   const CELL_DPS *const dps        = (const CELL_DPS *)(payload + MapChunkDPSOffset(chunkCells));
+   const CELL     *const cell       = (const CELL *)(payload + MapChunkCellOffset(chunkCells));
+   ui32                  packed;
+   cui32                 packedBytes = _MM_EncodeCells([dgs, dps, cell](cui32 i) { return MapCellValue(dgs[i], dps[i], cell[i]); },
+                                                       chunkCells, scratch, ui32(MapChunkBytes(chunkCells) / MAP_PALETTE_RATIO), packed);
+
+   if(packedBytes) return _MM_SparseStore(map, c, scratch, packedBytes, packed);
+   if(!_MM_CommitChunk(map, c)) return false;
+   _MM_ReadChunk(map, payload, c);
+   _InterlockedIncrement((vol long *)&map.sparse->expanded);
+#ifdef DATA_TRACKING
+   _InterlockedIncrement((vol long *)&sysData.sparse.expanded);
+#endif
+   return true;
+}
+
+//-- Map creation (MAP_FILL_JOB)
+
+// The layer values of a new map: open (openElement, no density), surface (its element is set per cell, _MM_SurfaceElement)
+// and solid (solidElement)
+static void _MM_LayerValues(MAP_CELL_VALUE &open, MAP_CELL_VALUE &surface, MAP_CELL_VALUE &solid, cui8 openElement, cui8 solidElement,
+                            cui8 atlasIndex) {
+   MAP_CELL_VALUE cell = {};
+
+   cell.geometry.er  = { 255, 0, 0, 0 };
+   cell.geometry.end = { 0, 0, 0, 0 };
+   //cell.geometry.warp = 0.0f;
+   cell.pixel.pmc    = 1.0f;
+   cell.pixel.gtc    = 1.0f;
+   cell.pixel.gev    = 0.0f;
+   cell.pixel.ems    = 1.0f;
+   cell.pixel.nms    = 1.0f;
+   cell.pixel.rms    = 1.0f;
+   cell.pixel.pms    = 1.0f;
+   cell.pixel.ai     = atlasIndex;
+   cell.vel          = { 0.0f, 0.0f };
+   cell.temp         = 294.15f;
+   cell.rad          = 0.0f;
+   cell.elec         = 0.0f;
+
+   open = surface = solid = cell;
+   open.geometry.et      = { openElement, 0, 0, 0 };
+   open.geometry.dens    = 0.0f;
+   surface.geometry.dens = 1.0f;
+   solid.geometry.et     = { solidElement, 0, 0, 0 };
+   solid.geometry.dens   = 1.01f;
+}
+
+// Element of a surface cell: a test pattern of elements 1~4 in runs of 256 cells, in place of the solid element
+static cui8 _MM_SurfaceElement(cui64 cellIndex) {
+   return ui8(((cellIndex >> 8) & 0x03) + 1u);
+}
+
+// Writes cells [first, first + cells) of a map's storage (MAP::cell) from 'value', streaming it (MAP_CELL_LAYOUT::Fill)
+static void _MM_WriteCells(MAP &map, cui64 first, cui64 cells, const MAP_CELL_VALUE &value) {
+   MAP_CELL_LAYOUT::Fill(map.cell, map.pDGS, map.pDPS, map.desc.chunkCells, first, cells, value);
+}
+
+// Fills cells [first, first + cells) of a map with one value. Geometry and pixel data are streamed as 64-byte patterns of
+// four records (MEM_KERNELS::stream)
+static void _MM_FillValue(MAP &map, cui64 first, cui64 cells, const MAP_CELL_VALUE &value) {
+   al64 CELL_DGS geometry[4] = { value.geometry, value.geometry, value.geometry, value.geometry };
+   al64 CELL_DPS pixel[4]    = { value.pixel, value.pixel, value.pixel, value.pixel };
+
+   memKernels.stream(&map.pDGS[first], cells * sizeof(CELL_DGS), geometry);
+   memKernels.stream(&map.pDPS[first], cells * sizeof(CELL_DPS), pixel);
+   _MM_WriteCells(map, first, cells, value);
+}
+
+// Fills chunks [begin, end) of a new dense map, a layer or surface run at a time, and sets their chunkVis bits a qword at a
+// time. A job of CreateMap's ParallelFor; 'begin' is a multiple of MAP_FILL_GRAIN, so jobs share no chunkVis qword
+static void _MM_FillChunks(ptr jobData, cui64 begin, cui64 end) {
+   const MAP_FILL_JOB &job        = *(MAP_FILL_JOB *)jobData;
+   MAP                &map        = *job.map;
+   cui64               chunkCells = map.desc.chunkCells;
+   const auto          bound      = [begin, end](csi32 chunk) { return chunk < si64(begin) ? begin : chunk > si64(end) ? end : ui64(chunk); };
+   cui64               surfaceCh  = bound(job.surfaceChOS);
+   cui64               solidCh    = bound(job.solidChOS);
+
+   if(surfaceCh > begin) _MM_FillValue(map, begin * chunkCells, (surfaceCh - begin) * chunkCells, job.open);
+
+   MAP_CELL_VALUE surface = job.surface;
+   for(ui64 cell = surfaceCh * chunkCells, last = solidCh * chunkCells; cell < last;) {
+      cui64 runEnd = (cell | 0x0FF) + 1u;
+      cui64 cells  = (runEnd < last ? runEnd : last) - cell;
+
+      surface.geometry.et = { _MM_SurfaceElement(cell), 0, 0, 0 };
+      _MM_FillValue(map, cell, cells, surface);
+      cell += cells;
+   }
+
+   if(end > solidCh) _MM_FillValue(map, solidCh * chunkCells, (end - solidCh) * chunkCells, job.solid);
+
+   // Only the map's last qword can be partial
+   for(ui64 w = begin >> 6; w < (end + 63u) >> 6; w++) {
+      cui64 bits = end - (w << 6);
+      map.chunkVis[w] = bits >= 64u ? ~0ull : (ui64(1) << bits) - 1u;
+   }
+}
+
+//-- Chunk streaming (MAP_STREAM); "stream locked" functions are called with .lock held
 
-         map->chunkMod[qwordIndex] ^= clearMask;
+// Least recently used resident chunk not used within MM_STREAM_MIN_AGE ticks; MM_STREAM_NONE if none. Stream locked
+static cui32 _MM_StreamVictim(const MAP &map) {
+   const MAP_STREAM &stream = *map.stream;
+
+   if(stream.tick < MM_STREAM_MIN_AGE) return MM_STREAM_NONE;
+
+   ui64 oldest = stream.tick - MM_STREAM_MIN_AGE + 1u;
+   ui32 victim = MM_STREAM_NONE;
+   for(ui32 s = 0; s < stream.slots; s++) {
+      cui32 chunk = stream.slotChunk[s];
+      if(chunk != MM_STREAM_NONE && stream.state[chunk] == mcs_resident && stream.slotUse[s] < oldest) {
+         oldest = stream.slotUse[s];
+         victim = chunk;
       }
+   }
 
-      al32 si32 activeMaskBuf[8];
+   return victim;
+}
+
+// Gives an absent chunk a free slot and marks it loading; the caller then loads it (_MM_StreamLoad). Stream locked
+static void _MM_StreamClaim(MAP &map, cui32 chunk) {
+   MAP_STREAM &stream = *map.stream;
+   cui32       slot   = stream.freeSlot[--stream.freeSlots];
 
-      for(si32 chunkZ = chunkMinZ; chunkZ < chunkMaxZ; chunkZ++) {
-         cAVX8Df32 chunkZf = { .ymm = _mm256_set1_ps((fl32)chunkZ) };
+   stream.state[chunk]     = mcs_loading;
+   stream.chunkSlot[chunk] = slot;
+   stream.slotChunk[slot]  = chunk;
+   stream.slotUse[slot]    = stream.tick;
+}
 
-         for(si32 chunkY = chunkMinY; chunkY < chunkMaxY; chunkY++) {
-            cAVX8Df32 chunkYf = { .ymm = _mm256_set1_ps((fl32)chunkY) };
+// Marks a resident chunk as being evicted and hides it from culling, keeping its chunkVis bit in .visible; the caller then
+// evicts it (_MM_StreamEvict). Stream locked
+static void _MM_StreamRetire(MAP &map, cui32 chunk) {
+   MAP_STREAM &stream = *map.stream;
 
-            for(si32 chunkX = chunkMinX; chunkX < chunkMaxX; chunkX += 8) {
-               cSSE4Ds32 chunkBase = { .vector = { chunkX, chunkY, chunkZ, 0 } };
-               cui8      visible   = camMan.ChunkFrustumIntersect8(chunkBase, 0);
+   stream.state[chunk] = mcs_evicting;
+   stream.retiring++;
+   if(ATOMIC_BITSET(map.chunkVis, map.desc.mapChunks).Reset(chunk)) ATOMIC_BITSET(stream.visible, map.desc.mapChunks).Set(chunk);
+   ATOMIC_BITSET(map.chunkMod, map.desc.mapChunks).Reset(chunk);
+}
 
-               if(!visible) continue;
+// Returns a chunk's slot to the free stack and marks the chunk absent. Stream locked
+static void _MM_StreamFree(MAP &map, cui32 chunk) {
+   MAP_STREAM &stream = *map.stream;
+   cui32       slot   = stream.chunkSlot[chunk];
 
-               AVX8Ds32 chunkXVec = { .ymm = _mm256_add_epi32(_mm256_set1_epi32(chunkX), laneOffsets.ymm) };
-               AVX8Ds32 rangeMask = { .ymm = _mm256_cmpgt_epi32(_mm256_set1_epi32(chunkMaxX), chunkXVec.ymm) };
-               AVX8Ds32 visibleVec = { .ymm = _mm256_srlv_epi32(_mm256_set1_epi32(visible), laneOffsets.ymm) };
-               visibleVec.ymm = _mm256_and_si256(visibleVec.ymm, ones.ymm);
-               visibleVec.ymm = _mm256_cmpeq_epi32(visibleVec.ymm, ones.ymm);
-               AVX8Ds32 activeMask = { .ymm = _mm256_and_si256(rangeMask.ymm, visibleVec.ymm) };
+   stream.state[chunk]     = mcs_absent;
+   stream.chunkSlot[chunk] = MM_STREAM_NONE;
+   stream.slotChunk[slot]  = MM_STREAM_NONE;
+   stream.freeSlot[stream.freeSlots++] = slot;
+}
 
-               if(_mm256_testz_si256(activeMask.ymm, activeMask.ymm)) continue;
+// Commits a loading chunk's pages and copies it from the file, then shows it to culling and marks it for upload (chunkMod).
+// On failure the chunk is absent again
+static cbool _MM_StreamLoad(MAP &map, cui32 chunk) {
+   MAP_STREAM &stream    = *map.stream;
+   cbool       committed = _MM_CommitChunk(map, chunk);
 
-               AVX8Df32 chunkXf  = { .ymm = _mm256_cvtepi32_ps(chunkXVec.ymm) };
-               AVX8Df32 diffX    = { .ymm = _mm256_sub_ps(chunkXf.ymm, camPosX.ymm) };
-               AVX8Df32 diffY    = { .ymm = _mm256_sub_ps(chunkYf.ymm, camPosY.ymm) };
-               AVX8Df32 diffZ    = { .ymm = _mm256_sub_ps(chunkZf.ymm, camPosZ.ymm) };
-               AVX8Df32 distSq   = { .ymm = _mm256_mul_ps(diffX.ymm, diffX.ymm) };
-               distSq.ymm = _mm256_fmadd_ps(diffY.ymm, diffY.ymm, distSq.ymm);
-               distSq.ymm = _mm256_fmadd_ps(diffZ.ymm, diffZ.ymm, distSq.ymm);
-               AVX8Df32 distance = { .ymm = _mm256_sqrt_ps(distSq.ymm) };
-               AVX8Ds32 distanceMask = { .ymm = _mm256_castps_si256(_mm256_cmp_ps(distance.ymm, zeroF.ymm, _CMP_GE_OQ)) };
+   if(committed) _MM_DecodeChunk(map, stream.file.data + stream.table[chunk].offset, stream.table[chunk].encoding, chunk);
 
-               activeMask.ymm = _mm256_and_si256(activeMask.ymm, distanceMask.ymm);
+   SpinLockVia(SPIN_WAIT_POLICY, &stream.lock);
+   if(committed) stream.state[chunk] = mcs_resident;
+   else _MM_StreamFree(map, chunk);
+   SpinUnlock(&stream.lock);
+   if(!committed) return false;
 
-               if(_mm256_testz_si256(activeMask.ymm, activeMask.ymm)) continue;
+   if(ATOMIC_BITSET(stream.visible, map.desc.mapChunks).Reset(chunk)) ATOMIC_BITSET(map.chunkVis, map.desc.mapChunks).Set(chunk);
+   ATOMIC_BITSET(map.chunkMod, map.desc.mapChunks).Set(chunk);
+#ifdef DATA_TRACKING
+   _InterlockedIncrement((vol long *)&sysData.streaming.resident);
+#endif
+   return true;
+}
 
-               _mm256_store_si256((__m256i *)activeMaskBuf, activeMask.ymm);
+// Writes an evicting chunk back to the file if it was modified (re-encoding it, _MM_StoreChunk), decommits its pages and
+// frees its slot
+static void _MM_StreamEvict(MAP &map, cui32 chunk) {
+   MAP_STREAM &stream = *map.stream;
 
-               for(ui32 lane = 0; lane < 8; lane++) {
-                  if(!activeMaskBuf[lane]) continue;
+   if(ATOMIC_BITSET(stream.dirty, map.desc.mapChunks).Reset(chunk)) {
+      _MM_StoreChunk(map, chunk, stream.file.data + stream.table[chunk].offset, stream.table[chunk]);
+#ifdef DATA_TRACKING
+      _InterlockedIncrement64((vsi64ptr)&sysData.streaming.writeBacks);
+#endif
+   }
+   _MM_DecommitChunk(map, chunk);
+
+   SpinLockVia(SPIN_WAIT_POLICY, &stream.lock);
+   _MM_StreamFree(map, chunk);
+   stream.retiring--;
+   SpinUnlock(&stream.lock);
+#ifdef DATA_TRACKING
+   _InterlockedIncrement64((vsi64ptr)&sysData.streaming.evictions);
+   _InterlockedDecrement((vol long *)&sysData.streaming.resident);
+#endif
+}
 
-                  VEC3Ds32 laneCoord = { ._si32 = { chunkXVec._si32[lane], chunkY, chunkZ } };
-                  cui32    chunkIndexUnsigned = mapMan.CalcChunkIndex((cVEC3Ds32 &)laneCoord, 0, 0);
-                  if(chunkIndexUnsigned == 0x080000001u || chunkIndexUnsigned >= chunkCount) continue;
+// StreamUpdate's prefetch: loads claimed chunks [begin, end)
+static void _MM_StreamLoadJob(ptr mapData, cui64 begin, cui64 end) {
+   for(ui64 c = begin; c < end; c++) _MM_StreamLoad(*(MAP *)mapData, ui32(c));
+}
 
-                  cui32 qwordOS = chunkIndexUnsigned >> 6;
-                  cui64 bitOS   = ui64(0x01) << (chunkIndexUnsigned & 0x03F);
+// StreamUpdate's eviction: evicts retired chunks [begin, end)
+static void _MM_StreamEvictJob(ptr mapData, cui64 begin, cui64 end) {
+   for(ui64 c = begin; c < end; c++) _MM_StreamEvict(*(MAP *)mapData, ui32(c));
+}
 
-                  if(map->chunkVis[qwordOS] & bitOS) {
-//                     if(distance < 128.0f)
-                        nearCells[nearCount++] = chunkIndexUnsigned;
-//                   else if(distance < 512.0f)
-//                      medCells[medCount++] = chunkIndexUnsigned;
-//                   else if(distance < 2048.0f)
-//                      farCells[farCount++] = chunkIndexUnsigned;
-                  }
-               }
+// Publishes the back set. A set the renderer skipped comes back as the new back set; its modified chunks were never uploaded,
+// so they are marked again for the next pass
+static void _MM_Publish(cMAPptrc map, VIS_RESULTS &results) {
+   VIS_SET *const skipped = results.Publish();
+
+   if(!skipped) return;
+
+   ATOMIC_BITSET chunkMod(map->chunkMod, map->desc.mapChunks);
+   for(ui32 i = 0; i < skipped->modCount; i++) chunkMod.Set(skipped->mod[i]);
+   skipped->modCount = 0;
+}
+
+#if !defined(USE_OLD_CODE)
+// Culls slabs [begin, end) of a MAPMAN_CULL_SLABS: collects and clears the slab's modified chunks, then collects the visible
+// chunks of its rows. A job of _MM_Cull_Pass's ParallelFor; slabs share no output and no chunkMod qword
+static void _MM_Cull_Slab(ptr slabData, cui64 begin, cui64 end) {
+   CLASS_CAM    &camMan = *(CLASS_CAM *)ptrLib[5];
+   CLASS_MAPMAN &mapMan = *(CLASS_MAPMAN *)ptrLib[6];
+
+   MAPMAN_CULL_SLABS    &slabs  = *(MAPMAN_CULL_SLABS *)slabData;
+   MAP                  *map    = slabs.map;
+   const CAMERA_DATAf32 &camera = *slabs.camera;
+
+   cSSE4Ds32 mapChunksH = { .vector = { map->desc.chunkCount.x >> 1, map->desc.chunkCount.y >> 1, (map->desc.chunkCount.z + 1) >> 1, 1 } };
+   cSSE4Ds32 mapChunksL = { .vector = { mapChunksH.vector.x - map->desc.chunkCount.x, mapChunksH.vector.y - map->desc.chunkCount.y,
+                                        mapChunksH.vector.z - map->desc.chunkCount.z, 1 } };
+
+   cui32 chunkCount  = map->desc.mapChunks;
+   cui32 rowChunks   = map->desc.chunkCount.x;
+   cui32 rowsY       = map->desc.chunkCount.y;
+   cui32 rows        = rowsY * map->desc.chunkCount.z;
+   cui64 chunkQWords = (chunkCount + 63u) >> 6;
+
+   const ATOMIC_BITSET chunkVis(map->chunkVis, chunkCount);
+
+   cAVX8Ds32 laneOffsets = { .vector = { 0, 1, 2, 3, 4, 5, 6, 7 } };
+   cAVX8Ds32 ones        = { .vector = { 1, 1, 1, 1, 1, 1, 1, 1 } };
+
+   csi32 chunkMinX = mapChunksL.vector.x;
+   csi32 chunkMinY = mapChunksL.vector.y;
+   csi32 chunkMinZ = mapChunksL.vector.z;
+   csi32 chunkMaxX = mapChunksH.vector.x;
+
+   al32 si32 activeMaskBuf[8];
+
+   for(ui64 slab = begin; slab < end; slab++) {
+      cui64 qwordBegin = slab * slabs.qwordsPerSlab < chunkQWords ? slab * slabs.qwordsPerSlab : chunkQWords;
+      cui64 qwordEnd   = qwordBegin + slabs.qwordsPerSlab < chunkQWords ? qwordBegin + slabs.qwordsPerSlab : chunkQWords;
+      cui32 rowBegin   = ui32(slab) * slabs.rowsPerSlab < rows ? ui32(slab) * slabs.rowsPerSlab : rows;
+      cui32 rowEnd     = rowBegin + slabs.rowsPerSlab < rows ? rowBegin + slabs.rowsPerSlab : rows;
+
+      ui32ptrc modCells  = &slabs.mod[qwordBegin << 6];
+      ui32ptrc nearCells = &slabs.vis[ui64(rowBegin) * rowChunks];
+
+      // Exchange-and-clear per word: a chunk marked by an editing thread mid-scan is taken now or by the next pass
+      cui64 modCount  = ATOMIC_BITSET(map->chunkMod, chunkCount).Drain(qwordBegin, qwordEnd, modCells);
+      ui64  nearCount = 0;
+
+      for(ui32 row = rowBegin; row < rowEnd; row++) {
+         csi32     chunkY  = chunkMinY + si32(row % rowsY);
+         csi32     chunkZ  = chunkMinZ + si32(row / rowsY);
+
+         for(si32 chunkX = chunkMinX; chunkX < chunkMaxX; chunkX += 8) {
+            cSSE4Ds32 chunkBase = { .vector = { chunkX, chunkY, chunkZ, 0 } };
+            cui8      visible   = camMan.ChunkFrustumIntersect8(chunkBase, camera);
+
+            if(!visible) continue;
+
+            AVX8Ds32 chunkXVec = { .ymm = _mm256_add_epi32(_mm256_set1_epi32(chunkX), laneOffsets.ymm) };
+            AVX8Ds32 rangeMask = { .ymm = _mm256_cmpgt_epi32(_mm256_set1_epi32(chunkMaxX), chunkXVec.ymm) };
+            AVX8Ds32 visibleVec = { .ymm = _mm256_srlv_epi32(_mm256_set1_epi32(visible), laneOffsets.ymm) };
+            visibleVec.ymm = _mm256_and_si256(visibleVec.ymm, ones.ymm);
+            visibleVec.ymm = _mm256_cmpeq_epi32(visibleVec.ymm, ones.ymm);
+            AVX8Ds32 activeMask = { .ymm = _mm256_and_si256(rangeMask.ymm, visibleVec.ymm) };
+
+            if(_mm256_testz_si256(activeMask.ymm, activeMask.ymm)) continue;
+
+            _mm256_store_si256((ui256 *)activeMaskBuf, activeMask.ymm);
+
+            for(ui32 lane = 0; lane < 8; lane++) {
+               if(!activeMaskBuf[lane]) continue;
+
+               VEC3Ds32 laneCoord = { ._si32 = { chunkXVec._si32[lane], chunkY, chunkZ } };
+               cui32    chunkIndexUnsigned = mapMan.CalcChunkIndex((cVEC3Ds32 &)laneCoord, 0, 0);
+               if(chunkIndexUnsigned == 0x080000001u || chunkIndexUnsigned >= chunkCount) continue;
+
+               // Change to L.O.D. lists (distance < 128.0f, 512.0f, 2048.0f) once the renderer draws them
+               if(chunkVis.Test(chunkIndexUnsigned)) nearCells[nearCount++] = chunkIndexUnsigned;
             }
          }
       }
 
-      MAPMAN_THREAD_STATUS.m128i_u64[0] = (medCount << 34) | (nearCount << 4) | 0x0C;
-      MAPMAN_THREAD_STATUS.m128i_u64[1] = (modCount << 30) | farCount;
+      slabs.modCount[slab] = (ui32)modCount;
+      slabs.visCount[slab] = (ui32)nearCount;
+   }
+}
+
+// One culling pass; run by the persistent cull thread, or as a job (Cull() cm_job). The map is split into slabs, culled
+// in parallel by the job system and joined in slab order
+static void _MM_Cull_Pass(ptr threadData, cui64, cui64) {
+   static si64 frequencyTics, startTics, endTics;
+   QueryPerformanceFrequency((LARGE_INTEGER *)&frequencyTics);
+
+   CLASS_CAM    &camMan = *(CLASS_CAM *)ptrLib[5];
+   CLASS_MAPMAN &mapMan = *(CLASS_MAPMAN *)ptrLib[6];
+
+   cMMTDcptrc         dataVis = (cMMTDcptrc)threadData;
+   MAP               *map     = dataVis->map;
+   VIS_RESULTS       &results = *dataVis->results;
+   VIS_SET           &set     = results.Back();
+   MAPMAN_CULL_SLABS &slabs   = mapMan.cullSlabs;
+
+   cui32 chunkCount  = map->desc.mapChunks;
+   cui32 rowChunks   = map->desc.chunkCount.x;
+   cui32 rows        = ui32(map->desc.chunkCount.y) * map->desc.chunkCount.z;
+   cui32 chunkQWords = (chunkCount + 63u) >> 6;
+
+   ui64 modCount, nearCount, medCount, farCount;
+
+   QueryPerformanceCounter((LARGE_INTEGER *)&startTics);
+
+   CAMERA_SNAPSHOT camera;
+   camMan.ReadSnapshot(camera, 0);   // Never torn by a concurrent TransformCamera
+   camMan.SetDimsf(map->desc.chunkDim, map->desc.chunkCount, camera.data);
+
+   // Slab output regions; grown to the largest map culled
+   if(slabs.capacity < chunkQWords << 6) {
+      mfree(slabs.vis, slabs.mod);
+      slabs.capacity = chunkQWords << 6;
+      slabs.vis      = zalloc1d16(ui32, slabs.capacity);
+      slabs.mod      = zalloc1d16(ui32, slabs.capacity);
+   }
+
+   ui32 slabCount = (jobSystem.workers + 1u) * MM_CULL_SLABS_PER_WORKER;
+   if(slabCount > MM_CULL_MAX_SLABS)                slabCount = MM_CULL_MAX_SLABS;
+   if(slabCount > chunkCount / MM_CULL_SLAB_CHUNKS) slabCount = chunkCount / MM_CULL_SLAB_CHUNKS;
+   if(slabCount > rows)                             slabCount = rows;
+   if(!slabCount)                                   slabCount = 1u;
+
+   slabs.map           = map;
+   slabs.camera        = &camera.data;
+   slabs.slabs         = slabCount;
+   slabs.rowsPerSlab   = (rows + slabCount - 1u) / slabCount;
+   slabs.qwordsPerSlab = (chunkQWords + slabCount - 1u) / slabCount;
+
+   if(slabCount == 1u) _MM_Cull_Slab(&slabs, 0, 1u);
+   else {
+      JOB_COUNTER counter;
+      jobSystem.ParallelFor(slabCount, 1u, _MM_Cull_Slab, &slabs, counter);
+      jobSystem.Wait(counter);
+   }
+
+   // Join the slabs' regions in slab order. Trailing slabs may start past the end of the map; they found nothing
+   nearCount = medCount = farCount = modCount = 0;
+   for(ui32 i = 0; i < slabCount; i++) {
+      if(slabs.modCount[i]) memcpy(&set.mod[modCount],      &slabs.mod[ui64(i * slabs.qwordsPerSlab) << 6],      sizeof(ui32) * slabs.modCount[i]);
+      if(slabs.visCount[i]) memcpy(&set.list[0][nearCount], &slabs.vis[ui64(i * slabs.rowsPerSlab) * rowChunks], sizeof(ui32) * slabs.visCount[i]);
+      modCount  += slabs.modCount[i];
+      nearCount += slabs.visCount[i];
+   }
+
+   set.count[0]  = (ui32)nearCount;
+   set.count[1]  = (ui32)medCount;
+   set.count[2]  = (ui32)farCount;
+   set.modCount  = (ui32)modCount;
+   set.cameraSeq = camera.seq;
+   _MM_Publish(map, results);
+
+   MAPMAN_THREAD_STATUS.m128i_u8[0] &= 0x0FC;
+
+   QueryPerformanceCounter((LARGE_INTEGER *)&endTics);
+   sysData.culling.map.time   = double(endTics - startTics) / double(frequencyTics) * 1000.0;
+   sysData.culling.map.mod    = (ui32)modCount;
+   sysData.culling.map.vis[0] = (ui32)nearCount;
+   sysData.culling.map.vis[1] = (ui32)medCount;
+   sysData.culling.map.vis[2] = (ui32)farCount;
+}
+
+static void _MM_Cull_Nonvisible_and_Unchanged(ptr threadData) {
+   MAPMAN_THREAD_STATUS.m128i_u8[0] |= 0x0C;
+
+   do {
+      while(!(MAPMAN_THREAD_STATUS.m128i_u8[0] & 0x03)) _mm_pause(); ///== Change to new spinlock
 
-      QueryPerformanceCounter((LARGE_INTEGER *)&endTics);
-      sysData.culling.map.time   = double(endTics - startTics) / double(frequencyTics) * 1000.0;
-      sysData.culling.map.mod    = (ui32)modCount;
-      sysData.culling.map.vis[0] = (ui32)nearCount;
-      sysData.culling.map.vis[1] = (ui32)medCount;
-      sysData.culling.map.vis[2] = (ui32)farCount;
+      _MM_Cull_Pass(threadData, 0, 0);
    } while(MAPMAN_THREAD_STATUS.m128i_u64[0] & 0x0C);
 }
 #else
-static void _MM_Cull_Nonvisible_and_Unchanged(ptr threadData) {
-      static si64 frequencyTics, startTics, endTics;
-      QueryPerformanceFrequency((LARGE_INTEGER *)&frequencyTics);
+// One culling pass; run by the persistent cull thread, or as a job (Cull() cm_job)
+static void _MM_Cull_Pass(ptr threadData, cui64, cui64) {
+   static si64 frequencyTics, startTics, endTics;
+   QueryPerformanceFrequency((LARGE_INTEGER *)&frequencyTics);
 
    CLASS_CAM    &camMan = *(CLASS_CAM *)ptrLib[5];
    CLASS_MAPMAN &mapMan = *(CLASS_MAPMAN *)ptrLib[6];
 
-   cMMTDcptrc  data[2] = { (cMMTDcptrc)threadData, (cMMTDcptrc)threadData + 1 };
-   MAP        *map     = data[0]->map;
+   cMMTDcptrc   data    = (cMMTDcptrc)threadData;
+   MAP         *map     = data->map;
+   VIS_RESULTS &results = *data->results;
+   VIS_SET     &set     = results.Back();
 
    cSSE4Ds32 mapChunksH = { .vector = { map->desc.chunkCount.x >> 1, map->desc.chunkCount.y >> 1, (map->desc.chunkCount.z + 1) >> 1, 1 } };
    cSSE4Ds32 mapChunksL = { .vector = { mapChunksH.vector.x - map->desc.chunkCount.x, mapChunksH.vector.y - map->desc.chunkCount.y,
@@ -1358,72 +2509,84 @@ static void _MM_Cull_Nonvisible_and_Unchanged(ptr threadData) {
    cui32 chunkCount = map->desc.mapChunks;
 
    SSE4Ds32 chunkOS   = {};
-   ui32ptrc nearCells = data[0]->chunkVis[0];
-   ui32ptrc medCells  = data[0]->chunkVis[1];
-   ui32ptrc farCells  = data[0]->chunkVis[2];
-   ui32ptrc modCells  = data[1]->chunkMod;
+   ui32ptrc nearCells = set.list[0];
+   ui32ptrc medCells  = set.list[1];
+   ui32ptrc farCells  = set.list[2];
+   ui32ptrc modCells  = set.mod;
 
    ui64 modCount, nearCount, medCount, farCount;
    ui32 i;
 
-   MAPMAN_THREAD_STATUS.m128i_u8[0] |= 0x0C;
-
-   do {
-      ///- Stall/skip? if status if 'busy'
-      while(!(MAPMAN_THREAD_STATUS.m128i_u8[0] & 0x03)) _mm_pause(); //Sleep(1);
-
-      QueryPerformanceCounter((LARGE_INTEGER *)&startTics);
-
-      camMan.SetDimsf(map->desc.chunkDim, map->desc.chunkCount, 0);
+   QueryPerformanceCounter((LARGE_INTEGER *)&startTics);
 
-      nearCount = medCount = farCount = 0;
-      modCount = 0;
-
-      for(i = 0; i < chunkCount; i++) {
-         cui64 bitOS   = (ui64)0x01 << (i & 0x03F);
-         cui32 qwordOS = i >> 6;
+   CAMERA_SNAPSHOT camera;
+   camMan.ReadSnapshot(camera, 0);
+   camMan.SetDimsf(map->desc.chunkDim, map->desc.chunkCount, camera.data);
 
-         if(map->chunkMod[qwordOS] & bitOS) { modCells[modCount++] = i;   map->chunkMod[qwordOS] ^= bitOS; }
-      }
+   nearCount = medCount = farCount = 0;
+   modCount = 0;
 
-      // Calculate each chunk's distance-to-camera and reject out-of-view chunks
-      // Sort nearest-to-furthest into L.O.D. lists for input assembler
-      for(chunkOS.vector.z = mapChunksL.vector.z; chunkOS.vector.z < mapChunksH.vector.z; chunkOS.vector.z++) {
-         for(chunkOS.vector.y = mapChunksL.vector.y; chunkOS.vector.y < mapChunksH.vector.y; chunkOS.vector.y++) {
-            for(chunkOS.vector.x = mapChunksL.vector.x; chunkOS.vector.x < mapChunksH.vector.x;) {
-               cui8 visible = camMan.ChunkFrustumIntersect8(chunkOS, 0);
+   for(i = 0; i < chunkCount; i++) {
+      cui64 bitOS   = (ui64)0x01 << (i & 0x03F);
+      cui32 qwordOS = i >> 6;
 
-               for(i = 0; i < 8; i++, chunkOS.vector.x++)
-                  if(visible & (0x01 << i)) {
-                     csi32 chunkIndex = mapMan.CalcChunkIndex((cVEC3Ds32 &)chunkOS, 0, 0);
-                     cui32 QWordOS    = chunkIndex >> 6;
-                     cui64 bitOS      = (ui64)0x01 << (chunkIndex & 0x03F);
+      if(map->chunkMod[qwordOS] & bitOS) { modCells[modCount++] = i;   map->chunkMod[qwordOS] ^= bitOS; }
+   }
 
-                     cfl32 distance = camMan.DistanceFromCamera(chunkOS.xmm, 0);
-                     // Change hard limits to LOD scalars
-                     if(map->chunkVis[QWordOS] & bitOS) {
+   // Calculate each chunk's distance-to-camera and reject out-of-view chunks
+   // Sort nearest-to-furthest into L.O.D. lists for input assembler
+   for(chunkOS.vector.z = mapChunksL.vector.z; chunkOS.vector.z < mapChunksH.vector.z; chunkOS.vector.z++) {
+      for(chunkOS.vector.y = mapChunksL.vector.y; chunkOS.vector.y < mapChunksH.vector.y; chunkOS.vector.y++) {
+         for(chunkOS.vector.x = mapChunksL.vector.x; chunkOS.vector.x < mapChunksH.vector.x;) {
+            cui8 visible = camMan.ChunkFrustumIntersect8(chunkOS, camera.data);
+
+            for(i = 0; i < 8; i++, chunkOS.vector.x++)
+               if(visible & (0x01 << i)) {
+                  csi32 chunkIndex = mapMan.CalcChunkIndex((cVEC3Ds32 &)chunkOS, 0, 0);
+                  cui32 QWordOS    = chunkIndex >> 6;
+                  cui64 bitOS      = (ui64)0x01 << (chunkIndex & 0x03F);
+
+                  cfl32 distance = camMan.DistanceFromCamera(chunkOS.xmm, camera.data);
+                  // Change hard limits to LOD scalars
+                  if(map->chunkVis[QWordOS] & bitOS) {
 //                        if(distance < 128.0f)
-                           nearCells[nearCount++] = chunkIndex;
+                        nearCells[nearCount++] = chunkIndex;
 //                        else if(distance < 512.0f)
 //                           medCells[medCount++] = chunkIndex;
 //                        else if(distance < 2048.0f)
 //                           farCells[farCount++] = chunkIndex;
-                     }
                   }
-            }
+               }
          }
       }
+   }
+
+   set.count[0]  = (ui32)nearCount;
+   set.count[1]  = (ui32)medCount;
+   set.count[2]  = (ui32)farCount;
+   set.modCount  = (ui32)modCount;
+   set.cameraSeq = camera.seq;
+   _MM_Publish(map, results);
+
+   MAPMAN_THREAD_STATUS.m128i_u8[0] &= 0x0FC;
+
+   ///- Telemetry tracking. Rewrite to be optional.
+   QueryPerformanceCounter((LARGE_INTEGER *)&endTics);
+   sysData.culling.map.time   = double(endTics - startTics) / double(frequencyTics) * 1000.0;
+   sysData.culling.map.mod    = (ui32)modCount;
+   sysData.culling.map.vis[0] = (ui32)nearCount;
+   sysData.culling.map.vis[1] = (ui32)medCount;
+   sysData.culling.map.vis[2] = (ui32)farCount;
+}
 
-      MAPMAN_THREAD_STATUS.m128i_u64[0] = (medCount << 34) | (nearCount << 4) | 0x0C;
-      MAPMAN_THREAD_STATUS.m128i_u64[1] = (modCount << 30) | farCount;
+static void _MM_Cull_Nonvisible_and_Unchanged(ptr threadData) {
+   MAPMAN_THREAD_STATUS.m128i_u8[0] |= 0x0C;
+
+   do {
+      ///- Stall/skip? if status if 'busy'
+      while(!(MAPMAN_THREAD_STATUS.m128i_u8[0] & 0x03)) _mm_pause(); //Sleep(1);
 
-      ///- Telemetry tracking. Rewrite to be optional.
-      QueryPerformanceCounter((LARGE_INTEGER *)&endTics);
-      sysData.culling.map.time   = double(endTics - startTics) / double(frequencyTics) * 1000.0;
-      sysData.culling.map.mod    = (ui32)modCount;
-      sysData.culling.map.vis[0] = (ui32)nearCount;
-      sysData.culling.map.vis[1] = (ui32)medCount;
-      sysData.culling.map.vis[2] = (ui32)farCount;
+      _MM_Cull_Pass(threadData, 0, 0);
    } while(MAPMAN_THREAD_STATUS.m128i_u64[0] & 0x0C);
 }
 #endif
@@ -1,16 +1,25 @@
 /************************************************************
  * File: Command queue.h                Created: 2022/11/20 *
- *                                Last modified: 2022/11/20 *
+ *                                Last modified: 2026/10/17 *
  *                                                          *
- * Desc:                                                    *
+ * Desc: Bounded lock-free MPMC command queue.              *
  *                                                          *
  *  Copyright (c) David William Bull. All rights reserved.  *
  ************************************************************/
 #pragma once
 
+#include <windows.h>
+#include <intrin.h>
 #include "typedefs.h"
+#include "memory management.h"
 #include "Data structures.h"
 
+#pragma comment(lib, "Synchronization.lib")
+#pragma intrinsic(_InterlockedCompareExchange64)
+
+constexpr cui32 CMD_QUEUE_DEFAULT = 256u;   // Default capacity (entries); rounded up to a power of two
+constexpr cui32 CMD_WAIT_SPINS    = 128u;   // Empty polls before WaitForCommands() sleeps
+
 //-- CMDENTRY.cmd combinable commands
 // cmd[0] entries
 #define CMD_NULL    0x000L
@@ -29,7 +38,10 @@
 // cmd[2] entries
 #define PAR_VID_BUF 0x001L // Buffer
 #define PAR_VID_SHA 0x002L // Shader
-// cmd[3] entries
+// cmd[3] entries: simulation edits (cmd[0] == CMD_UPDATE), applied by the world-generation thread
+#define PAR_SIM_GEV 0x001L // Add p2_fl32[0] to cell p_si32's pixel .gev
+#define PAR_SIM_DEN 0x002L // Add p3_fl32[0] to the quad-cell density at { p_si32, p2_si32[0], p2_si32[1] } (ModQuadCellDensity)
+#define PAR_SIM_ELE 0x004L // Set cell p_si32's geometry element (.et.x) to p2_ui8[0]
 
 //-- CMDENTRY.cmd combinable commands
 
@@ -50,6 +62,7 @@ al16 struct COMMAND_ENTRY {   // 24 bytes
       si64 p_si64;
       ui32 p2_ui32[2];
       si32 p2_si32[2];
+      fl32 p2_fl32[2];
       ui16 p2_ui16[4];
       si16 p2_si16[4];
       ui8  p2_ui8[8];
@@ -61,6 +74,7 @@ al16 struct COMMAND_ENTRY {   // 24 bytes
       si64 p2_si64;
       ui32 p3_ui32[2];
       si32 p3_si32[2];
+      fl32 p3_fl32[2];
       ui16 p3_ui16[4];
       si16 p3_si16[4];
       ui8  p3_ui8[8];
@@ -68,28 +82,146 @@ al16 struct COMMAND_ENTRY {   // 24 bytes
    };
 };
 
-extern inline si32 LocalProcessing(COMMAND_ENTRY *command);
+// Applies one command taken by ProcessCommands(); defined by the consuming thread (WorldGen threads.cpp)
+si32 LocalProcessing(COMMAND_ENTRY *command);
+
+// Queue slot; 'seq' == position when free for that lap, position + 1 once published
+al16 struct COMMAND_SLOT {
+   vui64         seq;
+   COMMAND_ENTRY entry;
+};
+
+// Inter-thread command manager: bounded multi-producer/multi-consumer queue (per-slot sequence numbers).
+// Any thread may add or take; an entry is copied in whole before its slot is published, so it is never seen torn
+al64 struct COMMAND_MANAGER {
+   COMMAND_SLOT *slot;
+   ui64          mask;
+
+   al64 vui64 enqueuePos = 0;
+   al64 vui64 dequeuePos = 0;
+   al64 vui32 signal     = 0;   // Bumped per add and by Close(); WaitForCommands() sleeps on it
+        vui32 waiters    = 0;
+        vui32 closed     = 0;   // Set by Close(); WaitForCommands() no longer sleeps
+
+   /// @param capacity  Entries; rounded up to a power of two (minimum 2).
+   COMMAND_MANAGER(ui32 capacity = CMD_QUEUE_DEFAULT) {
+      capacity = capacity < 2u ? 2u : 1u << (32u - _lzcnt_u32(capacity - 1u));
+      slot = (COMMAND_SLOT *)zalloc64(sizeof(COMMAND_SLOT) * capacity);
+      mask = capacity - 1u;
+      for(ui64 i = 0; i < capacity; i++) slot[i].seq = i;
+   }
+
+   ~COMMAND_MANAGER() { mfree(slot); }
+
+   inline cui32 Capacity() const { return ui32(mask + 1u); }
 
-// Inter-thread command manager
-al32 struct COMMAND_MANAGER {
-   COMMAND_ENTRY queue[64] {};   // 1,024 bytes
-   vsi8          nextAvailable = 0, nextToProcess = 0;
+   /// Adds a batch of commands, all or none; the batch occupies consecutive positions.
+   /// @return count on success; -1 if fewer than 'count' slots are free (retry after the consumer catches up).
+   /// @note A batch larger than Capacity() never fits.
+   inline si32 AddCommands(const COMMAND_ENTRY *commands, cui32 count) {
+      if(!count) return 0;
+      if(count > Capacity()) return -1;
 
-   // Add commands in reverse order for bulk processing
-   inline si8 AddCommands(COMMAND_ENTRY *commands, ui8 count) {
-      si8 siTemp = (nextAvailable + 1) & 0x03F;
-      for(si8 i = (count << 1) - 1; i > -1; i -= 2, siTemp++) {
-         if(siTemp == nextToProcess) return -1; // Check for sufficient slots
-         ((ui64 *)queue)[siTemp + i] = ((ui64 *)commands)[i];
-         ((ui64 *)queue)[siTemp + i - 1] = ((ui64 *)commands)[i - 1];
+      ui64 pos;
+      ui32 i;
+
+      for(;;) {
+         pos = enqueuePos;
+
+         // Every slot must already be free for this lap; a slot still held by a slow consumer means 'full'
+         for(i = 0; i < count && slot[(pos + i) & mask].seq == pos + i; i++);
+         if(i < count) {
+            if(slot[(pos + i) & mask].seq < pos + i) return -1;
+            continue;   // Another producer moved past 'pos'
+         }
+         if(ui64(_InterlockedCompareExchange64((vsi64ptr)&enqueuePos, si64(pos + count), si64(pos))) == pos) break;
+      }
+
+      for(i = 0; i < count; i++) {
+         COMMAND_SLOT &s = slot[(pos + i) & mask];
+
+         s.entry = commands[i];
+         s.seq   = pos + i + 1u;   // Release: publishes the entry
       }
-      return (nextAvailable = siTemp);
+
+      _InterlockedIncrement((vol long *)&signal);
+      if(waiters) WakeByAddressAll((ptr)&signal);
+
+      return si32(count);
    }
 
-   inline si8 ProcessCommands() {
-      si8 siTemp;
-      for(siTemp = nextToProcess; queue[siTemp].cmd[0]; siTemp = (siTemp + 1) & 0x03F) LocalProcessing(&queue[siTemp]);
+   inline cbool AddCommand(const COMMAND_ENTRY &command) { return AddCommands(&command, 1u) == 1; }
+
+   /// Takes up to 'maxCount' published commands, in order.
+   /// @return Number of commands copied to 'out'.
+   inline cui32 TakeCommands(COMMAND_ENTRY *out, cui32 maxCount) {
+      ui64 pos;
+      ui32 i;
+
+      for(;;) {
+         pos = dequeuePos;
+
+         for(i = 0; i < maxCount && slot[(pos + i) & mask].seq == pos + i + 1u; i++);
+         if(!i) {
+            if(slot[pos & mask].seq < pos + 1u) return 0;   // Empty, or the next entry is not yet published
+            continue;
+         }
+         if(ui64(_InterlockedCompareExchange64((vsi64ptr)&dequeuePos, si64(pos + i), si64(pos))) == pos) break;
+      }
+
+      for(ui32 j = 0; j < i; j++) {
+         COMMAND_SLOT &s = slot[(pos + j) & mask];
+
+         out[j] = s.entry;
+         s.seq  = pos + j + mask + 1u;   // Release: free for the next lap
+      }
+
+      return i;
+   }
+
+   inline cbool TakeCommand(COMMAND_ENTRY &out) { return TakeCommands(&out, 1u) == 1u; }
+
+   inline cbool Empty() const { cui64 pos = dequeuePos; return slot[pos & mask].seq != pos + 1u; }
+
+   /// Drains the queue through LocalProcessing().
+   /// @return Number of commands processed.
+   inline cui32 ProcessCommands() {
+      al16 COMMAND_ENTRY batch[16];
+      ui32 total = 0, taken;
+
+      while((taken = TakeCommands(batch, 16u)) != 0) {
+         for(ui32 i = 0; i < taken; i++) LocalProcessing(&batch[i]);
+         total += taken;
+      }
+
+      return total;
+   }
+
+   /// Releases every thread blocked in WaitForCommands(), now and later; call after clearing the consumer's ALIVE flag.
+   /// Commands may still be added and taken.
+   inline void Close() {
+      _InterlockedExchange((vol long *)&closed, 1);
+      _InterlockedIncrement((vol long *)&signal);
+      WakeByAddressAll((ptr)&signal);
+   }
+
+   /// Blocks until a command is available, Close() is called or 'timeoutMs' elapses; spins briefly, then sleeps on
+   /// WaitOnAddress.
+   /// @return true if the queue is non-empty.
+   inline cbool WaitForCommands(cDWORD timeoutMs = INFINITE) {
+      for(ui32 i = 0; i < CMD_WAIT_SPINS; i++) {
+         if(!Empty() || closed) return !Empty();
+         _mm_pause();
+      }
+
+      // 'seen' is read before the final check: an add or Close() after it changes the signal and WaitOnAddress() returns
+      // at once; one before it is seen by the check
+      cui32 seen = signal;
+
+      _InterlockedIncrement((vol long *)&waiters);
+      if(Empty() && !closed) WaitOnAddress((ptr)&signal, (ptr)&seen, sizeof(ui32), timeoutMs);
+      _InterlockedDecrement((vol long *)&waiters);
 
-      return (nextToProcess = siTemp);
+      return !Empty();
    }
 };
@@ -1,6 +1,6 @@
 /**********************************************************
  * File: D3D11 type defines.h         Created: 2023/04/16 *
- *                              Last modified: 2024/07/02 *
+ *                              Last modified: 2026/10/17 *
  *                                                        *
  * Desc:                                                  *
  *                                                        *
@@ -195,6 +195,13 @@ al32 struct CAMERA_DATAf32 { // 192 bytes
    SSE4Df32 fDims[2];
 };
 
+// Published copy of one camera (CLASS_CAM::PublishSnapshot); seq is odd while a publish is in progress
+al64 struct CAMERA_SNAPSHOT { // 320 bytes
+   vui32          seq;
+   CAMERA_DATAf32 data;
+   matrix         viewProj;
+};
+
 al64 struct CAMERA_DATAf64 { // 384 bytes
    union {
       AVX8Df64 pos_rot;
@@ -1,6 +1,6 @@
 /************************************************************
  * File: Data structures.h              Created: 2022/10/20 *
- *                                Last modified: 2026/08/12 *
+ *                                Last modified: 2026/10/17 *
  *                                                          *
  * Desc:                                                    *
  *                                                          *
@@ -14,7 +14,9 @@ enum AE_SUBSYSTEM : ui8 {
    ss_video,
    ss_audio,
    ss_gui,
-   ss_worldgen
+   ss_worldgen,
+   ss_map,   // Memory tag only (no thread)
+   ss_entity // Memory tag only (no thread)
 };
 
 enum AE_BUFFER_USAGE : ui8 {
@@ -66,7 +68,8 @@ al4 union ID32 {
 al8 union ID64 {
    struct {
       ui32 index;
-      ui32 group;
+      ui16 group;
+      ui16 gen;   // Slot generation for pooled handles; stale when it differs from the slot's current generation
    };
    ui64 id;
 };
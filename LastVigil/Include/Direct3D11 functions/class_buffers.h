@@ -1,6 +1,6 @@
 /************************************************************
  * File: class_buffers.h                Created: 2022/10/20 *
- *                                Last modified: 2024/06/29 *
+ *                                Last modified: 2026/10/17 *
  *                                                          *
  * Desc:                                                    *
  *                                                          *
@@ -89,7 +89,7 @@ al16 struct CLASS_BUFFERS {
       return index;   // Index of first buffer allocated
    }
 
-   // BindFlags == D3D11_BIND_SHADER_RESOURCE
+   // BindFlags == D3D11_BIND_SHADER_RESOURCE. A NULL source leaves a buffer that is not immutable uninitialised
    csi32 CreateStructured(cui8 context, cptrc source, cui32 stride, cui32 count, cui8 usageType) {
       csi32 index = bufferCount[3];
 
@@ -101,7 +101,7 @@ al16 struct CLASS_BUFFERS {
       bd[3][index].StructureByteStride = stride;
 
       srd.pSysMem = (ui8 *)source;
-      Try(stCreateBuf, dev->CreateBuffer(&bd[3][index], &srd, &pBuffer[3][index]), ss_video);
+      Try(stCreateBuf, dev->CreateBuffer(&bd[3][index], source ? &srd : NULL, &pBuffer[3][index]), ss_video);
       bufferCount[3]++;
 
       srvd[0].Format = DXGI_FORMAT_UNKNOWN;
@@ -125,7 +125,7 @@ al16 struct CLASS_BUFFERS {
       bd[3][index].StructureByteStride = stride;
 
       srd.pSysMem = (ui8 *)source;
-      Try(stCreateBuf, dev->CreateBuffer(&bd[3][index], &srd, &pBuffer[3][index]), ss_video);
+      Try(stCreateBuf, dev->CreateBuffer(&bd[3][index], source ? &srd : NULL, &pBuffer[3][index]), ss_video);
       bufferCount[3]++;
 
       uavd[0].Format = DXGI_FORMAT_UNKNOWN;
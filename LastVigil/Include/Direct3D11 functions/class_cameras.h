@@ -1,6 +1,6 @@
 /************************************************************
  * File: class_camera.h                 Created: 2022/10/20 *
- *                                Last modified: 2025/09/27 *
+ *                                Last modified: 2026/10/17 *
  *                                                          *
  * Desc:                                                    *
  *                                                          *
@@ -21,6 +21,9 @@ al32 struct CLASS_CAM {
    CAMERA_DATAf32 *const data32 = (CAMERA_DATAf32*)malloc64(sizeof(CAMERA_DATAf32[8]));
    CAMERA_DATAf64 *const data64 = (CAMERA_DATAf64*)malloc64(sizeof(CAMERA_DATAf64[8]));
 
+   // Seqlock copies of data32 and mProjCamera; written by TransformCamera (video thread) only, read by the cull passes
+   CAMERA_SNAPSHOT *const snapshot = (CAMERA_SNAPSHOT*)zalloc64(sizeof(CAMERA_SNAPSHOT[8]));
+
    CB_VIEW *const cbProj = (CB_VIEW*)malloc64(sizeof(CB_VIEW[8]));
    CB_MAIN *const cbMain = (CB_MAIN*)malloc64(sizeof(CB_MAIN[8]));
 
@@ -47,16 +50,20 @@ al32 struct CLASS_CAM {
 
    inline void SetDimsf(cVEC4Du16 dims, cui8 cam) { data32[cam].fDims[0].vector = { fl32(dims.x), fl32(dims.y), fl32(dims.z), fl32(dims.w) }; }
 
-   inline void SetDimsf(cVEC3Du16 chunkDims, cVEC3Du16 chunkCounts, cui8 cam) {
-      data32[cam].fDims[0].vector = { fl32(chunkDims.x), fl32(chunkDims.y), fl32(chunkDims.z), 1.0f };
-      data32[cam].fDims[1].vector = { fl32(chunkCounts.x), fl32(chunkCounts.y), fl32(chunkCounts.z), 1.0f };
+   inline void SetDimsf(cVEC3Du16 chunkDims, cVEC3Du16 chunkCounts, CAMERA_DATAf32 &camera) const {
+      camera.fDims[0].vector = { fl32(chunkDims.x), fl32(chunkDims.y), fl32(chunkDims.z), 1.0f };
+      camera.fDims[1].vector = { fl32(chunkCounts.x), fl32(chunkCounts.y), fl32(chunkCounts.z), 1.0f };
    }
 
-   inline void SetDimsf(cVEC4Du16 chunkDims, cVEC4Du16 chunkCounts, cui8 cam) {
-      data32[cam].fDims[0].vector = { fl32(chunkDims.x), fl32(chunkDims.y), fl32(chunkDims.z), fl32(chunkDims.w) };
-      data32[cam].fDims[1].vector = { fl32(chunkCounts.x), fl32(chunkCounts.y), fl32(chunkCounts.z), fl32(chunkDims.w) };
+   inline void SetDimsf(cVEC4Du16 chunkDims, cVEC4Du16 chunkCounts, CAMERA_DATAf32 &camera) const {
+      camera.fDims[0].vector = { fl32(chunkDims.x), fl32(chunkDims.y), fl32(chunkDims.z), fl32(chunkDims.w) };
+      camera.fDims[1].vector = { fl32(chunkCounts.x), fl32(chunkCounts.y), fl32(chunkCounts.z), fl32(chunkDims.w) };
    }
 
+   inline void SetDimsf(cVEC3Du16 chunkDims, cVEC3Du16 chunkCounts, cui8 cam) { SetDimsf(chunkDims, chunkCounts, data32[cam]); }
+
+   inline void SetDimsf(cVEC4Du16 chunkDims, cVEC4Du16 chunkCounts, cui8 cam) { SetDimsf(chunkDims, chunkCounts, data32[cam]); }
+
    inline void SetCamera(cui8 cam) { currentCamProj.x = cam; }
 
    inline void SetProjection(cui8 proj) { currentCamProj.y = proj; }
@@ -177,6 +184,8 @@ al32 struct CLASS_CAM {
          cfl32 mag = sqrtf(_mm_dp_ps(data32[cam].frustum.xmm[i], data32[cam].frustum.xmm[i], 0x071).m128_f32[0]);
          data32[cam].frustum.xmm[i] = _mm_div_ps(data32[cam].frustum.xmm[i], _mm_set_ps1(mag));
       }
+
+      PublishSnapshot(cam);
    }
 #else
    inline void TransformCamera(cui8 cam, cbool squareAspect) {
@@ -217,9 +226,40 @@ al32 struct CLASS_CAM {
       data32[cam].frustum.xmm[5] = _mm_sub_ps(m[1].xmm1, m[1].xmm0);
 
       for(ui8 i = 0; i < 6; i++) Normalize3D(data32[cam].frustum.xmm[i]);
+
+      PublishSnapshot(cam);
    }
 #endif
 
+   // Seqlock writer: the sequence is odd while the copy is in progress. x86 keeps stores in order, so compiler barriers suffice
+   inline void PublishSnapshot(cui8 cam) {
+      CAMERA_SNAPSHOT &shot = snapshot[cam];
+      cui32            seq  = shot.seq;
+
+      shot.seq = seq + 1u;
+      _ReadWriteBarrier();
+      shot.data     = data32[cam];
+      shot.viewProj = mProjCamera[cam];
+      _ReadWriteBarrier();
+      shot.seq = seq + 2u;
+   }
+
+   // Copies the newest complete snapshot of a camera without locking; retries while TransformCamera is publishing.
+   // Returns the snapshot's sequence number: even, and 0 if the camera has not yet been transformed
+   inline cui32 ReadSnapshot(CAMERA_SNAPSHOT &copy, cui8 cam) const {
+      const CAMERA_SNAPSHOT &shot = snapshot[cam];
+
+      for(;;) {
+         cui32 seq = shot.seq;
+         if(seq & 0x01) { _mm_pause(); continue; }
+         _ReadWriteBarrier();
+         copy.data     = shot.data;
+         copy.viewProj = shot.viewProj;
+         _ReadWriteBarrier();
+         if(shot.seq == seq) { copy.seq = seq;   return seq; }
+      }
+   }
+
    inline void UploadProjections(cui64 bits, cui8 cam) {
       cbProj[cam] = { (aemtrx)DX::XMMatrixTranspose((dxmtrx)mProj[cam][0]), (aemtrx)DX::XMMatrixTranspose((dxmtrx)mProj[cam][1]), { ScrRes.dims[ScrRes.state].aspect, 1.0f }, bits };
 
@@ -242,20 +282,24 @@ al32 struct CLASS_CAM {
       buf.UpdateConstant(0, &cbMain[cam], bufferIndex[cam][1], 1);
    }
 
-   inline cfl32 DistanceFromCamera(csi128 target, cui8 cam) {
-      cfl32x4 diff   = _mm_sub_ps(_mm_cvtepi32_ps(target), data32[cam].pos.xmm);
+   inline cfl32 DistanceFromCamera(csi128 target, const CAMERA_DATAf32 &camera) const {
+      cfl32x4 diff   = _mm_sub_ps(_mm_cvtepi32_ps(target), camera.pos.xmm);
       cfl32x4 square = _mm_mul_ps(diff, diff);
 
       return sqrtf(square.m128_f32[0] + square.m128_f32[1] + square.m128_f32[2]);
    }
 
-   inline cfl32 DistanceFromCamera(cfl32x4 target, cui8 cam) {
-      cfl32x4 diff   = _mm_sub_ps(target, data32[cam].pos.xmm);
+   inline cfl32 DistanceFromCamera(cfl32x4 target, const CAMERA_DATAf32 &camera) const {
+      cfl32x4 diff   = _mm_sub_ps(target, camera.pos.xmm);
       cfl32x4 square = _mm_mul_ps(diff, diff);
 
       return sqrtf(square.m128_f32[0] + square.m128_f32[1] + square.m128_f32[2]);
    }
 
+   inline cfl32 DistanceFromCamera(csi128 target, cui8 cam) { return DistanceFromCamera(target, data32[cam]); }
+
+   inline cfl32 DistanceFromCamera(cfl32x4 target, cui8 cam) { return DistanceFromCamera(target, data32[cam]); }
+
    inline cfl32 CursorSphereIntersect(cfl32x4 &sphere, cVEC2Ds32 curPos, cVEC2Du8 camProj) const {
       cmatrix mInvertedCam = mInverseCamera[camProj.x];
       cVEC2Df vScreen      = { curPos.x * ScrRes.rcpDims.w - 1.0f, 1.0f - (curPos.y * ScrRes.rcpDims.h) };
@@ -399,8 +443,11 @@ al32 struct CLASS_CAM {
    }
 
    // Each true bit in the return value == sphere visible
-   inline cui8 SphereFrustumIntersect8(cSSE4Df32 (&spheres)[8], cui8 cam) {
-      PLANEfl32 (&plane)[6] = data32[cam].frustum.fPlane;
+   inline cui8 SphereFrustumIntersect8(cSSE4Df32 (&spheres)[8], cui8 cam) { return SphereFrustumIntersect8(spheres, data32[cam]); }
+
+   // Each true bit in the return value == sphere visible
+   inline cui8 SphereFrustumIntersect8(cSSE4Df32 (&spheres)[8], const CAMERA_DATAf32 &camera) const {
+      const PLANEfl32 (&plane)[6] = camera.frustum.fPlane;
       ui8 i, success = 0xFF;
 
       for (i = 0; i < 6; i++)
@@ -489,9 +536,9 @@ al32 struct CLASS_CAM {
 
 #if defined(USE_ORACLE_CODE)
    // Each true bit in the return value == chunk visible
-   inline cui8 ChunkFrustumIntersect8(SSE4Ds32 chunk, cui8 cam) {
+   inline cui8 ChunkFrustumIntersect8(SSE4Ds32 chunk, const CAMERA_DATAf32 &camera) const {
       cAVX8Df32 chunkOffsets = { ._fl = { 0.5f, 0.5f, 0.5f, 1.0f, 0.5f, 0.5f, 0.5f, 1.0f } };
-      cAVX8Df32 chunkScale   = { .xmm = { data32[cam].fDims[0].xmm, data32[cam].fDims[0].xmm } };
+      cAVX8Df32 chunkScale   = { .xmm = { camera.fDims[0].xmm, camera.fDims[0].xmm } };
 
       cfl32 boundingSize = Max3(chunkScale.vector.x) * -0.86602540378443864676372317075294f;
 
@@ -503,7 +550,7 @@ al32 struct CLASS_CAM {
          cAVX8Df32 chunkOrigins = { .ymm = _mm256_mul_ps(_mm256_add_ps(_mm256_cvtepi32_ps(chunks.ymm), chunkOffsets.ymm), chunkScale.ymm) };
 
          for (j = 0; j < 6; j++) {
-            cfl32x4 plData = data32[cam].frustum.fPlane[j].xmm;
+            cfl32x4 plData = camera.frustum.fPlane[j].xmm;
             cfl32   side   = _mm_dp_ps(chunkOrigins.xmm0, plData, 0x0F1).m128_f32[0];
             if (side < boundingSize) {
                success ^= 0x01 << i;
@@ -511,7 +558,7 @@ al32 struct CLASS_CAM {
             }
          }
          for (j = 0; j < 6; j++) {
-            cfl32x4 plData = data32[cam].frustum.fPlane[j].xmm;
+            cfl32x4 plData = camera.frustum.fPlane[j].xmm;
             cfl32   side   = _mm_dp_ps(chunkOrigins.xmm1, plData, 0x0F1).m128_f32[0];
             if (side < boundingSize) {
                success ^= 0x02 << i;
@@ -524,8 +571,8 @@ al32 struct CLASS_CAM {
    }
 #else
    // Each true bit in the return value == chunk visible
-   inline cui8 ChunkFrustumIntersect8(SSE4Ds32 chunk, cui8 cam) {
-      cVEC4Df &chunkScale = data32[cam].fDims[0].vector;
+   inline cui8 ChunkFrustumIntersect8(SSE4Ds32 chunk, const CAMERA_DATAf32 &camera) const {
+      cVEC4Df &chunkScale = camera.fDims[0].vector;
 
       cfl32 boundingSize = Max3(chunkScale) * -0.86602540378443864676372317075294f;
 
@@ -547,7 +594,7 @@ al32 struct CLASS_CAM {
       ui8 success = 0xFF;
 
       for(ui8 planeIndex = 0; planeIndex < 6 && success; planeIndex++) {
-         const PLANEfl32 &plane = data32[cam].frustum.fPlane[planeIndex];
+         const PLANEfl32 &plane = camera.frustum.fPlane[planeIndex];
 
          cfl32x8 planeX = _mm256_broadcast_ss(&plane.xmm.m128_f32[0]);
          cfl32x8 planeY = _mm256_broadcast_ss(&plane.xmm.m128_f32[1]);
@@ -566,4 +613,7 @@ al32 struct CLASS_CAM {
       return success;
    }
 #endif
+
+   // Each true bit in the return value == chunk visible
+   inline cui8 ChunkFrustumIntersect8(SSE4Ds32 chunk, cui8 cam) { return ChunkFrustumIntersect8(chunk, data32[cam]); }
 };
@@ -1,6 +1,6 @@
 /************************************************************
  * File: Entity structures.h            Created: 2022/12/05 *
- *                                Last modified: 2023/06/30 *
+ *                                Last modified: 2026/10/17 *
  *                                                          *
  * Desc:                                                    *
  *                                                          *
@@ -163,7 +163,7 @@ al16 struct OBJECT_GROUP { // 48 bytes
    si32        maxParts;
 };
 
-al16 struct ENTITY_GROUP { // 112 bytes
+al16 struct ENTITY_GROUP { // 320 bytes
    chptr     name;
    chptr     text;
    ENTITY   *entity;
@@ -176,15 +176,28 @@ al16 struct ENTITY_GROUP { // 112 bytes
       };
       SPRITE_DPS *sprite_dps[2];
    };
-   ui64ptr entityVis; // 1-bit entity visiblity array
-   ui64ptr entityMod; // 1-bit entity activity array
-   si32    totalEntities;
+   ui64ptr entityVis;     // 1-bit entity visiblity array
+   ui64ptr entityMod;     // 1-bit entity activity array
+   ui32ptr entityFree;    // Stack of released entity slots; [0, freeEntities)
+   ui32ptr entityLive;    // Dense list of live entity slots walked by the culler; [0, liveEntities)
+   ui32ptr livePos;       // Position of each slot in entityLive; 0x0FFFFFFFF == released
+   ui16ptr entityGen;     // Generation of each slot; advanced on release so stale ID64s are rejected
+   ui32ptr boneNext;      // Free bone-range links, stored at the first bone of each released range
+   ui32ptr spriteFree[2]; // Stacks of released sprite array indices (sai); 0==Opaque, 1==Transparent
+   ui8ptr  boneSolo;      // Bones issued by CreateBone, outside any entity; 0==none, 1==Opaque, 2==Transparent
+   si32    totalEntities; // Slots ever issued (high-water mark); live slots are entityLive[0, liveEntities)
    si32    totalBones;
    si32    totalBone_DGS;
    si32    totalSpritesO;
    si32    totalSpritesT;
    si32    maxEntities;
    si32    maxBones;
+   si32    freeEntities;
+   si32    liveEntities;
+   si32    freeSprites[2];
+   ui32    boneFree[MAX_BONES_PER_ENTITY]; // Heads of released bone-range lists, indexed by range length - 1; 0x0FFFFFFFF == empty
+   ui16    genBase;                        // Generation of every slot when first committed (CLASS_ENTMAN::groupGen)
+   // 10 bytes padding
 };
 
 // Paramters for queued rendering
@@ -197,6 +210,8 @@ struct ENT_PARAMS {
    cui8       context;
 };
 
+struct VIS_RESULTS; // Visibility results.h
+
 // Declarations for threaded culling functionality
 al16 struct ENTMAN_THREAD_DATA {
    ENTITY_GROUP *group;
@@ -205,6 +220,7 @@ al16 struct ENTMAN_THREAD_DATA {
       ui32ptrptr entityVis;
       ui32ptr    entityMod;
    };
+   VIS_RESULTS *results;
 };
 
 // Declarations for threaded culling functionality
@@ -215,6 +231,7 @@ al16 struct ENTMAN_THREAD_DATAc {
       ui32ptrptrc entityVis;
       ui32ptrc    entityMod;
    };
+   VIS_RESULTS * const results;
 };
 
 // Pointers to vertex buffers for input assembler
@@ -1,8 +1,9 @@
 /************************************************************
  * File: File operations.h              Created: 2022/11/06 *
- *                                Last modified: 2024/07/10 *
+ *                                Last modified: 2026/10/17 *
  *                                                          *
  * Notes: 2024/05/06: Added support for data tracking       *
+ *        2026/10/17: Added memory-mapped file views        *
  *                                                          *
  * To do: Add WriteLine functions                           *
  *                                                          *
@@ -27,6 +28,14 @@ extern inline void Try(cchptrc stEvent, cui32 uiResult, cAE_SUBSYSTEM subsystem)
 
 enum ENUM_FILE_POS : ui8 { file_begin, file_current, file_end };
 
+// Whole-file memory mapping
+struct FILE_VIEW {
+   HANDLE file;
+   HANDLE mapping;
+   ui8ptr data;
+   ui64   bytes;
+};
+
 al32 struct CLASS_FILEOPS {
    cchar   stLoadShaders[32] = "Invalid shader list.cfg file";
    wchptrc pathWorking       = (wchptr)malloc64(sizeof(wchar[512]));
@@ -77,6 +86,74 @@ al32 struct CLASS_FILEOPS {
 #endif
    }
 
+   // Maps an existing file read-only. Returns false, with 'view' zeroed, if it cannot be opened or is empty
+   inline cbool MapForReading(cwchptrc path, FILE_VIEW &view) const { return MapExisting(path, false, view); }
+
+   // Maps an existing file read/write, in place; pages written are saved by the system. Returns false, with 'view' zeroed,
+   // if it cannot be opened or is empty
+   inline cbool MapForUpdating(cwchptrc path, FILE_VIEW &view) const { return MapExisting(path, true, view); }
+
+   inline cbool MapExisting(cwchptrc path, cbool writable, FILE_VIEW &view) const {
+      LARGE_INTEGER size;
+
+      view = {};
+      view.file = writable ? CreateFile(path, GENERIC_READ | GENERIC_WRITE, 0, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0) :
+                             CreateFile(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_READONLY | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+      if(view.file == INVALID_HANDLE_VALUE) { view.file = NULL; return false; }
+#ifdef DATA_TRACKING
+      ++sysData.storage.filesOpened;
+#endif
+      if(GetFileSizeEx(view.file, &size) && size.QuadPart > 0) {
+         view.bytes   = ui64(size.QuadPart);
+         view.mapping = CreateFileMapping(view.file, 0, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, 0);
+         if(view.mapping) view.data = (ui8ptr)MapViewOfFile(view.mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+      }
+      if(view.data) {
+#ifdef DATA_TRACKING
+         sysData.storage.bytesRead += view.bytes;
+#endif
+         return true;
+      }
+      UnmapFile(view);
+
+      return false;
+   }
+
+   // Creates (or truncates) a file of 'bytes' bytes and maps it read/write. Returns false, with 'view' zeroed, on failure
+   inline cbool MapForWriting(cwchptrc path, cui64 bytes, FILE_VIEW &view) const {
+      view = {};
+      view.file = CreateFile(path, GENERIC_READ | GENERIC_WRITE, 0, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+      if(view.file == INVALID_HANDLE_VALUE) { view.file = NULL; return false; }
+#ifdef DATA_TRACKING
+      ++sysData.storage.filesOpened;
+#endif
+      view.bytes   = bytes;
+      view.mapping = CreateFileMapping(view.file, 0, PAGE_READWRITE, DWORD(bytes >> 32), DWORD(bytes), 0);
+      if(view.mapping) view.data = (ui8ptr)MapViewOfFile(view.mapping, FILE_MAP_WRITE, 0, 0, 0);
+      if(view.data) {
+#ifdef DATA_TRACKING
+         sysData.storage.bytesWritten += bytes;
+#endif
+         return true;
+      }
+      UnmapFile(view);
+
+      return false;
+   }
+
+   // Unmaps and closes a view from MapForReading/MapForWriting; dirty pages are written back by the system
+   inline void UnmapFile(FILE_VIEW &view) const {
+      if(view.data) UnmapViewOfFile(view.data);
+      if(view.mapping) CloseHandle(view.mapping);
+      if(view.file) {
+         CloseHandle(view.file);
+#ifdef DATA_TRACKING
+         ++sysData.storage.filesClosed;
+#endif
+      }
+      view = {};
+   }
+
    // Returns current position in file
    inline cui32 GetPosition(cHANDLE file) const { return SetFilePointer(file, 0, 0, file_current); }
 
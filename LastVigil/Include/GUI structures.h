@@ -1,11 +1,13 @@
 /*********************************************************************
  * File: GUI structures.h                        Created: 2023/01/26 *
- *                                         Last modified: 2026/08/13 *
+ *                                         Last modified: 2026/10/17 *
  *                                                                   *
  * Desc:                                                             *
  *                                                                   *
  * 2024/04/18: Added GUI_DESC struct                                 *
  * 2026/08/13: Added .pIMMos to GUI_EL_DGS for CPU-side convenience  *
+ * 2026/10/17: GUI_INTERFACE vertex & activity arrays now grow in    *
+ *             place (reserve-and-commit)                            *
  *                                                                   *
  *  Copyright (c) David William Bull.          All rights reserved.  *
  *********************************************************************/
@@ -230,9 +232,11 @@ al32 struct GUI_ELEMENT { // 96 bytes
    };
 };
 
+constexpr ui32 GUI_INTERFACE_RESERVE = 0x010000u; // Element entries reserved per interface; maxVertices is 16-bit
+
 al16 struct GUI_INTERFACE { // 48 bytes
    union { chptr label; cchptr cLabel; }; // Interface name
-   ui32ptr vertex; // Vertex array of indices to element entries
+   ui32ptr vertex; // Vertex array of indices to element entries; reserved for GUI_INTERFACE_RESERVE, committed to maxVertices
    union {         // Array of input combinations
       ui512  *input512;
       ui256 (*input256)[2];
@@ -244,7 +248,7 @@ al16 struct GUI_INTERFACE { // 48 bytes
       chptr  inputLabels;
       char (*inputLabel)[32];
    };
-   union { cUNIPTR mod; UNIPTR _mod; }; // Activity array; 1 bit per element
+   union { cUNIPTR mod; UNIPTR _mod; }; // Activity array; 1 bit per element; reserved & committed as .vertex
    ui16 maxVertices; // Maximum element entries
    ui16 maxInputs;   // Maxmimum input bit patterns
    ui16 vertCount;   // Current element entries
@@ -252,11 +256,11 @@ al16 struct GUI_INTERFACE { // 48 bytes
 
 private:
    void Init(cui16 maxElement, cui16 maxInput) {
-      vertex      = zalloc1d32(ui32, maxElement);
+      vertex      = (ui32ptr)vreserve(GUI_INTERFACE_RESERVE * sizeof(ui32));
       inputs      = zalloc1d32(ui64, maxInput * 8u);
       inputLabel  = zalloc2d32(char, maxInput, 32u);
-      _mod        = zalloc1d16(ui8, maxElement >> 3u);
-      maxVertices = maxElement;
+      _mod        = (ui8ptr)vreserve(GUI_INTERFACE_RESERVE >> 3u);
+      maxVertices = (vertex && _mod.p && vcommit(vertex, 0, maxElement * sizeof(ui32)) && vcommit(_mod.p, 0, (maxElement + 7u) >> 3u)) ? maxElement : 0;
       maxInputs   = maxInput;
       vertCount   = 0;
       inputCount  = 0;
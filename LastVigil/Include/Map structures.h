@@ -1,6 +1,6 @@
 /************************************************************
  * File: Map structures.h               Created: 2022/12/11 *
- *                                Last modified: 2024/06/30 *
+ *                                Last modified: 2026/10/17 *
  *                                                          *
  * Desc:                                                    *
  *                                                          *
@@ -15,6 +15,10 @@
 #define MM_VIS_START 0x0FFFFFFFC0000000Eull
 #define MM_MOD_START 0x000000003FFFFFFFDull
 
+constexpr cui32 MM_CULL_MAX_SLABS        = 256u; // Slabs per parallel culling pass
+constexpr cui32 MM_CULL_SLABS_PER_WORKER = 4u;   // Slabs per job worker (and the submitting thread); evens out uneven rows
+constexpr cui32 MM_CULL_SLAB_CHUNKS      = 512u; // Fewest chunks per slab; smaller maps cull in fewer slabs, or one
+
 al16 struct ELEM_IGS { // 16 bytes
    f1p15x4 tc; // Texture coordinates : 1p15
    union {
@@ -88,9 +92,299 @@ al8 struct CELL { // 40 bytes
    float     temp;     // Current temperature (kelvin)
    float     rad;      // Current radiation decay
    float     elec;     // Current electron density
-   ui32      RES;
+   ui32      RES;      // Reserved; always 0, and not stored by CELLS_SOA
+};
+
+// Everything a cell holds but its pointers; the unit of encoded chunks (MAP_CHUNK_PALETTE) and of map fills
+al64 struct MAP_CELL_VALUE { // 64 bytes
+   CELL_DGS geometry;
+   CELL_DPS pixel;
+   VEC2Df   vel;
+   fl32     temp;
+   fl32     rad;
+   fl32     elec;
+   ui32     RES;  // CELL::RES
+   ui64     pad;  // Zero; values are compared whole
+};
+static_assert(sizeof(MAP_CELL_VALUE) == 64u, "MAP_CELL_VALUE is part of the 002u file layout.");
+
+inline MAP_CELL_VALUE MapCellValue(const CELL_DGS &geometry, const CELL_DPS &pixel, const CELL &cell) {
+   return { geometry, pixel, cell.vel, cell.temp, cell.rad, cell.elec, cell.RES, 0 };
+}
+
+//-- Cell layouts
+//   MAP::cell holds the cells' simulation fields (temp, rad, elec, vel) in the layout MAP_CELL_LAYOUT names (project
+//   definitions.h): CELLS_AOS or CELLS_SOA. Both are always compiled and have the same members; the map code reaches
+//   MAP::cell only through MAP_CELL_LAYOUT. 'cells' is MAP::cell, and 'dgs'/'dps' MAP::pDGS/pDPS unless noted.
+//   CELLS_AOS keeps CELL records, each linked to its geometry and pixel data. CELLS_SOA gives each chunk a block of MAP::cell
+//   holding its cells' temp, rad, elec, velX and velY as five arrays, each padded to 64 bytes (MapFieldArrayBytes), so a
+//   sweep of one field reads nothing else and needs no scalar tail; a cell's geometry and pixel data are found from its
+//   index, so no pointers are stored. Either way MAP::cell[i] reads as a CELL (cell[i].geometry->dens, cell[i].temp).
+//   CELL::RES is reserved and nothing sets it, so CELLS_SOA keeps no array for it and reads it back as 0; a non-zero RES
+//   handed to CELLS_SOA (Store, Fill, ReadChunk) would be lost, so it fails fast instead.
+
+enum MAP_CELL_FIELD : ui32 { mcf_temp, mcf_rad, mcf_elec, mcf_velX, mcf_velY, MAP_CELL_FIELDS };
+
+// Bytes of one of a chunk's field arrays (CELLS_SOA); a multiple of 64
+inline cui64 MapFieldArrayBytes(cui32 chunkCells) { return RoundUpToNearest64(ui64(chunkCells) * sizeof(fl32)); }
+
+// One cell, by reference
+struct CELL_REF {
+   CELL_DGS *geometry;
+   CELL_DPS *pixel;
+   fl32     &temp;
+   fl32     &rad;
+   fl32     &elec;
+   fl32     &velX;
+   fl32     &velY;
+};
+
+al8 struct MAP_CELLS { // 32 bytes
+   ui8ptr    block;      // Per-chunk field blocks, MAP_CELL_FIELDS * .arrayBytes apart
+   CELL_DGS *geometry;   // MAP::pDGS
+   CELL_DPS *pixel;      // MAP::pDPS
+   ui32      chunkCells;
+   ui32      arrayBytes; // MapFieldArrayBytes(chunkCells)
+
+   // Field array 'field' (MAP_CELL_FIELD) of chunk 'chunk'; lanes past its last cell belong to no cell
+   inline fl32ptrc Field(cui64 chunk, cui32 field) const { return (fl32ptr)(block + (chunk * MAP_CELL_FIELDS + field) * arrayBytes); }
+
+   inline CELL_REF operator[](cui64 index) const {
+      cui64 chunk = index / chunkCells;
+      cui64 i     = index - chunk * chunkCells;
+
+      return { &geometry[index], &pixel[index], Field(chunk, mcf_temp)[i], Field(chunk, mcf_rad)[i], Field(chunk, mcf_elec)[i],
+               Field(chunk, mcf_velX)[i], Field(chunk, mcf_velY)[i] };
+   }
 };
 
+// Nullable CELL_REF; stands in for CELL * (CLASS_MAPMAN::ResidentCell)
+struct CELL_REF_PTR {
+   const MAP_CELLS *cells;
+   ui64             index;
+
+   struct ARROW {
+      CELL_REF ref;
+      inline CELL_REF *operator->() { return &ref; }
+   };
+
+   inline explicit operator bool() const { return cells != NULL; }
+   inline CELL_REF operator*() const { return (*cells)[index]; }
+   inline ARROW    operator->() const { return { (*cells)[index] }; }
+};
+
+// CELL records
+struct CELLS_AOS {
+   typedef CELL *STORE; // MAP::cell
+   typedef CELL *PTR;   // Nullable handle of one cell
+
+   static constexpr ui32 FIELD_OFFSET[MAP_CELL_FIELDS] = { offsetof(CELL, temp), offsetof(CELL, rad), offsetof(CELL, elec),
+                                                           offsetof(CELL, vel), offsetof(CELL, vel) + sizeof(fl32) };
+
+   // Bytes of one chunk's share of MAP::cell
+   static inline cui64 StoreBytes(cui32 chunkCells) { return ui64(chunkCells) * sizeof(CELL); }
+
+   static inline ptr Base(const STORE &cells) { return cells; }
+
+   static inline void Attach(STORE &cells, ptrc store, CELL_DGS *const, CELL_DPS *const, cui32) { cells = (CELL *)store; }
+
+   static inline PTR At(const STORE &cells, cui64 index) { return &cells[index]; }
+
+   static inline MAP_CELL_VALUE Value(const STORE &cells, const CELL_DGS *const dgs, const CELL_DPS *const dps, cui32 chunkCells,
+                                      cui64 c, cui64 i) {
+      cui64 index = c * chunkCells + i;
+
+      return MapCellValue(dgs[index], dps[index], cells[index]);
+   }
+
+   static inline void Store(const STORE &cells, CELL_DGS *const dgs, CELL_DPS *const dps, cui64 index, const MAP_CELL_VALUE &value) {
+      cells[index] = { &dgs[index], &dps[index], value.vel, value.temp, value.rad, value.elec, value.RES };
+   }
+
+   // Copies chunk 'c' from the CELL records of a raw 002u payload; 'dgs' and 'dps' are the chunk's own
+   static inline void ReadChunk(const STORE &cells, const CELL *const stored, CELL_DGS *const dgs, CELL_DPS *const dps, cui64 c,
+                                cui32 chunkCells) {
+      CELL *const cell = &cells[c * chunkCells];
+
+      Copy(stored, cell, ui64(chunkCells) * sizeof(CELL));
+      for(ui64 i = 0; i < chunkCells; i++) {
+         cell[i].geometry = &dgs[i];
+         cell[i].pixel    = &dps[i];
+      }
+   }
+
+   // Copies chunk 'c' to the CELL records of a raw 002u payload, without pointers
+   static inline void WriteChunk(const STORE &cells, CELL *const stored, cui64 c, cui32 chunkCells) {
+      Copy(&cells[c * chunkCells], stored, ui64(chunkCells) * sizeof(CELL));
+      for(ui64 i = 0; i < chunkCells; i++) {
+         stored[i].geometry = NULL;
+         stored[i].pixel    = NULL;
+      }
+   }
+
+   // Sets cells [first, first + count) from 'value', linking each record to its geometry and pixel data. Four records are
+   // 160 bytes, so they are written as five 32-byte non-temporal stores, whose pointer lanes then step on by four cells
+   static inline void Fill(const STORE &cells, CELL_DGS *const dgs, CELL_DPS *const dps, cui32, cui64 first, cui64 count,
+                           const MAP_CELL_VALUE &value) {
+      CELL *const cell   = &cells[first];
+      const auto  record = [dgs, dps, &value, first](cui64 i) -> CELL {
+         return { &dgs[first + i], &dps[first + i], value.vel, value.temp, value.rad, value.elec, value.RES };
+      };
+      ui64 i = 0;
+
+      // Records are 8-byte aligned, so at most three precede a 32-byte boundary
+      for(; i < count && ((ui64)&cell[i] & 0x01F); i++) cell[i] = record(i);
+
+      if(i + 4u <= count) {
+         al32 CELL block[4];
+         al32 ui64 step[20] = {};
+         ui256     lane[5], stride[5];
+
+         for(ui8 k = 0; k < 4u; k++) {
+            block[k]          = record(i + k);
+            step[k * 5u]      = 4u * sizeof(CELL_DGS);
+            step[k * 5u + 1u] = 4u * sizeof(CELL_DPS);
+         }
+         for(ui8 l = 0; l < 5u; l++) {
+            lane[l]   = _mm256_load_si256((cui256ptr)block + l);
+            stride[l] = _mm256_load_si256((cui256ptr)step + l);
+         }
+         for(; i + 4u <= count; i += 4u) {
+            ui256ptrc out = (ui256ptr)&cell[i];
+            for(ui8 l = 0; l < 5u; l++) {
+               _mm256_stream_si256(out + l, lane[l]);
+               lane[l] = _mm256_add_epi64(lane[l], stride[l]);
+            }
+         }
+         _mm_sfence();
+      }
+      for(; i < count; i++) cell[i] = record(i);
+   }
+
+   // Field 'field' (MAP_CELL_FIELD) of cells [i, i + 8) of chunk 'c', gathered from their records; lanes clear in 'mask' read
+   // nothing and return 0
+   static inline fl32x8 Load8(const STORE &cells, cui32 chunkCells, cui64 c, cui32 field, cui32 i, cui256 mask) {
+      const fl32 *const base = (const fl32 *)((const ui8 *)&cells[c * chunkCells + i] + FIELD_OFFSET[field]);
+
+      return _mm256_mask_i32gather_ps(_mm256_setzero_ps(), base, _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                      _mm256_set1_epi32(si32(sizeof(CELL)))), _mm256_castsi256_ps(mask), 1);
+   }
+
+   // Writes the lanes of 'values' set in 'mask' back to their records, as Load8 read them
+   static inline void Store8(const STORE &cells, cui32 chunkCells, cui64 c, cui32 field, cui32 i, cfl32x8 values, cui256 mask) {
+      ui8ptrc   base = (ui8ptr)&cells[c * chunkCells + i] + FIELD_OFFSET[field];
+      al32 fl32 lane[8];
+
+      _mm256_store_ps(lane, values);
+      for(ui32 bits = ui32(_mm256_movemask_ps(_mm256_castsi256_ps(mask))); bits; bits &= bits - 1u) {
+         cui32 l = _tzcnt_u32(bits);
+         *(fl32ptr)(base + l * sizeof(CELL)) = lane[l];
+      }
+   }
+};
+
+// Per-chunk field arrays
+struct CELLS_SOA {
+   typedef MAP_CELLS    STORE; // MAP::cell
+   typedef CELL_REF_PTR PTR;   // Nullable handle of one cell
+
+   // Bytes of one chunk's share of MAP::cell
+   static inline cui64 StoreBytes(cui32 chunkCells) { return MapFieldArrayBytes(chunkCells) * MAP_CELL_FIELDS; }
+
+   static inline ptr Base(const STORE &cells) { return cells.block; }
+
+   static inline void Attach(STORE &cells, ptrc store, CELL_DGS *const dgs, CELL_DPS *const dps, cui32 chunkCells) {
+      cells = { (ui8ptr)store, dgs, dps, chunkCells, ui32(MapFieldArrayBytes(chunkCells)) };
+   }
+
+   static inline PTR At(const STORE &cells, cui64 index) { return { &cells, index }; }
+
+   static inline MAP_CELL_VALUE Value(const STORE &cells, const CELL_DGS *const dgs, const CELL_DPS *const dps, cui32 chunkCells,
+                                      cui64 c, cui64 i) {
+      cui64 index = c * chunkCells + i;
+
+      return { dgs[index], dps[index], { cells.Field(c, mcf_velX)[i], cells.Field(c, mcf_velY)[i] }, cells.Field(c, mcf_temp)[i],
+               cells.Field(c, mcf_rad)[i], cells.Field(c, mcf_elec)[i], 0, 0 };
+   }
+
+   static inline void Store(const STORE &cells, CELL_DGS *const, CELL_DPS *const, cui64 index, const MAP_CELL_VALUE &value) {
+      if(value.RES) __fastfail(FAST_FAIL_INVALID_ARG);
+
+      const CELL_REF cell = cells[index];
+
+      cell.temp = value.temp;
+      cell.rad  = value.rad;
+      cell.elec = value.elec;
+      cell.velX = value.vel.x;
+      cell.velY = value.vel.y;
+   }
+
+   // Scatters the CELL records of a raw 002u payload into chunk 'c''s field arrays
+   static inline void ReadChunk(const STORE &cells, const CELL *const stored, CELL_DGS *const, CELL_DPS *const, cui64 c,
+                                cui32 chunkCells) {
+      fl32ptrc temp = cells.Field(c, mcf_temp), rad = cells.Field(c, mcf_rad), elec = cells.Field(c, mcf_elec);
+      fl32ptrc velX = cells.Field(c, mcf_velX), velY = cells.Field(c, mcf_velY);
+      ui32     res  = 0;
+
+      for(ui64 i = 0; i < chunkCells; i++) {
+         temp[i] = stored[i].temp;
+         rad[i]  = stored[i].rad;
+         elec[i] = stored[i].elec;
+         velX[i] = stored[i].vel.x;
+         velY[i] = stored[i].vel.y;
+         res    |= stored[i].RES;
+      }
+      if(res) __fastfail(FAST_FAIL_INVALID_ARG);
+   }
+
+   // Gathers chunk 'c''s field arrays into the CELL records of a raw 002u payload, without pointers
+   static inline void WriteChunk(const STORE &cells, CELL *const stored, cui64 c, cui32 chunkCells) {
+      cfl32ptrc temp = cells.Field(c, mcf_temp), rad = cells.Field(c, mcf_rad), elec = cells.Field(c, mcf_elec);
+      cfl32ptrc velX = cells.Field(c, mcf_velX), velY = cells.Field(c, mcf_velY);
+
+      for(ui64 i = 0; i < chunkCells; i++) stored[i] = { NULL, NULL, { velX[i], velY[i] }, temp[i], rad[i], elec[i], 0 };
+   }
+
+   // Sets cells [first, first + count) from 'value': each field array's part of the range is streamed as a 64-byte pattern
+   // (MEM_KERNELS::stream)
+   static inline void Fill(const STORE &cells, CELL_DGS *const, CELL_DPS *const, cui32 chunkCells, cui64 first, cui64 count,
+                           const MAP_CELL_VALUE &value) {
+      al64 fl32 pattern[MAP_CELL_FIELDS][16];
+
+      if(value.RES) __fastfail(FAST_FAIL_INVALID_ARG);
+      for(ui8 l = 0; l < 16u; l++) {
+         pattern[mcf_temp][l] = value.temp;
+         pattern[mcf_rad][l]  = value.rad;
+         pattern[mcf_elec][l] = value.elec;
+         pattern[mcf_velX][l] = value.vel.x;
+         pattern[mcf_velY][l] = value.vel.y;
+      }
+      for(ui64 index = first, end = first + count; index < end;) {
+         cui64 chunk  = index / chunkCells;
+         cui64 offset = index - chunk * chunkCells;
+         cui64 run    = (end - index < chunkCells - offset) ? end - index : chunkCells - offset;
+
+         for(ui32 f = 0; f < MAP_CELL_FIELDS; f++) memKernels.stream(cells.Field(chunk, f) + offset, run * sizeof(fl32), pattern[f]);
+         index += run;
+      }
+   }
+
+   // Field 'field' (MAP_CELL_FIELD) of cells [i, i + 8) of chunk 'c'; 'i' is a multiple of 8. Lanes past the chunk's last
+   // cell are padding of its array, so every lane is read whatever 'mask' holds
+   static inline fl32x8 Load8(const STORE &cells, cui32, cui64 c, cui32 field, cui32 i, cui256) {
+      return _mm256_load_ps(cells.Field(c, field) + i);
+   }
+
+   // Writes 'values' back as Load8 read them; lanes past the chunk's last cell belong to no cell, so 'mask' is not needed
+   static inline void Store8(const STORE &cells, cui32, cui64 c, cui32 field, cui32 i, cfl32x8 values, cui256) {
+      _mm256_store_ps(cells.Field(c, field) + i, values);
+   }
+};
+
+// MAP::cell, and a nullable handle of one cell that stands in for CELL * (CLASS_MAPMAN::ResidentCell), in the selected layout
+typedef MAP_CELL_LAYOUT::STORE MAP_CELL_STORE;
+typedef MAP_CELL_LAYOUT::PTR   CELL_PTR;
+
 al16 struct MAPDIMS_ICB { // 16 bytes   ---   Map Cells and Chunk Cells not needed?
    ui64 dimData[2];
    // Map dimensions: X, Y, Z cell counts - 1     --- 30 bits -- [..][..][..][30]
@@ -191,16 +485,225 @@ al32 struct MAP_DESC {
    WORLD_LIST_RV wlrv;
 };
 
+struct MAP_STREAM;
+struct MAP_SPARSE;
+
 al32 struct MAP { // 256 bytes
-   MAPDIMS_ICB *pCB;      // Pointer to GPU's constant buffer
-   CELL_DGS    *pDGS;     // Pointer to array for GPU's geometry shader
-   CELL_DPS    *pDPS;     // Pointer to array for GPU's pixel shader
-   CELL        *cell;     // Pointer to cell data array
-   ui64        *chunkVis; // 1-bit chunk visibility array
-   ui64        *chunkMod; // 1-bit chunk activity array
-   CELL         oob;      // Properties for out-of-bounds area
-   ui64         RES;
-   MAP_DESC     desc;     // Map descriptors
+   MAPDIMS_ICB   *pCB;      // Pointer to GPU's constant buffer
+   CELL_DGS      *pDGS;     // Pointer to array for GPU's geometry shader
+   CELL_DPS      *pDPS;     // Pointer to array for GPU's pixel shader
+   MAP_CELL_STORE cell;     // Cell data, in the MAP_CELL_LAYOUT layout
+   ui64          *chunkVis; // 1-bit chunk visibility array
+   ui64          *chunkMod; // 1-bit chunk activity array
+   CELL           oob;      // Properties for out-of-bounds area
+   MAP_STREAM    *stream;   // Chunk residency of a streamed map (CLASS_MAPMAN::StreamMap); NULL == every chunk resident
+   MAP_SPARSE    *sparse;   // Encoded chunks of a sparse map; NULL == every chunk at full size (dense)
+   MAP_DESC       desc;     // Map descriptors
+};
+
+// Bytes of one chunk's share of MAP::cell
+inline cui64 MapCellStoreBytes(cui32 chunkCells) { return MAP_CELL_LAYOUT::StoreBytes(chunkCells); }
+
+// Base of a map's cell storage (MAP::cell)
+inline ptr CellStore(const MAP &map) { return MAP_CELL_LAYOUT::Base(map.cell); }
+
+// Sets a map's cell storage; set .pDGS, .pDPS and .desc.chunkCells first
+inline void SetCellStore(MAP &map, ptrc store) { MAP_CELL_LAYOUT::Attach(map.cell, store, map.pDGS, map.pDPS, map.desc.chunkCells); }
+
+//-- Map files
+//   Format 002u: [MAP_FILE_HEADER][name, info & periodic table name; null-terminated][MAP_FILE_CHUNK[mapChunks]][payloads]
+//   The string block, chunk table and every payload start on a 64-byte boundary. A raw payload holds the chunk's CELL_DGS,
+//   CELL_DPS and CELL records exactly as in memory, each section 64-byte aligned (MapChunkDPSOffset, MapChunkCellOffset);
+//   CELL's geometry/pixel pointers are stored as zero and relinked on load. An encoded payload holds a uniform chunk's one
+//   MAP_CELL_VALUE, or a palette chunk (MAP_CHUNK_PALETTE). Payload slots are chunkBytes apart whatever their encoding, so a
+//   streamed map rewrites its chunks in place; MAP_FILE_CHUNK::bytes is the part of the slot in use.
+//   Format 001u: [tag][name][info][table name][mapDim, chunkDim, zso, oob fields][vel, temp, rad & elec per cell][pDGS][pDPS]
+//   Read for migration only; SaveMap writes 002u.
+
+constexpr char  MAP_FILE_TAG_001u[] = "AE.LV01.MD.001u"; // 2[Engine].4[Frontend].2[Data type].3[Format version]1[Compression method]
+constexpr char  MAP_FILE_TAG_002u[] = "AE.LV01.MD.002u";
+constexpr cui32 MAP_FILE_GRAIN      = 64u;              // Chunks per load/save job
+
+enum MAP_CHUNK_ENCODING : ui32 { mce_raw, mce_uniform, mce_palette };
+
+al64 struct MAP_FILE_HEADER { // 128 bytes
+   char     tag[16];       // MAP_FILE_TAG_002u, null-terminated
+   ui32     headerBytes;   // sizeof(MAP_FILE_HEADER) when written; later formats append fields
+   ui32     chunkCells;
+   ui32     mapChunks;
+   ui32     chunkBytes;    // Bytes of one raw chunk payload (MapChunkBytes)
+   ui64     stringsOffset;
+   ui64     tableOffset;   // MAP_FILE_CHUNK[mapChunks]
+   ui64     fileBytes;
+   VEC3Du16 mapDim;
+   VEC3Du16 chunkDim;
+   si16     zso;
+   si16     entListDim;
+   VEC2Df   oobVel;
+   fl32     oobTemp;
+   fl32     oobRad;
+   fl32     oobElec;
+   ui32     RES[9];
+};
+static_assert(sizeof(MAP_FILE_HEADER) == 128u, "MAP_FILE_HEADER is part of the 002u file layout.");
+
+al16 struct MAP_FILE_CHUNK { // 16 bytes
+   ui64 offset;   // Payload position in the file; a multiple of 64
+   ui32 bytes;    // Payload bytes stored; chunkBytes when raw
+   ui32 encoding; // MAP_CHUNK_ENCODING
+};
+
+// Bulk chunk copies between a map and a mapped 002u file; job data of _MM_ReadChunks/_MM_WriteChunks
+struct MAP_FILE_JOB {
+   MAP            *map;
+   ui8            *file;
+   MAP_FILE_CHUNK *chunk;  // The file's chunk table; written by _MM_WriteChunks only
+   vui32           failed; // Set by a job that could not place a chunk
+};
+
+// Offsets of the sections of a raw 002u chunk payload, and its size
+inline cui64 MapChunkDPSOffset(cui32 chunkCells)  { return RoundUpToNearest64(ui64(chunkCells) * sizeof(CELL_DGS)); }
+inline cui64 MapChunkCellOffset(cui32 chunkCells) { return MapChunkDPSOffset(chunkCells) + RoundUpToNearest64(ui64(chunkCells) * sizeof(CELL_DPS)); }
+inline cui64 MapChunkBytes(cui32 chunkCells)      { return MapChunkCellOffset(chunkCells) + RoundUpToNearest64(ui64(chunkCells) * sizeof(CELL)); }
+
+//-- Encoded chunks
+//   Shared by 002u payloads and sparse maps (MAP_SPARSE). A cell value (MAP_CELL_VALUE) is everything a cell holds but its pointers. A chunk
+//   whose cells are all equal is stored as one value (mce_uniform); a chunk of few values, in runs, as a palette
+//   (mce_palette): [MAP_CHUNK_PALETTE][MAP_CELL_RUN[runs], padded to 64 bytes][MAP_CELL_VALUE[values]], the runs covering
+//   the chunk's cells in order. Any other chunk stays raw.
+
+constexpr cui32 MAP_PALETTE_VALUES = 64u;      // Most values in a palette chunk
+constexpr cui32 MAP_PALETTE_RATIO  = 4u;       // A chunk is encoded only into at most 1/MAP_PALETTE_RATIO of its raw bytes
+constexpr cui32 MAP_RUN_CELLS      = 0x0FFFFu; // Longest run; longer ones are split
+
+al64 struct MAP_CHUNK_PALETTE { // 64 bytes
+   ui32 values;
+   ui32 runs;
+   ui32 RES[14];
+};
+
+struct MAP_CELL_RUN { // 4 bytes
+   ui16 value; // Palette index
+   ui16 cells; // 1~MAP_RUN_CELLS
+};
+
+inline cui64 MapPaletteValuesOffset(cui32 runs)         { return sizeof(MAP_CHUNK_PALETTE) + RoundUpToNearest64(ui64(runs) * sizeof(MAP_CELL_RUN)); }
+inline cui64 MapPaletteBytes(cui32 values, cui32 runs) { return MapPaletteValuesOffset(runs) + ui64(values) * sizeof(MAP_CELL_VALUE); }
+
+// Value of cell 'i' of chunk 'c' of a map
+inline MAP_CELL_VALUE ChunkCellValue(const MAP &map, cui64 c, cui64 i) {
+   return MAP_CELL_LAYOUT::Value(map.cell, map.pDGS, map.pDPS, map.desc.chunkCells, c, i);
+}
+
+// Sets cell 'index' of a map's storage (MAP::cell) from 'value'; a CELL record is also linked to its geometry and pixel data
+inline void StoreCell(MAP &map, cui64 index, const MAP_CELL_VALUE &value) {
+   MAP_CELL_LAYOUT::Store(map.cell, map.pDGS, map.pDPS, index, value);
+}
+
+inline cbool SameCellValue(const MAP_CELL_VALUE &a, const MAP_CELL_VALUE &b) {
+   cui256 low  = _mm256_cmpeq_epi8(_mm256_load_si256((cui256ptr)&a), _mm256_load_si256((cui256ptr)&b));
+   cui256 high = _mm256_cmpeq_epi8(_mm256_load_si256((cui256ptr)&a + 1), _mm256_load_si256((cui256ptr)&b + 1));
+
+   return _mm256_movemask_epi8(_mm256_and_si256(low, high)) == -1;
+}
+
+// True if 'bytes' at 'payload' are a well-formed chunk payload of 'encoding' for chunks of 'chunkCells' cells
+inline cbool MapPayloadValid(const ui8 *const payload, cui32 bytes, cui32 encoding, cui32 chunkCells) {
+   switch(encoding) {
+   case mce_raw:     return bytes == MapChunkBytes(chunkCells);
+   case mce_uniform: return bytes == sizeof(MAP_CELL_VALUE);
+   case mce_palette: {
+      if(bytes < sizeof(MAP_CHUNK_PALETTE)) return false;
+
+      const MAP_CHUNK_PALETTE &header = *(const MAP_CHUNK_PALETTE *)payload;
+      if(!header.values || header.values > MAP_PALETTE_VALUES || header.runs > chunkCells || bytes != MapPaletteBytes(header.values, header.runs)) return false;
+
+      const MAP_CELL_RUN *const run = (const MAP_CELL_RUN *)(payload + sizeof(MAP_CHUNK_PALETTE));
+      ui64 cells = 0;
+      for(ui32 r = 0; r < header.runs; r++) {
+         if(run[r].value >= header.values || !run[r].cells) return false;
+         cells += run[r].cells;
+      }
+      return cells == chunkCells;
+   }
+   default: return false;
+   }
+}
+
+//-- Map creation
+
+constexpr cui32 MAP_FILL_GRAIN = 64u; // Chunks per CreateMap fill job; each job owns whole chunkVis qwords
+constexpr cui32 MAP_NODE_GRAIN = 64u; // Chunk-range boundaries between NUMA nodes fall on multiples of this (ChunkRangeOfNode)
+
+static_assert(!(MAP_NODE_GRAIN % MAP_FILL_GRAIN) && !(MAP_NODE_GRAIN % MAP_FILE_GRAIN), "A fill or file job must not span two nodes' chunks.");
+
+// CreateMap's fill of a dense map; job data of _MM_FillChunks. Chunks below surfaceChOS take .open, chunks from solidChOS
+// .solid, and the rest .surface with a per-cell element (_MM_SurfaceElement)
+al64 struct MAP_FILL_JOB {
+   MAP_CELL_VALUE open;
+   MAP_CELL_VALUE surface;
+   MAP_CELL_VALUE solid;
+   MAP           *map;
+   si32           surfaceChOS;
+   si32           solidChOS;
+};
+
+//-- Chunk streaming
+//   A streamed map keeps its 002u file mapped read/write and at most 'slots' chunks resident. Its cell, geometry and pixel
+//   arrays are reserved at full size, so cell indices are unchanged, and each chunk's pages are committed while it is
+//   resident; cells of other chunks must not be touched. A chunk that is not resident has its chunkVis and chunkMod bits
+//   clear, so culling never lists it; its chunkVis bit is kept in 'visible' until it is loaded again.
+//   Eviction takes the least recently used chunk. StreamUpdate renews chunks near the camera, active chunks (chunkMod) and
+//   chunks in the newest visibility set, and no chunk is evicted within MM_STREAM_MIN_AGE updates of its last use.
+
+constexpr cui32 MM_STREAM_NONE      = ~0u; // chunkSlot/slotChunk: no slot, no chunk
+constexpr cui32 MM_STREAM_MIN_AGE   = 4u;  // StreamUpdate calls a chunk stays resident after its last use; covers the
+                                           // visibility sets still queued for the renderer (VIS_RESULTS)
+constexpr cui32 MM_STREAM_PREFETCH  = 32u; // Chunks StreamUpdate may queue for loading, and for eviction, per call
+constexpr cui32 MM_STREAM_LOW_WATER = 8u;  // StreamUpdate evicts down to slots - slots / MM_STREAM_LOW_WATER
+
+enum MAP_CHUNK_STATE : ui8 { mcs_absent, mcs_loading, mcs_resident, mcs_evicting };
+
+al64 struct MAP_STREAM {
+   FILE_VIEW             file;      // Backing 002u file, mapped read/write
+   MAP_FILE_CHUNK       *table;     // The file's chunk table; a written-back chunk's entry is updated
+   ui8ptr                state;     // MAP_CHUNK_STATE of each chunk
+   ui32ptr               chunkSlot; // Slot of each chunk; MM_STREAM_NONE when absent
+   ui32ptr               slotChunk; // Chunk of each slot; MM_STREAM_NONE when free
+   ui64ptr               slotUse;   // Update tick of each slot's last use
+   ui32ptr               freeSlot;  // Stack of free slots
+   ui64ptr               visible;   // chunkVis bits of absent chunks
+   ui64ptr               dirty;     // 1 bit per chunk: resident contents differ from the file
+   ui32                  slots;     // Resident-chunk budget
+   ui32                  freeSlots; // Entries in freeSlot
+   ui32                  retiring;  // Chunks being evicted
+   ui32                  radius;    // Chunks kept and prefetched around the camera, per axis
+   vui32                 lock;      // SpinLock; guards state, chunkSlot, slotChunk, slotUse and freeSlot
+   vui64                 tick;      // StreamUpdate calls
+   JOB_COUNTER           jobs;      // Prefetch and eviction jobs in flight
+};
+
+//-- Sparse maps
+//   A loaded map that is not streamed, and whose chunks' arrays span whole pages, is sparse unless CLASS_MAPMAN::denseMaps
+//   is set. Its arrays are reserved as a streamed map's are, and a chunk's pages are committed only once it is expanded;
+//   until then the chunk is held encoded, as its 002u payload would be. Uniform values are shared through .value; other payloads are owned.
+//   FaultChunk expands a chunk before its cells are touched (ModQuadCellDensity, the editor, ResidentCell); the GPU upload
+//   (StageChunk) and SaveMap read encoded chunks as they are.
+
+constexpr cui32 MM_SPARSE_VALUES = 64u; // Distinct uniform values shared per map; further ones are held per chunk
+
+al16 struct MAP_SPARSE_CHUNK { // 16 bytes
+   const ui8 *payload;  // Encoded cells; NULL once expanded
+   ui32       bytes;
+   vui32      encoding; // MAP_CHUNK_ENCODING; mce_raw once expanded
+};
+
+al64 struct MAP_SPARSE {
+   MAP_SPARSE_CHUNK *chunk;    // Per chunk
+   MAP_CELL_VALUE   *value;    // Shared uniform values; MM_SPARSE_VALUES entries
+   ui32              values;   // Entries of .value in use
+   vui32             expanded; // Chunks with committed pages
+   vui32             lock;     // SpinLock; guards .value, .values, and each chunk's payload and expansion
 };
 
 ///--- !!! Add WORLD struct; add world chunk data functionality !!!
@@ -228,6 +731,9 @@ struct MAP_PARAMS {
 };
 
 // Declarations for threaded culling functionality
+struct VIS_RESULTS;    // Visibility results.h
+struct CAMERA_DATAf32; // D3D11 type defines.h
+
 al16 struct MAPMAN_THREAD_DATA {
    MAP *map;
    union {
@@ -235,6 +741,7 @@ al16 struct MAPMAN_THREAD_DATA {
       ui32ptrptr chunkVis;
       ui32ptr    chunkMod;
    };
+   VIS_RESULTS *results;
 };
 
 al16 struct MAPMAN_THREAD_DATAc {
@@ -244,6 +751,23 @@ al16 struct MAPMAN_THREAD_DATAc {
       ui32ptrcptrc chunkVis;
       ui32ptrc     chunkMod;
    };
+   VIS_RESULTS * const results;
+};
+
+// One parallel culling pass (_MM_Cull_Slab). Slabs are runs of whole chunk rows (one y, z pair) plus runs of chunkMod qwords;
+// each writes its indices to its own region of vis & mod, then the pass joins the regions in slab order. The lists come out
+// in ascending chunk index order, as from a serial pass, whatever the slab or worker count
+al64 struct MAPMAN_CULL_SLABS {
+   MAP                  *map;
+   const CAMERA_DATAf32 *camera;
+   ui32ptr               vis;           // [capacity]; slab s starts at s * rowsPerSlab * chunkCount.x
+   ui32ptr               mod;           // [capacity]; slab s starts at (s * qwordsPerSlab) << 6
+   ui32                  capacity;      // Entries allocated for each of vis & mod
+   ui32                  slabs;
+   ui32                  rowsPerSlab;
+   ui32                  qwordsPerSlab;
+   ui32                  visCount[MM_CULL_MAX_SLABS];
+   ui32                  modCount[MM_CULL_MAX_SLABS];
 };
 
 // Pointers to vertex buffers for input assembler
@@ -0,0 +1,99 @@
+/************************************************************
+ * File: Visibility results.h           Created: 2026/10/17 *
+ *                                Last modified: 2026/10/17 *
+ *                                                          *
+ * Desc: Triple-buffered culling results, handed from the   *
+ *       cull passes to the render thread without waiting.  *
+ *                                                          *
+ *  Copyright (c) David William Bull. All rights reserved.  *
+ ************************************************************/
+#pragma once
+
+#include <intrin.h>
+#include "typedefs.h"
+#include "memory management.h"
+
+constexpr cui32 VIS_MAX_LOD = MAX_MAP_LOD > MAX_ENT_LOD ? MAX_MAP_LOD : MAX_ENT_LOD;
+constexpr cui32 VIS_FRESH   = 0x04u; // VIS_RESULTS::ready flag: the newest set has not been taken by the renderer
+
+// Cull() threadCount: how a culling pass is run. The split modes start a pair of persistent threads (or one of them, cm_splitVisible
+// and cm_splitModified) and publish only through WaitForCulling(); the others publish each pass themselves
+enum CULL_MODE : si8 {
+   cm_splitModified = -2, // Persistent thread: modified chunks or bones only
+   cm_splitVisible  = -1, // Persistent thread: visible chunks or bones only
+   cm_inline        =  0, // On the calling thread (map manager only)
+   cm_thread        =  1, // One persistent thread
+   cm_splitThreads  =  2, // Both cm_splitVisible and cm_splitModified
+   cm_job           =  3  // One job per pass on the job system (StartViewCulling)
+};
+
+// One complete culling result
+al64 struct VIS_SET {
+   ui32ptr list[VIS_MAX_LOD];  // Visible chunk (map) or bone (entity) indices, per level of detail
+   ui32ptr mod;                // Modified chunk or bone indices, for upload
+   ui32    count[VIS_MAX_LOD]; // Entries in each list
+   ui32    modCount;
+   ui32    cameraSeq;          // Camera snapshot the set was culled against (CLASS_CAM::ReadSnapshot)
+   ui64    frame;              // Stamp: number of the pass that produced the set; 0 == no pass yet
+};
+
+// Triple buffer of culling results. The culler fills Back() and publishes it; the renderer takes the newest published set.
+// Neither side waits: a free set always exists for the culler, and the renderer keeps its set until a newer one arrives
+al64 struct VIS_RESULTS {
+   VIS_SET set[3];
+   vui32   ready;       // Index of the newest published set, | VIS_FRESH until the renderer takes it
+   ui32    back;        // Set being filled; culler-owned
+   ui32    front;       // Set being rendered; renderer-owned
+   ui32    modCapacity; // Entries allocated for each mod list
+   ui64    passes;      // Sets published; culler-owned
+
+   // Allocates three sets: lists of count >> (levelsOfDetail - LOD) entries, mod lists of modEntries. levelsOfDetail is the
+   // highest LOD index, so it must be below VIS_MAX_LOD; a larger value would write past list[] and fails fast instead
+   void Create(cui32 count, cui8 levelsOfDetail, cui32 modEntries) {
+      if(levelsOfDetail >= VIS_MAX_LOD) __fastfail(FAST_FAIL_INVALID_ARG);
+
+      for(ui8 s = 0; s < 3; s++) {
+         set[s] = {};
+         for(ui8 i = 0; i <= levelsOfDetail; i++) set[s].list[i] = zalloc1d16(ui32, count >> (levelsOfDetail - i));
+         set[s].mod = zalloc1d16(ui32, modEntries);
+      }
+      ready       = 1u;
+      back        = 0;
+      front       = 2u;
+      modCapacity = modEntries;
+      passes      = 0;
+   }
+
+   void Destroy(void) {
+      for(ui8 s = 0; s < 3; s++) {
+         for(ui8 i = 0; i < VIS_MAX_LOD; i++) mfree1(set[s].list[i]);
+         mfree1(set[s].mod);
+         set[s] = {};
+      }
+   }
+
+   inline VIS_SET &Back(void) { return set[back]; }
+
+   // Culler: publishes Back() and claims the free set as the new Back().
+   // Returns the new Back() if it held a set the renderer never took (its mod entries are left for the culler to carry over),
+   // otherwise NULL, with the new Back()'s mod list emptied
+   inline VIS_SET *Publish(void) {
+      set[back].frame = ++passes;
+
+      cui32 prev = (ui32)_InterlockedExchange((vol long *)&ready, long(back | VIS_FRESH));
+
+      back = prev & 0x03u;
+      if(prev & VIS_FRESH) return &set[back];
+      set[back].modCount = 0;
+
+      return NULL;
+   }
+
+   // Renderer: the newest published set. 'fresh' is false if it is the set already returned by the previous call
+   inline VIS_SET &Take(bool &fresh) {
+      fresh = (ready & VIS_FRESH) != 0;
+      if(fresh) front = (ui32)_InterlockedExchange((vol long *)&ready, long(front)) & 0x03u;
+
+      return set[front];
+   }
+};
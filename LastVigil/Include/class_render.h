@@ -1,9 +1,9 @@
 /************************************************************
 * File: class_render.h                 Created: 2023/01/16 *
-*                                Last modified: 2024/07/02 *
-*                                                          *
-* Desc:                                                    *
+*                                Last modified: 2026/10/17 *
 *                                                          *
+* Desc: Draw submission; Queue* calls record into deferred *
+*       command lists, replayed at presentation.           *
 *  Copyright (c) David William Bull. All rights reserved.  *
 ************************************************************/
 #pragma once
@@ -13,6 +13,7 @@
 #include "Direct3D11 functions\class_config.h"
 #include "Direct3D11 functions\class_buffers.h"
 #include "Direct3D11 functions\class_textures.h"
+#include "render commands.h"
 
 al32 struct CLASS_RENDER {
    CLASS_CONFIG   &cfg;
@@ -29,21 +30,19 @@ al32 struct CLASS_RENDER {
 
    IDXGISwapChain2 *swapchain;
 
-   si16 bufVertex = 0;
-   ui8  msaaLevel = 0;
+   si16 bufVertex      = 0;
+   ui8  msaaLevel      = 0;
+   vui8 presentRequest = 0; // Set by RequestPresentOutputImage()
 
-   // 5 byte spare
+   // 4 bytes spare
 
-   vui16 jobCount    = 0; // Current number of jobs waiting to complete
-   vui16 activeJob   = 0; // Current job being processed
-   vui8  threadsBusy = 0; // Flag array of remaining status for current worker threads
-   vui8  threadsMax  = 0; // Flag array of active status for current worker threads
+   al16 struct { VEC3Ds32 pos; fp8n0_1x4 col; } vCube {};
 
-   // 2 bytes spare
+   RENDER_QUEUE queue; // Command lists recorded by the Queue* functions, on any thread
 
-   al16 struct { VEC3Ds32 pos; fp8n0_1x4 col; } vCube {};
+   CLASS_RENDER(CLASS_CONFIG &cfgClass, CLASS_BUFFERS &bufClass, CLASS_TEXTURES &texClass) : cfg(cfgClass), buf(bufClass), tex(texClass) { queue.Create(); }
 
-   CLASS_RENDER(CLASS_CONFIG &cfgClass, CLASS_BUFFERS &bufClass, CLASS_TEXTURES &texClass) : cfg(cfgClass), buf(bufClass), tex(texClass) {}
+   ~CLASS_RENDER(void) { queue.Destroy(); }
 
    inline void Draw(cui8 context, cui32 vertexCount) const {
       devcon[context]->Draw(vertexCount, 0);
@@ -55,6 +54,18 @@ al32 struct CLASS_RENDER {
       ++sysData.gpu.total.drawCalls;
    }
 
+   //-- RENDER_QUEUE backend; called by queue.Replay()
+   inline void BeginPacket(cui64 key, cui8 context) const {}
+   inline void SetBlendState(cui8 context, cui8 state) const { cfg.SetBlendState(context, state); }
+   inline void SetDepthStencilState(cui8 context, csi8 state, cui32 stencilRef) const { cfg.SetDepthStencilState(context, state, stencilRef); }
+   inline void SetVertexFormat(cui8 context, cui8 profile) const { cfg.SetVertexFormat(context, profile); }
+   inline void SetShaderGroup(cui8 context, cui8 shaders) const { cfg.SetShaderGroup(context, shaders); }
+   inline void SetGSR(cui8 context, cui16 index, cui16 slot, cui16 count) const { buf.SetGSR(context, index, slot, count); }
+   inline void SetPSR(cui8 context, cui16 index, cui16 slot, cui16 count) const { buf.SetPSR(context, index, slot, count); }
+   inline void SetUAV(cui8 context, cui16 index, cui16 slot, cui16 count) const { buf.SetUAV(context, index, slot, count); }
+   inline void UpdateVertex(cui8 context, cptrc source, cui16 index, cui32 count) const { buf.UpdateVertex(context, source, index, count); }
+   inline void SetVertexPrimitive(cui8 context, cui16 index, cui8 slot, cui32 topology) const { buf.SetVertexPrimitive(context, index, slot, topology); }
+
    inline void DrawVoxel(cui8 context, cVEC3Ds32 &location, cfp8n0_1x4 colour) {
       vCube = { location, colour };
       cfg.SetShaderGroup(context, 5);
@@ -80,98 +91,83 @@ al32 struct CLASS_RENDER {
       sysData.gpu.frame.curDrawCalls  = 0;
    }
 
-   // Add to queue and wait
-   inline constexpr void AddJob(void) {
-      // Wait until PresentRenderTarget completes
-      while(activeJob >= 32768) _mm_pause();
-      cui16 localJC = ++jobCount;
-      // Wait until 
-      while(activeJob && (activeJob != localJC)) _mm_pause();
-      activeJob = localJC; }
-
-   // Remove from queue
-   inline constexpr void RemoveJob(void) { if(jobCount > activeJob) ++activeJob; else activeJob = 0; }
+   // Queue* functions record a packet and return; nothing reaches the device until the next Present*OutputImage().
+   // The render data they reference (visibility lists, GPU buffers) must stay valid until then.
+   // Each packet sets all the state it relies on, since packets from other passes and threads replay in between
 
    inline void QueueDrawMap(cMAP_PARAMS &params) {
-      cui8 context = params.context;
-      AddJob();
-      cfg.SetBlendState(context, 0);
-      cfg.SetDepthStencilState(context, 3, 0);
-      cfg.SetVertexFormat(context, 0);
-      buf.SetGSR(context, params.gpuBuf[1], 0, 3u);
-      buf.SetPSR(context, params.gpuBuf[4], 0, 1u);
+      RENDER_LIST &list = queue.Begin(RenderKey(rp_opaque, 1u, 0), params.context);
+      list.SetBlendState(0);
+      list.SetDepthStencilState(3, 0);
+      list.SetVertexFormat(0);
+      list.SetGSR(params.gpuBuf[1], 0, 3u);
+      list.SetPSR(params.gpuBuf[4], 0, 1u);
       for(ui8 i = 0; i <= params.levelsOfDetail; ++i) {
-         cfg.SetShaderGroup(context, i);
-         buf.UpdateVertex(context, params.visBuf[i], params.vertBuf[i], RoundUpToNearest4(params.vertCounts[i]));
-         buf.SetVertexPrimitive(context, params.vertBuf[i], 0, ae_pointlist);
-         devcon[context]->DrawInstanced(params.chunkCells, params.vertCounts[i], 0, 0); // For use with ?s.map.cells.hlsl
-//         gpu.devcon[0]->DrawInstanced(map.desc.chunkCells >> 3, mapManThreadData._ui32[i], 0, 0); // For use with ?s.map.cells.x8.hlsl
-         sysData.gpu.total.drawCalls++;
+         list.SetShaderGroup(i);
+         list.UpdateVertex(params.visBuf[i], params.vertBuf[i], RoundUpToNearest4(params.vertCounts[i]));
+         list.SetVertexPrimitive(params.vertBuf[i], 0, ae_pointlist);
+         list.InstanceDraw(params.chunkCells, params.vertCounts[i]); // For use with ?s.map.cells.hlsl
+//         list.InstanceDraw(map.desc.chunkCells >> 3, mapManThreadData._ui32[i]); // For use with ?s.map.cells.x8.hlsl
       }
-      RemoveJob();
+      queue.End(list);
    }
 
    inline void QueueDrawEntities(cENT_PARAMS &params) {
-      cui8 context = params.context;
-      AddJob();
-      cfg.SetBlendState(context, 0);
-      cfg.SetDepthStencilState(context, 3, 0);
-      cfg.SetVertexFormat(context, 1u);
-      buf.SetGSR(context, params.gpuBuf[0], 0, 3u);
-      buf.SetPSR(context, params.gpuBuf[3], 0, 1u);
+      RENDER_LIST &list = queue.Begin(RenderKey(rp_opaque, 0, 0), params.context);
+      list.SetBlendState(0);
+      list.SetDepthStencilState(3, 0);
+      list.SetVertexFormat(1u);
+      list.SetGSR(params.gpuBuf[0], 0, 3u);
+      list.SetPSR(params.gpuBuf[3], 0, 1u);
       for(ui8 i = 0; i <= params.levelsOfDetail; i++) {
          cui32 vertCount = params.vertCounts[i] >> 5u;
-         cfg.SetShaderGroup(context, i + 3u);
-         buf.UpdateVertex(context, params.visBuf[i], params.vertBuf[i], RoundUpToNearest4(vertCount));
-         buf.SetVertexPrimitive(context, params.vertBuf[i], 0, ae_pointlist);
-         devcon[context]->Draw(vertCount, 0);
-         sysData.gpu.total.drawCalls++;
+         list.SetShaderGroup(i + 3u);
+         list.UpdateVertex(params.visBuf[i], params.vertBuf[i], RoundUpToNearest4(vertCount));
+         list.SetVertexPrimitive(params.vertBuf[i], 0, ae_pointlist);
+         list.Draw(vertCount);
       }
-      RemoveJob();
+      queue.End(list);
    }
 
    inline void QueueDrawGUI(cui8 context, cui16 vertexBuffer, cui16 UAVBuffer, cui32 vertexCount) {
-      AddJob();
-      cfg.SetShaderGroup(context, 4u);
-      cfg.SetVertexFormat(context, 2u);
-      buf.SetVertexPrimitive(context, vertexBuffer, 0, ae_pointlist);
-      buf.SetUAV(context, UAVBuffer, 1u, 1u);
-      devcon[context]->Draw(vertexCount, 0);
-      ++sysData.gpu.total.drawCalls;
-      RemoveJob();
+      RENDER_LIST &list = queue.Begin(RenderKey(rp_interface, 0, 0), context);
+      list.SetBlendState(1);
+      list.SetDepthStencilState(0, 0);
+      list.SetShaderGroup(4u);
+      list.SetVertexFormat(2u);
+      list.SetVertexPrimitive(vertexBuffer, 0, ae_pointlist);
+      list.SetUAV(UAVBuffer, 1u, 1u);
+      list.Draw(vertexCount);
+      queue.End(list);
    }
 
    inline void QueueDrawVoxel(cui8 context, cVEC3Ds32 location, cfp8n0_1x4 colour) {
-      AddJob();
-      DrawVoxel(context, location, colour);
-      RemoveJob();
-   }
-
-   inline void QueueClearAndFlipOutputImage(cfl32x4 colour) {
-      AddJob();
-      ClearAndFlipOutputImage(colour);
-      RemoveJob();
+      const decltype(vCube) cube = { location, colour };
+
+      RENDER_LIST &list = queue.Begin(RenderKey(rp_overlay, 0, 0), context);
+      list.SetBlendState(1);
+      list.SetDepthStencilState(0, 0);
+      list.SetShaderGroup(5);
+      list.SetVertexFormat(3);
+      list.UpdateVertexInline(&cube, sizeof(cube), ui16(bufVertex));
+      list.SetVertexPrimitive(ui16(bufVertex), 0, ae_trianglestrip);
+      list.InstanceDraw(18, 1);
+      queue.End(list);
    }
 
+   // Replays every packet recorded since the last presentation, in key order, then presents
    inline void QueuePresentOutputImage(cui8 vsyncs) {
-      cui16 localJC = (jobCount += 32768u);
-      while(activeJob) _mm_pause();
+      queue.Replay(*this);
       PresentOutputImage(vsyncs);
-      jobCount = 0;
    }
 
-   inline void RequestPresentOutputImage(cui8 vsyncs) { jobCount += 32768; }
+   inline void RequestPresentOutputImage(cui8 vsyncs) { presentRequest = 1u; }
 
    // Unmanaged presentation.
    // To be called by the thread that manages the message pump
    inline void WaitForRequestToPresentOutputImage(cui8 vsyncs) {
-      while(jobCount < 32768u) _mm_pause();
-      while(activeJob) _mm_pause();
-      PresentOutputImage(vsyncs);
-      jobCount = 0;
+      while(!presentRequest) _mm_pause();
+      presentRequest = 0;
+      QueuePresentOutputImage(vsyncs);
    }
-
-   // Managed presentation.
-   // To be called, by the thread that manages the message pump, prior to final drawing and presentation
-   inline void WaitForThreadsToComplete(void) { while(threadsBusy) _mm_pause(); while(activeJob) _mm_pause(); threadsBusy = threadsMax; }
 };
@@ -1,13 +1,17 @@
 /************************************************************
  * File: thread flags.h                 Created: 2008/10/20 *
- *                                Last modified: 2024/07/03 *
+ *                                Last modified: 2026/10/17 *
  *                                                          *
- * Desc: Defines                                            *
+ * Desc: Defines, and THREAD_LIFE set/clear/wait helpers    *
  *                                                          *
  *  Copyright (c) David William Bull. All rights reserved.  *
  ************************************************************/
 #pragma once
 
+#include <windows.h>
+#include "typedefs.h"
+
+#pragma comment(lib, "Synchronization.lib")
 #pragma intrinsic(_InterlockedOr64, _InterlockedAnd64)
 
  /*   'Thread active' flags
@@ -26,7 +30,8 @@
            63: Main thread (MAIN_THREAD_OVER)
  */
 // THREAD_LIFE memory order (GCS p3): all cross-thread modification via _InterlockedOr64/_InterlockedAnd64
-// (lock-prefixed RMW; full barrier). Plain |= / &= / ^= are forbidden on this word.
+// (lock-prefixed RMW; full barrier), through ThreadLifeSet()/ThreadLifeClear() so waiters are woken.
+// Plain |= / &= / ^= are forbidden on this word.
 // Reads are aligned 8-byte volatile loads: atomic on x86-64; acquire under /volatile:ms (the x64 default).
 constexpr cui64  MAIN_THREAD_ALIVE = 0x00000000000000001u;
 constexpr cui64  MAIN_THREAD_DIED  = 0x00000000000000002u;
@@ -113,3 +118,70 @@ constexpr cui64  VS02_THREAD_DONE  = 0x00000000000000020u;
 constexpr cui64    VS_THREAD_RESET = 0x00000000000000014u;
 constexpr cui64    VS_THREAD_DONE  = 0x00000000000000028u;
 constexpr cui64    VS_THREADS      = 0x0000000000000003Cu;
+
+//== THREAD_LIFE helpers
+
+extern al16 vui64 THREAD_LIFE;
+
+/// Sets flags in THREAD_LIFE and wakes every thread blocked in a ThreadLifeWait*() call.
+/// @return THREAD_LIFE before the change.
+inline cui64 ThreadLifeSet(cui64 flags) {
+   cui64 previous = ui64(_InterlockedOr64((vsi64ptr)&THREAD_LIFE, si64(flags)));
+   WakeByAddressAll((ptr)&THREAD_LIFE);
+   return previous;
+}
+
+/// Clears flags in THREAD_LIFE and wakes every thread blocked in a ThreadLifeWait*() call.
+/// @return THREAD_LIFE before the change.
+inline cui64 ThreadLifeClear(cui64 flags) {
+   cui64 previous = ui64(_InterlockedAnd64((vsi64ptr)&THREAD_LIFE, ~si64(flags)));
+   WakeByAddressAll((ptr)&THREAD_LIFE);
+   return previous;
+}
+
+/// Blocks until (THREAD_LIFE & mask) == want; sleeps in WaitOnAddress, so an idle waiter costs no CPU.
+/// @param timeoutMs  Milliseconds, or INFINITE.
+/// @return true if the state was reached; false on timeout.
+inline cbool ThreadLifeWaitFor(cui64 mask, cui64 want, cDWORD timeoutMs) {
+   cui64 start = GetTickCount64();
+
+   for(;;) {
+      ui64 current = THREAD_LIFE;
+      if((current & mask) == want) return true;
+
+      DWORD wait = INFINITE;
+      if(timeoutMs != INFINITE) {
+         cui64 elapsed = GetTickCount64() - start;
+         if(elapsed >= timeoutMs) return false;
+         wait = DWORD(timeoutMs - elapsed);
+      }
+      // Returns on any change to the word, including bits outside 'mask', or spuriously; the loop re-tests
+      WaitOnAddress((ptr)&THREAD_LIFE, &current, sizeof(ui64), wait);
+   }
+}
+
+/// Blocks until any bit in 'mask' differs from 'seen', or the timeout elapses.
+/// @return THREAD_LIFE at return; compare with 'seen' to tell a change from a timeout.
+inline cui64 ThreadLifeWaitChange(cui64 mask, cui64 seen, cDWORD timeoutMs) {
+   cui64 start = GetTickCount64();
+
+   for(;;) {
+      ui64 current = THREAD_LIFE;
+      if((current ^ seen) & mask) return current;
+
+      DWORD wait = INFINITE;
+      if(timeoutMs != INFINITE) {
+         cui64 elapsed = GetTickCount64() - start;
+         if(elapsed >= timeoutMs) return current;
+         wait = DWORD(timeoutMs - elapsed);
+      }
+      WaitOnAddress((ptr)&THREAD_LIFE, &current, sizeof(ui64), wait);
+   }
+}
+
+/// Frame-pacing idle for subsystem loops: sleeps up to msTime, returning early when a bit in 'mask' changes
+/// (e.g. an ALIVE or RESET request). msTime 0 pauses once, as Idle() does.
+inline void ThreadLifeIdle(cui64 mask, cui64 seen, cui32 msTime) {
+   if(msTime) ThreadLifeWaitChange(mask, seen, msTime);
+   else _mm_pause();
+}
@@ -1,6 +1,6 @@
 /************************************************************
 * File: Input functions.cpp            Created: 2024/04/22 *
-*                                Last modified: 2024/07/23 *
+*                                Last modified: 2026/10/17 *
 *                                                          *
 * Desc:                                                    *
 *                                                          *
@@ -17,6 +17,41 @@
 #include "Armada Intelligence/class_mapmanager.h"
 #include "Armada Intelligence/class_entitymanager.h"
 #include "Armada Intelligence/Input functions.h"
+#include "Command queue.h"
+
+extern COMMAND_MANAGER cmd;
+
+// Simulation edits (PAR_SIM_*) for the world-generation thread, which applies them to the map (LocalProcessing). An edit
+// is dropped if the queue is full; a held input sends it again next tic
+static inline COMMAND_ENTRY SimEdit(cui8 target, csi32 p) {
+   COMMAND_ENTRY edit = {};
+
+   edit.cmd[0] = CMD_UPDATE;
+   edit.cmd[3] = target;
+   edit.p_si32 = p;
+
+   return edit;
+}
+
+static inline void QueueGevEdit(csi32 cellIndex, cfl32 gevMod) {
+   COMMAND_ENTRY edit = SimEdit(PAR_SIM_GEV, cellIndex);
+   edit.p2_fl32[0] = gevMod;
+   cmd.AddCommand(edit);
+}
+
+static inline void QueueElementEdit(csi32 cellIndex, cui8 element) {
+   COMMAND_ENTRY edit = SimEdit(PAR_SIM_ELE, cellIndex);
+   edit.p2_ui8[0] = element;
+   cmd.AddCommand(edit);
+}
+
+static inline void QueueDensityEdit(cVEC3Ds32 &coord, cfl32 densityMod) {
+   COMMAND_ENTRY edit = SimEdit(PAR_SIM_DEN, coord.x);
+   edit.p2_si32[0] = coord.y;
+   edit.p2_si32[1] = coord.z;
+   edit.p3_fl32[0] = densityMod;
+   cmd.AddCommand(edit);
+}
 
 // Scalar inputs to be processed via NULL input pattern in each stage
 void ProcessInputs(INPUT_PROC_DATA &ipd, GLOBALCTRLVARS &ctrlVars) {
@@ -64,35 +99,26 @@ void ProcessInputs(GLOBALCTRLVARS &ctrlVars) {
    cfl32 fElapsedTime = fl32(mainTimer.GetElapsedTimeScaled());
    csi32 siWheel      = ctrlVars.mouse.z;
 
-   si32 siChunk = 0;
-
    siActiveLayer = gui.ProcessInputs(ctrlVars, (*(GUI_DESC *)ptrLib[15]).interfaceIndex); // If cursor is over GUI element, process
    if(siActiveLayer.m128i_i32[0] < 0) {
       // Locate cell under cursor
       md.mcrv.activeCell.z = siWheel;
       md.mcrv.activePlane  = cam.CursorLayerIntersect(siWheel, cfl32x4{ 0.0f, 0.0f, 0.5f }, ctrlVars.curCoords, 0, 0);
 
-      siCell  = mapMan.CalcCellIndex(md.mcrv.activeCell, 0, 0);
-      siChunk = siCell / md.chunkCells;
+      siCell = mapMan.CalcCellIndex(md.mcrv.activeCell, 0, 0);
 
       // Mouse button 0
       if(siActiveLayer.m128i_i32[1] < 0 && ctrlVars.imm.k[16] & 0x01) {
-         if(siCell != 0x080000001) {
-            mapMan.world[0].map[0]->cell[siCell].pixel->gev += fElapsedTime * 8.0f;
-            mapMan.world[0].map[0]->chunkMod[siChunk >> 6] |= ui64(0x01) << (siChunk & 0x03F);
-         }
+         if(siCell != 0x080000001) QueueGevEdit(siCell, fElapsedTime * 8.0f);
       }
       // Mouse button 1
       if(siActiveLayer.m128i_i32[2] < 0 && ctrlVars.imm.k[16] & 0x02) {
-         if(siCell != 0x080000001) {
-            mapMan.world[0].map[0]->cell[siCell].pixel->gev -= fElapsedTime * 8.0f;
-            mapMan.world[0].map[0]->chunkMod[siChunk >> 6] |= ui64(0x01) << (siChunk & 0x03F);
-         }
+         if(siCell != 0x080000001) QueueGevEdit(siCell, -fElapsedTime * 8.0f);
       }
       // Mouse button 3
       if(ctrlVars.imm.k[16] & 0x08) {
          if(siCell != 0x080000001) {
-            mapMan.ModQuadCellDensity(md.mcrv.activeCell, -fElapsedTime, 0, 0);
+            QueueDensityEdit(md.mcrv.activeCell, -fElapsedTime);
 //            gpu.gui.element_dgs[gpu.gui.element[panelElement0].vertexIndex].rotAngle -= fElapsedTime;
 //            gpu.gui.element_dgs[gpu.gui.element[textInputEl].vertexIndex].rotAngle -= fElapsedTime;
          }
@@ -100,7 +126,7 @@ void ProcessInputs(GLOBALCTRLVARS &ctrlVars) {
       // Mouse button 4
       if(ctrlVars.imm.k[16] & 0x010) {
          if(siCell != 0x080000001) {
-            mapMan.ModQuadCellDensity(md.mcrv.activeCell, fElapsedTime, 0, 0);
+            QueueDensityEdit(md.mcrv.activeCell, fElapsedTime);
 //            gpu.gui.element_dgs[gpu.gui.element[panelElement0].vertexIndex].rotAngle += fElapsedTime;
 //            gpu.gui.element_dgs[gpu.gui.element[textInputEl].vertexIndex].rotAngle += fElapsedTime;
          }
@@ -108,20 +134,17 @@ void ProcessInputs(GLOBALCTRLVARS &ctrlVars) {
       // Mouse wheel left
       if(ctrlVars.imm.k[16] & 0x020) {
          if(siCell != 0x080000001) {
-            mapMan.ModQuadCellDensity(md.mcrv.activeCell, -fElapsedTime, 0, 0);
+            QueueDensityEdit(md.mcrv.activeCell, -fElapsedTime);
          }
       }
       // Mouse wheel right
       if(ctrlVars.imm.k[16] & 0x040) {
          if(siCell != 0x080000001) {
-            mapMan.ModQuadCellDensity(md.mcrv.activeCell, fElapsedTime, 0, 0);
+            QueueDensityEdit(md.mcrv.activeCell, fElapsedTime);
          }
       }
       if(ctrlVars.imm.k[4] & 0x01)
-         if(siCell != 0x080000001) {
-            mapMan.world[0].map[0]->cell[siCell].geometry->et.x = (ctrlVars.misc[1] & 0x03u) + 1u;
-            mapMan.world[0].map[0]->chunkMod[siChunk >> 6] |= ui64(0x01u) << (siChunk & 0x03Fu);
-         }
+         if(siCell != 0x080000001) QueueElementEdit(siCell, ui8((ctrlVars.misc[1] & 0x03u) + 1u));
    }
    // Mouse button 2
    if(ctrlVars.imm.k[16] & 0x04) {
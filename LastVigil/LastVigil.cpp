@@ -1,6 +1,6 @@
 /************************************************************
  * File: LastVigil.cpp                  Created: 2022/10/08 *
- *                           Code last modified: 2024/07/22 *
+ *                           Code last modified: 2026/10/17 *
  *                                                          *
  * Desc: Initial setup, and debug management.               *
  *                                                          *
@@ -25,7 +25,7 @@ extern void DirectInput8Thread(ptr);
 #ifdef DATA_TRACKING
 SYSTEM_DATA sysData = { 1024u, true };
 #endif
-//COMMAND_MANAGER cmd;
+COMMAND_MANAGER cmd;                    // Simulation commands: input thread to world-generation thread
 cptr          ptrLib[16];               // System-wide library for important classes & resources
 CLASS_FILEOPS files       = ptrLib;
 CLASS_TIMER   mainTimer   = &ptrLib[1];
@@ -50,6 +50,10 @@ int __cdecl wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
    ///--- Replace with files. usage
    hErrorOutput = CreateFile(stErrorFilename, GENERIC_WRITE, FILE_SHARE_WRITE, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
 
+   // Back large, long-lived arrays (lalloc) with large pages when the account holds the "Lock pages in memory" right;
+   // without it lalloc falls back to malloc
+   EnableLargePages();
+
    thread.idealProcessor[ss_main]     = 0;
    thread.priority[ss_main]           = 0;
    thread.sleepTime[ss_main]          = 1u;
@@ -67,24 +71,27 @@ int __cdecl wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
    thread.sleepTime[ss_worldgen]      = 1u;
 
    // Prevent thread from shutting down (after engine reset)
-   _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~MAIN_THREAD_DIED);
+   ThreadLifeClear(MAIN_THREAD_DIED);
 
-   _InterlockedOr64((vsi64ptr)&THREAD_LIFE, (si64)MAIN_THREAD_ALIVE);
+   ThreadLifeSet(MAIN_THREAD_ALIVE);
 
    // Adjust main thread
    thread.handle[ss_main] = GetCurrentThread();
    SetThreadIdealProcessor(thread.handle[ss_main], thread.idealProcessor[ss_main]);
    SetThreadPriority(thread.handle[ss_main], thread.priority[ss_main]);
 
+   // Begin job workers; one per virtual core, less the main thread's
+   jobSystem.Start(sysData.cpu.virtCoreCount > 1u ? sysData.cpu.virtCoreCount - 1u : 1u);
+
    // Begin video rendering thread
-   _InterlockedOr64((vsi64ptr)&THREAD_LIFE, (si64)VIDEO_THREAD_ALIVE);
+   ThreadLifeSet(VIDEO_THREAD_ALIVE);
    thread.handle[ss_video] = (ptr)_beginthread(Direct3D11Thread, 0, NULL);
    Sleep(100);
    SetThreadIdealProcessor(thread.handle[ss_video], thread.idealProcessor[ss_video]);
    SetThreadPriority(thread.handle[ss_video], thread.priority[ss_video]);
 
    // Begin audio rendering thread
-   _InterlockedOr64((vsi64ptr)&THREAD_LIFE, (si64)AUDIO_THREAD_ALIVE);
+   ThreadLifeSet(AUDIO_THREAD_ALIVE);
 //   thread.handle[ss_audio] = (ptr)_beginthread(OpenAL1_1Thread, 0, NULL);
    thread.handle[ss_audio] = (ptr)_beginthreadex(nullptr, 0, OpenAL1_1Thread, nullptr, 0, nullptr);
    Sleep(100);
@@ -92,22 +99,22 @@ int __cdecl wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
    SetThreadPriority(thread.handle[ss_audio], thread.priority[ss_audio]);
 
    // Begin input processing thread
-   _InterlockedOr64((vsi64ptr)&THREAD_LIFE, (si64)INPUT_THREAD_ALIVE);
+   ThreadLifeSet(INPUT_THREAD_ALIVE);
    thread.handle[ss_input] = (ptr)_beginthread(DirectInput8Thread, 0, NULL);
    Sleep(100);
    SetThreadIdealProcessor(thread.handle[ss_input], thread.idealProcessor[ss_input]);
    SetThreadPriority(thread.handle[ss_input], thread.priority[ss_input]);
 
    // Begin world generation thread
-   _InterlockedOr64((vsi64ptr)&THREAD_LIFE, (si64)GEN_THREAD_ALIVE);
+   ThreadLifeSet(GEN_THREAD_ALIVE);
    thread.handle[ss_worldgen] = (ptr)_beginthread(WorldGenThread, 0, NULL);
    Sleep(100);
    SetThreadIdealProcessor(thread.handle[ss_worldgen], thread.idealProcessor[ss_worldgen]);
    SetThreadPriority(thread.handle[ss_worldgen], thread.priority[ss_worldgen]);
 
    // Wait for video, audio and input subsystems to finish initialising
-   while((THREAD_LIFE & VAI_THREADS_DONE) != VAI_THREADS_DONE) _mm_pause();
-   _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~VAI_THREADS_DONE);
+   ThreadLifeWaitFor(VAI_THREADS_DONE, VAI_THREADS_DONE, INFINITE);
+   ThreadLifeClear(VAI_THREADS_DONE);
 
    ///
    /// Primary application loop
@@ -117,36 +124,28 @@ int __cdecl wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 
 //      mainTimer.Update();
 
-      Idle(thread.sleepTime[ss_main]);
+      ThreadLifeIdle(MAIN_THREAD_ALIVE, threadLife, thread.sleepTime[ss_main]);
    } while (threadLife & MAIN_THREAD_ALIVE);
 
    // Request input thread shutdown
-   _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~INPUT_THREAD_ALIVE);
-   do {
-      threadLife = THREAD_LIFE & INPUT_THREAD;
-      Sleep(8);
-   } while (!(threadLife & INPUT_THREAD_DIED));
+   ThreadLifeClear(INPUT_THREAD_ALIVE);
+   ThreadLifeWaitFor(INPUT_THREAD_DIED, INPUT_THREAD_DIED, INFINITE);
 
    // Request audio thread shutdown
-   _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~AUDIO_THREAD_ALIVE);
-   do {
-      threadLife = THREAD_LIFE & AUDIO_THREAD;
-      Sleep(8);
-   } while (!(threadLife & AUDIO_THREAD_DIED));
+   ThreadLifeClear(AUDIO_THREAD_ALIVE);
+   ThreadLifeWaitFor(AUDIO_THREAD_DIED, AUDIO_THREAD_DIED, INFINITE);
 
    // Request video thread shutdown
-   _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~VIDEO_THREAD_ALIVE);
-   do {
-      threadLife = THREAD_LIFE & VIDEO_THREAD;
-      Sleep(8);
-   } while (!(threadLife & VIDEO_THREAD_DIED));
+   ThreadLifeClear(VIDEO_THREAD_ALIVE);
+   ThreadLifeWaitFor(VIDEO_THREAD_DIED, VIDEO_THREAD_DIED, INFINITE);
 
-   // Request world generation thread shutdown
-   _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~GEN_THREAD_ALIVE);
-   do {
-      threadLife = THREAD_LIFE & GEN_THREADS;
-      Sleep(8);
-   } while (!(threadLife & GEN_THREAD_DIED));
+   // Request world generation thread shutdown; closing the command queue wakes it
+   ThreadLifeClear(GEN_THREAD_ALIVE);
+   cmd.Close();
+   ThreadLifeWaitFor(GEN_THREAD_DIED, GEN_THREAD_DIED, INFINITE);
+
+   // Stop job workers; every job submitter has shut down
+   jobSystem.Stop();
 
    threadLife = GetFileSize(hErrorOutput, NULL);
    CloseHandle(hErrorOutput);
@@ -170,14 +169,15 @@ void WriteError(cchptrc text, cbool fatal) {
    if(fatal) {
       WriteFile(hErrorOutput, "   *** FATAL ERROR ***\n", 24, &dwBytes, NULL);
 
-      _InterlockedOr64((vsi64ptr)&THREAD_LIFE, (si64)MAIN_THREAD_DIED);
+      ThreadLifeSet(MAIN_THREAD_DIED);
       Sleep(1000);
    } else
       WriteFile(hErrorOutput, "\n", 1, &dwBytes, NULL);
 }
 
 inline void Try(cchptrc stEvent, cui32 uiResult, cAE_SUBSYSTEM subsystem) {
-   al16 static cchar ae_subsystem[8][20] = { "MAIN:%04X : %s", "INPUT:%04X : %s", "VIDEO:%04X : %s", "AUDIO:%04X : %s", "GUI:%04X : %s", "WORLDGEN:%04X : %s", 0, 0 };
+   al16 static cchar ae_subsystem[8][20] = { "MAIN:%04X : %s", "INPUT:%04X : %s", "VIDEO:%04X : %s",    "AUDIO:%04X : %s",
+                                             "GUI:%04X : %s",  "WORLDGEN:%04X : %s", "MAP:%04X : %s", "ENTITY:%04X : %s" };
         static char  stDescription[64];
 
    if(uiResult & 0x080000000) {
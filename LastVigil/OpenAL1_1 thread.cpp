@@ -1,6 +1,6 @@
 /************************************************************
  * File: OpenAL1_1 thread.cpp           Created: 2022/11/12 *
- *                           Code last modified: 2024/07/20 *
+ *                           Code last modified: 2026/10/17 *
  *                                                          *
  * Desc:                                                    *
  *                                                          *
@@ -17,6 +17,7 @@
 #endif
 
 unsigned int __stdcall OpenAL1_1Thread(void* argList) {
+   MEM_TAG_SCOPE memTagScope(ss_audio);
    GLOBALCOORDS        gcoLocal     = {};
    CLASS_OAL11FILEOPS  sndFiles     = files;
    ALCdevice          *ALdev        = NULL;
@@ -27,11 +28,11 @@ unsigned int __stdcall OpenAL1_1Thread(void* argList) {
    ui8                 uiNumBuffers = 4;
 
    // Prevent thread from shutting down (after engine reset)
-   _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~AUDIO_THREAD_DIED);
+   ThreadLifeClear(AUDIO_THREAD_DIED);
 
 Reinitialise_:
 
-   _InterlockedAnd64((vsi64ptr)&THREAD_LIFE, (si64)~AUDIO_THREAD_RESET);
+   ThreadLifeClear(AUDIO_THREAD_RESET);
 
    // Initialisation
    CoInitializeEx(nullptr, COINIT_MULTITHREADED);
@@ -65,7 +66,7 @@ Reinitialise_:
    siSound[0] = sndFiles.LoadWAV(L"mirrors.wav", L"sounds");
    //alSourcePlay(siSound[0]);
 
-   _InterlockedOr64((vsi64ptr)&THREAD_LIFE, (si64)AUDIO_THREAD_DONE);
+   ThreadLifeSet(AUDIO_THREAD_DONE);
 
    ///
    /// Primary rendering loop
@@ -80,11 +81,11 @@ Reinitialise_:
       alListenerfv(AL_VELOCITY, gcoLocal.v);
       alListenerfv(AL_ORIENTATION, gcoLocal.o);
 
-      Idle(thread.sleepTime[ss_audio]);
+      ThreadLifeIdle(AUDIO_THREAD_ALIVE | AUDIO_THREAD_RESET, threadLife, thread.sleepTime[ss_audio]);
    } while (threadLife & AUDIO_THREAD_ALIVE);
 
    CoUninitialize();
-   _InterlockedOr64((vsi64ptr)&THREAD_LIFE, (si64)AUDIO_THREAD_DIED);
+   ThreadLifeSet(AUDIO_THREAD_DIED);
    //_endthread();
    return 0;
 }
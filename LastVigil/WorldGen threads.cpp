@@ -1,8 +1,8 @@
 /************************************************************
  * File: WorldGen threads.cpp           Created: 2022/10/09 *
- *                           Code last modified: 2022/10/09 *
+ *                           Code last modified: 2026/10/17 *
  *                                                          *
- * Desc: Entity creation & processing.                      *
+ * Desc: Entity creation & processing; simulation commands. *
  *                                                          *
  *  Copyright (c) David William Bull. All rights reserved.  *
  ************************************************************/
@@ -10,10 +10,43 @@
 #include "master header.h"
 #include "thread flags.h"
 #include "WorldGen threads.h"
+#include "Armada Intelligence/class_mapmanager.h"
 
 extern COMMAND_MANAGER cmd;
 
+// Applies one simulation edit queued by the input thread (Input functions.cpp). Returns 0; 0x080000001 for a command
+// this thread does not handle; 0x080000002 if the edited cell's chunk cannot be made resident
+si32 LocalProcessing(COMMAND_ENTRY *command) {
+   if(command->cmd[0] != CMD_UPDATE || !ptrLib[6]) return 0x080000001;
+
+   CLASS_MAPMAN &mapMan = *(CLASS_MAPMAN *)ptrLib[6];
+   MAP_DESC     &md     = *(MAP_DESC *)ptrLib[14];
+   MAP          &map    = *mapMan.world[0].map[0];
+   csi32         cell   = command->p_si32;
+   csi32         chunk  = cell / si32(md.chunkCells);
+
+   switch(command->cmd[3]) {
+   case PAR_SIM_DEN:
+      mapMan.ModQuadCellDensity({ command->p_si32, command->p2_si32[0], command->p2_si32[1] }, command->p3_fl32[0], 0, 0);
+      return 0;
+   case PAR_SIM_GEV:
+      if(!mapMan.FaultChunk(map, chunk, true)) return 0x080000002;
+      map.cell[cell].pixel->gev += command->p2_fl32[0];
+      break;
+   case PAR_SIM_ELE:
+      if(!mapMan.FaultChunk(map, chunk, true)) return 0x080000002;
+      map.cell[cell].geometry->et.x = command->p2_ui8[0];
+      break;
+   default:
+      return 0x080000001;
+   }
+   ATOMIC_BITSET(map.chunkMod, md.mapChunks).Set(chunk);
+
+   return 0;
+}
+
 void WorldGenThread(ptr argList) {
+   MEM_TAG_SCOPE memTagScope(ss_worldgen);
    al16 ui64 threadLife;
 //        si32 siGroup[1], siSprite[1];
 
@@ -33,13 +66,14 @@ void WorldGenThread(ptr argList) {
 //   cmd.queue[0].cmd[1] = PAR_VID_VER;
 //   cmd.queue[0].cmd[0] = CMD_CREATE;
 
-   // Primary processing loop
+   // Primary processing loop; applies queued simulation commands, sleeping while there are none, until shutdown is requested.
+   // Shutdown clears GEN_THREAD_ALIVE and then closes the queue (cmd.Close()), which ends the wait
    do {
-      threadLife = THREAD_LIFE & GEN_THREADS;
+      if(cmd.WaitForCommands()) cmd.ProcessCommands();
 
-      Sleep(1);
+      threadLife = THREAD_LIFE & GEN_THREADS;
    } while (threadLife & GEN_THREAD_ALIVE);
 
-   _InterlockedOr64((vsi64ptr)&THREAD_LIFE, (si64)GEN_THREAD_DIED);
+   ThreadLifeSet(GEN_THREAD_DIED);
    //_endthread();
 }
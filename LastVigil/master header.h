@@ -1,6 +1,6 @@
 /************************************************************
  * File: master header.h                Created: 2022/10/09 *
- *                                Last modified: 2024/03/30 *
+ *                                Last modified: 2026/10/17 *
  *                                                          *
  * Desc:                                                    *
  *                                                          *
@@ -30,6 +30,9 @@
    #include <memory management.h>
    #include <Common functions.h>
    #include <spinlocks.h>
+   #include <spinlock profile.h>
+   #include <job system.h>
+   #include <atomic bitset.h>
    #include <stdlib.h>
    #include <tchar.h>
    #include <thread flags.h>
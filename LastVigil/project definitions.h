@@ -1,6 +1,6 @@
 /************************************************************
  * File: project definitions.h          Created: 2024/06/15 *
- *                                Last modified: 2024/07/30 *
+ *                                Last modified: 2026/10/17 *
  *                                                          *
  * Desc:                                                    *
  *                                                          *
@@ -15,6 +15,18 @@
 
 #include "typedefs.h"
 
+// Layout of map cells' simulation fields (Map structures.h): CELLS_AOS keeps CELL records, CELLS_SOA per-chunk field arrays
+// (MAP_CELLS); CELL remains the file record either way
+struct CELLS_AOS;
+struct CELLS_SOA;
+typedef CELLS_AOS MAP_CELL_LAYOUT;
+
+// Wait policy of every engine spin lock (spinlocks.h): SPIN_PLAIN spins bare, SPIN_PROFILE ("spinlock profile.h") counts
+// each call site's contention and stalls into sysData.spin
+struct SPIN_PLAIN;
+struct SPIN_PROFILE;
+typedef SPIN_PLAIN SPIN_WAIT_POLICY;
+
 constexpr auto CFG_MAX_SHADERS = 128u; // Maximum number of shaders
 constexpr auto CFG_MAX_STATES  = 16u;  // Maximum number of sampler states
 
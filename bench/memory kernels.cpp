@@ -0,0 +1,257 @@
+/*
+ * File: memory kernels.cpp
+ * Version: v1.0
+ * Owner: David William Bull
+ * Created: 2026-10-17
+ * Last Modified: 2026-10-17
+ * Description: Headless microbenchmark of the memory management.h kernels against the C runtime, emitted as JSON.
+ * To Do: 1) Pin the process to one core and raise its priority before sampling, to tighten the spread on shared hosts.
+ *        2) Add a per-kernel size filter once the sweep is used in CI.
+ * Dependencies: memory management.h, job system.h, cpu features.h, typedefs.h, stdio.h, string.h, chrono, intrin.h
+ * ISA: AVX2 | AVX-512
+ * Thread-safety: N/A
+ * Reviewers: David William Bull
+ * License: MIT  Copyright: David William Bull
+ */
+
+//== Usage
+//   Build: msbuild "bench\memory kernels.vcxproj" /p:Configuration=Release /p:Platform=x64  (settings in bench.props)
+//   "memory kernels.exe" [--tier avx2|avx512] [--min bytes] [--max bytes] [--samples n] [--baseline file.json] > result.json
+//
+//   Sweeps every power-of-2 size in [min, max] (default 64 B ~ 1 GiB) for each kernel, cache-hot and cache-cold, and prints
+//   one JSON result per line. Throughput counts the bytes written per call; cycles are TSC ticks, not core clocks.
+//   Hot:  one buffer pair, warmed before sampling, reused by every repetition.
+//   Cold: repetitions walk distinct slices of a COLD_POOL_BYTES pool, flushed from every cache level before each sample.
+//   --baseline reads a previous run's output and marks each result whose median throughput fell by >= 3% (GCS bd2); the
+//   process then exits with 1. "crossover" is the smallest size at which Stream32 beats Copy32 by >= 3%.
+//   ParallelZero runs on a job system of one worker per logical processor but one, as in the engine.
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <intrin.h>
+#include "../include/typedefs.h"
+#include "../include/cpu features.h"
+#include "../include/memory management.h"
+
+// Wait policy of the job system's locks (spinlocks.h); the engine sets its own in project definitions.h
+struct SPIN_PLAIN;
+typedef SPIN_PLAIN SPIN_WAIT_POLICY;
+
+#include "../include/job system.h"
+
+constexpr cui64 DEFAULT_MIN_BYTES   = 64u;
+constexpr cui64 DEFAULT_MAX_BYTES   = 1ull << 30;
+constexpr cui64 COLD_POOL_BYTES     = 256ull << 20; // Comfortably larger than any current last-level cache
+constexpr cui64 TARGET_SAMPLE_BYTES = 64ull << 20;  // Bytes written per hot sample, before clamping to MAX_REPS
+constexpr cui64 MAX_REPS            = 1ull << 20;
+constexpr cui32 DEFAULT_SAMPLES     = 5u;
+constexpr cui32 MAX_SAMPLES         = 31u;
+constexpr cui32 MAX_BASELINE        = 4096u;
+constexpr cfl64 REGRESSION_RATIO    = 0.97;         // GCS bd2: 3% threshold
+
+typedef void (*BENCH_FN)(ptrc dest, cptrc source, cui64 numBytes);
+
+struct BENCH_KERNEL {
+   cchptr   name;
+   BENCH_FN func;
+};
+
+struct BENCH_RESULT {
+   char  kernel[32];
+   char  cache[8];
+   ui64  bytes;
+   fl64  gbps;
+};
+
+//-- Kernels under test, normalised to (dest, source, numBytes)
+
+static void BenchMemcpy(ptrc dest, cptrc source, cui64 numBytes) { memcpy(dest, source, numBytes); }
+static void BenchMemset(ptrc dest, cptrc source, cui64 numBytes) { memset(dest, 0x0A5, numBytes); }
+static void BenchCopy(ptrc dest, cptrc source, cui64 numBytes) { Copy(source, dest, numBytes); }
+static void BenchCopy32(ptrc dest, cptrc source, cui64 numBytes) { Copy32(source, dest, numBytes); }
+static void BenchCopy64(ptrc dest, cptrc source, cui64 numBytes) { Copy64(source, dest, numBytes); }
+static void BenchStream16(ptrc dest, cptrc source, cui64 numBytes) { Stream16(source, dest, numBytes); }
+static void BenchStream32(ptrc dest, cptrc source, cui64 numBytes) { Stream32(source, dest, numBytes); }
+static void BenchStream64(ptrc dest, cptrc source, cui64 numBytes) { Stream64(source, dest, numBytes); }
+static void BenchStream(ptrc dest, cptrc source, cui64 numBytes) { Stream(source, dest, numBytes); }
+static void BenchMset(ptrc dest, cptrc source, cui64 numBytes) { mset(dest, numBytes, cui8(0x0A5u)); }
+static void BenchMzero(ptrc dest, cptrc source, cui64 numBytes) { mzero(dest, numBytes); }
+static void BenchParallelZero(ptrc dest, cptrc source, cui64 numBytes) { ParallelZero(dest, numBytes); }
+
+// Allocation, fill and release; dest and source are unused
+static void BenchSalloc(ptrc dest, cptrc source, cui64 numBytes) {
+   ptrc pointer = salloc(numBytes, 64u, cui8(0x0A5u));
+   if(pointer) mdealloc(pointer);
+}
+
+static const BENCH_KERNEL BENCH_KERNELS[] = {
+   { "memcpy",   BenchMemcpy },   { "Copy",     BenchCopy },     { "Copy32",   BenchCopy32 },   { "Copy64", BenchCopy64 },
+   { "Stream16", BenchStream16 }, { "Stream32", BenchStream32 }, { "Stream64", BenchStream64 }, { "Stream", BenchStream },
+   { "memset",   BenchMemset },   { "mset",     BenchMset },     { "mzero",    BenchMzero },    { "salloc", BenchSalloc },
+   { "ParallelZero", BenchParallelZero },
+};
+
+//-- Helpers
+
+// Evict [addr, addr + numBytes) from every cache level
+static void FlushRange(cptrc addr, cui64 numBytes) {
+   for(ui64 i = 0; i < numBytes; i += 64u) _mm_clflush(&((cui8ptr)addr)[i]);
+   _mm_mfence();
+}
+
+// TSC ticks per nanosecond, measured against the steady clock over ~100 ms
+static fl64 CalibrateTsc(void) {
+   const auto start    = std::chrono::steady_clock::now();
+   cui64      tscStart = __rdtsc();
+   while(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100));
+   cui64      tscEnd   = __rdtsc();
+   cfl64      ns       = fl64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+   return fl64(tscEnd - tscStart) / ns;
+}
+
+static void SortAscending(fl64ptr values, cui32 count) {
+   for(ui32 i = 1; i < count; i++)
+      for(ui32 j = i; j && values[j - 1u] > values[j]; j--) { cfl64 t = values[j];   values[j] = values[j - 1u];   values[j - 1u] = t; }
+}
+
+// Reads the result lines written by a previous run; returns the number of entries read
+static ui32 LoadBaseline(cchptr path, BENCH_RESULT *const baseline) {
+   FILE *file;
+   char  line[256];
+   ui32  count = 0;
+
+   if(fopen_s(&file, path, "r") || !file) return 0;
+   while(count < MAX_BASELINE && fgets(line, sizeof(line), file)) {
+      BENCH_RESULT &entry = baseline[count];
+      if(sscanf_s(line, " {\"kernel\":\"%31[^\"]\",\"cache\":\"%7[^\"]\",\"bytes\":%llu,\"gbps\":%lf", entry.kernel, 32u, entry.cache, 8u,
+                  &entry.bytes, &entry.gbps) == 4) count++;
+   }
+   fclose(file);
+
+   return count;
+}
+
+static const BENCH_RESULT *FindBaseline(const BENCH_RESULT *const baseline, cui32 count, cchptr kernel, cchptr cache, cui64 bytes) {
+   for(ui32 i = 0; i < count; i++)
+      if(baseline[i].bytes == bytes && !strcmp(baseline[i].kernel, kernel) && !strcmp(baseline[i].cache, cache)) return &baseline[i];
+   return NULL;
+}
+
+//== Entry point
+
+int main(int argc, char **argv) {
+   ui64  minBytes = DEFAULT_MIN_BYTES, maxBytes = DEFAULT_MAX_BYTES;
+   ui32  samples  = DEFAULT_SAMPLES,   numBaseline = 0,   numRegressions = 0;
+   cchptr baselinePath = NULL;
+   ui8   isaBits  = 0x0FFu;
+
+   for(si32 i = 1; i < argc; i++) {
+      if(i + 1 >= argc) break;
+      if(!strcmp(argv[i], "--tier")) {
+         ++i;
+              if(!strcmp(argv[i], "avx2"))   isaBits = ISA_AVX2;
+         else if(!strcmp(argv[i], "avx512")) isaBits = ISA_AVX512F;
+      }
+      else if(!strcmp(argv[i], "--min"))      minBytes = _strtoui64(argv[++i], NULL, 0);
+      else if(!strcmp(argv[i], "--max"))      maxBytes = _strtoui64(argv[++i], NULL, 0);
+      else if(!strcmp(argv[i], "--samples"))  samples  = ui32(strtoul(argv[++i], NULL, 0));
+      else if(!strcmp(argv[i], "--baseline")) baselinePath = argv[++i];
+   }
+   if(minBytes < 64u) minBytes = 64u;
+   if(maxBytes < minBytes) maxBytes = minBytes;
+   if(!samples) samples = 1u;
+   if(samples > MAX_SAMPLES) samples = MAX_SAMPLES;
+
+   cui8   tier     = SelectMemKernels(isaBits);
+   cchptr tierName = tier == ISA_AVX512F ? "AVX-512F" : "AVX2";
+
+   jobSystem.Start(ui32(GetActiveProcessorCount(ALL_PROCESSOR_GROUPS)) - 1u);
+
+   BENCH_RESULT *const baseline = baselinePath ? (BENCH_RESULT *)malloc64(sizeof(BENCH_RESULT) * MAX_BASELINE) : NULL;
+   if(baseline) numBaseline = LoadBaseline(baselinePath, baseline);
+
+   cui64     poolBytes = maxBytes > COLD_POOL_BYTES ? maxBytes : COLD_POOL_BYTES;
+   ui8ptrc   source    = (ui8ptr)malloc64(poolBytes);
+   ui8ptrc   dest      = (ui8ptr)malloc64(poolBytes);
+   if(!source || !dest) {
+      fprintf(stderr, "memory kernels: failed to allocate 2 x %llu bytes\n", poolBytes);
+      return 2;
+   }
+   mset(source, poolBytes, cui8(0x05Au));
+   mzero(dest, poolBytes);
+
+   cfl64 tscPerNs = CalibrateTsc();
+   ui64  crossover[2] = {};
+   fl64  copy32Gbps[2] = {};
+
+   printf("{\"bench\":\"memory kernels\",\"version\":1,\"tier\":\"%s\",\"tsc_ghz\":%.3f,\"samples\":%u,\"baseline_entries\":%u,\n"
+          "\"results\":[\n", tierName, tscPerNs, samples, numBaseline);
+
+   bool first = true;
+   for(ui64 bytes = minBytes; bytes && bytes <= maxBytes; bytes <<= 1) {
+      for(ui8 cold = 0; cold < 2; cold++) {
+         cchptr cache  = cold ? "cold" : "hot";
+         cui64  slices = poolBytes / bytes;
+         ui64   reps   = TARGET_SAMPLE_BYTES / bytes;
+         if(!reps) reps = 1u;
+         if(reps > MAX_REPS) reps = MAX_REPS;
+         if(cold && reps > slices) reps = slices;
+
+         for(const BENCH_KERNEL &kernel : BENCH_KERNELS) {
+            fl64 gbps[MAX_SAMPLES], cpb[MAX_SAMPLES];
+
+            for(ui32 s = 0; s < samples; s++) {
+               if(cold) {
+                  FlushRange(source, reps * bytes);
+                  FlushRange(dest, reps * bytes);
+               } else kernel.func(dest, source, bytes);
+
+               const auto start    = std::chrono::steady_clock::now();
+               cui64      tscStart = __rdtsc();
+               for(ui64 r = 0; r < reps; r++) {
+                  cui64 offset = cold ? r * bytes : 0;
+                  kernel.func(&dest[offset], &source[offset], bytes);
+               }
+               cui64      tscEnd   = __rdtsc();
+               cfl64      ns       = fl64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+               cfl64      total    = fl64(reps * bytes);
+
+               gbps[s] = ns > 0.0 ? total / ns : 0.0;
+               cpb[s]  = fl64(tscEnd - tscStart) / total;
+            }
+            SortAscending(gbps, samples);
+            SortAscending(cpb, samples);
+
+            cfl64 medianGbps = gbps[samples >> 1], medianCpb = cpb[samples >> 1];
+
+            if(!strcmp(kernel.name, "Copy32")) copy32Gbps[cold] = medianGbps;
+            if(!strcmp(kernel.name, "Stream32") && !crossover[cold] && medianGbps >= copy32Gbps[cold] / REGRESSION_RATIO) crossover[cold] = bytes;
+
+            printf("%s {\"kernel\":\"%s\",\"cache\":\"%s\",\"bytes\":%llu,\"gbps\":%.4f,\"cycles_per_byte\":%.5f,\"gbps_min\":%.4f,\"gbps_max\":%.4f,"
+                   "\"reps\":%llu", first ? "" : ",\n", kernel.name, cache, bytes, medianGbps, medianCpb, gbps[0], gbps[samples - 1u], reps);
+            first = false;
+
+            const BENCH_RESULT *const prior = FindBaseline(baseline, numBaseline, kernel.name, cache, bytes);
+            if(prior && prior->gbps > 0.0) {
+               const bool regressed = medianGbps < prior->gbps * REGRESSION_RATIO;
+               printf(",\"baseline_gbps\":%.4f,\"delta_pct\":%.2f,\"regression\":%s", prior->gbps, (medianGbps / prior->gbps - 1.0) * 100.0,
+                      regressed ? "true" : "false");
+               numRegressions += regressed;
+            }
+            printf("}");
+         }
+      }
+   }
+
+   printf("\n],\n\"crossover\":{\"kernel\":\"Stream32\",\"versus\":\"Copy32\",\"hot\":%llu,\"cold\":%llu},\n\"regressions\":%u}\n",
+          crossover[0], crossover[1], numRegressions);
+
+   jobSystem.Stop();
+
+   mdealloc(dest);
+   mdealloc(source);
+   if(baseline) mdealloc(baseline);
+
+   return numRegressions ? 1 : 0;
+}
@@ -0,0 +1,41 @@
+#!/bin/sh
+# File: build.sh (bench POSIX shim)   Created: 2026/10/17
+#
+# Builds a bench with g++ on Linux, for hosts without MSVC:
+#    sh "bench/posix shim/build.sh" [bench] [output]
+#       bench:  "spin locks" (default) or "render commands"
+#       output: default ./spin-locks or ./render-commands
+#
+# Limits -- read before comparing its numbers with an MSVC build:
+#  1) Threads are pthreads and SwitchToThread() is sched_yield(); the Windows scheduler's quantum and yield behaviour
+#     differ, so oversubscribed runs are not comparable across the two.
+#  2) GCC ignores an alignment attribute written before 'struct' (al64 struct X), which MSVC honours. The sources are
+#     therefore compiled from temporary copies in which 'al64 struct X' reads 'struct al64 X' (al16/al32 likewise).
+#  3) g++ -O2 code generation is not MSVC /O2; single-thread costs differ by compiler.
+#  4) "render commands" takes vreserve/vcommit/vrelease from the shim's memory management.h (mmap/mprotect), not the
+#     engine's (VirtualAlloc); page commits cost differently, though a warmed-up list commits nothing per frame.
+# Record results from this build in "bench/results/<bench>.md" labelled as such, never as MSVC figures.
+
+set -e
+shim=$(cd "$(dirname "$0")" && pwd)
+root="$shim/../.."
+bench=${1:-spin locks}
+case "$bench" in
+   "spin locks")      headers="typedefs.h;spinlocks.h" ;;
+   "render commands") headers="typedefs.h;render commands.h" ;;
+   *) echo "build.sh: unknown bench '$bench'" >&2; exit 1 ;;
+esac
+out=${2:-./$(echo "$bench" | tr ' ' '-')}
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+mkdir -p "$tmp/include" "$tmp/bench"
+echo "$headers" | tr ';' '\n' | while IFS= read -r f; do
+   sed -E 's/^(al16|al32|al64) struct ([A-Za-z_0-9]+)/struct \1 \2/' "$root/include/$f" > "$tmp/include/$f"
+done
+sed -E 's/^(al16|al32|al64) struct ([A-Za-z_0-9]+)/struct \1 \2/' "$root/bench/$bench.cpp" > "$tmp/bench/$bench.cpp"
+
+g++ -O2 -std=c++20 -mavx2 -mbmi -mbmi2 -mfma -pthread -w -I"$shim" \
+    '-D__declspec(x)=__attribute__((x))' -Dalign=aligned '-D__pragma(x)=' -D__forceinline=inline \
+    -D__int8=char -D__int16=short -D__int32=int '-D__int64=long long' -D__bfloat16=__bf16 \
+    "$tmp/bench/$bench.cpp" -o "$out"
@@ -0,0 +1,32 @@
+/************************************************************
+ * File: intrin.h (bench POSIX shim)    Created: 2026/10/17 *
+ *                                Last modified: 2026/10/17 *
+ *                                                          *
+ * Desc: MSVC _Interlocked* intrinsics on GCC atomics.      *
+ *                                                          *
+ *  Copyright (c) David William Bull. All rights reserved.  *
+ ************************************************************/
+#pragma once
+
+#include <immintrin.h>
+#include <x86intrin.h>
+
+// MSVC's long is 32 bits and the headers cast 32-bit words to (vol long *); LP64's long is 64 bits, so the 'long' forms
+// operate on the 32-bit word the pointer really addresses. Every one is a full barrier, as LOCK-prefixed MSVC intrinsics are
+inline long _InterlockedCompareExchange(volatile long *p, long x, long c) {
+   return __sync_val_compare_and_swap((volatile int *)p, int(c), int(x));
+}
+inline long _InterlockedExchange(volatile long *p, long v)    { return __atomic_exchange_n((volatile int *)p, int(v), __ATOMIC_SEQ_CST); }
+inline long _InterlockedExchangeAdd(volatile long *p, long v) { return __atomic_fetch_add((volatile int *)p, int(v), __ATOMIC_SEQ_CST); }
+inline long _InterlockedIncrement(volatile long *p)           { return __atomic_add_fetch((volatile int *)p, 1, __ATOMIC_SEQ_CST); }
+inline long _InterlockedDecrement(volatile long *p)           { return __atomic_sub_fetch((volatile int *)p, 1, __ATOMIC_SEQ_CST); }
+
+inline long long _InterlockedCompareExchange64(volatile long long *p, long long x, long long c) {
+   return __sync_val_compare_and_swap(p, c, x);
+}
+inline long long _InterlockedExchangeAdd64(volatile long long *p, long long v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
+inline long long _InterlockedIncrement64(volatile long long *p)                { return __atomic_add_fetch(p, 1, __ATOMIC_SEQ_CST); }
+
+#define _ReadWriteBarrier()                        __asm__ __volatile__("" ::: "memory")
+#define _InterlockedCompareExchangePointer(p, x, c) __sync_val_compare_and_swap((p), (c), (x))
+#define _InterlockedExchangePointer(p, v)           __atomic_exchange_n((p), (v), __ATOMIC_SEQ_CST)
@@ -0,0 +1,34 @@
+/************************************************************
+ * File: memory management.h (shim)     Created: 2026/10/17 *
+ *                                Last modified: 2026/10/17 *
+ *                                                          *
+ * Desc: The vreserve/vcommit/vrelease trio of the engine's *
+ *       memory management.h, on mmap/mprotect, for bench   *
+ *       builds on Linux hosts. build.sh compiles it in     *
+ *       place of the engine header; nothing else of that   *
+ *       header is provided.                                *
+ *                                                          *
+ *  Copyright (c) David William Bull. All rights reserved.  *
+ ************************************************************/
+#pragma once
+
+#include <sys/mman.h>
+
+constexpr cui64 VM_PAGE_BYTES = 4096u;
+
+inline ptrc vreserve(csize_t maxBytes) {
+   ptrc base = mmap(NULL, maxBytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+   return base == MAP_FAILED ? NULL : base;
+}
+
+inline cbool vcommit(ptrc base, csize_t oldBytes, csize_t newBytes) {
+   cui64 from = (oldBytes + VM_PAGE_BYTES - 1u) & ~(VM_PAGE_BYTES - 1u), to = (newBytes + VM_PAGE_BYTES - 1u) & ~(VM_PAGE_BYTES - 1u);
+
+   if(to <= from) return true;
+   return mprotect(&((ui8ptr)base)[from], to - from, PROT_READ | PROT_WRITE) == 0;
+}
+
+// munmap needs the reservation's size, which the engine's form passes for its read-outs anyway
+inline void vrelease(ptrc base, csize_t, csize_t maxBytes) {
+   if(base) munmap(base, maxBytes);
+}
@@ -0,0 +1,91 @@
+/************************************************************
+ * File: windows.h (bench POSIX shim)   Created: 2026/10/17 *
+ *                                Last modified: 2026/10/17 *
+ *                                                          *
+ * Desc: The few Win32 calls the benches make, on           *
+ *       pthreads, for runs on Linux hosts with g++. Not an *
+ *       engine header; see build.sh for its limits.        *
+ *                                                          *
+ *  Copyright (c) David William Bull. All rights reserved.  *
+ ************************************************************/
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tuple>
+
+#define _WINDEF_   // typedefs.h: BYTE/WORD/DWORD come from here
+#define _WINNT_
+
+typedef unsigned char  BYTE;
+typedef unsigned short WORD;
+typedef unsigned int   DWORD;   // 32-bit, as on Windows
+typedef void          *HANDLE;
+typedef void          *LPVOID;
+typedef int            BOOL;
+typedef struct HWND__ *HWND;
+
+#define WINAPI
+#define TRUE     1
+#define INFINITE 0xFFFFFFFFu
+
+#define FAST_FAIL_INVALID_ARG     5
+#define FAST_FAIL_FATAL_APP_EXIT  7
+#define __fastfail(code) __builtin_trap()
+
+struct SYSTEM_INFO { DWORD dwNumberOfProcessors; };
+
+inline void  GetSystemInfo(SYSTEM_INFO *info) { info->dwNumberOfProcessors = DWORD(sysconf(_SC_NPROCESSORS_ONLN)); }
+inline void  Sleep(DWORD ms) { timespec t = { time_t(ms / 1000u), long(ms % 1000u) * 1000000L }; nanosleep(&t, NULL); }
+inline BOOL  SwitchToThread(void) { return sched_yield() == 0; }
+inline DWORD GetCurrentThreadId(void) { return DWORD(gettid()); }
+inline void  OutputDebugStringA(const char *text) { fputs(text, stderr); }
+
+// A thread handle owns the pthread and the Win32-style entry point it runs
+struct SHIM_THREAD {
+   pthread_t thread;
+   DWORD   (*entry)(LPVOID);
+   LPVOID    param;
+};
+
+inline void *ShimThreadEntry(void *arg) { SHIM_THREAD *t = (SHIM_THREAD *)arg; t->entry(t->param); return NULL; }
+
+inline HANDLE CreateThread(void *, size_t, DWORD (*entry)(LPVOID), LPVOID param, DWORD, DWORD *) {
+   SHIM_THREAD *t = new SHIM_THREAD { 0, entry, param };
+   if(pthread_create(&t->thread, NULL, ShimThreadEntry, t)) { delete t; return NULL; }
+   return t;
+}
+
+// Joins every thread; only the wait-all, INFINITE form is supported
+inline DWORD WaitForMultipleObjects(DWORD count, HANDLE *handles, BOOL, DWORD) {
+   for(DWORD i = 0; i < count; i++) pthread_join(((SHIM_THREAD *)handles[i])->thread, NULL);
+   return 0;
+}
+
+inline BOOL CloseHandle(HANDLE handle) { delete (SHIM_THREAD *)handle; return TRUE; }
+
+inline int fopen_s(FILE **file, const char *path, const char *mode) { *file = fopen(path, mode); return *file ? 0 : 1; }
+
+// sscanf_s follows each string destination with its buffer size; sscanf takes none, so those are dropped
+template<typename... A, typename T, typename... R>
+inline int ShimScan(const char *buffer, const char *format, std::tuple<A...> args, T *p, R... rest);
+
+template<typename... A> inline int ShimScan(const char *buffer, const char *format, std::tuple<A...> args) {
+   return std::apply([&](auto... p) { return sscanf(buffer, format, p...); }, args);
+}
+template<typename... A, typename... R>
+inline int ShimScan(const char *buffer, const char *format, std::tuple<A...> args, char *str, unsigned size, R... rest) {
+   return ShimScan(buffer, format, std::tuple_cat(args, std::tuple<char *>(str)), rest...);
+}
+template<typename... A, typename T, typename... R>
+int ShimScan(const char *buffer, const char *format, std::tuple<A...> args, T *p, R... rest) {
+   return ShimScan(buffer, format, std::tuple_cat(args, std::tuple<T *>(p)), rest...);
+}
+
+#define sscanf_s(buffer, format, ...) ShimScan(buffer, format, std::tuple<>(), __VA_ARGS__)
+#define sprintf_s snprintf
@@ -0,0 +1,235 @@
+/*
+ * File: render commands.cpp
+ * Version: v1.0
+ * Owner: David William Bull
+ * Created: 2026-10-17
+ * Last Modified: 2026-10-17
+ * Description: Headless benchmark and self-check of render commands.h: threads record keyed packets, the main thread merges
+ *              and replays them through RENDER_BACKEND_NULL. Emitted as JSON.
+ * To Do: 1) Vary packet size (commands per packet) as well as thread count.
+ *        2) Time a D3D11 replay of the same lists once a WARP device is available headless.
+ * Dependencies: render commands.h, typedefs.h, windows.h, stdio.h, string.h, chrono, intrin.h
+ * ISA: Scalar
+ * Thread-safety: N/A
+ * Reviewers: David William Bull
+ * License: MIT  Copyright: David William Bull
+ */
+
+//== Usage
+//   "render commands.exe" [--min threads] [--max threads] [--frames n] [--packets per-thread] [--baseline file.json] > result.json
+//   Build: msbuild "bench\render commands.vcxproj" /p:Configuration=Release /p:Platform=x64  (settings in bench.props)
+//          sh "bench/posix shim/build.sh" "render commands"  on Linux hosts without MSVC; not comparable with the MSVC build
+//
+//   For each power-of-2 thread count in [min, max] (default 1~16) every thread records 'packets' packets per frame (default
+//   128) with pseudo-random keys; the main thread then replays the frame through the null backend. Each frame is also
+//   recorded on one thread into a single list and replayed, and the two replays must match (same checksum, no key out of
+//   order, every packet replayed); a mismatch marks the result "ok":false and the process exits with 1.
+//   "record_mpps": million packets recorded per second, all threads, including the frame hand-off.
+//   "replay_mpps": million packets merged and replayed per second by the main thread.
+//   --baseline reads a previous run's output and marks each result whose replay throughput fell by >= 3% (GCS bd2).
+//   Record runs in "bench/results/render commands.md" with the build configuration, per GCS bd1.
+
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <intrin.h>
+#include "../include/typedefs.h"
+#include "../include/render commands.h"
+
+constexpr cui32 DEFAULT_MIN_THREADS = 1u;
+constexpr cui32 DEFAULT_MAX_THREADS = MAX_RENDER_THREADS;
+constexpr cui32 DEFAULT_FRAMES      = 256u;
+constexpr cui32 DEFAULT_PACKETS     = 128u;
+constexpr cui32 COMMANDS_PER_PACKET = 7u;
+constexpr cui32 MAX_BASELINE        = 64u;
+constexpr cfl64 REGRESSION_RATIO    = 0.97;  // GCS bd2: 3% threshold
+
+struct BENCH_RESULT {
+   ui32 threads;
+   fl64 mpps;
+};
+
+// State shared by the recording threads
+al64 struct BENCH_SHARED {
+   RENDER_QUEUE *queue;
+   ui32          packets;
+   vui32         frame;    // Incremented by the main thread to start each frame; ~0 ends the run
+   al64 vui32    done;     // Threads finished with the current frame
+};
+
+struct BENCH_WORKER {
+   BENCH_SHARED *shared;
+   ui32          index;
+};
+
+//-- Recording
+
+// Records packet 'i' of thread 'thread' in 'frame'. Keys are unique, so the replay order is fully determined
+static void RecordPacket(RENDER_QUEUE &queue, cui32 frame, cui32 thread, cui32 i) {
+   cui32 hash = (frame * 0x09E3779B1u) ^ (thread * 0x085EBCA77u) ^ (i * 0x0C2B2AE3Du);
+   cui64 key  = RenderKey(ui8(hash & 0x03u), ui8(hash >> 8), (ui64(hash >> 16) << 32) | (ui64(thread) << 24) | i);
+
+   RENDER_LIST &list = queue.Begin(key, 0);
+   list.SetBlendState(ui8(i & 0x01u));
+   list.SetDepthStencilState(3, 0);
+   list.SetVertexFormat(ui8(thread & 0x03u));
+   list.SetShaderGroup(ui8(hash >> 24));
+   list.UpdateVertex(NULL, ui16(thread), i + 1u);
+   list.SetVertexPrimitive(ui16(thread), 0, 1u);
+   list.InstanceDraw(64u, i + 1u);
+   queue.End(list);
+}
+
+static DWORD WINAPI BenchWorker(LPVOID param) {
+   const BENCH_WORKER &self   = *(BENCH_WORKER *)param;
+   BENCH_SHARED       &shared = *self.shared;
+   ui32                frame  = 0;
+
+   for(;;) {
+      ui32 next;
+      while((next = shared.frame) == frame) _mm_pause();
+      if(next == ~0u) break;
+      frame = next;
+
+      for(ui32 i = 0; i < shared.packets; i++) RecordPacket(*shared.queue, frame, self.index, i);
+      _InterlockedIncrement((vol long *)&shared.done);
+   }
+
+   return 0;
+}
+
+//-- Helpers
+
+static ui32 LoadBaseline(cchptr path, BENCH_RESULT *const baseline) {
+   FILE *file;
+   char  line[256];
+   ui32  count = 0;
+
+   if(fopen_s(&file, path, "r") || !file) return 0;
+   while(count < MAX_BASELINE && fgets(line, sizeof(line), file)) {
+      BENCH_RESULT &entry = baseline[count];
+      cchptr        found = strstr(line, "\"replay_mpps\":");
+      if(sscanf_s(line, " {\"threads\":%u", &entry.threads) == 1 && found && sscanf_s(found, "\"replay_mpps\":%lf", &entry.mpps) == 1) count++;
+   }
+   fclose(file);
+
+   return count;
+}
+
+//== Entry point
+
+int main(int argc, char **argv) {
+   ui32   minThreads = DEFAULT_MIN_THREADS, maxThreads = DEFAULT_MAX_THREADS;
+   ui32   frames     = DEFAULT_FRAMES,      packets    = DEFAULT_PACKETS;
+   ui32   numBaseline = 0, numFailures = 0;
+   cchptr baselinePath = NULL;
+
+   for(si32 i = 1; i < argc; i++) {
+      if(i + 1 >= argc) break;
+           if(!strcmp(argv[i], "--min"))      minThreads = ui32(strtoul(argv[++i], NULL, 0));
+      else if(!strcmp(argv[i], "--max"))      maxThreads = ui32(strtoul(argv[++i], NULL, 0));
+      else if(!strcmp(argv[i], "--frames"))   frames     = ui32(strtoul(argv[++i], NULL, 0));
+      else if(!strcmp(argv[i], "--packets"))  packets    = ui32(strtoul(argv[++i], NULL, 0));
+      else if(!strcmp(argv[i], "--baseline")) baselinePath = argv[++i];
+   }
+   if(minThreads < 1u) minThreads = 1u;
+   if(maxThreads > MAX_RENDER_THREADS) maxThreads = MAX_RENDER_THREADS;
+   if(maxThreads < minThreads) maxThreads = minThreads;
+   if(!frames) frames = 1u;
+   // The reference list records every thread's packets, and lists grow only up to their maximum
+   if(packets > RENDER_LIST_MAX_PACKETS / MAX_RENDER_THREADS) packets = RENDER_LIST_MAX_PACKETS / MAX_RENDER_THREADS;
+   if(packets * COMMANDS_PER_PACKET > RENDER_LIST_MAX_COMMANDS / MAX_RENDER_THREADS)
+      packets = RENDER_LIST_MAX_COMMANDS / MAX_RENDER_THREADS / COMMANDS_PER_PACKET;
+
+   static BENCH_RESULT baseline[MAX_BASELINE];
+   if(baselinePath) numBaseline = LoadBaseline(baselinePath, baseline);
+
+   // 'reference' gives one list a whole frame; only the main thread records into it
+   static RENDER_QUEUE queue, reference;
+   queue.Create();
+   reference.Create(MAX_RENDER_THREADS * RENDER_LIST_COMMANDS, MAX_RENDER_THREADS * RENDER_LIST_PACKETS); // Grows if needed
+
+   printf("{\"bench\":\"render commands\",\"version\":1,\"frames\":%u,\"packets\":%u,\"commands_per_packet\":%u,\"baseline_entries\":%u,\n"
+          "\"results\":[\n", frames, packets, COMMANDS_PER_PACKET, numBaseline);
+
+   bool first = true;
+   for(ui32 threads = minThreads; threads <= maxThreads; threads <<= 1) {
+      // Each run's new threads claim slots from 0 again
+      queue.threads = 0;
+
+      static BENCH_SHARED shared;
+      static BENCH_WORKER worker[MAX_RENDER_THREADS];
+      HANDLE              thread[MAX_RENDER_THREADS];
+
+      shared.queue   = &queue;
+      shared.packets = packets;
+      shared.frame   = 0;
+      shared.done    = 0;
+
+      ui32 started = 0;
+      for(; started < threads; started++) {
+         worker[started] = { &shared, started };
+         thread[started] = CreateThread(NULL, 0, BenchWorker, &worker[started], 0, NULL);
+         if(!thread[started]) break;
+      }
+
+      RENDER_BACKEND_NULL backend, check;
+      fl64                recordSeconds = 0.0, replaySeconds = 0.0;
+      ui64                totalPackets  = 0, mismatches = 0;
+
+      for(ui32 frame = 1; frame <= frames; frame++) {
+         const auto begin = std::chrono::steady_clock::now();
+         shared.done  = 0;
+         shared.frame = frame;
+         while(shared.done < started) _mm_pause();
+         const auto recorded = std::chrono::steady_clock::now();
+
+         backend.Reset();
+         cui32      replayed = queue.Replay(backend);
+         const auto end      = std::chrono::steady_clock::now();
+
+         recordSeconds += fl64(std::chrono::duration_cast<std::chrono::nanoseconds>(recorded - begin).count()) * 1e-9;
+         replaySeconds += fl64(std::chrono::duration_cast<std::chrono::nanoseconds>(end - recorded).count()) * 1e-9;
+         totalPackets  += replayed;
+
+         // The same frame, from one list
+         for(ui32 t = 0; t < started; t++)
+            for(ui32 i = 0; i < packets; i++) RecordPacket(reference, frame, t, i);
+         check.Reset();
+         reference.Replay(check);
+
+         mismatches += backend.outOfOrder || replayed != started * packets || backend.checksum != check.checksum || check.outOfOrder;
+      }
+
+      shared.frame = ~0u;
+      WaitForMultipleObjects(started, thread, TRUE, INFINITE);
+      for(ui32 i = 0; i < started; i++) CloseHandle(thread[i]);
+
+      cfl64 recordMpps = recordSeconds > 0.0 ? fl64(totalPackets) / recordSeconds * 1e-6 : 0.0;
+      cfl64 replayMpps = replaySeconds > 0.0 ? fl64(totalPackets) / replaySeconds * 1e-6 : 0.0;
+      const bool ok    = !mismatches;
+
+      printf("%s {\"threads\":%u,\"record_mpps\":%.4f,\"replay_mpps\":%.4f,\"replay_us_per_frame\":%.3f,\"packets_replayed\":%llu,"
+             "\"ok\":%s", first ? "" : ",\n", started, recordMpps, replayMpps, replaySeconds * 1e6 / fl64(frames),
+             totalPackets, ok ? "true" : "false");
+      first        = false;
+      numFailures += !ok;
+
+      for(ui32 i = 0; i < numBaseline; i++) {
+         if(baseline[i].threads != started || baseline[i].mpps <= 0.0) continue;
+         const bool regressed = replayMpps < baseline[i].mpps * REGRESSION_RATIO;
+         printf(",\"baseline_replay_mpps\":%.4f,\"delta_pct\":%.2f,\"regression\":%s", baseline[i].mpps,
+                (replayMpps / baseline[i].mpps - 1.0) * 100.0, regressed ? "true" : "false");
+         numFailures += regressed;
+         break;
+      }
+      printf("}");
+   }
+   queue.Destroy();
+   reference.Destroy();
+
+   printf("\n],\n\"failures\":%u}\n", numFailures);
+
+   return numFailures ? 1 : 0;
+}
@@ -0,0 +1,225 @@
+/*
+ * File: spin locks.cpp
+ * Version: v1.0
+ * Owner: David William Bull
+ * Created: 2026-10-17
+ * Last Modified: 2026-10-17
+ * Description: Headless contention benchmark of the spinlocks.h variants at 2~64 threads: throughput and fairness, emitted as JSON.
+ * To Do: 1) Add a NUMA-split run (threads on two nodes) once cross-node hand-off cost is being tuned.
+ *        2) Sweep critical-section length as well as thread count.
+ * Dependencies: spinlocks.h, typedefs.h, windows.h, stdio.h, string.h, chrono, intrin.h
+ * ISA: AVX2
+ * Thread-safety: N/A
+ * Reviewers: David William Bull
+ * License: MIT  Copyright: David William Bull
+ */
+
+//== Usage
+//   "spin locks.exe" [--min threads] [--max threads] [--ms duration] [--inside pauses] [--outside pauses] [--baseline file.json] > result.json
+//   Build: msbuild "bench\spin locks.vcxproj" /p:Configuration=Release /p:Platform=x64  (settings in bench.props)
+//          sh "bench/posix shim/build.sh"  on Linux hosts without MSVC; not comparable with the MSVC build (limits in build.sh)
+//
+//   For each power-of-2 thread count in [min, max] (default 2~64) every thread loops: acquire, touch one shared cache line for
+//   'inside' pauses, release, then wait 'outside' pauses. Each run lasts 'ms' milliseconds (default 250) and prints one JSON
+//   result per line.
+//   "mops":     million acquisitions per second, all threads.
+//   "fairness": Jain's index over per-thread acquisition counts: 1.0 == perfectly even, 1/threads == one thread took all.
+//   "min_max":  fewest / most acquisitions by any thread; 0 means at least one thread starved for the whole run.
+//   --baseline reads a previous run's output and marks each result whose throughput fell by >= 3% (GCS bd2); the process
+//   then exits with 1. Record runs in "bench/results/spin locks.md" with the build configuration, per GCS bd1.
+
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <intrin.h>
+#include "../include/typedefs.h"
+#include "../include/spinlocks.h"
+
+constexpr cui32 DEFAULT_MIN_THREADS = 2u;
+constexpr cui32 DEFAULT_MAX_THREADS = 64u;
+constexpr cui32 MAX_THREADS         = 64u;   // WaitForMultipleObjects() limit
+constexpr cui32 DEFAULT_MS          = 250u;
+constexpr cui32 DEFAULT_INSIDE      = 8u;
+constexpr cui32 DEFAULT_OUTSIDE     = 64u;
+constexpr cui32 MAX_BASELINE        = 256u;
+constexpr cfl64 REGRESSION_RATIO    = 0.97;  // GCS bd2: 3% threshold
+
+enum BENCH_LOCK : ui8 { bl_min, bl_spin, bl_max, bl_ticket, bl_mcs, bl_count };
+
+static cchptr LOCK_NAMES[bl_count] = { "SpinLockMin", "SpinLock", "SpinLockMax", "TicketLock", "McsLock" };
+
+struct BENCH_RESULT {
+   char lock[32];
+   ui32 threads;
+   fl64 mops;
+};
+
+// State shared by every worker; each lock on its own line, apart from the start/stop flags
+al64 struct BENCH_SHARED {
+   vui32           start;
+   vui32           stop;
+   ui32            inside;
+   ui32            outside;
+   BENCH_LOCK      kind;
+   SPINLOCK_PADDED spin;
+   TICKET_LOCK     ticket;
+   MCS_LOCK        mcs;
+   al64 vui64      data[8];   // The cache line written inside the critical section
+};
+
+// Per-thread result; padded so counting never false-shares
+al64 struct BENCH_WORKER {
+   BENCH_SHARED *shared;
+   ui64          acquisitions;
+};
+
+//-- Worker
+
+static DWORD WINAPI BenchWorker(LPVOID param) {
+   BENCH_WORKER &self   = *(BENCH_WORKER *)param;
+   BENCH_SHARED &shared = *self.shared;
+   ui64          count  = 0;
+
+   while(!shared.start) _mm_pause();
+
+   while(!shared.stop) {
+      switch(shared.kind) {
+      case bl_min:    SpinLockMin(&shared.spin.lock); break;
+      case bl_spin:   SpinLock(&shared.spin.lock);    break;
+      case bl_max:    SpinLockMax(&shared.spin.lock); break;
+      case bl_ticket: TicketLock(&shared.ticket);     break;
+      case bl_mcs:    McsLock(&shared.mcs);           break;
+      }
+
+      for(ui32 i = 0; i < shared.inside; i++) { shared.data[i & 0x07u]++;   _mm_pause(); }
+
+      switch(shared.kind) {
+      case bl_min: case bl_spin: case bl_max: SpinUnlock(&shared.spin.lock); break;
+      case bl_ticket:                         TicketUnlock(&shared.ticket);  break;
+      case bl_mcs:                            McsUnlock(&shared.mcs);        break;
+      }
+      count++;
+
+      for(ui32 i = 0; i < shared.outside; i++) _mm_pause();
+   }
+   self.acquisitions = count;
+
+   return 0;
+}
+
+//-- Helpers
+
+// Reads the result lines written by a previous run; returns the number of entries read
+static ui32 LoadBaseline(cchptr path, BENCH_RESULT *const baseline) {
+   FILE *file;
+   char  line[256];
+   ui32  count = 0;
+
+   if(fopen_s(&file, path, "r") || !file) return 0;
+   while(count < MAX_BASELINE && fgets(line, sizeof(line), file)) {
+      BENCH_RESULT &entry = baseline[count];
+      if(sscanf_s(line, " {\"lock\":\"%31[^\"]\",\"threads\":%u,\"mops\":%lf", entry.lock, 32u, &entry.threads, &entry.mops) == 3) count++;
+   }
+   fclose(file);
+
+   return count;
+}
+
+static const BENCH_RESULT *FindBaseline(const BENCH_RESULT *const baseline, cui32 count, cchptr lock, cui32 threads) {
+   for(ui32 i = 0; i < count; i++)
+      if(baseline[i].threads == threads && !strcmp(baseline[i].lock, lock)) return &baseline[i];
+   return NULL;
+}
+
+//== Entry point
+
+int main(int argc, char **argv) {
+   ui32   minThreads = DEFAULT_MIN_THREADS, maxThreads = DEFAULT_MAX_THREADS, ms = DEFAULT_MS;
+   ui32   inside     = DEFAULT_INSIDE,      outside    = DEFAULT_OUTSIDE;
+   ui32   numBaseline = 0, numRegressions = 0;
+   cchptr baselinePath = NULL;
+
+   for(si32 i = 1; i < argc; i++) {
+      if(i + 1 >= argc) break;
+           if(!strcmp(argv[i], "--min"))      minThreads = ui32(strtoul(argv[++i], NULL, 0));
+      else if(!strcmp(argv[i], "--max"))      maxThreads = ui32(strtoul(argv[++i], NULL, 0));
+      else if(!strcmp(argv[i], "--ms"))       ms         = ui32(strtoul(argv[++i], NULL, 0));
+      else if(!strcmp(argv[i], "--inside"))   inside     = ui32(strtoul(argv[++i], NULL, 0));
+      else if(!strcmp(argv[i], "--outside"))  outside    = ui32(strtoul(argv[++i], NULL, 0));
+      else if(!strcmp(argv[i], "--baseline")) baselinePath = argv[++i];
+   }
+   if(minThreads < 1u) minThreads = 1u;
+   if(maxThreads > MAX_THREADS) maxThreads = MAX_THREADS;
+   if(maxThreads < minThreads) maxThreads = minThreads;
+   if(!ms) ms = 1u;
+
+   static BENCH_RESULT baseline[MAX_BASELINE];
+   if(baselinePath) numBaseline = LoadBaseline(baselinePath, baseline);
+
+   static BENCH_SHARED shared;
+   static BENCH_WORKER worker[MAX_THREADS];
+   HANDLE              thread[MAX_THREADS];
+
+   SYSTEM_INFO sysInfo;
+   GetSystemInfo(&sysInfo);
+
+   printf("{\"bench\":\"spin locks\",\"version\":1,\"cores\":%lu,\"ms\":%u,\"inside\":%u,\"outside\":%u,\"baseline_entries\":%u,\n"
+          "\"results\":[\n", sysInfo.dwNumberOfProcessors, ms, inside, outside, numBaseline);
+
+   bool first = true;
+   for(ui32 threads = minThreads; threads <= maxThreads; threads <<= 1) {
+      for(ui8 kind = 0; kind < bl_count; kind++) {
+         shared.start   = 0;
+         shared.stop    = 0;
+         shared.inside  = inside;
+         shared.outside = outside;
+         shared.kind    = BENCH_LOCK(kind);
+
+         ui32 started = 0;
+         for(; started < threads; started++) {
+            worker[started] = { &shared, 0 };
+            thread[started] = CreateThread(NULL, 0, BenchWorker, &worker[started], 0, NULL);
+            if(!thread[started]) break;
+         }
+
+         const auto begin = std::chrono::steady_clock::now();
+         shared.start = 1u;
+         Sleep(ms);
+         shared.stop = 1u;
+         WaitForMultipleObjects(started, thread, TRUE, INFINITE);
+         cfl64 seconds = fl64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count()) * 1e-9;
+
+         ui64 total = 0, least = ~0ull, most = 0;
+         fl64 sumSq = 0.0;
+         for(ui32 i = 0; i < started; i++) {
+            cui64 n = worker[i].acquisitions;
+            total += n;
+            sumSq += fl64(n) * fl64(n);
+            if(n < least) least = n;
+            if(n > most)  most  = n;
+            CloseHandle(thread[i]);
+         }
+
+         cfl64 mops     = seconds > 0.0 ? fl64(total) / seconds * 1e-6 : 0.0;
+         cfl64 fairness = sumSq > 0.0 ? fl64(total) * fl64(total) / (fl64(started) * sumSq) : 0.0;
+
+         printf("%s {\"lock\":\"%s\",\"threads\":%u,\"mops\":%.4f,\"fairness\":%.4f,\"min_max\":%.4f,\"acquisitions\":%llu", first ? "" : ",\n",
+                LOCK_NAMES[kind], started, mops, fairness, most ? fl64(least) / fl64(most) : 0.0, total);
+         first = false;
+
+         const BENCH_RESULT *const prior = FindBaseline(baseline, numBaseline, LOCK_NAMES[kind], started);
+         if(prior && prior->mops > 0.0) {
+            const bool regressed = mops < prior->mops * REGRESSION_RATIO;
+            printf(",\"baseline_mops\":%.4f,\"delta_pct\":%.2f,\"regression\":%s", prior->mops, (mops / prior->mops - 1.0) * 100.0,
+                   regressed ? "true" : "false");
+            numRegressions += regressed;
+         }
+         printf("}");
+      }
+   }
+
+   printf("\n],\n\"regressions\":%u}\n", numRegressions);
+
+   return numRegressions ? 1 : 0;
+}
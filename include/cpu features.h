@@ -0,0 +1,89 @@
+/*
+ * File: cpu features.h
+ * Version: v1.1
+ * Owner: David William Bull
+ * Created: 2026-10-17
+ * Last Modified: 2026-10-17
+ * Description: One-time instruction-set and NUMA-topology probes shared by SYSTEM_DATA::cpu and the memory manager; NUMA thread affinity.
+ * To Do: 1) Add AVX-512BW/VL and AVX10 bits once a kernel needs them (requires widening the 8-bit mask).
+ *        2) Extend the NUMA probe beyond processor group 0 (>64 virtual cores), alongside data tracking.h To Do 1.
+ * Dependencies: windows.h, typedefs.h
+ * ISA: Scalar
+ * Thread-safety: Reentrant
+ * Reviewers: Unassigned
+ * License: MIT  Copyright: David William Bull
+ */
+#pragma once
+
+#include <windows.h>
+#include "typedefs.h"
+
+//== Instruction-set bits; layout of SYSTEM_DATA::cpu.instructions
+
+constexpr cui8 ISA_SSE2    = 0x01u;
+constexpr cui8 ISA_SSE3    = 0x02u;
+constexpr cui8 ISA_SSSE3   = 0x04u;
+constexpr cui8 ISA_SSE4_1  = 0x08u;
+constexpr cui8 ISA_SSE4_2  = 0x10u;
+constexpr cui8 ISA_AVX     = 0x20u;
+constexpr cui8 ISA_AVX2    = 0x40u;
+constexpr cui8 ISA_AVX512F = 0x80u;
+
+/// Probes the instruction sets usable by this process.
+/// @return ISA_* bit flags.
+/// @note IsProcessorFeaturePresent reports AVX/AVX2/AVX-512F only when the OS also saves the matching register state
+///       (XSAVE/XGETBV), so a set bit is safe to dispatch on without a separate OS check.
+inline cui8 ProbeInstructionSets(void) {
+   ui8 isaBits;
+
+   isaBits  =  IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE) & 1;
+   isaBits |= (IsProcessorFeaturePresent(PF_SSE3_INSTRUCTIONS_AVAILABLE) & 1) << 1;
+   isaBits |= (IsProcessorFeaturePresent(PF_SSSE3_INSTRUCTIONS_AVAILABLE) & 1) << 2;
+   isaBits |= (IsProcessorFeaturePresent(PF_SSE4_1_INSTRUCTIONS_AVAILABLE) & 1) << 3;
+   isaBits |= (IsProcessorFeaturePresent(PF_SSE4_2_INSTRUCTIONS_AVAILABLE) & 1) << 4;
+   isaBits |= (IsProcessorFeaturePresent(PF_AVX_INSTRUCTIONS_AVAILABLE) & 1) << 5;
+   isaBits |= (IsProcessorFeaturePresent(PF_AVX2_INSTRUCTIONS_AVAILABLE) & 1) << 6;
+   isaBits |= (IsProcessorFeaturePresent(PF_AVX512F_INSTRUCTIONS_AVAILABLE) & 1) << 7;
+
+   return isaBits;
+}
+
+//== NUMA topology
+
+constexpr cui8 MAX_NUMA_NODES = 8u; // Nodes tracked; memory and threads are never placed on higher-numbered nodes
+
+/// Probes the NUMA nodes and the virtual cores of processor group 0 on each.
+/// @param nodeCoreMap  Receives MAX_NUMA_NODES bitmaps, one per node, in the layout of SYSTEM_DATA::cpu.virtCoreMap; 0 for
+///                     absent nodes, and for nodes whose cores all lie outside processor group 0.
+/// @return Node count: 1 on single-node systems, and never more than MAX_NUMA_NODES.
+inline cui8 ProbeNumaNodes(ui64ptrc nodeCoreMap) {
+   ULONG highestNode = 0;
+
+   if(!GetNumaHighestNodeNumber(&highestNode)) highestNode = 0;
+   cui8 nodeCount = highestNode < MAX_NUMA_NODES ? ui8(highestNode + 1u) : MAX_NUMA_NODES;
+
+   for(ui8 i = 0; i < MAX_NUMA_NODES; ++i) {
+      GROUP_AFFINITY affinity = {};
+      nodeCoreMap[i] = (i < nodeCount && GetNumaNodeProcessorMaskEx(i, &affinity) && !affinity.Group) ? (ui64)affinity.Mask : 0;
+   }
+
+   return nodeCount;
+}
+
+/// NUMA node of the processor the calling thread is running on; 0 when unknown.
+inline cui8 CurrentNumaNode(void) {
+   PROCESSOR_NUMBER processor;
+   USHORT           node;
+
+   GetCurrentProcessorNumberEx(&processor);
+   return (GetNumaProcessorNodeEx(&processor, &node) && node < MAX_NUMA_NODES) ? (ui8)node : 0;
+}
+
+/// Restricts a thread to the cores of one NUMA node, so the memory placed on that node stays local to it.
+/// @return true on success; false, leaving the affinity unchanged, if the node is absent or has no cores.
+inline cbool SetThreadNumaNode(HANDLE thread, cui8 node) {
+   GROUP_AFFINITY affinity = {};
+
+   if(node >= MAX_NUMA_NODES || !GetNumaNodeProcessorMaskEx(node, &affinity) || !affinity.Mask) return false;
+   return SetThreadGroupAffinity(thread, &affinity, NULL) != 0;
+}
@@ -1,15 +1,16 @@
 /*
  * File: data tracking.h
- * Version: v1.1
+ * Version: v1.6
  * Owner: David William Bull
  * Created: 2024-03-30
- * Last Modified: 2026-08-12
- * Description: System data aggregation: CPU topology, memory-allocation tracking, and run-time performance read-outs.
+ * Last Modified: 2026-10-17
+ * Description: System data aggregation: CPU topology, lock-free memory-allocation tracking with per-subsystem budgets, spin-lock contention per call site
+ *              (SPIN_PROFILE acquisitions), map chunk residency, sparse map chunks, and run-time read-outs.
  * To Do: 1) Add support for processor groups (>64 virtual cores) via GetLogicalProcessorInformationEx.
  *        2) Add network (and APU?) read-out sections.
- * Dependencies: typedefs.h, Shlobj.h, spinlocks.h
+ * Dependencies: typedefs.h, Shlobj.h, cpu features.h
  * ISA: SSE4.2
- * Thread-safety: Reentrant
+ * Thread-safety: MT-safe (MemTrack, MemUntrack, MemTrackTotals, MemSetBudget); remaining read-outs are single-writer
  * Reviewers: Unassigned
  * License: LicenseRef-Proprietary  Copyright: David William Bull
  */
@@ -17,7 +18,58 @@
 
 #include "typedefs.h"
 #include "Shlobj.h"
-#include "spinlocks.h"
+#include "cpu features.h"
+
+constexpr cui32 MEM_TRACK_SHARDS    = 16u;                  // Counter shards; power of 2. Threads are assigned round-robin
+constexpr cui64 MEM_TRACK_TOMBSTONE = 1u;                   // Key of an erased tracking-table slot (0 == never used)
+constexpr cui64 MEM_TRACK_HASH      = 0x09E3779B97F4A7C15u; // Fibonacci-hashing multiplier
+constexpr cui32 MEM_TAGS            = 8u;                   // Subsystem tags (AE_SUBSYSTEM values); power of 2
+constexpr cui32 MAX_SPIN_SITES      = 256u;                 // Spin-lock call sites counted by SPIN_PROFILE
+
+// Defined by the application (Data structures.h, LastVigil.cpp); used to report exceeded memory budgets
+enum AE_SUBSYSTEM : ui8;
+extern inline void Try(cchptrc stEvent, cui32 uiResult, const AE_SUBSYSTEM subsystem);
+
+// Per-thread-shard allocation counters; one cache line each so threads never contend on a shared total
+al64 struct MEM_TRACK_SHARD {
+   vui64 allocated   = 0; // Bytes; wraps below zero when this shard's threads free memory allocated on other shards
+   vui64 allocations = 0; // Records; wraps the same way. Only the sum over all shards is meaningful
+   vui64 untracked   = 0; // Allocations dropped because the table was full or never initialised
+   ui64  padding[5];
+};
+
+// Per-subsystem allocation counters and soft budget; one cache line per tag
+al64 struct MEM_TAG_STATS {
+   vui64  live       = 0; // Bytes currently allocated under this tag
+   vui64  peak       = 0; // Greatest value of live since start-up
+   vui64  count      = 0; // Allocations currently live under this tag
+   vui64  budget     = 0; // Soft budget in bytes; 0 == none. Set with MemSetBudget
+   cchptr overFile   = 0; // Call site of the allocation that last took live over budget
+   ui32   overLine   = 0;
+   vui32  overBudget = 0; // 1 from the allocation that crosses the budget until live falls back within it
+   ui64   padding[2];
+};
+
+// Contention counters of one spin-lock call site (SPIN_PROFILE acquisitions; see "spinlock profile.h"); one cache line each
+al64 struct SPIN_SITE_STATS {
+   cchptr kind          = 0; // Acquisition profile: "SpinLockMin", "SpinLock" or "SpinLockMax"
+   cchptr file          = 0; // Call site
+   vui64  acquisitions  = 0;
+   vui64  contended     = 0; // Acquisitions that found the lock held
+   vui64  spinCycles    = 0; // TSC cycles spent in contended acquisitions
+   vui64  maxSpinCycles = 0; // Longest single acquisition
+   vui32  yields        = 0; // Sleep calls taken while waiting
+   vui32  timeouts      = 0; // Waits that passed SPIN_DEADLOCK_CYCLES, plus recursive acquisitions
+   ui32   line          = 0;
+   // 4 bytes padding
+};
+
+// Global totals, summed over every MEM_TRACK_SHARD by MemTrackTotals
+struct MEM_TRACK_TOTALS {
+   ui64 allocated;
+   ui64 allocations;
+   ui64 untracked;
+};
 
 // Input: Maxmimum memory allocations
 al64 struct SYSTEM_DATA {
@@ -26,25 +78,49 @@ al64 struct SYSTEM_DATA {
    ///--- CPU read-outs
    struct CPU_INFO_BLOCK { // Hardware information
       ui64 virtCoreMap[2] = {}; // Bitmaps of available virtual cores; 0==Non-SMT, 1==SMT
+      ui64 nodeCoreMap[MAX_NUMA_NODES] = {}; // Bitmaps of the virtual cores on each NUMA node
       ui32 cacheL1[2][2]  = {}; // Sizes of L1 code and data caches per core; [0==Non-SMT, 1==SMT][0==Code, 1==Data]
       ui32 cacheL2[2]     = {}; // Size of L2 cache per core; 0==Non-SMT, 1==SMT
       ui32 cacheL3        = 0;  // Size of L3 cache per core complex
       ui16 coreCount[2]   = {}; // Number of physical cores; 0==Non-SMT, 1==SMT
       ui16 virtCoreCount  = 0;  // Total number of virtual CPU cores
       ui8  SMTCount       = 0;  // Number of virtual cores per physical SMT core
-      ui8  instructions   = 0;  // Bit flags: 0x01==SSE2, 0x02==SSE3, 0x04==SSSE3, 0x08==SSE4.1, 0x10==SSE4.2, 0x20==AVX, 0x40==AVX2, 0x80==AVX-512F
-      // 4 bytes padding
+      ui8  instructions   = 0;  // ISA_* bit flags (cpu features.h): 0x01==SSE2, 0x02==SSE3, 0x04==SSSE3, 0x08==SSE4.1, 0x10==SSE4.2, 0x20==AVX, 0x40==AVX2, 0x80==AVX-512F
+      ui8  nodeCount      = 1u; // Number of NUMA nodes (1~MAX_NUMA_NODES)
+      // 3 bytes padding
    } cpu;
    ///--- RAM read-outs
    struct {
-      vptrptr  location;
-      vui64ptr byteCount;
-      vui64    allocated      = 0;
-      vui32    allocations    = 0;
-      vui32    maxAllocations = 0;
-      vui32    lock           = 0; // Tracking-table spin lock: 0 == unlocked, 1 == locked; see spinlocks.h
-      vui32    untracked      = 0; // Allocations dropped because the table was full or never initialised
+      vui64ptr        key;                     // Open-addressing table of tracked addresses; 0 == empty, MEM_TRACK_TOMBSTONE == erased
+      vui64ptr        byteCount;               // Size of the allocation in the matching key slot
+      ui8ptr          slotTag;                 // Subsystem tag of the allocation in the matching key slot
+      cchptrptr       slotFile;                // Call site (file) of the allocation in the matching key slot; 0 == unknown
+      ui32ptr         slotLine;                // Call site (line) of the allocation in the matching key slot
+      ui64            tableMask      = 0;      // Table slots - 1 (slots is a power of 2 >= 2 * maxAllocations)
+      ui32            maxAllocations = 0;      // Requested capacity; 0 == tracking disabled
+      ui8             tableShift     = 64u;    // 64 - log2(slots); shifts MEM_TRACK_HASH products down to a slot index
+      vui32           nextShard      = 0;      // Round-robin cursor for assigning threads to shards
+      MEM_TRACK_SHARD shard[MEM_TRACK_SHARDS]; // Read totals via MemTrackTotals
+      MEM_TAG_STATS   tag[MEM_TAGS];           // Indexed by AE_SUBSYSTEM
+      vui64           arenaReserved      = 0;  // Bytes held by all live frame arenas (each block is also counted in allocated)
+      vui64           arenaHighWater     = 0;  // Greatest per-frame usage of any one frame arena, in bytes; raised at FRAME_ARENA::Reset
+      vui64           arenaOverflows     = 0;  // Frame-arena requests refused for lack of space
+      vui64           largePageBytes     = 0;  // Bytes currently committed on large pages by lalloc (also counted in allocated)
+      vui64           largePageFallbacks = 0;  // lalloc requests above LARGE_PAGE_THRESHOLD served by malloc instead
+      vui64           vmReserved         = 0;  // Address space held by vreserve'd arrays, in bytes
+      vui64           vmCommitted        = 0;  // Bytes committed within vreserve'd arrays (not counted in allocated)
    } mem;
+   ///--- Lock read-outs (filled by "spinlock profile.h")
+   struct {
+      SPIN_SITE_STATS  site[MAX_SPIN_SITES]; // The first min(sites, MAX_SPIN_SITES) entries are in use
+      vui32            sites       = 0;      // Call sites registered; beyond MAX_SPIN_SITES - 1 they share the last entry
+      vui32            stalls      = 0;      // Waits that passed SPIN_DEADLOCK_CYCLES, plus recursive acquisitions
+      SPIN_SITE_STATS *stallSite   = 0;      // Most recent stall: call site, lock, cycles waited (0 == recursive acquisition),
+      ptr              stallLock   = 0;      // and the holding and waiting thread IDs
+      vui64            stallCycles = 0;
+      vui32            stallOwner  = 0;
+      vui32            stallWaiter = 0;
+   } spin;
    ///--- Storage read-outs
    struct {
       vui64 bytesRead    = 0;
@@ -89,8 +165,25 @@ al64 struct SYSTEM_DATA {
       } entity;
       ///--- More?
    } culling;
+   ///--- Map streaming read-outs (CLASS_MAPMAN::FaultChunk, StreamUpdate); all streamed maps
+   struct {
+      vui64 hits       = 0; // Chunk faults served by resident chunks
+      vui64 misses     = 0; // Chunk faults that loaded the chunk on the faulting thread
+      vui64 prefetches = 0; // Chunks queued for loading ahead of use
+      vui64 evictions  = 0;
+      vui64 writeBacks = 0; // Evicted or closed chunks written back to their map file
+      vui32 resident   = 0; // Chunks resident
+      vui32 slots      = 0; // Resident-chunk budget
+   } streaming;
+   ///--- Sparse map read-outs (CLASS_MAPMAN::ExpandChunk; MAP_SPARSE); all sparse maps
+   struct {
+      vui64 encodedBytes = 0; // Bytes of encoded chunks; a shared uniform value counts once per chunk
+      vui64 expansions   = 0; // Encoded chunks given full storage on first access
+      vui32 encoded      = 0; // Chunks held encoded
+      vui32 expanded     = 0; // Chunks at full size
+   } sparse;
 private:
-   bool freeAllAllocations; // 1 byte overflow beyond 280 byte alignment
+   bool freeAllAllocations;
 public:
    SYSTEM_DATA(cui64 maxMemAllocations, cbool freeAllMemoryOnDeletion) {
       typedef SYSTEM_LOGICAL_PROCESSOR_INFORMATION SLPI, * SLPIptr, *const SLPIptrc;
@@ -100,19 +193,36 @@ public:
       wchptr   stPath = 0;
       DWORD    bytesProc;
 
-      mem.location  = (vptrptr)_aligned_malloc(maxMemAllocations << 3u, 32u);
-      mem.byteCount = (vui64ptr)_aligned_malloc(maxMemAllocations << 3u, 32u);
-      if(mem.location && mem.byteCount) {
-         for(ui64 i = 0; i < maxMemAllocations; ++i) {
-            mem.location[i]  = 0;
+      ui64 slots = 64u;   ui8 slotBits = 6u;
+      while(slots < (maxMemAllocations << 1u)) { slots <<= 1u;   ++slotBits; } // Load factor <= 0.5 keeps probe chains short
+
+      mem.key       = (vui64ptr)_aligned_malloc(slots << 3u, 64u);
+      mem.byteCount = (vui64ptr)_aligned_malloc(slots << 3u, 64u);
+      mem.slotTag   = (ui8ptr)_aligned_malloc(slots, 64u);
+      mem.slotFile  = (cchptrptr)_aligned_malloc(slots << 3u, 64u);
+      mem.slotLine  = (ui32ptr)_aligned_malloc(slots << 2u, 64u);
+      if(mem.key && mem.byteCount && mem.slotTag && mem.slotFile && mem.slotLine && maxMemAllocations) {
+         for(ui64 i = 0; i < slots; ++i) {
+            mem.key[i]       = 0;
             mem.byteCount[i] = 0;
+            mem.slotTag[i]   = 0;
+            mem.slotFile[i]  = 0;
+            mem.slotLine[i]  = 0;
          }
+         mem.tableMask      = slots - 1u;
+         mem.tableShift     = 64u - slotBits;
          mem.maxAllocations = (ui32)maxMemAllocations;
-      } else { // Partial failure: release the survivor; tracking stays disabled (maxAllocations remains 0 per its default)
+      } else { // Partial failure: release the survivors; tracking stays disabled (maxAllocations remains 0 per its default)
+         _aligned_free(mem.slotLine);
+         _aligned_free(mem.slotFile);
+         _aligned_free(mem.slotTag);
          _aligned_free((ptr)mem.byteCount);
-         _aligned_free(mem.location);
-         mem.location  = 0;
+         _aligned_free((ptr)mem.key);
+         mem.key       = 0;
          mem.byteCount = 0;
+         mem.slotTag   = 0;
+         mem.slotFile  = 0;
+         mem.slotLine  = 0;
       }
 
       if(folderProgramFiles) {
@@ -165,71 +275,154 @@ public:
       }
       _aligned_free(sysLPI);
       cpu.virtCoreCount = PopulationCount64(cpu.virtCoreMap[0] | cpu.virtCoreMap[1]);
-      cpu.instructions  =  IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE) & 1;
-      cpu.instructions |= (IsProcessorFeaturePresent(PF_SSE3_INSTRUCTIONS_AVAILABLE) & 1) << 1;
-      cpu.instructions |= (IsProcessorFeaturePresent(PF_SSSE3_INSTRUCTIONS_AVAILABLE) & 1) << 2;
-      cpu.instructions |= (IsProcessorFeaturePresent(PF_SSE4_1_INSTRUCTIONS_AVAILABLE) & 1) << 3;
-      cpu.instructions |= (IsProcessorFeaturePresent(PF_SSE4_2_INSTRUCTIONS_AVAILABLE) & 1) << 4;
-      cpu.instructions |= (IsProcessorFeaturePresent(PF_AVX_INSTRUCTIONS_AVAILABLE) & 1) << 5;
-      cpu.instructions |= (IsProcessorFeaturePresent(PF_AVX2_INSTRUCTIONS_AVAILABLE) & 1) << 6;
-      cpu.instructions |= (IsProcessorFeaturePresent(PF_AVX512F_INSTRUCTIONS_AVAILABLE) & 1) << 7;
+      cpu.instructions  = ProbeInstructionSets();
+      cpu.nodeCount     = ProbeNumaNodes(cpu.nodeCoreMap);
+      if(!cpu.nodeCoreMap[0] && cpu.nodeCount == 1u) cpu.nodeCoreMap[0] = cpu.virtCoreMap[0] | cpu.virtCoreMap[1];
 
       freeAllAllocations = freeAllMemoryOnDeletion;
    }
 
    ~SYSTEM_DATA(void) {
-      if(freeAllAllocations && mem.location)
-         for(ui32 i = 0; i < mem.maxAllocations; ++i)
-            if(mem.location[i]) _aligned_free((ptr)mem.location[i]);
+      if(freeAllAllocations && mem.maxAllocations)
+         for(ui64 i = 0; i <= mem.tableMask; ++i)
+            if(mem.key[i] > MEM_TRACK_TOMBSTONE) _aligned_free((ptr)mem.key[i]);
       _aligned_free(folderProgramFiles);
+      _aligned_free(mem.slotLine);
+      _aligned_free(mem.slotFile);
+      _aligned_free(mem.slotTag);
       _aligned_free((ptr)mem.byteCount);
-      _aligned_free(mem.location);
+      _aligned_free((ptr)mem.key);
       mem.maxAllocations = 0;
    }
 };
 
 extern SYSTEM_DATA sysData;
 
-/// @brief Appends a record to the allocation-tracking table. Never writes past maxAllocations: when the table is
-///        full, or construction failed (maxAllocations == 0), the record is dropped and mem.untracked incremented.
-/// @param pointer   Address returned by _aligned_malloc; must be non-null.
+// Counter shard of the calling thread; assigned round-robin on the thread's first tracked allocation or free
+inline thread_local cui32 memTrackShard = _InterlockedIncrement((vol long *)&sysData.mem.nextShard) & (MEM_TRACK_SHARDS - 1u);
+
+constexpr cchar stMemBudget[] = "Memory budget exceeded";
+
+/// @brief Sets the soft budget of a subsystem tag. Exceeding it is reported once through Try, then re-armed when the
+///        tag's live bytes fall back within budget.
+/// @param tag       AE_SUBSYSTEM value.
+/// @param numBytes  Budget in bytes; 0 removes it.
+inline void MemSetBudget(cui8 tag, cui64 numBytes) {
+   MEM_TAG_STATS &stats = sysData.mem.tag[tag & (MEM_TAGS - 1u)];
+   stats.budget = numBytes;
+   if(!numBytes || stats.live <= numBytes) stats.overBudget = 0;
+}
+
+// Charges an allocation to a subsystem tag: raises peak, and reports the allocation that first crosses the budget
+inline void MemTagAdd(cui8 tag, cui64 numBytes, cchptrc file, cui32 line) {
+   MEM_TAG_STATS &stats = sysData.mem.tag[tag & (MEM_TAGS - 1u)];
+   cui64          live  = (ui64)_InterlockedExchangeAdd64((vsi64ptr)&stats.live, (si64)numBytes) + numBytes;
+   si64           peak  = (si64)stats.peak;
+
+   _InterlockedIncrement64((vsi64ptr)&stats.count);
+   while(live > (ui64)peak) {
+      csi64 seen = _InterlockedCompareExchange64((vsi64ptr)&stats.peak, (si64)live, peak);
+      if(seen == peak) break;
+      peak = seen;
+   }
+
+   cui64 budget = stats.budget;
+   if(budget && live > budget && !_InterlockedExchange((vol long *)&stats.overBudget, 1)) {
+      stats.overFile = file;
+      stats.overLine = line;
+      Try(stMemBudget, 0x080000001, (AE_SUBSYSTEM)(tag & (MEM_TAGS - 1u)));
+   }
+}
+
+// Releases an allocation from a subsystem tag, re-arming the budget warning once live is back within budget
+inline void MemTagSub(cui8 tag, cui64 numBytes) {
+   MEM_TAG_STATS &stats = sysData.mem.tag[tag & (MEM_TAGS - 1u)];
+   cui64          live  = (ui64)_InterlockedExchangeAdd64((vsi64ptr)&stats.live, -(si64)numBytes) - numBytes;
+
+   _InterlockedDecrement64((vsi64ptr)&stats.count);
+   if(stats.overBudget && live <= stats.budget) _InterlockedExchange((vol long *)&stats.overBudget, 0);
+}
+
+/// @brief Inserts a record into the allocation-tracking table. Never blocks: a free slot is claimed with one
+///        CAS. When no slot is free, or construction failed (maxAllocations == 0), the record is dropped and the
+///        calling thread's untracked counter incremented.
+/// @param pointer   Address returned by _aligned_malloc; must be non-null and not already tracked.
 /// @param numBytes  Size of the allocation in bytes.
-/// @note Serialised by mem.lock. SpinLockMax and SpinUnlock are full barriers (LOCK CMPXCHG / XCHG), so every
-///       table mutation is globally visible before the lock clears; the counters are modified only inside the lock.
-inline void MemTrack(ptrc pointer, csize_t numBytes) {
-   SpinLockMax(&sysData.mem.lock);
-   if(sysData.mem.allocations < sysData.mem.maxAllocations) {
-      sysData.mem.byteCount[sysData.mem.allocations] = numBytes;
-      sysData.mem.location[sysData.mem.allocations]  = pointer;
-      sysData.mem.allocated += numBytes;
-      sysData.mem.allocations++;
-   } else sysData.mem.untracked++;
-   SpinUnlock(&sysData.mem.lock);
+/// @param tag       Subsystem (AE_SUBSYSTEM value) charged for the allocation; see MemTagAdd.
+/// @param file      Call site (__FILE__) or 0; must be a string literal or otherwise outlive the allocation.
+/// @param line      Call site (__LINE__) or 0.
+/// @note Lock-free. The slot's byteCount, tag and site are stored after its key is published; a concurrent MemUntrack
+///       of the same address cannot occur, as the caller has not yet handed the pointer out.
+inline void MemTrack(ptrc pointer, csize_t numBytes, cui8 tag, cchptrc file, cui32 line) {
+   MEM_TRACK_SHARD &shard = sysData.mem.shard[memTrackShard];
+   cui64            key   = (ui64)pointer;
+
+   if(sysData.mem.maxAllocations) {
+      vui64ptrc keys = sysData.mem.key;
+      cui64     mask = sysData.mem.tableMask;
+      ui64      i    = (key * MEM_TRACK_HASH) >> sysData.mem.tableShift;
+
+      for(ui64 probe = 0; probe <= mask; ++probe, i = (i + 1u) & mask) {
+         cui64 slot = keys[i];
+         if(slot > MEM_TRACK_TOMBSTONE) continue; // Occupied
+         if(_InterlockedCompareExchange64((vsi64ptr)&keys[i], (si64)key, (si64)slot) != (si64)slot) continue; // Lost the slot to another thread
+         sysData.mem.byteCount[i] = numBytes;
+         sysData.mem.slotTag[i]   = tag;
+         sysData.mem.slotFile[i]  = file;
+         sysData.mem.slotLine[i]  = line;
+         _InterlockedExchangeAdd64((vsi64ptr)&shard.allocated, (si64)numBytes);
+         _InterlockedIncrement64((vsi64ptr)&shard.allocations);
+         MemTagAdd(tag, numBytes, file, line);
+         return;
+      }
+   }
+   _InterlockedIncrement64((vsi64ptr)&shard.untracked);
 }
 
-/// @brief Removes a record from the allocation-tracking table via swap-and-pop: the top record fills the vacated
-///        slot, so [0, allocations) stays densely packed and mem.allocations remains a valid append cursor.
+/// @brief Erases a record from the allocation-tracking table, leaving a tombstone that MemTrack may reuse.
 /// @param pointer  Address to remove.
 /// @return true if a record was found and removed, otherwise false.
-/// @note Serialised by mem.lock; same barrier guarantees as MemTrack. Call before _aligned_free(pointer) so the
-///       address cannot be recycled by another thread while its stale record is still in the table.
+/// @note Lock-free. The erase is a CAS from the address to MEM_TRACK_TOMBSTONE, so of two threads freeing the same
+///       address exactly one succeeds. Call before _aligned_free(pointer) so the address cannot be recycled by
+///       another thread while its record is still in the table.
 inline cui64 MemUntrack(ptrc pointer) {
-   SpinLockMax(&sysData.mem.lock);
-   vptrptrc  location  = sysData.mem.location;
-   vui64ptrc byteCount = sysData.mem.byteCount;
-   cui32     count     = sysData.mem.allocations;
-
-   ui32 index = 0;
-   while(index < count && pointer != location[index]) index++;
-   if(index >= count) { SpinUnlock(&sysData.mem.lock);   return false; } // Pointer is not in the table
-
-   cui32 last = count - 1u;
-   sysData.mem.allocated -= byteCount[index];
-   location[index]  = location[last];   // Swap-and-pop: the top record fills the hole; the vacated
-   byteCount[index] = byteCount[last];  // top slot is zeroed so the destructor sweep stays valid
-   location[last]  = 0;
-   byteCount[last] = 0;
-   sysData.mem.allocations = last;
-   SpinUnlock(&sysData.mem.lock);
-   return true;
+   if(!sysData.mem.maxAllocations) return false;
+
+   vui64ptrc keys = sysData.mem.key;
+   cui64     key  = (ui64)pointer;
+   cui64     mask = sysData.mem.tableMask;
+   ui64      i    = (key * MEM_TRACK_HASH) >> sysData.mem.tableShift;
+
+   for(ui64 probe = 0; probe <= mask; ++probe, i = (i + 1u) & mask) {
+      cui64 slot = keys[i];
+      if(!slot) return false; // End of the probe chain: pointer is not in the table
+      if(slot != key) continue;
+
+      cui64 numBytes = sysData.mem.byteCount[i];
+      cui8  tag      = sysData.mem.slotTag[i];
+      if(_InterlockedCompareExchange64((vsi64ptr)&keys[i], (si64)MEM_TRACK_TOMBSTONE, (si64)key) != (si64)key) return false; // Freed elsewhere
+
+      MEM_TRACK_SHARD &shard = sysData.mem.shard[memTrackShard];
+      _InterlockedExchangeAdd64((vsi64ptr)&shard.allocated, -(si64)numBytes);
+      _InterlockedDecrement64((vsi64ptr)&shard.allocations);
+      MemTagSub(tag, numBytes);
+      return true;
+   }
+   return false;
+}
+
+/// @brief Sums the per-thread counter shards.
+/// @return Bytes and records currently tracked, and allocations dropped since start-up.
+/// @note Each shard is read atomically but not all at once: exact once the tracked threads are quiescent, otherwise
+///       within the allocations in flight during the call.
+inline MEM_TRACK_TOTALS MemTrackTotals(void) {
+   MEM_TRACK_TOTALS totals = {};
+
+   for(ui32 i = 0; i < MEM_TRACK_SHARDS; ++i) {
+      totals.allocated   += sysData.mem.shard[i].allocated;
+      totals.allocations += sysData.mem.shard[i].allocations;
+      totals.untracked   += sysData.mem.shard[i].untracked;
+   }
+
+   return totals;
 }
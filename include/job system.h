@@ -0,0 +1,438 @@
+/*
+ * File: job system.h
+ * Version: v1.0
+ * Owner: David William Bull
+ * Created: 2026-10-17
+ * Last Modified: 2026-10-17
+ * Description: Work-stealing job system: one Chase-Lev deque per worker, a locked injection queue for non-worker threads,
+ *              job counters and dependencies, and ParallelFor over index ranges. Sized from SYSTEM_DATA::cpu.virtCoreCount.
+ *              On NUMA hosts each worker is pinned to a node, its deque lives in that node's memory (nodeArena), and jobs
+ *              tagged with a node are run by that node's workers first.
+ * To Do: 1) Grow deques on overflow instead of running the job inline.
+ *        2) Job priorities (frame-critical versus background).
+ * Dependencies: windows.h, typedefs.h, cpu features.h, memory management.h, spinlocks.h, Synchronization.lib; the includer
+ *               declares SPIN_WAIT_POLICY (SPIN_PLAIN or SPIN_PROFILE), the wait policy of its locks
+ * ISA: Scalar
+ * Thread-safety: MT-safe; JOB_DEQUE::Push/Pop are owner-only, Steal is MT-safe.
+ * Reviewers: Unassigned
+ * License: MIT  Copyright: David William Bull
+ */
+#pragma once
+
+#include <windows.h>
+#include <intrin.h>
+#include "typedefs.h"
+#include "cpu features.h"
+#include "memory management.h"
+#include "spinlocks.h"
+
+#pragma comment(lib, "Synchronization.lib")
+#pragma intrinsic(_InterlockedExchange64, _InterlockedCompareExchange64, _InterlockedIncrement64, _InterlockedDecrement64)
+
+//== Tuning constants
+
+constexpr cui32 MAX_JOB_WORKERS  = 64u;    // Matches MAXIMUM_WAIT_OBJECTS, so Stop() joins every worker in one wait
+constexpr cui32 JOB_DEQUE_SIZE   = 4096u;  // Jobs per worker deque; power of two. A full deque runs the job inline
+constexpr cui32 JOB_INJECT_SIZE  = 4096u;  // Jobs in the shared injection queue; power of two
+constexpr cui32 JOB_IDLE_SPINS   = 256u;   // Empty TryRunOne() passes before an idle worker sleeps
+constexpr DWORD JOB_SLEEP_MS     = 4u;     // Upper bound on an idle worker's sleep; covers a missed wake
+constexpr cui64 JOB_NODE_ARENA   = 64ull << 20; // Bytes nodeArena reserves per node when the job system creates it
+constexpr cui8  JOB_ANY_NODE     = 0x0FFu;  // JOB::node of jobs that may run on any worker
+
+static_assert(!(JOB_DEQUE_SIZE & (JOB_DEQUE_SIZE - 1u)), "JOB_DEQUE_SIZE must be a power of two: index masking.");
+static_assert(!(JOB_INJECT_SIZE & (JOB_INJECT_SIZE - 1u)), "JOB_INJECT_SIZE must be a power of two: index masking.");
+
+//== Jobs
+
+// Job body; processes indices [begin, end). Single jobs receive whatever range they were submitted with
+typedef void (*JOB_FN)(ptr data, cui64 begin, cui64 end);
+
+// Completion counter: incremented per submitted job (and per ParallelFor split), decremented when each finishes
+al64 struct JOB_COUNTER {
+   vsi64 pending = 0;
+};
+
+struct JOB {
+   JOB_FN             fn;
+   ptr                data;
+   ui64               begin;
+   ui64               end;
+   JOB_COUNTER       *counter;   // Optional; signalled when this job (and every split of it) finishes
+   const JOB_COUNTER *after;     // Optional dependency; the job is deferred until after->pending == 0
+   ui64               grain;     // ParallelFor split size; 0 == run [begin, end) as one piece
+   ui8                node = JOB_ANY_NODE; // NUMA node whose workers should run the job (and its splits)
+};
+
+//== Chase-Lev deque
+
+// Fixed-size work-stealing deque. The owning worker pushes and pops at the bottom (LIFO, cache-warm);
+// thieves take from the top (FIFO, oldest and usually largest work)
+al64 struct JOB_DEQUE {
+        vsi64 top    = 0;
+   al64 vsi64 bottom = 0;   // Own cache line: written on every owner push/pop
+   al64 JOB   job[JOB_DEQUE_SIZE];
+
+   /// Owner only.
+   /// @return false if the deque is full.
+   inline cbool Push(const JOB &newJob) {
+      csi64 b = bottom;
+      csi64 t = top;
+
+      if(b - t >= si64(JOB_DEQUE_SIZE)) return false;
+
+      job[b & (JOB_DEQUE_SIZE - 1u)] = newJob;
+      bottom = b + 1;   // Release: the job is visible before the new bottom
+
+      return true;
+   }
+
+   /// Owner only.
+   /// @return false if the deque is empty, or a thief won the race for the last job.
+   inline cbool Pop(JOB &out) {
+      csi64 b = bottom - 1;
+
+      // Full barrier: the reserved bottom must be visible to thieves before top is read
+      _InterlockedExchange64(&bottom, b);
+
+      csi64 t = top;
+
+      if(t > b) { bottom = b + 1; return false; }
+
+      out = job[b & (JOB_DEQUE_SIZE - 1u)];
+      if(t != b) return true;
+
+      // Last job; race any thief for it
+      cbool won = _InterlockedCompareExchange64(&top, t + 1, t) == t;
+      bottom = b + 1;
+
+      return won;
+   }
+
+   /// Any thread.
+   /// @return false if the deque is empty, or another thread took the job first.
+   inline cbool Steal(JOB &out) {
+      csi64 t = top;
+      csi64 b = bottom;
+
+      if(t >= b) return false;
+
+      out = job[t & (JOB_DEQUE_SIZE - 1u)];
+
+      return _InterlockedCompareExchange64(&top, t + 1, t) == t;
+   }
+};
+
+//== Injection queue
+
+// Bounded FIFO for jobs submitted by threads that are not workers (subsystem threads, the main thread)
+al64 struct JOB_QUEUE {
+   vui32 lock = 0;
+   vui32 head = 0;
+   vui32 tail = 0;
+   al64 JOB job[JOB_INJECT_SIZE];
+
+   inline cbool Push(const JOB &newJob) {
+      SpinLockVia(SPIN_WAIT_POLICY, &lock);
+      if(tail - head >= JOB_INJECT_SIZE) { SpinUnlock(&lock); return false; }
+      job[tail & (JOB_INJECT_SIZE - 1u)] = newJob;
+      tail++;
+      SpinUnlock(&lock);
+
+      return true;
+   }
+
+   inline cbool Pop(JOB &out) {
+      if(head == tail) return false;   // Unlocked peek; avoids lock traffic from idle workers
+
+      SpinLockVia(SPIN_WAIT_POLICY, &lock);
+      if(head == tail) { SpinUnlock(&lock); return false; }
+      out = job[head & (JOB_INJECT_SIZE - 1u)];
+      head++;
+      SpinUnlock(&lock);
+
+      return true;
+   }
+};
+
+//== Job system
+
+// Worker number of the calling thread: 1-based; 0 == not a job worker
+inline thread_local ui32 jobWorker = 0;
+
+inline DWORD WINAPI _JobWorker(LPVOID workerNumber);
+inline void        _JobParallelFill(ptrc addr, cui64 numBytes, cptrc pattern);
+
+al64 struct JOB_SYSTEM {
+   JOB_DEQUE *deque[MAX_JOB_WORKERS] = {};
+   JOB_QUEUE *inject = NULL;
+   JOB_QUEUE *nodeInject[MAX_NUMA_NODES] = {}; // Jobs for one node's workers, from threads not on that node; nodes > 1 only
+
+   HANDLE thread[MAX_JOB_WORKERS] = {};
+   ui8    workerNode[MAX_JOB_WORKERS] = {};   // NUMA node each worker is pinned to
+
+   JOB_DEQUE *nodeDeque[MAX_NUMA_NODES][MAX_JOB_WORKERS] = {}; // Carved from nodeArena on first use; kept for later Starts
+
+   al64 vui32 signal   = 0;   // Bumped per submit; idle workers WaitOnAddress() on it
+        vui32 sleepers = 0;
+        vui32 running  = 0;
+        ui32  workers  = 0;
+        ui8   nodes    = 1u;  // NUMA nodes with workers pinned to them; 1 == no placement
+
+   /// Allocates one deque per worker and starts the workers. On a multi-node host the workers are spread over the nodes
+   /// in proportion to their cores and pinned there (SetThreadNumaNode), and each node's deques and queue come from
+   /// nodeArena; if that memory cannot be had, the workers run unpinned.
+   /// @param workerCount  Number of worker threads; clamped to [1, MAX_JOB_WORKERS]. Usually virtCoreCount - 1, leaving the
+   ///                     submitting thread a core of its own (it runs jobs too while it waits).
+   /// @return 0 on success; 0x080000001 if already started; 0x080000002 if allocation failed; 0x080000003 if no thread started.
+   inline cui32 Start(ui32 workerCount) {
+      if(workers) return 0x080000001;
+
+      if(!workerCount) workerCount = 1u;
+      else if(workerCount > MAX_JOB_WORKERS) workerCount = MAX_JOB_WORKERS;
+
+      inject = (JOB_QUEUE *)zalloc64(sizeof(JOB_QUEUE));
+      if(!inject) return 0x080000002;
+
+      nodes = PlaceWorkers(workerCount);
+      if(nodes == 1u) {
+         JOB_DEQUE *const block = (JOB_DEQUE *)zalloc64(sizeof(JOB_DEQUE) * workerCount);
+         if(!block) { mdealloc(inject); inject = NULL; return 0x080000002; }
+         for(ui32 i = 0; i < workerCount; i++) { deque[i] = &block[i]; workerNode[i] = 0; }
+      }
+
+      running = 1u;
+      workers = workerCount;
+
+      // Suspended until pinned, so each worker's stack is first touched on its own node
+      for(ui32 i = 0; i < workerCount; i++) {
+         thread[i] = CreateThread(NULL, 0, _JobWorker, (LPVOID)ui64(i + 1u), CREATE_SUSPENDED, NULL);
+         if(!thread[i]) { workers = i; break; }
+         if(nodes > 1u) SetThreadNumaNode(thread[i], workerNode[i]);
+         ResumeThread(thread[i]);
+      }
+
+      if(workers) { parallelFill = _JobParallelFill; return 0; }
+
+      running = 0;
+      FreeDeques();
+
+      return 0x080000003;
+   }
+
+   /// Stops and joins every worker, then runs any jobs still queued on the calling thread.
+   inline void Stop() {
+      if(!workers) return;
+
+      parallelFill = NULL;
+      running      = 0;
+      _InterlockedIncrement((vol long *)&signal);
+      WakeByAddressAll((ptr)&signal);
+
+      WaitForMultipleObjects(workers, thread, TRUE, INFINITE);
+      for(ui32 i = 0; i < workers; i++) { CloseHandle(thread[i]); thread[i] = NULL; }
+
+      while(TryRunOne());
+
+      workers = 0;
+      FreeDeques();
+   }
+
+   /// Queues a job: on the calling worker's own deque, or the injection queue from any other thread; a job for a NUMA node
+   /// the caller is not on goes to that node's queue. Runs it inline when the system is stopped or the queue is full.
+   inline void Submit(const JOB &job) {
+      if(job.counter) _InterlockedIncrement64(&job.counter->pending);
+
+      cui32            self = jobWorker;
+      JOB_QUEUE *const away = (nodes > 1u && job.node < nodes && !(self && workerNode[self - 1u] == job.node)) ? nodeInject[job.node] : NULL;
+
+      if(!workers || !(away ? away->Push(job) : ((self && deque[self - 1u]->Push(job)) || inject->Push(job)))) { Run(job); return; }
+
+      _InterlockedIncrement((vol long *)&signal);
+      if(sleepers) WakeByAddressSingle((ptr)&signal);
+   }
+
+   inline void Submit(const JOB_FN fn, ptrc data, JOB_COUNTER *counter = NULL, const JOB_COUNTER *after = NULL) {
+      Submit({ fn, data, 0, 0, counter, after, 0 });
+   }
+
+   /// Runs fn over [0, count) in pieces of at most 'grain' indices. The range is split in halves as it is taken, so idle
+   /// workers steal large pieces first; every piece boundary is a multiple of 'grain'.
+   /// @note Returns once the range is queued; Wait(counter) for completion.
+   /// @note Make 'grain' a multiple of 64 when pieces set bits in shared ui64 masks, so no two pieces share a word.
+   inline void ParallelFor(cui64 count, cui64 grain, const JOB_FN fn, ptrc data, JOB_COUNTER &counter, const JOB_COUNTER *after = NULL) {
+      if(count) Submit({ fn, data, 0, count, &counter, after, grain ? grain : 1u });
+   }
+
+   /// As ParallelFor, over [begin, end), run by the workers of NUMA node 'node' while they have it queued; idle workers of
+   /// other nodes steal what is left. Piece boundaries are begin plus multiples of 'grain'.
+   inline void ParallelFor(cui64 begin, cui64 end, cui64 grain, const JOB_FN fn, ptrc data, JOB_COUNTER &counter, cui8 node) {
+      if(end > begin) Submit({ fn, data, begin, end, &counter, NULL, grain ? grain : 1u, node });
+   }
+
+   /// Runs queued jobs on the calling thread until counter->pending reaches 0.
+   inline void Wait(const JOB_COUNTER &counter) {
+      while(counter.pending) if(!TryRunOne()) _mm_pause();
+   }
+
+   /// Runs one job, if any: the caller's own deque first, then its node's queue and the injection queue, then steals from
+   /// the other workers (those on the caller's node first), and last takes work queued for other nodes.
+   /// @return true if a job was run.
+   inline cbool TryRunOne() {
+      if(!workers) return false;
+
+      cui32 self   = jobWorker;
+      cui8  home   = self ? workerNode[self - 1u] : JOB_ANY_NODE;
+      cui32 passes = nodes > 1u ? 2u : 1u;
+      JOB   job;
+
+      if(self && deque[self - 1u]->Pop(job)) { Run(job); return true; }
+      if(passes > 1u && home < nodes && nodeInject[home]->Pop(job)) { Run(job); return true; }
+      if(inject->Pop(job)) { Run(job); return true; }
+
+      // Start with the next worker along, so thieves spread out instead of all hitting deque 0
+      for(ui32 pass = 0; pass < passes; pass++)
+         for(ui32 i = 0, victim = self % workers; i < workers; i++, victim = (victim + 1u) % workers) {
+            cbool local = passes == 1u || (workerNode[victim] == home) == !pass;
+            if(local && victim + 1u != self && deque[victim]->Steal(job)) { Run(job); return true; }
+         }
+
+      if(passes > 1u) for(ui8 n = 0; n < nodes; n++) if(n != home && nodeInject[n]->Pop(job)) { Run(job); return true; }
+
+      return false;
+   }
+
+   private : inline void Run(JOB job) {
+      // Dependency not met: put the job back and let its predecessor finish first
+      if(job.after && job.after->pending) {
+         if(workers && inject->Push(job)) return;
+         Wait(*job.after);
+      }
+
+      // Keep the lower half; queue the upper half for thieves
+      if(job.grain) while(job.end - job.begin > job.grain) {
+         cui64 pieces = (job.end - job.begin + job.grain - 1u) / job.grain;
+         JOB   upper  = job;
+
+         upper.begin = job.end = job.begin + (pieces >> 1) * job.grain;
+         Submit(upper);
+      }
+
+      job.fn(job.data, job.begin, job.end);
+
+      if(job.counter) _InterlockedDecrement64(&job.counter->pending);
+   }
+
+   // Spreads workerCount workers over the NUMA nodes in proportion to their cores (workerNode), and gives each worker its
+   // deque, and each node its queue, from that node's arena. Returns the node count; 1, placing nothing, on a single-node
+   // host or if an arena cannot supply the memory
+   inline cui8 PlaceWorkers(cui32 workerCount) {
+      ui64 nodeCoreMap[MAX_NUMA_NODES];
+      ui32 cores[MAX_NUMA_NODES] = {}, onNode[MAX_NUMA_NODES] = {}, total = 0;
+      cui8 nodeCount = ProbeNumaNodes(nodeCoreMap);
+
+      if(nodeCount < 2u) return 1u;
+      for(ui8 n = 0; n < nodeCount; n++) total += cores[n] = ui32(_mm_popcnt_u64(nodeCoreMap[n]));
+      if(!total) return 1u;
+
+      for(ui32 i = 0; i < workerCount; i++) {
+         cui32 target = ui32(ui64(i) * total / workerCount);
+         ui8   n      = 0;
+
+         for(ui32 below = cores[0]; below <= target; ) below += cores[++n];
+         workerNode[i] = n;
+      }
+
+      for(ui8 n = 0; n < nodeCount; n++) {
+         if(!nodeInject[n] && !(nodeInject[n] = (JOB_QUEUE *)NodeAlloc(n, sizeof(JOB_QUEUE)))) return 1u;
+         nodeInject[n]->lock = nodeInject[n]->head = nodeInject[n]->tail = 0;
+      }
+      for(ui32 i = 0; i < workerCount; i++) {
+         cui8        n    = workerNode[i];
+         JOB_DEQUE *&home = nodeDeque[n][onNode[n]++];
+
+         if(!home && !(home = (JOB_DEQUE *)NodeAlloc(n, sizeof(JOB_DEQUE)))) return 1u;
+         home->top = home->bottom = 0;
+         deque[i]  = home;
+      }
+
+      return nodeCount;
+   }
+
+   // numBytes from nodeArena[node], creating the arena with JOB_NODE_ARENA bytes reserved if it is still empty; 0 on failure
+   static inline ptrc NodeAlloc(cui8 node, cui64 numBytes) {
+      if(!nodeArena[node].base && !nodeArena[node].Create(node, JOB_NODE_ARENA)) return 0;
+      return nodeArena[node].Alloc(numBytes, 64u);
+   }
+
+   // Releases the injection queue, and the deques of a single-node start; deques carved from nodeArena stay in nodeDeque
+   inline void FreeDeques() {
+      if(nodes == 1u) mdealloc(deque[0]);
+      mdealloc(inject);
+      for(ui32 i = 0; i < MAX_JOB_WORKERS; i++) deque[i] = NULL;
+      inject = NULL;
+   }
+};
+
+inline JOB_SYSTEM jobSystem;
+
+inline DWORD WINAPI _JobWorker(LPVOID workerNumber) {
+   jobWorker = ui32(ui64(workerNumber));
+
+   ui32 idle = 0;
+
+   while(jobSystem.running) {
+      if(jobSystem.TryRunOne()) { idle = 0; continue; }
+      if(++idle < JOB_IDLE_SPINS) { _mm_pause(); continue; }
+
+      // Sleep until the next submit. 'seen' is read before the final queue check: a submit after it changes the signal and
+      // WaitOnAddress() returns at once
+      cui32 seen = jobSystem.signal;
+
+      _InterlockedIncrement((vol long *)&jobSystem.sleepers);
+      if(!jobSystem.TryRunOne()) WaitOnAddress((ptr)&jobSystem.signal, (ptr)&seen, sizeof(ui32), JOB_SLEEP_MS);
+      _InterlockedDecrement((vol long *)&jobSystem.sleepers);
+
+      idle = 0;
+   }
+
+   return 0;
+}
+
+//== Parallel bulk fill (memory management.h ParallelFill, ParallelZero, zalloc and salloc from PARALLEL_FILL_THRESHOLD bytes)
+
+struct FILL_JOB {
+   ui8ptr  addr;       // Start of the whole fill
+   ui64    numBytes;
+   cui8ptr pattern;    // 64-byte block, in phase with addr
+};
+
+// Streams slices [begin, end) of a FILL_JOB. Slice i spans [addr + i * PARALLEL_FILL_SLICE, addr + (i + 1) * PARALLEL_FILL_SLICE)
+// with both ends but the first rounded up to a 4KB page, so no page is written by two workers
+inline void _JobFillSlices(ptr data, cui64 begin, cui64 end) {
+   const FILL_JOB &fill  = *(const FILL_JOB *)data;
+   cui64           start = (ui64)fill.addr, stop = start + fill.numBytes;
+
+   for(ui64 i = begin; i < end; i++) {
+      cui64 from = i ? RoundUpToNearest(start + i * PARALLEL_FILL_SLICE, 4096ull) : start;
+      ui64  to   = RoundUpToNearest(start + (i + 1u) * PARALLEL_FILL_SLICE, 4096ull);
+
+      if(to > stop) to = stop;
+      if(from >= to) continue;
+
+      // Keep the pattern in phase with the start of the whole fill
+      al64 ui8 rotated[64];
+      for(ui32 j = 0; j < 64u; j++) rotated[j] = fill.pattern[(from - start + j) & 0x03F];
+
+      memKernels.stream((ptr)from, to - from, rotated);
+   }
+}
+
+/// Installed as memory management.h's parallelFill while the workers run: one ParallelFor slice per PARALLEL_FILL_SLICE
+/// bytes, then helps the workers until the fill is done.
+inline void _JobParallelFill(ptrc addr, cui64 numBytes, cptrc pattern) {
+   const FILL_JOB fill = { (ui8ptr)addr, numBytes, (cui8ptr)pattern };
+   JOB_COUNTER    counter;
+
+   jobSystem.ParallelFor((numBytes + PARALLEL_FILL_SLICE - 1u) / PARALLEL_FILL_SLICE, 1u, _JobFillSlices, (ptrc)&fill, counter);
+   jobSystem.Wait(counter);
+}
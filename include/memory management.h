@@ -1,26 +1,27 @@
 /*
  * File: memory management.h
  *
- * Version: v1.2
+ * Version: v1.4
  *
  * Owner: David William Bull
  *
  * Created: 2008-12-08
  *
- * Last Modified: 2026-08-12
+ * Last Modified: 2026-10-17
  *
- * Description: Aligned allocators, pattern fill, zeroing, temporal and non-temporal copies, and interlocked transfers; optional allocation tracking.
+ * Description: Aligned, large-page, reserve-and-commit and NUMA-node-placed allocators, per-thread and per-node arenas, pattern fill,
+ *              zeroing (multi-threaded for large allocations), temporal and non-temporal copies, and interlocked transfers; optional
+ *              allocation tracking by subsystem tag and call site.
  *
- * To Do: 1) Replace the retained #ifdef __AVX512__ forks with run-time CPUID dispatch per GCS a8; retire the pre-AVX fallback arms per a2.
- *        2) Unit-test the salloc, mset, and mzero tail paths and the Copy and Stream families.
- *        3) Benchmark the non-temporal Stream16/32/64 against temporal copies per bd1/bd2 before asserting a performance win.
- *        4) Unify the truncation semantics of the two Copy64 overloads (const floors, volatile ceils; divergence is documented but unresolved).
+ * To Do: 1) Unit-test the salloc, mset, and mzero tail paths and the Copy and Stream families under each SelectMemKernels tier.
+ *        2) Record bench/memory kernels.cpp runs on target SKUs per bd1/bd2; pick the Stream crossover size from that data.
+ *        3) Unify the truncation semantics of the two Copy64 overloads (const floors, volatile ceils; divergence is documented but unresolved).
  *
- * Dependencies: windows.h, corecrt_malloc.h, typedefs.h, common functions.h, data tracking.h (DATA_TRACKING builds only)
+ * Dependencies: windows.h, corecrt_malloc.h, typedefs.h, common functions.h, cpu features.h, data tracking.h (DATA_TRACKING builds only)
  *
- * ISA: Scalar | SSE4.2 | AVX2 | AVX-512
+ * ISA: AVX2 (baseline) | AVX-512F; selected once at start-up by run-time probe (SelectMemKernels)
  *
- * Thread-safety: Reentrant
+ * Thread-safety: Reentrant; FRAME_ARENA is thread-confined (one arena per thread via the thread_local frameArena)
  *
  * Reviewers: David William Bull
  *
@@ -28,12 +29,13 @@
  */
 #pragma once
 
-#pragma intrinsic(_InterlockedExchange64)
+#pragma intrinsic(_InterlockedExchange64, _InterlockedExchangeAdd64, _InterlockedIncrement64, _InterlockedCompareExchange64)
 
 #include <windows.h>
 #include <corecrt_malloc.h>
 #include "typedefs.h"
 #include "common functions.h"
+#include "cpu features.h"
 
 #ifdef DATA_TRACKING
 #include "data tracking.h"
@@ -41,310 +43,759 @@
 
 #define _MEMORY_MANAGER_
 
-#define malloc1(byteCount)  malloc(byteCount, 1u)
-#define malloc2(byteCount)  malloc(byteCount, 2u)
-#define malloc4(byteCount)  malloc(byteCount, 4u)
-#define malloc8(byteCount)  malloc(byteCount, 8u)
-#define malloc16(byteCount) malloc(byteCount, 16u)
-#define malloc32(byteCount) malloc(byteCount, 32u)
-#define malloc64(byteCount) malloc(byteCount, 64u)
+// Call site of an allocation macro; recorded against the allocation in DATA_TRACKING builds
+#define MEM_SITE __FILE__, __LINE__
+
+// Subsystem tag (AE_SUBSYSTEM value) charged for the calling thread's allocations; set once at each thread's entry point
+inline thread_local ui8 memTag = 0;
+
+// Charges the calling thread's allocations to another subsystem tag until the end of the enclosing scope
+struct MEM_TAG_SCOPE {
+   cui8 previous;
+
+   MEM_TAG_SCOPE(cui8 tag) : previous(memTag) { memTag = tag; }
+   ~MEM_TAG_SCOPE(void) { memTag = previous; }
+};
+
+#define malloc1(byteCount)  malloc(byteCount, 1u, MEM_SITE)
+#define malloc2(byteCount)  malloc(byteCount, 2u, MEM_SITE)
+#define malloc4(byteCount)  malloc(byteCount, 4u, MEM_SITE)
+#define malloc8(byteCount)  malloc(byteCount, 8u, MEM_SITE)
+#define malloc16(byteCount) malloc(byteCount, 16u, MEM_SITE)
+#define malloc32(byteCount) malloc(byteCount, 32u, MEM_SITE)
+#define malloc64(byteCount) malloc(byteCount, 64u, MEM_SITE)
 
 // Declare 1-dimensional array at 16-byte boundary
 #define declare1d16(dataType, variableName, dim) \
-   dataType *const variableName = (dataType *)malloc(RoundUpToNearest16(sizeof(dataType) * (dim)), 16u)
+   dataType *const variableName = (dataType *)malloc(RoundUpToNearest16(sizeof(dataType) * (dim)), 16u, MEM_SITE)
 
 // Declare 1-dimensional array at 32-byte boundary
 #define declare1d32(dataType, variableName, dim) \
-   dataType *const variableName = (dataType *)malloc(RoundUpToNearest32(sizeof(dataType) * (dim)), 32u)
+   dataType *const variableName = (dataType *)malloc(RoundUpToNearest32(sizeof(dataType) * (dim)), 32u, MEM_SITE)
 
 // Declare 1-dimensional array at 64-byte boundary
 #define declare1d64(dataType, variableName, dim) \
-   dataType *const variableName = (dataType *)malloc(RoundUpToNearest64(sizeof(dataType) * (dim)), 64u)
+   dataType *const variableName = (dataType *)malloc(RoundUpToNearest64(sizeof(dataType) * (dim)), 64u, MEM_SITE)
 
 // Declare 2-dimensional array at 16-byte boundary
 #define declare2d16(dataType, variableName, dim1, dim2) \
-   dataType (*const variableName)[dim2] = (dataType (*)[dim2])malloc(RoundUpToNearest16(sizeof(dataType) * ((dim1) * (dim2))), 16u)
+   dataType (*const variableName)[dim2] = (dataType (*)[dim2])malloc(RoundUpToNearest16(sizeof(dataType) * ((dim1) * (dim2))), 16u, MEM_SITE)
 
 // Declare 2-dimensional array at 32-byte boundary
 #define declare2d32(dataType, variableName, dim1, dim2) \
-   dataType (*const variableName)[dim2] = (dataType (*)[dim2])malloc(RoundUpToNearest32(sizeof(dataType) * ((dim1) * (dim2))), 32u)
+   dataType (*const variableName)[dim2] = (dataType (*)[dim2])malloc(RoundUpToNearest32(sizeof(dataType) * ((dim1) * (dim2))), 32u, MEM_SITE)
 
 // Declare 2-dimensional array at 64-byte boundary
 #define declare2d64(dataType, variableName, dim1, dim2) \
-   dataType (*const variableName)[dim2] = (dataType (*)[dim2])malloc(RoundUpToNearest64(sizeof(dataType) * ((dim1) * (dim2))), 64u)
+   dataType (*const variableName)[dim2] = (dataType (*)[dim2])malloc(RoundUpToNearest64(sizeof(dataType) * ((dim1) * (dim2))), 64u, MEM_SITE)
 
 // Declare 1-dimensional array at 16-byte boundary, then zero contents
 #define declare1d16z(dataType, variableName, dim) \
-   dataType *const variableName = (dataType *)salloc(RoundUpToNearest16(sizeof(dataType) * (dim)), 16u, null128)
+   dataType *const variableName = (dataType *)zalloc(RoundUpToNearest16(sizeof(dataType) * (dim)), 16u, MEM_SITE)
 
 // Declare 1-dimensional array at 32-byte boundary, then zero contents
 #define declare1d32z(dataType, variableName, dim) \
-   dataType *const variableName = (dataType *)salloc(RoundUpToNearest32(sizeof(dataType) * (dim)), 32u, null128)
+   dataType *const variableName = (dataType *)zalloc(RoundUpToNearest32(sizeof(dataType) * (dim)), 32u, MEM_SITE)
 
 // Declare 1-dimensional array at 64-byte boundary, then zero contents
 #define declare1d64z(dataType, variableName, dim) \
-   dataType *const variableName = (dataType *)salloc(RoundUpToNearest64(sizeof(dataType) * (dim)), 64u, null128)
+   dataType *const variableName = (dataType *)zalloc(RoundUpToNearest64(sizeof(dataType) * (dim)), 64u, MEM_SITE)
 
 // Declare 2-dimensional array at 16-byte boundary, then zero contents
 #define declare2d16z(dataType, variableName, dim1, dim2) \
-   dataType (*const variableName)[dim2] = (dataType (*)[dim2])salloc(RoundUpToNearest16(sizeof(dataType) * ((dim1) * (dim2))), 16u, null128)
+   dataType (*const variableName)[dim2] = (dataType (*)[dim2])zalloc(RoundUpToNearest16(sizeof(dataType) * ((dim1) * (dim2))), 16u, MEM_SITE)
 
 // Declare 2-dimensional array at 32-byte boundary, then zero contents
 #define declare2d32z(dataType, variableName, dim1, dim2) \
-   dataType (*const variableName)[dim2] = (dataType (*)[dim2])salloc(RoundUpToNearest32(sizeof(dataType) * ((dim1) * (dim2))), 32u, null128)
+   dataType (*const variableName)[dim2] = (dataType (*)[dim2])zalloc(RoundUpToNearest32(sizeof(dataType) * ((dim1) * (dim2))), 32u, MEM_SITE)
 
 // Declare 2-dimensional array at 64-byte boundary, then zero contents
 #define declare2d64z(dataType, variableName, dim1, dim2) \
-   dataType (*const variableName)[dim2] = (dataType (*)[dim2])salloc(RoundUpToNearest64(sizeof(dataType) * ((dim1) * (dim2))), 64u, null128)
+   dataType (*const variableName)[dim2] = (dataType (*)[dim2])zalloc(RoundUpToNearest64(sizeof(dataType) * ((dim1) * (dim2))), 64u, MEM_SITE)
 
 // Declare 1-dimensional array at 16-byte boundary, then set the entire array to a repeating pattern of 8~512 bits
 #define declare1d16s(dataType, variableName, dim, bitPattern) \
-   dataType *const variableName = (dataType *)salloc(RoundUpToNearest16(sizeof(dataType) * (dim)), 16u, bitPattern)
+   dataType *const variableName = (dataType *)salloc(RoundUpToNearest16(sizeof(dataType) * (dim)), 16u, bitPattern, MEM_SITE)
 
 // Declare 1-dimensional array at 32-byte boundary, then set the entire array to a repeating pattern of 8~512 bits
 #define declare1d32s(dataType, variableName, dim, bitPattern) \
-   dataType *const variableName = (dataType *)salloc(RoundUpToNearest32(sizeof(dataType) * (dim)), 32u, bitPattern)
+   dataType *const variableName = (dataType *)salloc(RoundUpToNearest32(sizeof(dataType) * (dim)), 32u, bitPattern, MEM_SITE)
 
 // Declare 1-dimensional array at 64-byte boundary, then set the entire array to a repeating pattern of 8~512 bits
 #define declare1d64s(dataType, variableName, dim, bitPattern) \
-   dataType *const variableName = (dataType *)salloc(RoundUpToNearest64(sizeof(dataType) * (dim)), 64u, bitPattern)
+   dataType *const variableName = (dataType *)salloc(RoundUpToNearest64(sizeof(dataType) * (dim)), 64u, bitPattern, MEM_SITE)
 
 // Allocates RAM at 16-byte boundary, then sets the entire array to a repeating pattern of 8~512 bits
-#define salloc16(byteCount, bitPattern) salloc(byteCount, 16u, bitPattern)
+#define salloc16(byteCount, bitPattern) salloc(byteCount, 16u, bitPattern, MEM_SITE)
 
 // Allocates RAM at 16-byte boundary, then sets the entire array to a repeating pattern of 8~512 bits
 #define salloc1d16(dataType, dim, bitPattern) \
-   (dataType *)salloc(RoundUpToNearest16(sizeof(dataType) * (dim)), 16u, bitPattern)
+   (dataType *)salloc(RoundUpToNearest16(sizeof(dataType) * (dim)), 16u, bitPattern, MEM_SITE)
 
 // Allocates RAM at 16-byte boundary, then sets the entire array to a repeating pattern of 8~512 bits
 #define salloc2d16(dataType, dim1, dim2, bitPattern) \
-   (dataType (*)[dim2])salloc(RoundUpToNearest16(sizeof(dataType) * ((dim1) * (dim2))), 16u, bitPattern)
+   (dataType (*)[dim2])salloc(RoundUpToNearest16(sizeof(dataType) * ((dim1) * (dim2))), 16u, bitPattern, MEM_SITE)
 
 // Allocates RAM at 32-byte boundary, then sets the entire array to a repeating pattern of 8~512 bits
-#define salloc32(byteCount, bitPattern) salloc(byteCount, 32u, bitPattern)
+#define salloc32(byteCount, bitPattern) salloc(byteCount, 32u, bitPattern, MEM_SITE)
 
 // Allocates RAM at 32-byte boundary, then sets the entire array to a repeating pattern of 8~512 bits
 #define salloc1d32(dataType, dim, bitPattern) \
-   (dataType *)salloc(RoundUpToNearest32(sizeof(dataType) * (dim)), 32u, bitPattern)
+   (dataType *)salloc(RoundUpToNearest32(sizeof(dataType) * (dim)), 32u, bitPattern, MEM_SITE)
 
 // Allocates RAM at 32-byte boundary, then sets the entire array to a repeating pattern of 8~512 bits
 #define salloc2d32(dataType, dim1, dim2, bitPattern) \
-   (dataType (*)[dim2])salloc(RoundUpToNearest32(sizeof(dataType) * ((dim1) * (dim2))), 32u, bitPattern)
+   (dataType (*)[dim2])salloc(RoundUpToNearest32(sizeof(dataType) * ((dim1) * (dim2))), 32u, bitPattern, MEM_SITE)
 
 // Allocates RAM at 64-byte boundary, then sets the entire array to a repeating pattern of 8~512 bits
-#define salloc64(byteCount, bitPattern) salloc(byteCount, 64u, bitPattern)
+#define salloc64(byteCount, bitPattern) salloc(byteCount, 64u, bitPattern, MEM_SITE)
 
 // Allocates RAM at 64-byte boundary, then sets the entire array to a repeating pattern of 8~512 bits
 #define salloc1d64(dataType, dim, bitPattern) \
-   (dataType *)salloc(RoundUpToNearest64(sizeof(dataType) * (dim)), 64u, bitPattern)
+   (dataType *)salloc(RoundUpToNearest64(sizeof(dataType) * (dim)), 64u, bitPattern, MEM_SITE)
 
 // Allocates RAM at 64-byte boundary, then sets the entire array to a repeating pattern of 8~512 bits
 #define salloc2d64(dataType, dim1, dim2, bitPattern) \
-   (dataType (*)[dim2])salloc(RoundUpToNearest64(sizeof(dataType) * ((dim1) * (dim2))), 64u, bitPattern)
+   (dataType (*)[dim2])salloc(RoundUpToNearest64(sizeof(dataType) * ((dim1) * (dim2))), 64u, bitPattern, MEM_SITE)
 
 // Allocates RAM at 16-byte boundary, then sets the entire array to zero
-#define zalloc16(byteCount) salloc(byteCount, 16u, null128)
+#define zalloc16(byteCount) zalloc(byteCount, 16u, MEM_SITE)
 
 // Allocates RAM at 16-byte boundary, then sets the entire array to zero
 #define zalloc1d16(dataType, dim) \
-   (dataType *)salloc(RoundUpToNearest16(sizeof(dataType) * (dim)), 16u, null128)
+   (dataType *)zalloc(RoundUpToNearest16(sizeof(dataType) * (dim)), 16u, MEM_SITE)
 
 // Allocates RAM at 16-byte boundary, then sets the entire array to zero
 #define zalloc2d16(dataType, dim1, dim2) \
-   (dataType (*)[dim2])salloc(RoundUpToNearest16(sizeof(dataType) * ((dim1) * (dim2))), 16u, null128)
-
-#ifdef __AVX__
-// Allocates RAM at 32-byte boundary, then sets the entire array to zero
-#define zalloc32(byteCount) salloc(byteCount, 32u, null256)
+   (dataType (*)[dim2])zalloc(RoundUpToNearest16(sizeof(dataType) * ((dim1) * (dim2))), 16u, MEM_SITE)
 
 // Allocates RAM at 32-byte boundary, then sets the entire array to zero
-#define zalloc1d32(dataType, dim) \
-   (dataType *)salloc(RoundUpToNearest32(sizeof(dataType) * (dim)), 32u, null256)
-
-// Allocates RAM at 32-byte boundary, then sets the entire array to zero
-#define zalloc2d32(dataType, dim1, dim2) \
-   (dataType (*)[dim2])salloc(RoundUpToNearest32(sizeof(dataType) * ((dim1) * (dim2))), 32u, null256)
-#else
-// Allocates RAM at 32-byte boundary, then sets the entire array to zero
-#define zalloc32(byteCount) salloc(byteCount, 32u, null128)
+#define zalloc32(byteCount) zalloc(byteCount, 32u, MEM_SITE)
 
 // Allocates RAM at 32-byte boundary, then sets the entire array to zero
 #define zalloc1d32(dataType, dim) \
-   (dataType *)salloc(RoundUpToNearest32(sizeof(dataType) * (dim)), 32u, null128)
+   (dataType *)zalloc(RoundUpToNearest32(sizeof(dataType) * (dim)), 32u, MEM_SITE)
 
 // Allocates RAM at 32-byte boundary, then sets the entire array to zero
 #define zalloc2d32(dataType, dim1, dim2) \
-   (dataType (*)[dim2])salloc(RoundUpToNearest32(sizeof(dataType) * ((dim1) * (dim2))), 32u, null128)
-#endif
+   (dataType (*)[dim2])zalloc(RoundUpToNearest32(sizeof(dataType) * ((dim1) * (dim2))), 32u, MEM_SITE)
 
-#ifdef __AVX512__
 // Allocates RAM at 64-byte boundary, then sets the entire array to zero
-#define zalloc64(byteCount) salloc(byteCount, 64u, null512)
+#define zalloc64(byteCount) zalloc(byteCount, 64u, MEM_SITE)
 
 // Allocates RAM at 64-byte boundary, then sets the entire array to zero
 #define zalloc1d64(dataType, dim) \
-   (dataType *)salloc(RoundUpToNearest64(sizeof(dataType) * (dim)), 64u, null512)
+   (dataType *)zalloc(RoundUpToNearest64(sizeof(dataType) * (dim)), 64u, MEM_SITE)
 
 // Allocates RAM at 64-byte boundary, then sets the entire array to zero
 #define zalloc2d64(dataType, dim1, dim2) \
-   (dataType (*)[dim2])salloc(RoundUpToNearest64(sizeof(dataType) * ((dim1) * (dim2))), 64u, null512)
-#else
-#ifdef __AVX__
-// Allocates RAM at 64-byte boundary, then sets the entire array to zero
-#define zalloc64(byteCount) salloc(byteCount, 64u, null256)
+   (dataType (*)[dim2])zalloc(RoundUpToNearest64(sizeof(dataType) * ((dim1) * (dim2))), 64u, MEM_SITE)
+
+//== Run-time kernel dispatch
+//   One implementation of each bulk kernel per instruction-set tier: AVX2, the baseline (GCS a2), and AVX-512F, one step
+//   above it (a8). There is no narrower tier; the AVX2 table is also the fallback. SelectMemKernels fills the memKernels
+//   table once, from the same ISA_* probe that fills SYSTEM_DATA::cpu.instructions, so a single binary uses AVX-512 where
+//   the CPU and OS support it. The public mzero/mset/Copy/Copy32/Copy64/Stream16/32/64 call through the table.
+//   MSVC emits the intrinsics of every tier regardless of /arch; no tier is entered unless its probe bit is set.
+
+// Lane width (bytes) of the widest aligned copy/stream per tier
+constexpr cui64 MEM_TIER_WIDTH_AVX2   = 32u;
+constexpr cui64 MEM_TIER_WIDTH_AVX512 = 64u;
+
+// Writes the bytes before addr's first laneBytes boundary, and rotates pattern into rotated so that it stays in phase
+// with addr from that boundary on. Returns the number of bytes written
+inline cui64 _StreamFillHead(ptrc addr, cui64 numBytes, cptrc pattern, ui8ptrc rotated, cui64 laneBytes) {
+   cui64 misalign = (0u - (ui64)addr) & (laneBytes - 1u);
+   cui64 head     = misalign < numBytes ? misalign : numBytes;
+   ui64  i;
+   for(i = 0; i < head; ++i) ((ui8ptr)addr)[i] = ((cui8ptr)pattern)[i];
+   for(i = 0; i < 64u; ++i) rotated[i] = ((cui8ptr)pattern)[(i + head) & 0x03F];
+   return head;
+}
 
-// Allocates RAM at 64-byte boundary, then sets the entire array to zero
-#define zalloc1d64(dataType, dim) \
-   (dataType *)salloc(RoundUpToNearest64(sizeof(dataType) * (dim)), 64u, null256)
+//-- AVX2 tier
 
-// Allocates RAM at 64-byte boundary, then sets the entire array to zero
-#define zalloc2d64(dataType, dim1, dim2) \
-   (dataType (*)[dim2])salloc(RoundUpToNearest64(sizeof(dataType) * ((dim1) * (dim2))), 64u, null256)
-#else
-// Allocates RAM at 64-byte boundary, then sets the entire array to zero
-#define zalloc64(byteCount) salloc(byteCount, 64, null128)
+inline void _MZero_AVX2(ptrc addr, cui64 numBytes) {
+   cui64 count = numBytes >> 5;
+   ui64  i;
+   for(i = 0; i < count; ++i) _mm256_storeu_si256(&((ui256ptr)addr)[i], _mm256_setzero_si256());
+   for(i <<= 2; i < (numBytes >> 3); ++i) ((ui64ptr)addr)[i] = 0u;
+   for(i <<= 3; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
+}
 
-// Allocates RAM at 64-byte boundary, then sets the entire array to zero
-#define zalloc1d64(dataType, dim) \
-   (dataType *)salloc(RoundUpToNearest64(sizeof(dataType) * (dim)), 64u, null128)
+inline void _MFill_AVX2(ptrc addr, cui64 numBytes, cptrc pattern) {
+   cui256 p0 = _mm256_load_si256(&((cui256ptr)pattern)[0]), p1 = _mm256_load_si256(&((cui256ptr)pattern)[1]);
+   cui64  count = numBytes >> 6;
+   ui64   i;
+   for(i = 0; i < count; ++i) {
+      _mm256_storeu_si256(&((ui256ptr)addr)[(i << 1)], p0);
+      _mm256_storeu_si256(&((ui256ptr)addr)[(i << 1) + 1], p1);
+   }
+   for(i <<= 6; i < numBytes; ++i) ((ui8ptr)addr)[i] = ((cui8ptr)pattern)[i & 0x03F];
+}
 
-// Allocates RAM at 64-byte boundary, then sets the entire array to zero
-#define zalloc2d64(dataType, dim1, dim2) \
-   (dataType (*)[dim2])salloc(RoundUpToNearest64(sizeof(dataType) * ((dim1) * (dim2))), 64u, null128)
-#endif
-#endif
+inline void _Copy_AVX2(cptrc source, ptrc dest, cui64 byteCount) {
+   cui64 j = byteCount >> 5, k = byteCount >> 2;
+   ui64  i;
+   for(i = 0; i < j; i++) _mm256_storeu_si256(&((ui256ptr)dest)[i], _mm256_lddqu_si256(&((cui256ptr)source)[i]));
+   for(i <<= 3; i < k; i++) ((ui32ptr)dest)[i] = ((cui32ptr)source)[i];
+   for(i = k << 2; i < byteCount; i++) ((ui8ptr)dest)[i] = ((cui8ptr)source)[i];
+}
+
+// Aligned copy of byteCount rounded down to 32; serves Copy32 on every tier, and Copy64 on this one
+inline void _Copy32_AVX2(cptrc source, ptrc dest, cui64 byteCount) {
+   cui64 j = byteCount >> 5;
+   for(ui64 i = 0; i < j; i++) _mm256_store_si256(&((ui256ptr)dest)[i], _mm256_load_si256(&((cui256ptr)source)[i]));
+}
+
+// Non-temporal copy of byteCount rounded down to 16; serves Stream16 on every tier
+inline void _Stream16_AVX2(cptrc source, ptrc dest, cui64 byteCount) {
+   cui64 j = byteCount >> 4;
+   for(ui64 i = 0; i < j; i++) _mm_stream_si128(&((ui128ptr)dest)[i], _mm_load_si128(&((cui128ptr)source)[i]));
+   _mm_sfence();
+}
+
+// Non-temporal copy of byteCount rounded down to 32; serves Stream32 on every tier, and Stream64 on this one
+inline void _Stream32_AVX2(cptrc source, ptrc dest, cui64 byteCount) {
+   cui64 j = byteCount >> 5;
+   for(ui64 i = 0; i < j; i++) _mm256_stream_si256(&((ui256ptr)dest)[i], _mm256_load_si256(&((cui256ptr)source)[i]));
+   _mm_sfence();
+}
+
+// Non-temporal fill; any alignment
+inline void _StreamFill_AVX2(ptrc addr, cui64 numBytes, cptrc pattern) {
+   al64 ui8 rotated[64];
+   cui64    head  = _StreamFillHead(addr, numBytes, pattern, rotated, MEM_TIER_WIDTH_AVX2);
+   ui8ptrc  body  = &((ui8ptr)addr)[head];
+   cui64    bytes = numBytes - head, count = bytes >> 6;
+   cui256   p0 = _mm256_load_si256(&((cui256ptr)rotated)[0]), p1 = _mm256_load_si256(&((cui256ptr)rotated)[1]);
+   ui64     i;
+   for(i = 0; i < count; ++i) {
+      _mm256_stream_si256(&((ui256ptr)body)[(i << 1)], p0);
+      _mm256_stream_si256(&((ui256ptr)body)[(i << 1) + 1], p1);
+   }
+   _mm_sfence();
+   for(i <<= 6; i < bytes; ++i) body[i] = rotated[i & 0x03F];
+}
+
+//-- AVX-512F tier
+
+inline void _MZero_AVX512(ptrc addr, cui64 numBytes) {
+   cui64 count = numBytes >> 6;
+   ui64  i;
+   for(i = 0; i < count; ++i) _mm512_storeu_si512(&((ui512ptr)addr)[i], _mm512_setzero_si512());
+   for(i <<= 3; i < (numBytes >> 3); ++i) ((ui64ptr)addr)[i] = 0u;
+   for(i <<= 3; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
+}
+
+inline void _MFill_AVX512(ptrc addr, cui64 numBytes, cptrc pattern) {
+   cui512 p0    = _mm512_load_si512(pattern);
+   cui64  count = numBytes >> 6;
+   ui64   i;
+   for(i = 0; i < count; ++i) _mm512_storeu_si512(&((ui512ptr)addr)[i], p0);
+   for(i <<= 3; i < (numBytes >> 3); ++i) ((ui64ptr)addr)[i] = ((cui64ptr)pattern)[i & 0x07];
+   for(i <<= 3; i < numBytes; ++i) ((ui8ptr)addr)[i] = ((cui8ptr)pattern)[i & 0x03F];
+}
+
+inline void _Copy_AVX512(cptrc source, ptrc dest, cui64 byteCount) {
+   cui64 j = byteCount >> 6, k = byteCount >> 2;
+   ui64  i;
+   for(i = 0; i < j; i++) _mm512_storeu_si512(&((ui512ptr)dest)[i], _mm512_loadu_si512(&((cui512ptr)source)[i]));
+   for(i <<= 4; i < k; i++) ((ui32ptr)dest)[i] = ((cui32ptr)source)[i];
+   for(i = k << 2; i < byteCount; i++) ((ui8ptr)dest)[i] = ((cui8ptr)source)[i];
+}
+
+// Aligned copy of byteCount rounded down to 64; serves Copy64 on this tier
+inline void _Copy64_AVX512(cptrc source, ptrc dest, cui64 byteCount) {
+   cui64 j = byteCount >> 6;
+   for(ui64 i = 0; i < j; i++) _mm512_store_si512(&((ui512ptr)dest)[i], _mm512_load_si512(&((cui512ptr)source)[i]));
+}
+
+// Non-temporal copy of byteCount rounded down to 64; serves Stream64 on this tier
+inline void _Stream64_AVX512(cptrc source, ptrc dest, cui64 byteCount) {
+   cui64 j = byteCount >> 6;
+   for(ui64 i = 0; i < j; i++) _mm512_stream_si512(&((ui512ptr)dest)[i], _mm512_load_si512(&((cui512ptr)source)[i]));
+   _mm_sfence();
+}
+
+// Non-temporal fill; any alignment
+inline void _StreamFill_AVX512(ptrc addr, cui64 numBytes, cptrc pattern) {
+   al64 ui8 rotated[64];
+   cui64    head  = _StreamFillHead(addr, numBytes, pattern, rotated, MEM_TIER_WIDTH_AVX512);
+   ui8ptrc  body  = &((ui8ptr)addr)[head];
+   cui64    bytes = numBytes - head, count = bytes >> 6;
+   cui512   p0    = _mm512_load_si512(rotated);
+   ui64     i;
+   for(i = 0; i < count; ++i) _mm512_stream_si512(&((ui512ptr)body)[i], p0);
+   _mm_sfence();
+   for(i <<= 6; i < bytes; ++i) body[i] = rotated[i & 0x03F];
+}
+
+//-- Dispatch table
+
+typedef void (*MEM_ZERO_FN)(ptrc addr, cui64 numBytes);
+typedef void (*MEM_FILL_FN)(ptrc addr, cui64 numBytes, cptrc pattern);
+typedef void (*MEM_COPY_FN)(cptrc source, ptrc dest, cui64 byteCount);
+
+/// Bulk-memory kernels for one instruction-set tier. Every entry may be reassigned individually (e.g. by a test harness)
+/// after SelectMemKernels; entries must stay valid for the CPU running them.
+/// @note zero, fill and copy accept any alignment. copy32/copy64/stream16/32/64 require source and dest aligned to
+///       their lane width and floor byteCount to it; the volatile Copy64 and Stream64 ceil byteCount via width first.
+struct MEM_KERNELS {
+   MEM_ZERO_FN zero;     // Zero numBytes
+   MEM_FILL_FN fill;     // Fill numBytes with a repeating 64-byte, 64-byte-aligned pattern block
+   MEM_FILL_FN stream;   // As fill, with non-temporal stores (bypasses the caches; for buffers larger than the LLC)
+   MEM_COPY_FN copy;     // Unaligned copy of byteCount bytes
+   MEM_COPY_FN copy32;   // Aligned copy; byteCount floored to 32
+   MEM_COPY_FN copy64;   // Aligned copy; byteCount floored to width
+   MEM_COPY_FN stream16; // Non-temporal copy; byteCount floored to 16
+   MEM_COPY_FN stream32; // Non-temporal copy; byteCount floored to 32
+   MEM_COPY_FN stream64; // Non-temporal copy; byteCount floored to width
+   ui64        width;    // Lane width in bytes of copy64 and stream64
+   ui8         isa;      // ISA_* bit of the selected tier
+};
+
+constexpr MEM_KERNELS MEM_KERNELS_AVX2   = { _MZero_AVX2, _MFill_AVX2, _StreamFill_AVX2, _Copy_AVX2, _Copy32_AVX2, _Copy32_AVX2, _Stream16_AVX2,
+                                             _Stream32_AVX2, _Stream32_AVX2, MEM_TIER_WIDTH_AVX2, ISA_AVX2 };
+constexpr MEM_KERNELS MEM_KERNELS_AVX512 = { _MZero_AVX512, _MFill_AVX512, _StreamFill_AVX512, _Copy_AVX512, _Copy32_AVX2, _Copy64_AVX512,
+                                             _Stream16_AVX2, _Stream32_AVX2, _Stream64_AVX512, MEM_TIER_WIDTH_AVX512, ISA_AVX512F };
+
+// Active kernel table. Constant-initialised to the AVX2 baseline (GCS a2), so it is valid before dynamic initialisation runs
+inline MEM_KERNELS memKernels = MEM_KERNELS_AVX2;
+
+/// Selects the widest kernel tier permitted by isaBits and the CPU, and installs it in memKernels.
+/// @param isaBits  ISA_* flags to allow; pass ProbeInstructionSets() for the native tier, or a subset (e.g. ISA_AVX2) to
+///                 force a narrower tier under test. Bits the CPU lacks are ignored, so a wider tier can never be forced.
+/// @return ISA_* bit of the installed tier.
+/// @note Not synchronised: call at start-up, or from a test while no other thread uses the memory functions.
+inline cui8 SelectMemKernels(cui8 isaBits) {
+   cui8 allowed = isaBits & ProbeInstructionSets();
+
+   memKernels = (allowed & ISA_AVX512F) ? MEM_KERNELS_AVX512 : MEM_KERNELS_AVX2;
+
+   return memKernels.isa;
+}
+
+// One-time probe, at dynamic initialisation: the ISA_* bit of the tier in use
+inline cui8 memKernelTier = SelectMemKernels(0x0FFu);
+
+//== Parallel bulk fill
+//   Fills of PARALLEL_FILL_THRESHOLD bytes or more go through the parallelFill hook, which the job system installs while
+//   its workers run (job system.h, _JobParallelFill): the range is split into page-aligned slices of PARALLEL_FILL_SLICE
+//   bytes and streamed by the workers, so several cores share the memory bandwidth and, on NUMA hosts, each slice's
+//   pages are first touched on the node of the worker that fills them. Without the hook, large fills are streamed by the
+//   calling thread; smaller fills always run there, through memKernels.fill.
+
+constexpr cui64 PARALLEL_FILL_THRESHOLD = 64ull << 20; // Smaller fills run on the calling thread, through memKernels.fill
+constexpr cui64 PARALLEL_FILL_SLICE     = 16ull << 20; // Bytes per job; slices end on 4KB page boundaries
+
+// Multi-threaded fill of PARALLEL_FILL_THRESHOLD bytes or more; NULL == stream on the calling thread. Set by JOB_SYSTEM::Start
+// and cleared by JOB_SYSTEM::Stop
+inline MEM_FILL_FN parallelFill = NULL;
+
+/// Fills numBytes at addr with a repeating 64-byte, 64-byte-aligned pattern block, across the job workers when large.
+/// @note Returns once every byte is written.
+inline void ParallelFill(ptrc addr, cui64 numBytes, cptrc pattern) {
+   if(numBytes < PARALLEL_FILL_THRESHOLD) { memKernels.fill(addr, numBytes, pattern); return; }
+
+   const MEM_FILL_FN fill = parallelFill;
+
+   if(fill) fill(addr, numBytes, pattern);
+   else     memKernels.stream(addr, numBytes, pattern);
+}
+
+/// Zeroes numBytes at addr, across the job workers when large.
+inline void ParallelZero(ptrc addr, cui64 numBytes) {
+   if(numBytes < PARALLEL_FILL_THRESHOLD) { memKernels.zero(addr, numBytes); return; }
+
+   al64 cui64 zero[8] = {};
+   ParallelFill(addr, numBytes, zero);
+}
+
+//== Zeroing, filling and copying
+
+// Set a region of memory to zero
+inline void mzero(ptrc addr, cui64 numBytes) { memKernels.zero(addr, numBytes); }
+
+// Set a region of memory to zero
+inline void mzero(vptrc addr, cui64 numBytes) { memKernels.zero((ptrc)addr, numBytes); }
+
+// Set a region of memory to zero
+inline void mzero(ui128ptrc addr, cui64 numBytes) { memKernels.zero(addr, numBytes); }
+
+// Set a region of memory to zero
+inline void mzero(ui256ptrc addr, cui64 numBytes) { memKernels.zero(addr, numBytes); }
+
+// Set a region of memory to zero
+inline void mzero(ui512ptrc addr, cui64 numBytes) { memKernels.zero(addr, numBytes); }
+
+// Set a region of memory to a repeating pattern
+#define setmem(addr, numBytes, bitPattern) mset(addr, numBytes, bitPattern)
+
+// Set a region of memory to a repeating 128-bit pattern
+inline void mset(ptrc addr, cui64 numBytes, cui128 bitPattern) {
+   al64 cui128 pattern[4] = { bitPattern, bitPattern, bitPattern, bitPattern };
+   memKernels.fill(addr, numBytes, pattern);
+}
+
+// Set a region of memory to a repeating 256-bit pattern
+inline void mset(ptrc addr, cui64 numBytes, cui256 bitPattern) {
+   al64 cui256 pattern[2] = { bitPattern, bitPattern };
+   memKernels.fill(addr, numBytes, pattern);
+}
+
+// Set a region of memory to a repeating 512-bit pattern
+inline void mset(ptrc addr, cui64 numBytes, cui512 bitPattern) {
+   al64 cui512 pattern = bitPattern;
+   memKernels.fill(addr, numBytes, &pattern);
+}
+
+// Set a region of memory to a repeating 64-bit pattern
+inline void mset(ptrc addr, cui64 numBytes, cui64 bitPattern64) {
+   al64 cui64 pattern[8] = { bitPattern64, bitPattern64, bitPattern64, bitPattern64, bitPattern64, bitPattern64, bitPattern64, bitPattern64 };
+   memKernels.fill(addr, numBytes, pattern);
+}
+
+// Set a region of memory to a repeating 8-bit pattern
+inline void mset(ptrc addr, cui64 numBytes, cui8 bitPattern8) {
+   cui64 bitPattern   = ui64(bitPattern8);
+   cui64 bitPattern16 = bitPattern   | (bitPattern   << 8u);
+   cui64 bitPattern32 = bitPattern16 | (bitPattern16 << 16u);
+   mset(addr, numBytes, cui64(bitPattern32 | (bitPattern32 << 32u)));
+}
+
+// Set a region of memory to a repeating 16-bit pattern
+inline void mset(ptrc addr, cui64 numBytes, cui16 bitPattern16) {
+   cui64 bitPattern   = ui64(bitPattern16);
+   cui64 bitPattern32 = bitPattern | (bitPattern << 16u);
+   mset(addr, numBytes, cui64(bitPattern32 | (bitPattern32 << 32u)));
+}
+
+// Set a region of memory to a repeating 32-bit pattern
+inline void mset(ptrc addr, cui64 numBytes, cui32 bitPattern32) {
+   cui64 bitPattern = ui64(bitPattern32);
+   mset(addr, numBytes, cui64(bitPattern | (bitPattern << 32u)));
+}
 
 // Allocate RAM at aligned boundary
-inline ptrc malloc(csize_t numBytes, csize_t alignment) {
+inline ptrc malloc(csize_t numBytes, csize_t alignment, cchptrc file = 0, cui32 line = 0) {
    ptrc pointer = _aligned_malloc(numBytes, alignment);
 #ifdef DATA_TRACKING
-   if(pointer) MemTrack(pointer, numBytes);
+   if(pointer) MemTrack(pointer, numBytes, memTag, file, line);
 #endif
    return pointer;
 }
 
-// Allocates RAM at aligned boundary, then sets the entire array to a repeating 8-bit pattern
-inline ptrc salloc(csize_t numBytes, csize_t alignment, cui8 bitPattern) {
-   ptrc pointer = _aligned_malloc(numBytes, alignment);
-   if(pointer) {
-#ifdef DATA_TRACKING
-      MemTrack(pointer, numBytes);
-#endif
-      cui64 bitPat8  = ui64(bitPattern);
-      cui64 bitPat16 = bitPat8  | (bitPat8 << 8u);
-      cui64 bitPat32 = bitPat16 | (bitPat16 << 16u);
-      cui64 bitPat64 = bitPat32 | (bitPat32 << 32u);
-      cui64 limit    = numBytes >> 3;
-      ui64  os;
-
-      for(os = 0; os < limit; os++) ((ui64ptr)pointer)[os] = bitPat64;
-      for(os <<= 3; os < numBytes; os++) ((ui8ptr)pointer)[os] = ((ui8 (&)[8])bitPat64)[os & 0x07];
+// Allocates RAM at aligned boundary, then sets the entire array to zero; on the job workers from PARALLEL_FILL_THRESHOLD bytes
+inline ptrc zalloc(csize_t numBytes, csize_t alignment, cchptrc file = 0, cui32 line = 0) {
+   ptrc pointer = malloc(numBytes, alignment, file, line);
+   if(pointer) ParallelZero(pointer, numBytes);
+   return pointer;
 }
+
+// Allocates RAM at aligned boundary, then sets the entire array to a repeating 64-byte block; on the job workers from
+// PARALLEL_FILL_THRESHOLD bytes
+inline ptrc _Salloc(csize_t numBytes, csize_t alignment, cptrc pattern, cchptrc file, cui32 line) {
+   ptrc pointer = malloc(numBytes, alignment, file, line);
+   if(pointer) ParallelFill(pointer, numBytes, pattern);
    return pointer;
 }
 
+// Allocates RAM at aligned boundary, then sets the entire array to a repeating 64-bit pattern
+inline ptrc salloc(csize_t numBytes, csize_t alignment, cui64 bitPattern, cchptrc file = 0, cui32 line = 0) {
+   al64 cui64 pattern[8] = { bitPattern, bitPattern, bitPattern, bitPattern, bitPattern, bitPattern, bitPattern, bitPattern };
+   return _Salloc(numBytes, alignment, pattern, file, line);
+}
+
+// Allocates RAM at aligned boundary, then sets the entire array to a repeating 8-bit pattern
+inline ptrc salloc(csize_t numBytes, csize_t alignment, cui8 bitPattern, cchptrc file = 0, cui32 line = 0) {
+   return salloc(numBytes, alignment, cui64(0x0101010101010101u * bitPattern), file, line);
+}
+
 // Allocates RAM at aligned boundary, then sets the entire array to a repeating 16-bit pattern
-inline ptrc salloc(csize_t numBytes, csize_t alignment, cui16 bitPattern) {
-   ptrc pointer = _aligned_malloc(numBytes, alignment);
-   if(pointer) {
+inline ptrc salloc(csize_t numBytes, csize_t alignment, cui16 bitPattern, cchptrc file = 0, cui32 line = 0) {
+   return salloc(numBytes, alignment, cui64(0x0001000100010001u * bitPattern), file, line);
+}
+
+// Allocates RAM at aligned boundary, then sets the entire array to a repeating 32-bit pattern
+inline ptrc salloc(csize_t numBytes, csize_t alignment, cui32 bitPattern, cchptrc file = 0, cui32 line = 0) {
+   return salloc(numBytes, alignment, cui64(0x0000000100000001u * bitPattern), file, line);
+}
+
+// Allocates RAM at aligned boundary, then sets the entire array to a repeating 128-bit pattern
+inline ptrc salloc(csize_t numBytes, csize_t alignment, cui128 bitPattern, cchptrc file = 0, cui32 line = 0) {
+   al64 cui128 pattern[4] = { bitPattern, bitPattern, bitPattern, bitPattern };
+   return _Salloc(numBytes, alignment, pattern, file, line);
+}
+
+// Allocates RAM at aligned boundary, then sets the entire array to a repeating 256-bit pattern
+inline ptrc salloc(csize_t numBytes, csize_t alignment, cui256 bitPattern, cchptrc file = 0, cui32 line = 0) {
+   al64 cui256 pattern[2] = { bitPattern, bitPattern };
+   return _Salloc(numBytes, alignment, pattern, file, line);
+}
+
+// Allocates RAM at aligned boundary, then sets the entire array to a repeating 512-bit pattern
+inline ptrc salloc(csize_t numBytes, csize_t alignment, cui512 bitPattern, cchptrc file = 0, cui32 line = 0) {
+   al64 cui512 pattern = bitPattern;
+   return _Salloc(numBytes, alignment, &pattern, file, line);
+}
+
+//== Large-page allocation
+//   Opt-in backing of big, long-lived arrays (map cells) with large pages, to cut TLB misses on random access. Nothing
+//   changes until EnableLargePages succeeds; any request the OS cannot satisfy silently falls back to malloc. Blocks are
+//   released by mdealloc/mfree, which recognise them through the vmBlock registry.
+
+constexpr cui64 LARGE_PAGE_THRESHOLD = 16ull << 20; // Smaller requests always use malloc
+constexpr cui32 MAX_VM_BLOCKS        = 256u;        // Live large-page (lalloc) and NUMA-placed (nreserve) blocks
+constexpr cui64 VM_BLOCK_ALIGNMENT   = 65536u;      // VirtualAlloc allocation granularity; every registered base is a multiple
+
+#define lalloc16(byteCount) lalloc(byteCount, 16u, MEM_SITE)
+#define lalloc32(byteCount) lalloc(byteCount, 32u, MEM_SITE)
+#define lalloc64(byteCount) lalloc(byteCount, 64u, MEM_SITE)
+
+// VirtualAlloc'd block that mdealloc/mfree must release with VirtualFree
+struct VM_BLOCK {
+   vui64 base;       // Address returned by VirtualAlloc; 0 == free entry
+   vui64 numBytes;   // Reserved bytes
+   vui64 largePages; // Non-zero for lalloc blocks, whose numBytes are also counted in sysData.mem.largePageBytes
+};
+
+inline ui64     largePageSize = 0; // Large-page granularity in bytes; 0 == large pages disabled
+inline VM_BLOCK vmBlock[MAX_VM_BLOCKS] = {};
+
+// Records a VirtualAlloc'd block for release by mdealloc/mfree; returns false, recording nothing, when the registry is full
+inline cbool RegisterVmBlock(ptrc base, cui64 numBytes, cbool largePages) {
+   for(ui32 i = 0; i < MAX_VM_BLOCKS; ++i)
+      if(!vmBlock[i].base && !_InterlockedCompareExchange64((vsi64ptr)&vmBlock[i].base, (si64)base, 0)) {
+         vmBlock[i].numBytes   = numBytes;
+         vmBlock[i].largePages = largePages;
+         return true;
+      }
+   return false;
+}
+
+/// Enables large-page allocation for lalloc by acquiring SeLockMemoryPrivilege for the process token.
+/// @return Large-page size in bytes, or 0 if the privilege is not held (lalloc then always falls back to malloc).
+/// @note Call once at start-up, before the first lalloc. The user account needs the "Lock pages in memory" right.
+inline cui64 EnableLargePages(void) {
+   HANDLE           token;
+   TOKEN_PRIVILEGES tp = {};
+
+   if(!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) return 0;
+   tp.PrivilegeCount           = 1;
+   tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+   // AdjustTokenPrivileges succeeds without granting when the account lacks the right; GetLastError tells them apart
+   cbool granted = LookupPrivilegeValue(NULL, SE_LOCK_MEMORY_NAME, &tp.Privileges[0].Luid) &&
+                   AdjustTokenPrivileges(token, FALSE, &tp, 0, NULL, NULL) && GetLastError() == ERROR_SUCCESS;
+   CloseHandle(token);
+
+   return largePageSize = granted ? GetLargePageMinimum() : 0;
+}
+
+/// Allocates RAM on large pages when enabled and numBytes >= LARGE_PAGE_THRESHOLD, otherwise at an aligned boundary via
+/// malloc. The large-page path rounds up to whole pages and is aligned to the page size.
+/// @param alignment  Alignment of the malloc fallback.
+/// @return Pointer to release with mdealloc/mfree, or 0 on failure.
+/// @note Large pages are committed and locked up-front; VirtualAlloc fails (and lalloc falls back) when physical memory
+///       is too fragmented to supply them.
+inline ptrc lalloc(csize_t numBytes, csize_t alignment, cchptrc file = 0, cui32 line = 0) {
+   cui64 pageSize = largePageSize;
+
+   if(pageSize && numBytes >= LARGE_PAGE_THRESHOLD) {
+      cui64 roundedBytes = (numBytes + pageSize - 1u) & ~(pageSize - 1u);
+      ptrc  pointer      = VirtualAlloc(NULL, roundedBytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+
+      if(pointer) {
+         if(RegisterVmBlock(pointer, roundedBytes, true)) {
 #ifdef DATA_TRACKING
-      MemTrack(pointer, numBytes);
+            MemTrack(pointer, roundedBytes, memTag, file, line);
+            _InterlockedExchangeAdd64((vsi64ptr)&sysData.mem.largePageBytes, (si64)roundedBytes);
+#endif
+            return pointer;
+         }
+         VirtualFree(pointer, 0, MEM_RELEASE); // Registry full
+      }
+#ifdef DATA_TRACKING
+      _InterlockedIncrement64((vsi64ptr)&sysData.mem.largePageFallbacks);
 #endif
-      cui64 bitPat16 = ui64(bitPattern);
-      cui64 bitPat32 = bitPat16 | (bitPat16 << 16u);
-      cui64 bitPat64 = bitPat32 | (bitPat32 << 32u);
-      cui64 limit    = numBytes >> 3;
-      ui64  os;
-
-      for(os = 0; os < limit; os++) ((ui64ptr)pointer)[os] = bitPat64;
-      for(os <<= 3; os < numBytes; os++) ((ui8ptr)pointer)[os] = ((ui8 (&)[8])bitPat64)[os & 0x07];
    }
-   return pointer;
+
+   return malloc(numBytes, alignment, file, line);
 }
 
-// Allocates RAM at aligned boundary, then sets the entire array to a repeating 32-bit pattern
-inline ptrc salloc(csize_t numBytes, csize_t alignment, cui32 bitPattern) {
-   ptrc pointer = _aligned_malloc(numBytes, alignment);
-   if(pointer) {
+// Releases pointer if lalloc or nreserve placed it; returns false, leaving pointer untouched, otherwise
+inline cbool VmBlockFree(ptrc pointer) {
+   if((ui64)pointer & (VM_BLOCK_ALIGNMENT - 1u)) return false; // Rejects nearly every malloc'd pointer without a search
+
+   for(ui32 i = 0; i < MAX_VM_BLOCKS; ++i) {
+      if(vmBlock[i].base != (ui64)pointer) continue;
 #ifdef DATA_TRACKING
-      MemTrack(pointer, numBytes);
+      MemUntrack(pointer);
+      if(vmBlock[i].largePages) _InterlockedExchangeAdd64((vsi64ptr)&sysData.mem.largePageBytes, -(si64)vmBlock[i].numBytes);
 #endif
-      cui64 bitPat32 = ui64(bitPattern);
-      cui64 bitPat64 = bitPat32 | (bitPat32 << 32u);
-      cui64 limit    = numBytes >> 3;
-      ui64  os;
-
-      for(os = 0; os < limit; os++) ((ui64ptr)pointer)[os] = bitPat64;
-      for(os <<= 3; os < numBytes; os++) ((ui8ptr)pointer)[os] = ((ui8 (&)[8])bitPat64)[os & 0x07];
+      VirtualFree(pointer, 0, MEM_RELEASE);
+      _InterlockedExchange64((vsi64ptr)&vmBlock[i].base, 0);
+      return true;
    }
-   return pointer;
+
+   return false;
 }
 
-// Allocates RAM at aligned boundary, then sets the entire array to a repeating 64-bit pattern
-inline ptrc salloc(csize_t numBytes, csize_t alignment, cui64 bitPattern) {
-   ptrc pointer = _aligned_malloc(numBytes, alignment);
-   if(pointer) {
+//== Reserve-and-commit arrays
+//   Growable arrays whose address never changes: address space for the largest size is reserved once, and pages are
+//   committed as the array grows. Raw pointers into the array therefore survive growth, and growth never copies.
+//   Newly committed pages read as zero. Reserving costs address space only; committed bytes are reported in SYSTEM_DATA.
+
+constexpr cui64 VM_PAGE_BYTES = 4096u; // Commit granularity
+
+/// Reserves address space for an array of up to maxBytes; no memory is committed.
+/// @return Base address, or 0 on failure. Release with vrelease.
+inline ptrc vreserve(csize_t maxBytes) {
+   ptrc base = VirtualAlloc(NULL, maxBytes, MEM_RESERVE, PAGE_NOACCESS);
 #ifdef DATA_TRACKING
-      MemTrack(pointer, numBytes);
+   if(base) _InterlockedExchangeAdd64((vsi64ptr)&sysData.mem.vmReserved, (si64)RoundUpToNearest(maxBytes, VM_PAGE_BYTES));
 #endif
-      cui64 limit = numBytes >> 3;
-      ui64  os;
-
-      for(os = 0; os < limit; os++) ((ui64ptr)pointer)[os] = bitPattern;
-      for(os <<= 3; os < numBytes; os++) ((ui8ptr)pointer)[os] = ((ui8 (&)[8])bitPattern)[os & 0x07];
-   }
-   return pointer;
+   return base;
 }
 
-// Allocates RAM at aligned (to multiple of 16 byte) boundary, then sets the entire array to a repeating 128-bit pattern
-inline ptrc salloc(csize_t numBytes, csize_t alignment, cui128 bitPattern) {
-   ptrc pointer = _aligned_malloc(numBytes, alignment);
-   if(pointer) {
+/// Grows the committed part of a vreserve'd array from oldBytes to newBytes (both counted from base).
+/// @return true if [base, base + newBytes) is committed; false if the OS refused, leaving oldBytes committed.
+/// @note newBytes must not exceed the reservation. Pages already committed are left untouched, so existing contents stay.
+inline cbool vcommit(ptrc base, csize_t oldBytes, csize_t newBytes) {
+   cui64 from = RoundUpToNearest(oldBytes, VM_PAGE_BYTES), to = RoundUpToNearest(newBytes, VM_PAGE_BYTES);
+
+   if(to <= from) return true;
+   if(!VirtualAlloc(&((ui8ptr)base)[from], to - from, MEM_COMMIT, PAGE_READWRITE)) return false;
 #ifdef DATA_TRACKING
-      MemTrack(pointer, numBytes);
+   _InterlockedExchangeAdd64((vsi64ptr)&sysData.mem.vmCommitted, (si64)(to - from));
 #endif
-      cui64 limit = numBytes >> 4;
-      ui64  os;
+   return true;
+}
 
-      for(os = 0; os < limit; os++) ((ui128ptr)pointer)[os] = bitPattern;
-      for(os <<= 4; os < numBytes; os++) ((ui8ptr)pointer)[os] = ((ui8 (&)[16])bitPattern)[os & 0x0F];
-   }
-   return pointer;
+/// Commits the pages spanning [offset, offset + numBytes) of a vreserve'd array, for arrays committed piecemeal rather
+/// than grown from base. The range should be page-aligned and not yet committed, or the read-outs overcount.
+/// @return true on success; the pages read as zero.
+inline cbool vcommitRange(ptrc base, csize_t offset, csize_t numBytes) {
+   cui64 from = offset & ~(VM_PAGE_BYTES - 1u), to = RoundUpToNearest(offset + numBytes, VM_PAGE_BYTES);
+
+   if(to <= from) return true;
+   if(!VirtualAlloc(&((ui8ptr)base)[from], to - from, MEM_COMMIT, PAGE_READWRITE)) return false;
+#ifdef DATA_TRACKING
+   _InterlockedExchangeAdd64((vsi64ptr)&sysData.mem.vmCommitted, (si64)(to - from));
+#endif
+   return true;
 }
 
-// Allocates RAM at aligned (to multiple of 32 byte) boundary, then sets the entire array to a repeating 256-bit pattern
-inline ptrc salloc(csize_t numBytes, csize_t alignment, cui256 bitPattern) {
-   ptrc pointer = _aligned_malloc(numBytes, alignment);
-   if(pointer) {
+/// Decommits the pages spanning [offset, offset + numBytes) of a vreserve'd array; the address range stays reserved.
+/// Their contents are discarded, and any page partly outside the range is decommitted as well.
+inline void vdecommitRange(ptrc base, csize_t offset, csize_t numBytes) {
+   cui64 from = offset & ~(VM_PAGE_BYTES - 1u), to = RoundUpToNearest(offset + numBytes, VM_PAGE_BYTES);
+
+   if(to <= from) return;
+   VirtualFree(&((ui8ptr)base)[from], to - from, MEM_DECOMMIT);
 #ifdef DATA_TRACKING
-      MemTrack(pointer, numBytes);
+   _InterlockedExchangeAdd64((vsi64ptr)&sysData.mem.vmCommitted, -(si64)(to - from));
 #endif
-      cui64 limit = numBytes >> 5;
-      ui64  os;
+}
 
-      for(os = 0; os < limit; os++) ((ui256ptr)pointer)[os] = bitPattern;
-      for(os <<= 5; os < numBytes; os++) ((ui8ptr)pointer)[os] = ((ui8 (&)[32])bitPattern)[os & 0x01F];
-   }
-   return pointer;
+/// Releases a vreserve'd array and its committed pages.
+/// @param committedBytes  Bytes committed by vcommit; used only for the SYSTEM_DATA read-outs.
+/// @param maxBytes        Size passed to vreserve; used only for the SYSTEM_DATA read-outs.
+inline void vrelease(ptrc base, csize_t committedBytes, csize_t maxBytes) {
+   if(!base) return;
+   VirtualFree(base, 0, MEM_RELEASE);
+#ifdef DATA_TRACKING
+   _InterlockedExchangeAdd64((vsi64ptr)&sysData.mem.vmCommitted, -(si64)RoundUpToNearest(committedBytes, VM_PAGE_BYTES));
+   _InterlockedExchangeAdd64((vsi64ptr)&sysData.mem.vmReserved, -(si64)RoundUpToNearest(maxBytes, VM_PAGE_BYTES));
+#endif
 }
 
-// Allocates RAM at aligned (to multiple of 64 byte) boundary, then sets the entire array to a repeating 512-bit pattern
-inline ptrc salloc(csize_t numBytes, csize_t alignment, cui512 bitPattern) {
-   ptrc pointer = _aligned_malloc(numBytes, alignment);
-   if(pointer) {
+//== NUMA-node placement
+//   On multi-socket hosts a big array is split into ranges whose physical pages come from the node whose cores process
+//   them. nreserve reserves the array as one block, which mdealloc/mfree release like any other allocation; CommitOnNode
+//   then commits each range with its node preferred. A page straddling two ranges goes to whichever is committed first.
+//   Node numbers are those of SYSTEM_DATA::cpu (ProbeNumaNodes); JOB_SYSTEM::Start pins its workers to them (SetThreadNumaNode).
+
+constexpr cui64 NODE_ARENA_COMMIT = 2ull << 20; // Bytes a node arena commits at a time
+
+/// Reserves numBytes of address space, with nothing committed; commit each range with CommitOnNode before use.
+/// @return Base address (VM_BLOCK_ALIGNMENT-aligned), or 0 on failure. Release with mdealloc/mfree.
+inline ptrc nreserve(csize_t numBytes, cchptrc file = 0, cui32 line = 0) {
+   ptrc base = VirtualAlloc(NULL, numBytes, MEM_RESERVE, PAGE_NOACCESS);
+
+   if(!base) return 0;
+   if(!RegisterVmBlock(base, numBytes, false)) { VirtualFree(base, 0, MEM_RELEASE);   return 0; }
 #ifdef DATA_TRACKING
-      MemTrack(pointer, numBytes);
+   MemTrack(base, numBytes, memTag, file, line);
 #endif
-      cui64 limit = numBytes >> 6;
-      ui64  os;
+   return base;
+}
 
-      for(os = 0; os < limit; os++) ((ui512ptr)pointer)[os] = bitPattern;
-      for(os <<= 3; os < (numBytes >> 3); os++) ((ui64ptr)pointer)[os] = ((ui64 (&)[8])bitPattern)[os & 0x07];
-      for(os <<= 3; os < numBytes; os++) ((ui8ptr)pointer)[os] = ((ui8 (&)[64])bitPattern)[os & 0x03F];
-   }
-   return pointer;
+/// Commits the pages spanning [offset, offset + numBytes) of an nreserve'd or vreserve'd block, preferring node's memory.
+/// @return true on success. Pages committed for the first time read as zero; already committed pages are left untouched.
+/// @note The preference applies when each page is first touched; pages come from another node once node's memory is full.
+inline cbool CommitOnNode(ptrc base, csize_t offset, csize_t numBytes, cui8 node) {
+   cui64 from = offset & ~(VM_PAGE_BYTES - 1u), to = RoundUpToNearest(offset + numBytes, VM_PAGE_BYTES);
+
+   if(to <= from) return true;
+   return VirtualAllocExNuma(GetCurrentProcess(), &((ui8ptr)base)[from], to - from, MEM_COMMIT, PAGE_READWRITE, node) != NULL;
 }
 
+/// Bump allocator whose pages all lie on one NUMA node, for long-lived per-node data; grows in place, NODE_ARENA_COMMIT
+/// bytes at a time, up to the capacity reserved by Create.
+/// @note Not synchronised; allocate from one thread at a time.
+struct NODE_ARENA {
+   ui8ptr base      = 0; // Reserved block; VM_BLOCK_ALIGNMENT-aligned
+   ui64   capacity  = 0; // Reserved bytes
+   ui64   committed = 0; // Bytes committed from base
+   ui64   offset    = 0; // Bump cursor, in bytes from base
+   ui8    node      = 0; // NUMA node supplying the pages
+
+   /// Reserves maxBytes for node, releasing any existing block first.
+   /// @return true on success; on failure the arena is left empty and every Alloc returns 0.
+   inline cbool Create(cui8 nodeIndex, cui64 maxBytes) {
+      Destroy();
+      base = (ui8ptr)nreserve(maxBytes, MEM_SITE);
+      if(!base) return false;
+      capacity = maxBytes;
+      node     = nodeIndex;
+      return true;
+   }
+
+   /// Releases the block; all pointers previously returned by Alloc become invalid.
+   inline void Destroy(void) {
+      if(!base) return;
+      VmBlockFree(base);
+      base     = 0;
+      capacity = committed = offset = 0;
+   }
+
+   /// Bumps the cursor to the next alignment boundary and returns numBytes from it, committing pages as needed.
+   /// @param alignment  Power of two no greater than VM_BLOCK_ALIGNMENT.
+   /// @return Aligned pointer, or 0 if the request exceeds the capacity or the OS refuses the commit. Memory never
+   ///         handed out before reads as zero; memory reused after Reset keeps its previous contents.
+   inline ptrc Alloc(cui64 numBytes, cui64 alignment) {
+      cui64 start = (offset + (alignment - 1u)) & ~(alignment - 1u), end = start + numBytes;
+
+      if(!base || end > capacity) return 0;
+      if(end > committed) {
+         cui64 target = RoundUpToNearest(end, NODE_ARENA_COMMIT) < capacity ? RoundUpToNearest(end, NODE_ARENA_COMMIT) : capacity;
+         if(!CommitOnNode(base, committed, target - committed, node)) return 0;
+         committed = target;
+      }
+      offset = end;
+
+      return base + start;
+   }
+
+   /// Releases every allocation in O(1); committed pages are kept for reuse.
+   inline void Reset(void) { offset = 0; }
+};
+
+// One arena per NUMA node, indexed by node number; empty until Create. JOB_SYSTEM::Start creates those of the nodes it pins
+// workers to, and keeps their deques there
+inline NODE_ARENA nodeArena[MAX_NUMA_NODES];
+
 inline cui64 mdealloc(ptrc pointer);
 
 // Frees a pointer and returns true if successful.
@@ -356,6 +807,7 @@ inline cui64 mfree1(ptrc pointer) { return mdealloc(pointer); }
 // Frees a pointer and returns true if successful.
 inline cui64 mdealloc(ptrc pointer) {
    if(!pointer) return false;
+   if(VmBlockFree(pointer)) return true;
 #ifdef DATA_TRACKING
    // Untrack before freeing so the address cannot be recycled while its record is live. When tracking never
    // initialised (maxAllocations == 0) fall through and free; otherwise an unknown pointer is refused -- the
@@ -373,6 +825,7 @@ inline cui64 mdealloc_(ptr pointer, ...) {
 
    for(; (ui64 &)pointer != -1; pointer = va_arg(val, ptrc), ptrBit <<= 1)
       if(pointer) {
+         if(VmBlockFree(pointer)) { retVal |= ptrBit;   continue; }
 #ifdef DATA_TRACKING
          if(sysData.mem.maxAllocations && !MemUntrack(pointer)) continue; // Unknown pointer: its bit stays 0
 #endif
@@ -383,226 +836,8 @@ inline cui64 mdealloc_(ptr pointer, ...) {
    return retVal;
 }
 
-// Set a region of memory to zero
-inline void mzero(ptrc addr, cui64 numBytes) {
-   ui64 i;
-#ifdef __AVX512__
-   if(numBytes & 0x03Fu) {
-#endif
-#ifdef __AVX__
-      if(numBytes & 0x01Fu) {
-#endif
-         if(numBytes & 0x0F) {
-            cui64 count = numBytes >> 3;
-            for(i = 0; i < count; ++i) ((ui64ptr)addr)[i] = 0ull;
-            for(i <<= 3; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-            return;
-         }
-         cui64 count = numBytes >> 4;
-         for(i = 0; i < count; ++i) ((ui128ptr)addr)[i] = null128;
-         for(i <<= 2; i < (numBytes >> 2); ++i) ((ui32ptr)addr)[i] = 0u;
-         for(i <<= 2; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-         return;
-#ifdef __AVX__
-      }
-      cui64 count = numBytes >> 5;
-      for(i = 0; i < count; ++i) ((ui256ptr)addr)[i] = null256;
-      for(i <<= 3; i < (numBytes >> 2); ++i) ((ui32ptr)addr)[i] = 0u;
-      for(i <<= 2; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-      return;
-#endif
-#ifdef __AVX512__
-   }
-   cui64 count = numBytes >> 6;
-   for(i = 0; i < count; ++i) ((ui512ptr)addr)[i] = null512;
-   for(i <<= 3; i < (numBytes >> 3); ++i) ((ui64ptr)addr)[i] = 0u;
-   for(i <<= 3; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-#endif
-}
-
-// Set a region of memory to zero
-inline void mzero(vptrc addr, cui64 numBytes) {
-   ui64 i;
-#ifdef __AVX512__
-   if(numBytes & 0x03Fu) {
-#endif
-#ifdef __AVX__
-      if(numBytes & 0x01F) {
-#endif
-         if(numBytes & 0x0F) {
-            cui64 count = numBytes >> 3;
-            for(i = 0; i < count; ++i) ((ui64ptr)addr)[i] = 0ull;
-            for(i <<= 3; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-            return;
-         }
-         cui64 count = numBytes >> 4;
-         for(i = 0; i < count; ++i) ((ui128ptr)addr)[i] = null128;
-         for(i <<= 2; i < (numBytes >> 2); ++i) ((ui32ptr)addr)[i] = 0u;
-         for(i <<= 2; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-         return;
-#ifdef __AVX__
-      }
-      cui64 count = numBytes >> 5;
-      for(i = 0; i < count; ++i) ((ui256ptr)addr)[i] = null256;
-      for(i <<= 3; i < (numBytes >> 2); ++i) ((ui32ptr)addr)[i] = 0u;
-      for(i <<= 2; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-      return;
-#endif
-#ifdef __AVX512__
-   }
-   cui64 count = numBytes >> 6;
-   for(i = 0; i < count; ++i) ((ui512ptr)addr)[i] = null512;
-   for(i <<= 3; i < (numBytes >> 3); ++i) ((ui64ptr)addr)[i] = 0u;
-   for(i <<= 3; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-#endif
-}
-
-// Set a region of memory to zero
-inline void mzero(ui128ptrc addr, cui64 numBytes) {
-   ui64 i;
-   cui64 count = numBytes >> 4;
-   for(i = 0; i < count; ++i) ((ui128ptr)addr)[i] = null128;
-   for(i <<= 2; i < (numBytes >> 2); ++i) ((ui32ptr)addr)[i] = 0u;
-   for(i <<= 2; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-   return;
-}
-
-// Set a region of memory to zero
-inline void mzero(ui256ptrc addr, cui64 numBytes) {
-   ui64 i;
-#ifdef __AVX__
-   cui64 count = numBytes >> 5;
-   for(i = 0; i < count; ++i) ((ui256ptr)addr)[i] = null256;
-   for(i <<= 3; i < (numBytes >> 2); ++i) ((ui32ptr)addr)[i] = 0u;
-   for(i <<= 2; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-#else
-   cui64 count = numBytes >> 4;
-   for(i = 0; i < count; ++i) ((ui128ptr)addr)[i] = null128;
-   for(i <<= 2; i < (numBytes >> 2); ++i) ((ui32ptr)addr)[i] = 0u;
-   for(i <<= 2; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-#endif
-   return;
-}
-
-// Set a region of memory to zero
-inline void mzero(ui512ptrc addr, cui64 numBytes) {
-   ui64 i;
-#ifdef __AVX512__
-   cui64 count = numBytes >> 6;
-   for(i = 0; i < count; ++i) ((ui512ptr)addr)[i] = null512;
-   for(i <<= 3; i < (numBytes >> 3); ++i) ((ui64ptr)addr)[i] = 0u;
-   for(i <<= 3; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-#else
-#ifdef __AVX__
-   cui64 count = numBytes >> 5;
-   for(i = 0; i < count; ++i) ((ui256ptr)addr)[i] = null256;
-   for(i <<= 3; i < (numBytes >> 2); ++i) ((ui32ptr)addr)[i] = 0u;
-   for(i <<= 2; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-#else
-   cui64 count = numBytes >> 4;
-   for(i = 0; i < count; ++i) ((ui128ptr)addr)[i] = null128;
-   for(i <<= 2; i < (numBytes >> 2); ++i) ((ui32ptr)addr)[i] = 0u;
-   for(i <<= 2; i < numBytes; ++i) ((ui8ptr)addr)[i] = 0u;
-#endif
-#endif
-   return;
-}
-
-// Set a region of memory to a repeating pattern
-#define setmem(addr, numBytes, bitPattern) mset(addr, numBytes, bitPattern)
-
-// Set a region of 16-byte-aligned memory to a repeating 128-bit pattern
-inline void mset(ptrc addr, cui64 numBytes, cui128 bitPattern) {
-   cui64 limit = numBytes >> 4;
-   ui64  os;
-
-   for(os = 0; os < limit; os++) ((ui128ptr)addr)[os] = bitPattern;
-   for(os <<= 4; os < numBytes; os++) ((ui8ptr)addr)[os] = bitPattern.m128i_u8[os & 0x0F];
-}
-
-// Set a region of 32-byte-aligned memory to a repeating 256-bit pattern
-inline void mset(ptrc addr, cui64 numBytes, cui256 bitPattern) {
-   cui64 limit = numBytes >> 5;
-   ui64  os;
-
-   for(os = 0; os < limit; os++) ((ui256ptr)addr)[os] = bitPattern;
-   for(os <<= 5; os < numBytes; os++) ((ui8ptr)addr)[os] = bitPattern.m256i_u8[os & 0x01F];
-}
-
-// Set a region of 64-byte-aligned memory to a repeating 512-bit pattern
-inline void mset(ptrc addr, cui64 numBytes, cui512 bitPattern) {
-   cui64 limit = numBytes >> 6;
-   ui64  os;
-
-   for(os = 0; os < limit; os++) ((ui512ptr)addr)[os] = bitPattern;
-   for(os <<= 3; os < (numBytes >> 3); os++) ((ui64ptr)addr)[os] = bitPattern.m512i_u64[os & 0x07];
-   for(os <<= 3; os < numBytes; os++) ((ui8ptr)addr)[os] = bitPattern.m512i_u8[os & 0x03F];
-}
-
-#ifdef __AVX512__
-#define _mm_PB64_mm_ cui512 { .m512i_u64 = { bitPattern64, bitPattern64, bitPattern64, bitPattern64, \
-                                             bitPattern64, bitPattern64, bitPattern64, bitPattern64 } }
-#else
-#ifdef __AVX__
-#define _mm_PB64_mm_ cui256 { .m256i_u64 = { bitPattern64, bitPattern64, bitPattern64, bitPattern64 } }
-#else
-#define _mm_PB64_mm_ cui128 { .m128i_u64 = { bitPattern64, bitPattern64 } }
-#endif
-#endif
-
-// Set a region of 64-byte-aligned memory to a repeating 8-bit pattern
-inline void mset(ptrc addr, cui64 numBytes, cui8 bitPattern8) {
-   cui64 bitPattern   = ui64(bitPattern8);
-   cui64 bitPattern16 = bitPattern   | (bitPattern   << 8u);
-   cui64 bitPattern32 = bitPattern16 | (bitPattern16 << 16u);
-   cui64 bitPattern64 = bitPattern32 | (bitPattern32 << 32u);
-   mset(addr, numBytes, _mm_PB64_mm_);
-}
-
-// Set a region of 64-byte-aligned memory to a repeating 16-bit pattern
-inline void mset(ptrc addr, cui64 numBytes, cui16 bitPattern16) {
-   cui64 bitPattern   = ui64(bitPattern16);
-   cui64 bitPattern32 = bitPattern   | (bitPattern   << 16u);
-   cui64 bitPattern64 = bitPattern32 | (bitPattern32 << 32u);
-   mset(addr, numBytes, _mm_PB64_mm_);
-}
-
-// Set a region of 64-byte-aligned memory to a repeating 32-bit pattern
-inline void mset(ptrc addr, cui64 numBytes, cui32 bitPattern32) {
-   cui64 bitPattern   = ui64(bitPattern32);
-   cui64 bitPattern64 = bitPattern | (bitPattern << 32u);
-   mset(addr, numBytes, _mm_PB64_mm_);
-}
-
-// Set a region of 64-byte-aligned memory to a repeating 64-bit pattern
-inline void mset(ptrc addr, cui64 numBytes, cui64 bitPattern64) {
-   mset(addr, numBytes, _mm_PB64_mm_);
-}
-
-#undef _mm_PB64_mm_
-
 // Copy byteCount bytes of unaligned data
-inline void Copy(cptrc source, ptrc dest, cui64 byteCount) {
-   cui64 k = byteCount >> 2;
-   ui64  i = 0;
-#ifdef __AVX512__
-   cui64 j = byteCount >> 6;
-   for(; i < j; i++) _mm512_storeu_epi64(&((ui512ptr)dest)[i], _mm512_loadu_epi64(&((ui512ptr)source)[i]));
-   i <<= 4;
-#else
-#ifdef __AVX__
-   cui64 j = byteCount >> 5;
-   for(; i < j; i++) _mm256_storeu_si256(&((ui256ptr)dest)[i], _mm256_lddqu_si256(&((ui256ptr)source)[i]));
-   i <<= 3;
-#else
-   cui64 j = byteCount >> 4;
-   for(; i < j; i++) _mm_storeu_si128(&((ui128ptr)dest)[i], _mm_lddqu_si128(&((ui128ptr)source)[i]));
-   i <<= 2;
-#endif
-#endif
-   for(; i < k; i++) ((ui32ptr)dest)[i] = ((ui32ptr)source)[i];
-   for(i = k << 2; i < byteCount; i++) ((ui8ptr)dest)[i] = ((ui8ptr)source)[i];
-}
+inline void Copy(cptrc source, ptrc dest, cui64 byteCount) { memKernels.copy(source, dest, byteCount); }
 
 // Copy byteCount (rounded-down to the nearest 8) bytes of data
 inline void Copy8(cptrc source, ptrc dest, cui64 byteCount) {
@@ -629,97 +864,28 @@ inline void Copy16(vptrc source, vptrc dest, cui64 byteCount) {
 }
 
 // Copy byteCount (rounded-down to the nearest 32) bytes of 256-bit-aligned data via SIMD instruction
-inline void Copy32(cptrc source, ptrc dest, cui64 byteCount) {
-#ifdef __AVX__
-   cui64 j = byteCount >> 5;
-   for(ui64 i = 0; i < j; i++) ((ui256ptr)dest)[i] = _mm256_load_si256(&((ui256ptr)source)[i]);
-#else
-   cui64 j = byteCount >> 4;
-   for(ui64 i = 0; i < j; i++) ((ui128ptr)dest)[i] = _mm_load_si128(&((ui128ptr)source)[i]);
-#endif
-}
+inline void Copy32(cptrc source, ptrc dest, cui64 byteCount) { memKernels.copy32(source, dest, byteCount); }
 
 // Copy byteCount (rounded-down to the nearest 32) bytes of 256-bit-aligned data via SIMD instruction
-inline void Copy32(vptrc source, vptrc dest, cui64 byteCount) {
-#ifdef __AVX__
-   cui64 j = byteCount >> 5;
-   for(ui64 i = 0; i < j; i++) ((ui256ptr)dest)[i] = _mm256_load_si256(&((ui256ptr)source)[i]);
-#else
-   cui64 j = byteCount >> 4;
-   for(ui64 i = 0; i < j; i++) ((ui128ptr)dest)[i] = _mm_load_si128(&((ui128ptr)source)[i]);
-#endif
-}
+inline void Copy32(vptrc source, vptrc dest, cui64 byteCount) { memKernels.copy32((cptrc)source, (ptrc)dest, byteCount); }
 
-// Copy byteCount (rounded-down to the nearest 64) bytes of 512-bit-aligned data via SIMD instruction
-inline void Copy64(cptrc source, ptrc dest, cui64 byteCount) {
-#ifdef __AVX512__
-   cui64 j = byteCount >> 6;
-   for(ui64 i = 0; i < j; i++) ((ui512ptr)dest)[i] = _mm512_load_epi32(&((ui512ptr)source)[i]);
-#else
-#ifdef __AVX__
-   cui64 j = byteCount >> 5;
-   for(ui64 i = 0; i < j; i++) ((ui256ptr)dest)[i] = _mm256_load_si256(&((ui256ptr)source)[i]);
-#else
-   cui64 j = byteCount >> 4;
-   for(ui64 i = 0; i < j; i++) ((ui128ptr)dest)[i] = _mm_load_si128(&((ui128ptr)source)[i]);
-#endif
-#endif
-}
+// Copy byteCount (rounded-down to the nearest lane width: 64 with AVX-512F, else 32) bytes of 512-bit-aligned data via SIMD instruction
+inline void Copy64(cptrc source, ptrc dest, cui64 byteCount) { memKernels.copy64(source, dest, byteCount); }
 
-// Copy byteCount (rounded-up to the nearest 64) bytes of 512-bit-aligned data via SIMD instruction
-inline void Copy64(vptrc source, vptrc dest, cui64 byteCount) {
-#ifdef __AVX512__
-   cui64 j = ui64((byteCount + 63) >> 6);
-   for(ui64 i = 0; i < j; i++) ((ui512ptr)dest)[i] = _mm512_load_epi32(&((ui512ptr)source)[i]);
-#else
-#ifdef __AVX__
-   cui64 j = ui64((byteCount + 31) >> 5);
-   for(ui64 i = 0; i < j; i++) ((ui256ptr)dest)[i] = _mm256_load_si256(&((ui256ptr)source)[i]);
-#else
-   cui64 j = ui64((byteCount + 15) >> 4);
-   for(ui64 i = 0; i < j; i++) ((ui128ptr)dest)[i] = _mm_load_si128(&((ui128ptr)source)[i]);
-#endif
-#endif
-}
+// Copy byteCount (rounded-up to the nearest lane width: 64 with AVX-512F, else 32) bytes of 512-bit-aligned data via SIMD instruction
+inline void Copy64(vptrc source, vptrc dest, cui64 byteCount) { memKernels.copy64((cptrc)source, (ptrc)dest, byteCount + memKernels.width - 1u); }
 
 // Non-temporally copy byteCount (rounded-down to the nearest 16) bytes of 128-bit-aligned data via SIMD instruction.
-// NT stores are weakly ordered; the trailing _mm_sfence makes the writes globally visible before return.
-inline void Stream16(cptrc source, ptrc dest, cui64 byteCount) {
-   cui64 j = byteCount >> 4;
-   for(ui64 i = 0; i < j; i++) _mm_stream_si128(&((ui128ptr)dest)[i], _mm_load_si128(&((ui128ptr)source)[i]));
-   _mm_sfence();
-}
+// NT stores are weakly ordered; the kernel's trailing _mm_sfence makes the writes globally visible before return.
+inline void Stream16(cptrc source, ptrc dest, cui64 byteCount) { memKernels.stream16(source, dest, byteCount); }
 
 // Non-temporally copy byteCount (rounded-down to the nearest 32) bytes of 256-bit-aligned data via SIMD instruction.
-// NT stores are weakly ordered; the trailing _mm_sfence makes the writes globally visible before return.
-inline void Stream32(cptrc source, ptrc dest, cui64 byteCount) {
-#ifdef __AVX__
-   cui64 j = byteCount >> 5;
-   for(ui64 i = 0; i < j; i++) _mm256_stream_si256(&((ui256ptr)dest)[i], _mm256_load_si256(&((ui256ptr)source)[i]));
-#else
-   cui64 j = byteCount >> 4;
-   for(ui64 i = 0; i < j; i++) _mm_stream_si128(&((ui128ptr)dest)[i], _mm_load_si128(&((ui128ptr)source)[i]));
-#endif
-   _mm_sfence();
-}
+// NT stores are weakly ordered; the kernel's trailing _mm_sfence makes the writes globally visible before return.
+inline void Stream32(cptrc source, ptrc dest, cui64 byteCount) { memKernels.stream32(source, dest, byteCount); }
 
-// Non-temporally copy byteCount (rounded-up to the nearest 64) bytes of 512-bit-aligned data via SIMD instruction.
-// NT stores are weakly ordered; the trailing _mm_sfence makes the writes globally visible before return.
-inline void Stream64(cptrc source, ptrc dest, cui64 byteCount) {
-#ifdef __AVX512__
-   cui64 j = ui64((byteCount + 63) >> 6);
-   for(ui64 i = 0; i < j; i++) _mm512_stream_si512(&((ui512ptr)dest)[i], _mm512_load_si512(&((ui512ptr)source)[i]));
-#else
-#ifdef __AVX__
-   cui64 j = ui64((byteCount + 31) >> 5);
-   for(ui64 i = 0; i < j; i++) _mm256_stream_si256(&((ui256ptr)dest)[i], _mm256_load_si256(&((ui256ptr)source)[i]));
-#else
-   cui64 j = ui64((byteCount + 15) >> 4);
-   for(ui64 i = 0; i < j; i++) _mm_stream_si128(&((ui128ptr)dest)[i], _mm_load_si128(&((ui128ptr)source)[i]));
-#endif
-#endif
-   _mm_sfence();
-}
+// Non-temporally copy byteCount (rounded-up to the nearest lane width: 64 with AVX-512F, else 32) bytes of 512-bit-aligned data via SIMD instruction.
+// NT stores are weakly ordered; the kernel's trailing _mm_sfence makes the writes globally visible before return.
+inline void Stream64(cptrc source, ptrc dest, cui64 byteCount) { memKernels.stream64(source, dest, byteCount + memKernels.width - 1u); }
 
 // (Non-temporally) Copy byteCount (rounded-up to the nearest 16/32/64) bytes of 128/256/512-bit-aligned data via SIMD instruction.
 // If either source or dest is unaligned, standard copy is used.
@@ -766,3 +932,114 @@ inline void LockedMoveAndClear(vptrc source, vptrc dest, csi32 byteCount) {
    for(si32 i = 0; i < j; i++)
       ((vsi64ptr)dest)[i] = _InterlockedExchange64(&((vsi64ptr)source)[i], 0);
 }
+
+//== Frame arena
+
+constexpr cui64 FRAME_ARENA_DEFAULT_BYTES = 4194304u; // Capacity reserved on a thread's first falloc* when Create was never called (4MB)
+
+// Allocates byteCount bytes at a 16/32/64-byte boundary from the calling thread's frame arena; returns 0 when the arena is exhausted
+#define falloc16(byteCount) frameArena.Alloc(byteCount, 16u)
+#define falloc32(byteCount) frameArena.Alloc(byteCount, 32u)
+#define falloc64(byteCount) frameArena.Alloc(byteCount, 64u)
+
+// Allocates a 1-dimensional array at a 16/32/64-byte boundary from the calling thread's frame arena
+#define falloc1d16(dataType, dim) (dataType *)frameArena.Alloc(sizeof(dataType) * (dim), 16u)
+#define falloc1d32(dataType, dim) (dataType *)frameArena.Alloc(sizeof(dataType) * (dim), 32u)
+#define falloc1d64(dataType, dim) (dataType *)frameArena.Alloc(sizeof(dataType) * (dim), 64u)
+
+/// Linear (bump) allocator for transient per-frame data. One 64-byte-aligned block is taken from malloc() once; every
+/// Alloc thereafter is an offset bump, Reset releases everything in O(1), and Mark/Rewind (or FRAME_SCOPE) unwind
+/// nested allocations without disturbing outer ones. Nothing is freed individually, and no heap call is made after
+/// the block exists.
+/// @note Thread-confined: each thread owns its arena through the thread_local frameArena, so no operation locks.
+///       Arena memory may be read by another thread only if that thread is finished with it before the owner's next
+///       Reset or Rewind.
+/// @note DATA_TRACKING builds track the backing block once (via malloc) and publish the greatest per-frame usage of
+///       any arena in sysData.mem.arenaHighWater, instead of tracking each Alloc.
+struct FRAME_ARENA {
+   ui8ptr base     = 0; // Backing block; 64-byte aligned
+   ui64   capacity = 0; // Size of the backing block, in bytes
+   ui64   offset   = 0; // Bump cursor, in bytes from base
+   ui64   peak     = 0; // Greatest offset reached since the last Reset
+
+   /// Allocates the backing block, releasing any existing one first.
+   /// @param numBytes  Capacity in bytes; rounded up to the nearest 64.
+   /// @return true on success; on failure the arena is left empty and every Alloc returns 0 until Create succeeds.
+   inline cbool Create(cui64 numBytes) {
+      Destroy();
+      base = (ui8ptr)malloc(RoundUpToNearest64(numBytes), 64u, MEM_SITE);
+      if(!base) return false;
+      capacity = RoundUpToNearest64(numBytes);
+#ifdef DATA_TRACKING
+      _InterlockedExchangeAdd64((vsi64ptr)&sysData.mem.arenaReserved, (si64)capacity);
+#endif
+      return true;
+   }
+
+   /// Releases the backing block; all pointers previously returned by Alloc become invalid.
+   inline void Destroy(void) {
+      if(!base) return;
+      Reset();
+#ifdef DATA_TRACKING
+      _InterlockedExchangeAdd64((vsi64ptr)&sysData.mem.arenaReserved, -(si64)capacity);
+#endif
+      mdealloc(base);
+      base     = 0;
+      capacity = 0;
+   }
+
+   /// Bumps the cursor to the next alignment boundary and returns numBytes from it. A thread's first Alloc creates a
+   /// FRAME_ARENA_DEFAULT_BYTES block if Create was never called.
+   /// @param numBytes   Bytes requested; contents are undefined.
+   /// @param alignment  Power of two no greater than 64 (the alignment of base).
+   /// @return Aligned pointer, or 0 if the request does not fit (counted in sysData.mem.arenaOverflows).
+   inline ptrc Alloc(cui64 numBytes, cui64 alignment) {
+      if(!base && !Create(FRAME_ARENA_DEFAULT_BYTES)) return 0;
+
+      cui64 start = (offset + (alignment - 1u)) & ~(alignment - 1u);
+
+      if(start + numBytes > capacity) {
+#ifdef DATA_TRACKING
+         _InterlockedIncrement64((vsi64ptr)&sysData.mem.arenaOverflows);
+#endif
+         return 0;
+      }
+      offset = start + numBytes;
+      if(offset > peak) peak = offset;
+
+      return base + start;
+   }
+
+   /// Returns the current cursor, for a later Rewind.
+   inline cui64 Mark(void) const { return offset; }
+
+   /// Releases every allocation made since marker was taken. Markers must be rewound in LIFO order; a marker beyond
+   /// the cursor (i.e. taken before an intervening Reset) is ignored.
+   inline void Rewind(cui64 marker) { if(marker <= offset) offset = marker; }
+
+   /// Releases every allocation in O(1). Call once per frame/tic, at a point where no arena pointer is live.
+   inline void Reset(void) {
+#ifdef DATA_TRACKING
+      // Lock-free maximum; the CAS is a full barrier, and a stale read only costs one more iteration
+      for(si64 highWater = (si64)sysData.mem.arenaHighWater; (si64)peak > highWater;) {
+         csi64 seen = _InterlockedCompareExchange64((vsi64ptr)&sysData.mem.arenaHighWater, (si64)peak, highWater);
+         if(seen == highWater) break;
+         highWater = seen;
+      }
+#endif
+      offset = 0;
+      peak   = 0;
+   }
+};
+
+// The calling thread's frame arena; zero-initialised, so it costs nothing until first use
+inline thread_local FRAME_ARENA frameArena;
+
+/// Scoped marker: rewinds the arena to its construction-time cursor when the scope exits.
+struct FRAME_SCOPE {
+   FRAME_ARENA &arena;
+   cui64        marker;
+
+   FRAME_SCOPE(FRAME_ARENA &owner) : arena(owner), marker(owner.Mark()) {}
+   ~FRAME_SCOPE(void) { arena.Rewind(marker); }
+};
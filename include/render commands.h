@@ -0,0 +1,363 @@
+/************************************************************
+ * File: render commands.h              Created: 2026/10/17 *
+ *                                Last modified: 2026/10/17 *
+ *                                                          *
+ * Desc: Deferred, key-sorted render command lists. Any     *
+ *       thread records packets into its own list; the      *
+ *       render thread merges them by key and replays them  *
+ *       through a backend (class_render.h, or the null     *
+ *       backend for headless runs).                        *
+ *                                                          *
+ *  Copyright (c) David William Bull. All rights reserved.  *
+ ************************************************************/
+#pragma once
+
+#include <intrin.h>
+#include <string.h>
+#include "typedefs.h"
+#include "memory management.h"
+
+#pragma intrinsic(_InterlockedExchange, _InterlockedIncrement)
+
+//== Tuning constants
+
+constexpr cui32 MAX_RENDER_THREADS       = 16u;       // Recording threads per queue; one more fails fast (RENDER_QUEUE::Slot)
+constexpr cui32 RENDER_LIST_COMMANDS     = 2048u;     // Commands per list committed by default
+constexpr cui32 RENDER_LIST_PACKETS      = 256u;      // Packets per list committed by default
+constexpr cui32 RENDER_LIST_MAX_COMMANDS = 1u << 20;  // Commands a list may grow to; its address space is reserved up front
+constexpr cui32 RENDER_LIST_MAX_PACKETS  = 1u << 16;  // Packets a list may grow to
+constexpr cui32 RENDER_PACKET_COMMANDS   = 0x0FFFFu;  // Most commands in one packet (RENDER_PACKET::count)
+constexpr cui32 RENDER_INLINE_BYTES      = 16u;       // Largest vertex update copied into the command itself
+
+//== Sort keys
+
+// Replay passes; the top byte of every key
+enum RENDER_PASS : ui8 { rp_clear, rp_opaque, rp_overlay, rp_interface };
+
+// pass:8 | layer:8 | order:48. Packets replay in ascending key order; equal keys replay in recording order,
+// lower thread slot first
+inline constexpr cui64 RenderKey(cui8 pass, cui8 layer, cui64 order) {
+   return (ui64(pass) << 56) | (ui64(layer) << 48) | (order & 0x0FFFFFFFFFFFFull);
+}
+
+//== Commands
+
+enum RENDER_OP : ui8 {
+   rop_blend, rop_depth_stencil, rop_vertex_format, rop_shader_group, rop_gsr, rop_psr, rop_uav,
+   rop_update_vertex, rop_update_vertex_inline, rop_vertex_primitive, rop_draw, rop_draw_instanced
+};
+
+al16 struct RENDER_CMD { // 32 bytes
+   ui8  op;
+   ui8  arg8;
+   ui16 arg16[3];
+   ui32 arg32[2];
+   union {
+      cptr data;                           // rop_update_vertex: caller's data; must stay valid until replayed
+      ui8  inlined[RENDER_INLINE_BYTES];   // rop_update_vertex_inline: copied at record time
+   };
+};
+
+// A keyed run of commands, replayed as a unit on one device context
+al16 struct RENDER_PACKET { // 16 bytes
+   ui64 key;
+   ui32 first;   // Index of the packet's first command
+   ui16 count;
+   ui8  context;
+   ui8  RES;
+};
+
+//== Command list
+
+// One thread's recording for one frame. Packets are kept sorted by key as they close, so the render thread only merges.
+// Both arrays reserve address space for their maximum and commit pages as they grow (vreserve/vcommit), so a full list
+// grows in place without copying; only the recording thread grows it, and Replay() reads the other frame's list
+al64 struct RENDER_LIST {
+   RENDER_CMD    *cmd;      // RENDER_LIST_MAX_COMMANDS reserved; cmdMax committed
+   RENDER_PACKET *packet;   // RENDER_LIST_MAX_PACKETS reserved; packetMax committed
+   ui32           cmdCount;
+   ui32           cmdMax;
+   ui32           packetCount;
+   ui32           packetMax;
+   al64 vui32     open;     // Non-zero while a packet is being recorded; Replay() waits on it
+
+   // Commits room for at least 'need' entries of a list array, doubling its capacity. Running past 'limit', or out of
+   // memory, fails fast: a draw must never vanish from a frame unnoticed
+   template<typename T> static inline void Grow(T *const base, ui32 &capacity, cui32 need, cui32 limit) {
+      ui32 target = capacity << 1;
+
+      if(target < need)  target = need;
+      if(target > limit) target = limit;
+      if(need > limit || !vcommit(base, ui64(capacity) * sizeof(T), ui64(target) * sizeof(T))) __fastfail(FAST_FAIL_FATAL_APP_EXIT);
+      capacity = target;
+   }
+
+   void Create(cui32 commands, cui32 packets) {
+      cmd         = (RENDER_CMD *)vreserve(RENDER_LIST_MAX_COMMANDS * sizeof(RENDER_CMD));
+      packet      = (RENDER_PACKET *)vreserve(RENDER_LIST_MAX_PACKETS * sizeof(RENDER_PACKET));
+      cmdMax      = packetMax = 0;
+      cmdCount    = packetCount = 0;
+      open        = 0;
+      if(!cmd || !packet) __fastfail(FAST_FAIL_FATAL_APP_EXIT);
+      Grow(cmd, cmdMax, commands, RENDER_LIST_MAX_COMMANDS);
+      Grow(packet, packetMax, packets, RENDER_LIST_MAX_PACKETS);
+   }
+
+   void Destroy(void) {
+      vrelease(cmd, cmdMax * sizeof(RENDER_CMD), RENDER_LIST_MAX_COMMANDS * sizeof(RENDER_CMD));
+      vrelease(packet, packetMax * sizeof(RENDER_PACKET), RENDER_LIST_MAX_PACKETS * sizeof(RENDER_PACKET));
+      cmd    = NULL;
+      packet = NULL;
+   }
+
+   inline void Reset(void) { cmdCount = packetCount = 0; }
+
+   inline void BeginPacket(cui64 key, cui8 context) {
+      if(packetCount >= packetMax) Grow(packet, packetMax, packetCount + 1u, RENDER_LIST_MAX_PACKETS);
+      packet[packetCount] = { key, cmdCount, 0, context, 0 };
+   }
+
+   // Closes the packet opened by BeginPacket() and inserts it by key, after any packets with an equal key. A packet of
+   // more than RENDER_PACKET_COMMANDS commands fails fast
+   inline void EndPacket(void) {
+      RENDER_PACKET newPacket = packet[packetCount];
+      ui32          i         = packetCount;
+
+      if(cmdCount - newPacket.first > RENDER_PACKET_COMMANDS) __fastfail(FAST_FAIL_INVALID_ARG);
+      newPacket.count = ui16(cmdCount - newPacket.first);
+
+      for(; i && packet[i - 1u].key > newPacket.key; i--) packet[i] = packet[i - 1u];
+      packet[i] = newPacket;
+      packetCount++;
+   }
+
+   //-- Recording; valid between RENDER_QUEUE::Begin() and End()
+
+   inline RENDER_CMD &Push(cui8 op) {
+      if(cmdCount >= cmdMax) Grow(cmd, cmdMax, cmdCount + 1u, RENDER_LIST_MAX_COMMANDS);
+
+      RENDER_CMD &command = cmd[cmdCount++];
+      command.op = op;
+
+      return command;
+   }
+
+   inline void SetBlendState(cui8 state) { Push(rop_blend).arg8 = state; }
+
+   inline void SetDepthStencilState(csi8 state, cui32 stencilRef) {
+      RENDER_CMD &command = Push(rop_depth_stencil);
+      command.arg8      = ui8(state);
+      command.arg32[0]  = stencilRef;
+   }
+
+   inline void SetVertexFormat(cui8 profile) { Push(rop_vertex_format).arg8 = profile; }
+
+   inline void SetShaderGroup(cui8 shaders) { Push(rop_shader_group).arg8 = shaders; }
+
+   inline void SetResources(cui8 op, cui16 index, cui16 slot, cui16 count) {
+      RENDER_CMD &command = Push(op);
+      command.arg16[0] = index;
+      command.arg16[1] = slot;
+      command.arg16[2] = count;
+   }
+
+   inline void SetGSR(cui16 index, cui16 slot, cui16 count) { SetResources(rop_gsr, index, slot, count); }
+   inline void SetPSR(cui16 index, cui16 slot, cui16 count) { SetResources(rop_psr, index, slot, count); }
+   inline void SetUAV(cui16 index, cui16 slot, cui16 count) { SetResources(rop_uav, index, slot, count); }
+
+   // 'source' is read at replay, not now
+   inline void UpdateVertex(cptrc source, cui16 index, cui32 count) {
+      RENDER_CMD &command = Push(rop_update_vertex);
+      command.arg16[0] = index;
+      command.arg32[0] = count;
+      command.data     = source;
+   }
+
+   // Copies one vertex of up to RENDER_INLINE_BYTES now, so 'source' may change before replay
+   inline void UpdateVertexInline(cptrc source, cui32 bytes, cui16 index) {
+      RENDER_CMD &command = Push(rop_update_vertex_inline);
+      command.arg16[0] = index;
+      command.arg32[0] = 1u;
+      memcpy(command.inlined, source, bytes < RENDER_INLINE_BYTES ? bytes : RENDER_INLINE_BYTES);
+   }
+
+   inline void SetVertexPrimitive(cui16 index, cui8 slot, cui32 topology) {
+      RENDER_CMD &command = Push(rop_vertex_primitive);
+      command.arg8     = slot;
+      command.arg16[0] = index;
+      command.arg32[0] = topology;
+   }
+
+   inline void Draw(cui32 vertexCount) { Push(rop_draw).arg32[0] = vertexCount; }
+
+   inline void InstanceDraw(cui32 verticesPerInstance, cui32 instances) {
+      RENDER_CMD &command = Push(rop_draw_instanced);
+      command.arg32[0] = verticesPerInstance;
+      command.arg32[1] = instances;
+   }
+};
+
+//== Queue
+
+// Recording threads claim a slot on first use and alternate between its two lists by frame parity, so recording never
+// waits on a replay. A BACKEND provides the methods Execute() calls, each taking the packet's context first
+al64 struct RENDER_QUEUE {
+   RENDER_LIST list[MAX_RENDER_THREADS][2];
+   vui32       frame   = 0;   // Parity selects the lists being recorded; the other parity is replayed
+   vui32       threads = 0;   // Slots claimed
+   ui32        commandsPerList;
+   ui32        packetsPerList;
+   ui32        replayed;      // Packets replayed by the last Replay()
+
+   void Create(cui32 commands = RENDER_LIST_COMMANDS, cui32 packets = RENDER_LIST_PACKETS) {
+      commandsPerList = commands;
+      packetsPerList  = packets;
+      for(ui32 i = 0; i < MAX_RENDER_THREADS; i++) { list[i][0].Create(commands, packets);   list[i][1].Create(commands, packets); }
+   }
+
+   void Destroy(void) {
+      for(ui32 i = 0; i < MAX_RENDER_THREADS; i++) { list[i][0].Destroy();   list[i][1].Destroy(); }
+   }
+
+   // The calling thread's slot in this queue; claimed on first use. Slots are never shared, so a thread past
+   // MAX_RENDER_THREADS fails fast rather than race another thread on its lists
+   inline cui32 Slot(void) {
+      thread_local struct { RENDER_QUEUE *queue; ui32 slot; } claim = {};
+
+      if(claim.queue != this) {
+         cui32 slot = ui32(_InterlockedIncrement((vol long *)&threads)) - 1u;
+         if(slot >= MAX_RENDER_THREADS) __fastfail(FAST_FAIL_INVALID_ARG);
+         claim = { this, slot };
+      }
+
+      return claim.slot;
+   }
+
+   /// Opens a packet in the calling thread's current list.
+   /// @return The list to record into, until End().
+   inline RENDER_LIST &Begin(cui64 key, cui8 context) {
+      RENDER_LIST (&pair)[2] = list[Slot()];
+
+      for(;;) {
+         cui32        parity  = frame & 0x01u;
+         RENDER_LIST &current = pair[parity];
+
+         // Full barrier: either Replay() sees 'open', or this thread sees Replay()'s new frame and moves to the other list
+         _InterlockedExchange((vol long *)&current.open, 1);
+         if((frame & 0x01u) == parity) {
+            current.BeginPacket(key, context);
+            return current;
+         }
+         current.open = 0;
+      }
+   }
+
+   inline void End(RENDER_LIST &current) {
+      current.EndPacket();
+      _ReadWriteBarrier();
+      current.open = 0;
+   }
+
+   // Replays one command
+   template<class BACKEND> static inline void Execute(BACKEND &backend, cui8 context, const RENDER_CMD &command) {
+      switch(command.op) {
+      case rop_blend:                backend.SetBlendState(context, command.arg8); break;
+      case rop_depth_stencil:        backend.SetDepthStencilState(context, si8(command.arg8), command.arg32[0]); break;
+      case rop_vertex_format:        backend.SetVertexFormat(context, command.arg8); break;
+      case rop_shader_group:         backend.SetShaderGroup(context, command.arg8); break;
+      case rop_gsr:                  backend.SetGSR(context, command.arg16[0], command.arg16[1], command.arg16[2]); break;
+      case rop_psr:                  backend.SetPSR(context, command.arg16[0], command.arg16[1], command.arg16[2]); break;
+      case rop_uav:                  backend.SetUAV(context, command.arg16[0], command.arg16[1], command.arg16[2]); break;
+      case rop_update_vertex:        backend.UpdateVertex(context, command.data, command.arg16[0], command.arg32[0]); break;
+      case rop_update_vertex_inline: backend.UpdateVertex(context, command.inlined, command.arg16[0], command.arg32[0]); break;
+      case rop_vertex_primitive:     backend.SetVertexPrimitive(context, command.arg16[0], command.arg8, command.arg32[0]); break;
+      case rop_draw:                 backend.Draw(context, command.arg32[0]); break;
+      case rop_draw_instanced:       backend.InstanceDraw(context, command.arg32[0], command.arg32[1]); break;
+      }
+   }
+
+   /// Render thread only. Starts a new frame of recording, then merges every list of the previous frame by key and replays
+   /// it through 'backend'. The lists are emptied afterwards.
+   /// @return The number of packets replayed.
+   template<class BACKEND> cui32 Replay(BACKEND &backend) {
+      cui32 parity = frame & 0x01u;
+      ui32  head[MAX_RENDER_THREADS];
+      ui32  i, slots;
+
+      _InterlockedIncrement((vol long *)&frame);
+
+      slots = threads < MAX_RENDER_THREADS ? threads : MAX_RENDER_THREADS;
+      for(i = 0; i < slots; i++) {
+         while(list[i][parity].open) _mm_pause();   // A packet begun before the flip; finishes shortly
+         head[i] = 0;
+      }
+
+      // k-way merge; each list is already in key order, and ties go to the lower slot
+      for(replayed = 0;; replayed++) {
+         ui32 next = MAX_RENDER_THREADS;
+         ui64 key  = ~0ull;
+
+         for(i = 0; i < slots; i++) {
+            const RENDER_LIST &current = list[i][parity];
+            if(head[i] < current.packetCount && (next == MAX_RENDER_THREADS || current.packet[head[i]].key < key)) {
+               next = i;
+               key  = current.packet[head[i]].key;
+            }
+         }
+         if(next == MAX_RENDER_THREADS) break;
+
+         const RENDER_LIST   &source  = list[next][parity];
+         const RENDER_PACKET &packet  = source.packet[head[next]++];
+         const RENDER_CMD    *command = &source.cmd[packet.first];
+
+         backend.BeginPacket(packet.key, packet.context);
+         for(ui32 j = 0; j < packet.count; j++) Execute(backend, packet.context, command[j]);
+      }
+
+      for(i = 0; i < slots; i++) list[i][parity].Reset();
+
+      return replayed;
+   }
+};
+
+//== Null backend
+
+// Executes nothing; counts what it is given and checks that packets arrive in key order. For headless recording and
+// sorting benchmarks (bench/render commands.cpp)
+struct RENDER_BACKEND_NULL {
+   ui64 packets     = 0;
+   ui64 commands    = 0;
+   ui64 drawCalls   = 0;
+   ui64 vertices    = 0;
+   ui64 outOfOrder  = 0;   // Packets whose key was lower than the previous packet's
+   ui64 checksum    = 0;   // Order-dependent hash of every packet key and command
+   ui64 lastKey     = 0;
+
+   inline void Reset(void) { *this = {}; }
+
+   inline void Mix(cui64 value) { checksum = (checksum ^ value) * 0x0100000001B3ull; commands++; }
+
+   inline void BeginPacket(cui64 key, cui8 context) {
+      outOfOrder += packets && key < lastKey;
+      lastKey     = key;
+      packets++;
+      checksum    = (checksum ^ key) * 0x0100000001B3ull;
+   }
+
+   inline void SetBlendState(cui8, cui8 state)                            { Mix(0x0100u | state); }
+   inline void SetDepthStencilState(cui8, csi8 state, cui32 stencilRef)   { Mix(0x0200u | ui8(state) | ui64(stencilRef) << 16); }
+   inline void SetVertexFormat(cui8, cui8 profile)                        { Mix(0x0300u | profile); }
+   inline void SetShaderGroup(cui8, cui8 shaders)                         { Mix(0x0400u | shaders); }
+   inline void SetGSR(cui8, cui16 index, cui16 slot, cui16 count)         { Mix(0x0500u | ui64(index) << 16 | ui64(slot) << 32 | ui64(count) << 48); }
+   inline void SetPSR(cui8, cui16 index, cui16 slot, cui16 count)         { Mix(0x0600u | ui64(index) << 16 | ui64(slot) << 32 | ui64(count) << 48); }
+   inline void SetUAV(cui8, cui16 index, cui16 slot, cui16 count)         { Mix(0x0700u | ui64(index) << 16 | ui64(slot) << 32 | ui64(count) << 48); }
+   inline void UpdateVertex(cui8, cptrc, cui16 index, cui32 count)        { Mix(0x0800u | ui64(index) << 16 | ui64(count) << 32); }
+   inline void SetVertexPrimitive(cui8, cui16 index, cui8 slot, cui32 topology) { Mix(0x0900u | ui64(index) << 16 | ui64(slot) << 32 | ui64(topology) << 40); }
+   inline void Draw(cui8, cui32 vertexCount)                              { Mix(0x0A00u | ui64(vertexCount) << 16);   drawCalls++;   vertices += vertexCount; }
+
+   inline void InstanceDraw(cui8, cui32 verticesPerInstance, cui32 instances) {
+      Mix(0x0B00u | ui64(verticesPerInstance) << 16 | ui64(instances) << 40);
+      drawCalls++;
+      vertices += ui64(verticesPerInstance) * instances;
+   }
+};
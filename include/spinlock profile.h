@@ -0,0 +1,129 @@
+/*
+ * File: spinlock profile.h
+ * Version: v1.0
+ * Owner: David William Bull
+ * Created: 2026-10-17
+ * Last Modified: 2026-10-17
+ * Description: SPIN_PROFILE wait policy for the spinlocks.h TTAS acquisitions: per-call-site contention counters and deadlock
+ *              diagnostics, kept in sysData.spin. The engine's locks use it when project definitions.h sets SPIN_WAIT_POLICY
+ *              to SPIN_PROFILE; a single call site can opt in with SpinLockMinProfiled, SpinLockProfiled or SpinLockMaxProfiled.
+ * To Do: 1) Profiled forms of TicketLock and McsLock (spinlocks.h To Do 2).
+ * Dependencies: spinlocks.h, data tracking.h
+ * ISA: AVX2
+ * Thread-safety: MT-safe
+ * Reviewers: Unassigned
+ * License: MIT  Copyright: David William Bull
+ */
+#pragma once
+
+#include "spinlocks.h"
+#include "data tracking.h"
+
+constexpr cui64 SPIN_DEADLOCK_CYCLES = 0x0100000000u; // TSC cycles (~1-2s) one wait may last before it is recorded as a stall
+
+// The calling thread's current wait; a thread waits on at most one spin lock at a time
+struct SPIN_WAIT {
+   SPIN_SITE_STATS *site;
+   ui64             start;     // TSC on entry to SpinAcquireProfiled
+   ui32             yields;    // Sleep calls taken during this wait
+   bool             contended; // The lock was observed held at least once
+   bool             reported;  // The stall has been recorded for this wait
+};
+
+inline thread_local SPIN_WAIT spinWait = {};
+
+/// Claims the sysData.spin read-out of one lock call site. Called once per site, through SPIN_SITE.
+/// @param kind  Acquisition profile: "SpinLockMin", "SpinLock" or "SpinLockMax".
+/// @param file  Call site (__FILE__); must be a string literal.
+/// @param line  Call site (__LINE__).
+/// @return The site's counters. Once the table is full, the remaining sites share its last entry, labelled "(overflow)".
+inline SPIN_SITE_STATS *SpinSiteRegister(cchptrc kind, cchptrc file, cui32 line) {
+   cui32            index = ui32(_InterlockedIncrement((vol long *)&sysData.spin.sites)) - 1u;
+   SPIN_SITE_STATS &site  = sysData.spin.site[index < MAX_SPIN_SITES ? index : MAX_SPIN_SITES - 1u];
+
+   if(index >= MAX_SPIN_SITES - 1u) {
+      site.kind = "(overflow)";
+      site.file = "";
+      site.line = 0;
+   } else {
+      site.kind = kind;
+      site.file = file;
+      site.line = line;
+   }
+
+   return &site;
+}
+
+// Records a wait that has passed SPIN_DEADLOCK_CYCLES (or a recursive acquisition, with cycles == 0) in sysData.spin.stall*;
+// once per wait
+inline void SpinDiagnose(vui32ptrc lock, cui64 cycles) {
+   SPIN_SITE_STATS *const site = spinWait.site;
+
+   spinWait.reported = true;
+   if(site) _InterlockedIncrement((vol long *)&site->timeouts);
+   sysData.spin.stallSite   = site;
+   sysData.spin.stallLock   = (ptr)lock;
+   sysData.spin.stallCycles = cycles;
+   sysData.spin.stallOwner  = *lock;
+   sysData.spin.stallWaiter = GetCurrentThreadId();
+   _InterlockedIncrement((vol long *)&sysData.spin.stalls);
+}
+
+inline void SpinAcquireProfiled(SPIN_SITE_STATS *const site, vui32ptrc lock, void (*const acquire)(vui32ptrc));
+
+// Wait policy of the profiled acquisitions. Held locks store the owner's thread ID instead of 1, so a stall names the holder
+// and a recursive acquisition is caught on entry
+struct SPIN_PROFILE {
+   typedef SPIN_SITE_STATS *SITE;
+
+   static inline SITE Register(cchptrc kind, cchptrc file, cui32 line) { return SpinSiteRegister(kind, file, line); }
+
+   template <void (*ACQUIRE)(vui32ptrc)>
+   static inline void Acquire(SITE site, vui32ptrc lock) { SpinAcquireProfiled(site, lock, ACQUIRE); }
+
+   static inline long Owner(void) { return long(GetCurrentThreadId()); }
+
+   // Marks the acquisition contended and checks it against SPIN_DEADLOCK_CYCLES
+   static inline void Wait(vui32ptrc lock) {
+      spinWait.contended = true;
+      if(spinWait.reported) return;
+
+      cui64 cycles = __rdtsc() - spinWait.start;
+      if(cycles > SPIN_DEADLOCK_CYCLES) SpinDiagnose(lock, cycles);
+   }
+
+   static inline void Yield(void) { ++spinWait.yields; }
+};
+
+/// Acquires a spin lock through one of the acquisition profiles and charges the wait to its call site.
+/// @param site     Counters of the call site; from SPIN_SITE_OF(SPIN_PROFILE, kind).
+/// @param lock     32-bit lock flag: 0 == unlocked, otherwise the owner's thread ID (1 if taken without SPIN_PROFILE).
+/// @param acquire  SpinLockMin<SPIN_PROFILE>, SpinLock<SPIN_PROFILE> or SpinLockMax<SPIN_PROFILE>.
+/// @note Called through SpinLockVia(SPIN_PROFILE, ...) and the macros below; the counters are plain interlocked adds to the site's own cache line,
+///       so uncontended acquisitions pay two TSC reads and one LOCK XADD.
+inline void SpinAcquireProfiled(SPIN_SITE_STATS *const site, vui32ptrc lock, void (*const acquire)(vui32ptrc)) {
+   spinWait = { site, __rdtsc(), 0, false, false };
+   if(*lock == ui32(SPIN_PROFILE::Owner())) SpinDiagnose(lock, 0); // Recursive acquisition: this wait can never end
+
+   acquire(lock);
+
+   cui64 cycles = __rdtsc() - spinWait.start;
+   _InterlockedIncrement64((vsi64ptr)&site->acquisitions);
+   if(!spinWait.contended) return;
+
+   _InterlockedIncrement64((vsi64ptr)&site->contended);
+   _InterlockedExchangeAdd64((vsi64ptr)&site->spinCycles, (si64)cycles);
+   if(spinWait.yields) _InterlockedExchangeAdd((vol long *)&site->yields, (long)spinWait.yields);
+
+   si64 longest = (si64)site->maxSpinCycles;
+   while(cycles > (ui64)longest) {
+      csi64 seen = _InterlockedCompareExchange64((vsi64ptr)&site->maxSpinCycles, (si64)cycles, longest);
+      if(seen == longest) break;
+      longest = seen;
+   }
+}
+
+// Counted acquisitions at one call site, whatever SPIN_WAIT_POLICY is; release with SpinUnlock as usual
+#define SpinLockMinProfiled(lock) SpinLockMinVia(SPIN_PROFILE, lock)
+#define SpinLockProfiled(lock)    SpinLockVia(SPIN_PROFILE, lock)
+#define SpinLockMaxProfiled(lock) SpinLockMaxVia(SPIN_PROFILE, lock)
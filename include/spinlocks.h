@@ -1,13 +1,14 @@
 /*
  * File: spinlocks.h
- * Version: v1.0.0
+ * Version: v1.2.0
  * Owner: David William Bull
  * Created: 2026-08-11
- * Last Modified: 2026-08-11
- * Description: User-space spin locks for x86-64 MSVC builds: three acquisition profiles, try-acquire, and full-barrier release.
- * To Do: 1) Tune backoff and yield thresholds per CPU architecture; record results in bench/ per bd1.
- *        2) Add optional acquisition timeout and debug-build deadlock detection.
- *        3) Add a cache-line-padded lock type for lock arrays, to prevent false sharing.
+ * Last Modified: 2026-10-17
+ * Description: User-space spin locks for x86-64 MSVC builds: three test-and-test-and-set acquisition profiles, try-acquire and
+ *              full-barrier release, and a bounded-wait acquisition; FIFO ticket and MCS queue locks; a cache-line-padded lock
+ *              for lock arrays. The TTAS acquisitions take a wait policy; "spinlock profile.h" supplies one that counts contention.
+ * To Do: 1) Tune backoff and yield thresholds per CPU architecture; only 1 vCPU shim runs are recorded so far ("bench/results/spin locks.md").
+ *        2) Extend SPIN_PROFILE counting to the ticket and MCS locks.
  * Dependencies: typedefs.h, windows.h, intrin.h
  * ISA: AVX2
  * Thread-safety: MT-safe
@@ -20,7 +21,7 @@
 #include <intrin.h>
 #include "typedefs.h"
 
-#pragma intrinsic(_InterlockedCompareExchange, _InterlockedExchange)
+#pragma intrinsic(_InterlockedCompareExchange, _InterlockedExchange, _InterlockedExchangeAdd)
 
 // GCS a2/a3 build guards: the CPU baseline is AVX2+FMA3+BMI2, compiled with /arch:AVX2
 #ifndef __AVX2__
@@ -34,11 +35,29 @@ constexpr cui32 SPIN_BACKOFF_MIN     = 16u;     // Initial ceiling of the random
 constexpr cui32 SPIN_BACKOFF_MAX     = 1024u;   // Final ceiling of the randomised backoff window; power of two
 constexpr cui32 SPIN_YIELD_THRESHOLD = 10000u;  // Pause iterations before SpinLockMin yields the CPU
 constexpr cui64 SPIN_CYCLE_THRESHOLD = 100000u; // TSC-cycle delta before SpinLockMax's starvation-escape yield
+constexpr cui32 TICKET_BACKOFF_UNIT  = 32u;     // Pause iterations per ticket ahead of the caller (proportional backoff)
+constexpr cui32 MCS_NODES_PER_THREAD = 8u;      // MCS locks one thread may hold at once via the single-argument API
 
 static_assert(SPIN_BACKOFF_MIN && !(SPIN_BACKOFF_MIN & (SPIN_BACKOFF_MIN - 1u)), "SPIN_BACKOFF_MIN must be a power of two: mask-based jitter.");
 static_assert(SPIN_BACKOFF_MAX && !(SPIN_BACKOFF_MAX & (SPIN_BACKOFF_MAX - 1u)), "SPIN_BACKOFF_MAX must be a power of two: mask-based jitter.");
 static_assert(SPIN_BACKOFF_MIN <= SPIN_BACKOFF_MAX, "Backoff window is inverted.");
 
+//== Wait policies
+
+// The TTAS acquisitions (SpinLockMin, SpinLock, SpinLockMax) take a wait policy: what a held lock stores, a probe per
+// spin and per yield, and a per-call-site record that wraps each acquisition (SpinLockVia). SPIN_PLAIN is the default and
+// compiles to the bare loops; SPIN_PROFILE ("spinlock profile.h") counts each call site's contention into sysData.spin.
+// The engine picks one for all of its locks with SPIN_WAIT_POLICY (project definitions.h)
+struct SPIN_PLAIN {
+   typedef cptr SITE;                                                                  // Call-site record: none
+   static constexpr SITE Register(cchptrc, cchptrc, cui32) { return NULL; }            // Once per call site
+   template <void (*ACQUIRE)(vui32ptrc)>
+   static inline void Acquire(SITE, vui32ptrc lock) { ACQUIRE(lock); }                // One acquisition through the site
+   static inline long Owner(void) { return 1; }                                        // Value stored while held
+   static inline void Wait(vui32ptrc) {}                                               // One spin on a held lock
+   static inline void Yield(void) {}                                                   // One Sleep() during a wait
+};
+
 //== Lock operations
 
 /// Acquires a spin lock; conserves power and CPU during long waits.
@@ -47,8 +66,10 @@ static_assert(SPIN_BACKOFF_MIN <= SPIN_BACKOFF_MAX, "Backoff window is inverted.
 /// are able to run. Best when the lock may be held for a long time, or when conserving power and CPU matters
 /// more than acquisition latency.
 /// @param lock  32-bit lock flag: 0 == unlocked, 1 == locked. Must be initialised to 0 and naturally aligned.
+/// @tparam WAIT  Wait policy (SPIN_PLAIN or SPIN_PROFILE); see "Wait policies".
 /// @note Acquisition is a full barrier (LOCK CMPXCHG): reads and writes after the call cannot move before it.
 /// @note Sleep(1) surrenders the rest of the timeslice; the actual delay is >= the system timer period (~1ms-15.6ms).
+template <typename WAIT = SPIN_PLAIN>
 inline void SpinLockMin(vui32ptrc lock) {
    ui32 spinCount  = 0;
    bool firstYield = true;
@@ -57,7 +78,9 @@ inline void SpinLockMin(vui32ptrc lock) {
       // Read-only wait: no interlocked traffic while the lock is observed held
       while(*lock) {
          _mm_pause();
+         WAIT::Wait(lock);
          if(++spinCount >= SPIN_YIELD_THRESHOLD) {
+            WAIT::Yield();
             if(firstYield) {
                Sleep(0);             // Yield to ready threads of equal priority
                firstYield = false;
@@ -66,7 +89,7 @@ inline void SpinLockMin(vui32ptrc lock) {
          }
       }
       // The lock was observed free; attempt to acquire it: 0 -> 1
-      if(_InterlockedCompareExchange((vol long *)lock, 1, 0) == 0) return;
+      if(_InterlockedCompareExchange((vol long *)lock, WAIT::Owner(), 0) == 0) return;
    }
 }
 
@@ -74,16 +97,19 @@ inline void SpinLockMin(vui32ptrc lock) {
 /// Test-and-test-and-set with bounded, TSC-jittered exponential backoff after each failed acquisition,
 /// reducing coherence traffic and thundering-herd retries under moderate contention.
 /// @param lock  32-bit lock flag: 0 == unlocked, 1 == locked. Must be initialised to 0 and naturally aligned.
+/// @tparam WAIT  Wait policy (SPIN_PLAIN or SPIN_PROFILE); see "Wait policies".
 /// @note Acquisition is a full barrier (LOCK CMPXCHG): reads and writes after the call cannot move before it.
+template <typename WAIT = SPIN_PLAIN>
 inline void SpinLock(vui32ptrc lock) {
    ui32 backoff = SPIN_BACKOFF_MIN;
 
    for(;;) {
       // Read-only wait: no interlocked traffic while the lock is observed held
-      while(*lock) _mm_pause();
+      while(*lock) { _mm_pause();   WAIT::Wait(lock); }
       // The lock was observed free; attempt to acquire it: 0 -> 1
-      if(_InterlockedCompareExchange((vol long *)lock, 1, 0) == 0) return;
+      if(_InterlockedCompareExchange((vol long *)lock, WAIT::Owner(), 0) == 0) return;
       // Lost the race: pause 1~backoff times, jittered by the TSC, then widen the window up to SPIN_BACKOFF_MAX
+      WAIT::Wait(lock);
       cui32 pauses = (ui32(__rdtsc()) & (backoff - 1u)) + 1u;
       for(ui32 i = 0; i < pauses; ++i) _mm_pause();
       if(backoff < SPIN_BACKOFF_MAX) backoff <<= 1u;
@@ -94,8 +120,10 @@ inline void SpinLock(vui32ptrc lock) {
 /// Tight test-and-test-and-set with no backoff. If the wait exceeds SPIN_CYCLE_THRESHOLD cycles -- e.g. the
 /// holder was pre-empted -- the thread yields once via Sleep(0), re-arms the threshold, and resumes spinning.
 /// @param lock  32-bit lock flag: 0 == unlocked, 1 == locked. Must be initialised to 0 and naturally aligned.
+/// @tparam WAIT  Wait policy (SPIN_PLAIN or SPIN_PROFILE); see "Wait policies".
 /// @note Acquisition is a full barrier (LOCK CMPXCHG): reads and writes after the call cannot move before it;
 ///       no separate fence is required.
+template <typename WAIT = SPIN_PLAIN>
 inline void SpinLockMax(vui32ptrc lock) {
    ui64 refTSC = __rdtsc();
 
@@ -103,13 +131,42 @@ inline void SpinLockMax(vui32ptrc lock) {
       // Read-only wait: no interlocked traffic while the lock is observed held
       while(*lock) {
          _mm_pause();
+         WAIT::Wait(lock);
          if(__rdtsc() - refTSC > SPIN_CYCLE_THRESHOLD) {
+            WAIT::Yield();
             Sleep(0);                // Starvation escape: the holder may have been pre-empted
             refTSC = __rdtsc();      // Re-arm the threshold, then resume spinning
          }
       }
       // The lock was observed free; attempt to acquire it: 0 -> 1
-      if(_InterlockedCompareExchange((vol long *)lock, 1, 0) == 0) return;
+      if(_InterlockedCompareExchange((vol long *)lock, WAIT::Owner(), 0) == 0) return;
+   }
+}
+
+/// Acquires a spin lock, giving up after a bounded wait; for call sites that can recover from a lock that is never released.
+/// Test-and-test-and-set with the same TSC-jittered exponential backoff as SpinLock; the wait is measured with the TSC.
+/// @param lock       32-bit lock flag: 0 == unlocked, 1 == locked. Must be initialised to 0 and naturally aligned.
+/// @param maxCycles  TSC cycles to wait before giving up; 0 == a single attempt, as SpinLockTry.
+/// @return true if the lock was acquired, otherwise false.
+/// @note A successful acquisition is a full barrier (LOCK CMPXCHG); a timed-out attempt imposes no ordering.
+/// @note Takes no wait policy: the caller already decides what a timeout means.
+inline cbool SpinLockFor(vui32ptrc lock, cui64 maxCycles) {
+   cui64 refTSC  = __rdtsc();
+   ui32  backoff = SPIN_BACKOFF_MIN;
+
+   for(;;) {
+      // Read-only wait: no interlocked traffic while the lock is observed held
+      while(*lock) {
+         if(__rdtsc() - refTSC >= maxCycles) return false;
+         _mm_pause();
+      }
+      // The lock was observed free; attempt to acquire it: 0 -> 1
+      if(_InterlockedCompareExchange((vol long *)lock, 1, 0) == 0) return true;
+      if(__rdtsc() - refTSC >= maxCycles) return false;
+      // Lost the race: back off as SpinLock does
+      cui32 pauses = (ui32(__rdtsc()) & (backoff - 1u)) + 1u;
+      for(ui32 i = 0; i < pauses; ++i) _mm_pause();
+      if(backoff < SPIN_BACKOFF_MAX) backoff <<= 1u;
    }
 }
 
@@ -119,8 +176,140 @@ inline void SpinLockMax(vui32ptrc lock) {
 /// @note A successful attempt is a full barrier (LOCK CMPXCHG); a failed attempt imposes no ordering.
 inline cbool SpinLockTry(vui32ptrc lock) { return _InterlockedCompareExchange((vol long *)lock, 1, 0) == 0; }
 
-/// Releases a spin lock acquired by SpinLockMin, SpinLock, SpinLockMax, or SpinLockTry.
+/// Releases a spin lock acquired by SpinLockMin, SpinLock, SpinLockMax, SpinLockFor, or SpinLockTry.
 /// @param lock  32-bit lock flag: 1 == locked on entry; 0 == unlocked on return.
 /// @note Release is a full barrier (XCHG): every write inside the critical section is globally visible before
 ///       the flag clears, independent of the /volatile:ms|iso compiler mode. Call only while holding the lock.
 inline void SpinUnlock(vui32ptrc lock) { _InterlockedExchange((vol long *)lock, 0); }
+
+//== Policy-routed acquisitions
+
+// Record of the enclosing call site under wait policy WAIT, registered on first use; SPIN_PLAIN's is a constant
+#define SPIN_SITE_OF(WAIT, kind) \
+   ([]() -> WAIT::SITE { static const WAIT::SITE site = WAIT::Register(kind, __FILE__, __LINE__); return site; }())
+
+// Acquisitions through wait policy WAIT, charged to the call site; release with SpinUnlock as usual. Engine code passes
+// SPIN_WAIT_POLICY, so one typedef switches every lock between SPIN_PLAIN and SPIN_PROFILE
+#define SpinLockMinVia(WAIT, lock) WAIT::Acquire<SpinLockMin<WAIT>>(SPIN_SITE_OF(WAIT, "SpinLockMin"), (lock))
+#define SpinLockVia(WAIT, lock)    WAIT::Acquire<SpinLock<WAIT>>(SPIN_SITE_OF(WAIT, "SpinLock"), (lock))
+#define SpinLockMaxVia(WAIT, lock) WAIT::Acquire<SpinLockMax<WAIT>>(SPIN_SITE_OF(WAIT, "SpinLockMax"), (lock))
+
+//== Padded lock
+
+// One SpinLock flag per cache line. Use for arrays of locks, so that neighbouring locks never share a line
+al64 struct SPINLOCK_PADDED {
+   vui32 lock = 0;
+};
+
+static_assert(sizeof(SPINLOCK_PADDED) == 64u, "SPINLOCK_PADDED must fill exactly one cache line.");
+
+//== Ticket lock
+
+// FIFO spin lock: threads are served in arrival order, so none starves. Waiters spin on 'serving' only.
+// Best for short sections under moderate contention. Every hand-off invalidates the line in all waiters, so
+// prefer MCS_LOCK when many threads contend.
+al64 struct TICKET_LOCK {
+   vui32 next    = 0;   // Next ticket to hand out
+   vui32 serving = 0;   // Ticket now holding the lock
+};
+
+/// Acquires a ticket lock; waits in FIFO order.
+/// Backoff is proportional to the caller's distance from the head of the queue, to reduce polling of 'serving'.
+/// After SPIN_YIELD_THRESHOLD pause iterations the waiter yields with SwitchToThread(), so a pre-empted
+/// holder or earlier ticket can run.
+/// @note Acquisition is a full barrier (LOCK XADD).
+inline void TicketLock(TICKET_LOCK *const lock) {
+   cui32 ticket    = ui32(_InterlockedExchangeAdd((vol long *)&lock->next, 1));
+   ui32  spinCount = 0;
+
+   for(;;) {
+      cui32 ahead = ticket - lock->serving;
+      if(!ahead) return;
+
+      cui32 pauses = ahead * TICKET_BACKOFF_UNIT;
+      for(ui32 i = 0; i < pauses; ++i) _mm_pause();
+      if((spinCount += pauses) >= SPIN_YIELD_THRESHOLD) { SwitchToThread(); spinCount = 0; }
+   }
+}
+
+/// Attempts to acquire a ticket lock without waiting; succeeds only if no thread holds or awaits it.
+/// @return true if the lock was acquired, otherwise false.
+inline cbool TicketLockTry(TICKET_LOCK *const lock) {
+   cui32 serving = lock->serving;
+   return ui32(_InterlockedCompareExchange((vol long *)&lock->next, long(serving + 1u), long(serving))) == serving;
+}
+
+/// Releases a ticket lock, serving the next ticket in line.
+/// @note Release is a full barrier (XCHG). Call only while holding the lock.
+inline void TicketUnlock(TICKET_LOCK *const lock) { _InterlockedExchange((vol long *)&lock->serving, long(lock->serving + 1u)); }
+
+//== MCS queue lock
+
+// Queue node; one per waiting or holding thread, per lock
+al64 struct MCS_NODE {
+   MCS_NODE *vol next;
+   vui32         locked;
+};
+
+// FIFO queue lock (Mellor-Crummey & Scott). Each waiter spins on its own node, so a hand-off touches only
+// the next waiter's cache line. Throughput holds up as the thread count grows.
+al64 struct MCS_LOCK {
+   MCS_NODE *vol tail   = NULL;
+   MCS_NODE     *holder = NULL;   // Node of the current holder; written and read only under the lock
+};
+
+/// Acquires an MCS lock using a caller-supplied node.
+/// @param node  Must stay valid, and must not be reused for another lock, until McsUnlock(lock, node) returns.
+/// @note Acquisition is a full barrier (XCHG); the hand-off is a full barrier in McsUnlock.
+inline void McsLock(MCS_LOCK *const lock, MCS_NODE *const node) {
+   node->next   = NULL;
+   node->locked = 1u;
+
+   MCS_NODE *const prev = (MCS_NODE *)_InterlockedExchangePointer((ptr vol *)&lock->tail, node);
+
+   if(prev) {
+      ui32 spinCount = 0;
+
+      prev->next = node;
+      // Local spin: only the predecessor writes this node
+      while(node->locked) {
+         _mm_pause();
+         if(++spinCount >= SPIN_YIELD_THRESHOLD) { SwitchToThread(); spinCount = 0; }
+      }
+   }
+}
+
+/// Releases an MCS lock acquired with McsLock(lock, node), handing it to the next queued thread, if any.
+inline void McsUnlock(MCS_LOCK *const lock, MCS_NODE *const node) {
+   if(!node->next) {
+      // No visible successor: try to swing the tail back to empty
+      if(_InterlockedCompareExchangePointer((ptr vol *)&lock->tail, NULL, node) == node) return;
+      // A successor has swapped in but not yet linked itself
+      while(!node->next) _mm_pause();
+   }
+   _InterlockedExchange((vol long *)&node->next->locked, 0);
+}
+
+// Per-thread node pool for the single-argument MCS API; bit n of mcsNodesUsed == mcsNode[n] in use
+inline thread_local MCS_NODE mcsNode[MCS_NODES_PER_THREAD];
+inline thread_local ui32     mcsNodesUsed = 0;
+
+/// Acquires an MCS lock with a node from the calling thread's pool; same call shape as SpinLock.
+/// @note A thread may hold at most MCS_NODES_PER_THREAD of these at once; release in any order. Taking one more is a bug and
+///       ends the process (__fastfail) rather than overrun the pool; nest deeper with McsLock(lock, node) and a caller-owned node.
+inline void McsLock(MCS_LOCK *const lock) {
+   cui32 index = _tzcnt_u32(~mcsNodesUsed);
+
+   if(index >= MCS_NODES_PER_THREAD) __fastfail(FAST_FAIL_INVALID_ARG);
+   mcsNodesUsed |= 1u << index;
+   McsLock(lock, &mcsNode[index]);
+   lock->holder = &mcsNode[index];
+}
+
+/// Releases an MCS lock acquired with McsLock(lock).
+inline void McsUnlock(MCS_LOCK *const lock) {
+   MCS_NODE *const node = lock->holder;   // Read before the hand-off; the next holder overwrites it
+
+   McsUnlock(lock, node);
+   mcsNodesUsed &= ~(1u << ui32(node - mcsNode));
+}